@@ -0,0 +1,600 @@
+#include "AdventureCharacters.h"
+#include "Navigation.h"
+#include "Flocking.h"
+#include "Formation.h"
+#include <glm/gtc/constants.hpp>
+#include <algorithm> // Para std::min/max
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+// --- Random Number Generator ---
+std::random_device rd;
+std::mt19937 gen(rd());
+std::uniform_real_distribution<float> distrib(-1.0f, 1.0f); // For directions
+std::uniform_real_distribution<float> distrib01(0.0f, 1.0f); // For probabilities/intervals
+std::uniform_real_distribution<float> distribFlyY(FLYING_MIN_Y, FLYING_MAX_Y);
+std::uniform_real_distribution<float> distribWander(-WANDER_RADIUS, WANDER_RADIUS);
+
+float simulationTime = 0.0f;
+
+CharacterPools characterPools;
+NpcScheduler npcScheduler;
+SimulationLod simulationLod;
+uint32_t simulationTick = 0;
+
+const int SimulationLod::TIER_INTERVALS[SimulationLod::TIER_COUNT] = { 1, 2, 4 };
+
+int SimulationLod::tierFor(float distanceSquared) const {
+    for (int t = 0; t < TIER_COUNT - 1; ++t) {
+        if (distanceSquared <= tierRadius[t] * tierRadius[t]) return t;
+    }
+    return TIER_COUNT - 1;
+}
+
+void parseSimulationLod(int argc, char** argv) {
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--sim-lod") != 0) continue;
+        simulationLod.enabled = true;
+        // Optional "near,mid" radii
+        if (i + 1 < argc && argv[i + 1][0] != '-') {
+            const char* radii = argv[++i];
+            simulationLod.tierRadius[0] = static_cast<float>(std::atof(radii));
+            if (const char* comma = std::strchr(radii, ',')) simulationLod.tierRadius[1] = static_cast<float>(std::atof(comma + 1));
+            simulationLod.tierRadius[1] = std::max(simulationLod.tierRadius[0], simulationLod.tierRadius[1]);
+        }
+    }
+}
+
+
+// --- Implementações das classes NPC ---
+
+void BMO::chooseNewTarget() {
+    targetPosition = glm::vec3(distribWander(gen), groundHeight, distribWander(gen));
+    timeSinceLastDecision = 0.0f;
+    decisionInterval = 4.0f + distrib01(gen) * 6.0f; // 4-10s
+}
+
+void BMO::update(float deltaTime) {
+    Character::update(deltaTime); // Calls base update (handles wander if not controlled)
+    // Ensure BMO stays exactly on the ground if not jumping
+    if (!isJumping) {
+        position.y = groundHeight;
+    }
+}
+
+void PrincessBubblegum::chooseNewTarget() {
+    targetPosition = glm::vec3(distribWander(gen), groundHeight, distribWander(gen));
+    timeSinceLastDecision = 0.0f;
+    decisionInterval = 5.0f + distrib01(gen) * 5.0f; // 5-10s
+}
+
+void PrincessBubblegum::update(float deltaTime) {
+    Character::update(deltaTime); // Calls base update (handles wander if not controlled)
+    // Ensure PB stays exactly on the ground if not jumping
+     if (!isJumping) {
+        position.y = groundHeight;
+    }
+}
+
+void IceKing::chooseNewTarget() {
+    targetPosition = glm::vec3(distribWander(gen), distribFlyY(gen), distribWander(gen)); // Target includes random Y
+    timeSinceLastDecision = 0.0f;
+    decisionInterval = 6.0f + distrib01(gen) * 6.0f; // 6-12s
+}
+// IceKing uses base Character::update
+
+void Marceline::chooseNewTarget() {
+    targetPosition = glm::vec3(distribWander(gen), distribFlyY(gen), distribWander(gen)); // Target includes random Y
+    timeSinceLastDecision = 0.0f;
+    decisionInterval = 4.0f + distrib01(gen) * 4.0f; // 4-8s (more erratic?)
+}
+// Marceline uses base Character::update
+
+
+// --- Implementações Character / Finn / Jake (DEPOIS de todas as class declarations) ---
+
+// Character Constructor Definition
+Character::Character(glm::vec3 pos, float rot, float inc, float spd, float jumpInitialSpd, float g, float grndHeight, bool npc) :
+    position(pos), rotation(rot), headInclination(inc), speed(spd), isJumping(false),
+    currentVerticalSpeed(0.0f), gravity(g), groundHeight(grndHeight), initialJumpSpeed(jumpInitialSpd), // Initialize initialJumpSpeed
+    legSwingAngle(0.0f), armSwingAngle(0.0f), moving(false),
+    targetPosition(pos), timeSinceLastDecision(0.0f), decisionInterval(5.0f + distrib01(gen) * 5.0f),
+    isNPC(npc), isUnderPlayerControl(false) // Initialize new flag
+{
+    // Don't call chooseNewTarget here, let derived NPC constructors do it
+}
+
+// Character update DEFINITION
+void Character::update(float deltaTime) {
+    // Always apply gravity/jump physics
+    updateJump(deltaTime);
+
+    // Update limb swing (mainly for Finn/Jake appearance)
+    updateLimbSwing(deltaTime);
+
+    // Handle NPC wandering ONLY if it's an NPC, NOT under player control and not following a formation
+    if (isNPC && !isUnderPlayerControl && formationGroup < 0) {
+        updateNPCWander(deltaTime);
+    } else if (isNPC) {
+        decisionDue = true; // The player (or its formation) moved it: re-check as soon as it is released
+    }
+
+    // Reset moving flag IF NOT under player control (player control sets it via input)
+    if (!isUnderPlayerControl) {
+        moving = false; // NPCs set 'moving' in wander logic if they move
+    } else {
+         moving = false; // Reset player moving flag each frame, set true on move input
+    }
+}
+
+// ***** ADD THIS DEFINITION *****
+void Character::chooseNewTarget() {
+    // Default implementation for the base class or non-overriding derived classes.
+    // Choose a random target on the ground.
+    targetPosition = glm::vec3(distribWander(gen), groundHeight, distribWander(gen));
+    timeSinceLastDecision = 0.0f;
+    // Set a default decision interval
+    decisionInterval = 5.0f + distrib01(gen) * 5.0f; // Random interval 5-10s
+}
+// ***** END OF ADDED DEFINITION *****
+
+// Character updateNPCWander DEFINITION (uses dynamic_cast, needs derived class definitions)
+void Character::updateNPCWander(float deltaTime) {
+    timeSinceLastDecision += deltaTime;
+    // Check distance OR time interval to pick new target (only when npcScheduler says it may be due)
+    if (decisionDue) {
+        decisionDue = false;
+        if (timeSinceLastDecision > decisionInterval || glm::distance(position, targetPosition) < 1.0f) {
+            chooseNewTarget(); // Calls the VIRTUAL function (derived implementation if exists)
+            if (navigation.enabled && !isFlyer(this)) targetPosition = navigation.snapToWaypoint(targetPosition);
+            ++npcScheduler.stats.decisions;
+        }
+        npcScheduler.schedule(this, deltaTime);
+    }
+
+    glm::vec3 direction = targetPosition - position;
+    float distanceToTarget = glm::length(direction);
+
+    // Only move and rotate if not already at the target
+    if (distanceToTarget > 0.1f) {
+        glm::vec3 moveDir = glm::normalize(direction);
+        // Walkers follow the flow field around obstacles (--nav); flyers keep the straight line
+        if (navigation.enabled && !isFlyer(this)) moveDir = navigation.steer(position, targetPosition, moveDir);
+        // Flyers blend in the flock steering computed this tick (--flock)
+        if (flocking.enabled && isFlyer(this)) moveDir = flocking.blend(moveDir, flockSteering);
+
+        // Rotate to face the target direction
+        rotation = atan2(moveDir.x, moveDir.z);
+
+        // Move towards target
+        position += moveDir * speed * deltaTime;
+        velocity = moveDir * speed;
+        moving = true; // Indicate movement
+        if (flocking.enabled && isFlyer(this)) position.y = std::clamp(position.y, FLYING_MIN_Y, FLYING_MAX_Y);
+
+        // Ensure walking NPCs don't accidentally change Y due to float inaccuracy while moving
+        // Check if 'this' is NOT a flyer using dynamic_cast
+         if (!dynamic_cast<IceKing*>(this) && !dynamic_cast<Marceline*>(this)){
+             // Ensure Y stays at ground height ONLY IF NOT JUMPING
+             // (This check might be redundant if jump logic handles ground snapping well)
+             if (!isJumping) {
+                position.y = groundHeight;
+             }
+         }
+
+    } else {
+        moving = false; // Reached target
+        velocity = glm::vec3(0.0f);
+        // Snap walkers to ground height precisely when stopped
+        // Check if 'this' is NOT a flyer
+        if (!dynamic_cast<IceKing*>(this) && !dynamic_cast<Marceline*>(this)){
+            position.y = groundHeight;
+            isJumping = false; // Ensure grounded state if snapped
+            currentVerticalSpeed = 0.0f;
+        }
+    }
+}
+
+
+// Character startJump DEFINITION (uses dynamic_cast, needs Jake definition)
+void Character::startJump(float jumpInitialSpeed) {
+    float effectiveGround = groundHeight;
+    // Check if 'this' is actually a Jake object
+    if (const Jake* j = dynamic_cast<const Jake*>(this)) {
+        effectiveGround = j->getEffectiveGroundHeight();
+    }
+    // Allow jump only if not already jumping and close to the effective ground
+    // Removed !isNPC check - allow controlled NPCs to jump
+    if (!isJumping && abs(position.y - effectiveGround) < 0.15f) { // Slightly larger tolerance
+        isJumping = true;
+        currentVerticalSpeed = jumpInitialSpeed; // Use the passed-in value
+    }
+}
+
+// Character updateJump DEFINITION (uses dynamic_cast, needs Jake definition)
+void Character::updateJump(float deltaTime) {
+    // Apply gravity if airborne or moving upwards
+    // Flyers (IceKing, Marceline) have gravity 0, so this won't affect them negatively
+     if (position.y > groundHeight || currentVerticalSpeed > 0 || isJumping) { // Keep applying gravity until landed
+        currentVerticalSpeed -= gravity * deltaTime;
+     }
+
+    // Update position based on vertical speed
+    position.y += currentVerticalSpeed * deltaTime;
+
+    // Determine the target ground height (might be higher for stretched Jake)
+    float targetGround = groundHeight;
+    if (Jake* j = dynamic_cast<Jake*>(this)) {
+        targetGround = j->getEffectiveGroundHeight();
+    }
+
+    // Check for landing (only if moving downwards or at ground level)
+    if (position.y <= targetGround && currentVerticalSpeed <= 0) {
+        position.y = targetGround; // Snap to ground
+        isJumping = false;         // Stop jumping state
+        currentVerticalSpeed = 0.0f; // Reset vertical speed
+    }
+}
+
+// Character updateLimbSwing DEFINITION
+void Character::updateLimbSwing(float deltaTime) {
+    // Only applies animation to Finn/Jake appearance
+    if (dynamic_cast<Finn*>(this) || dynamic_cast<Jake*>(this)) {
+        const float swingSpeed = 6.0f;
+        const float maxSwingAngle = glm::radians(40.0f);
+        const float armMultiplier = 1.2f;
+
+        if (moving) { // 'moving' is set by input processing or NPC wander
+            float time = simulationTime; // Use global time for consistent swing
+            legSwingAngle = sin(time * swingSpeed) * maxSwingAngle;
+            armSwingAngle = -sin(time * swingSpeed) * maxSwingAngle * armMultiplier; // Arms swing opposite
+        } else {
+            // Dampen swing when stopped
+            legSwingAngle *= pow(0.1f, deltaTime);
+            armSwingAngle *= pow(0.1f, deltaTime);
+            if (abs(legSwingAngle) < 0.01f) legSwingAngle = 0.0f;
+            if (abs(armSwingAngle) < 0.01f) armSwingAngle = 0.0f;
+        }
+    } else {
+        // Ensure non-Finn/Jake have zero swing
+        legSwingAngle = 0.0f;
+        armSwingAngle = 0.0f;
+    }
+}
+
+// --- Movement Methods (Apply directly to character, no NPC check needed here) ---
+void Character::moveForward(float deltaTime) {
+    position.x += speed * deltaTime * sin(rotation);
+    position.z += speed * deltaTime * cos(rotation);
+    moving = true;
+}
+
+void Character::moveBackward(float deltaTime) {
+    position.x -= speed * deltaTime * sin(rotation);
+    position.z -= speed * deltaTime * cos(rotation);
+    moving = true;
+}
+
+void Character::rotateLeft(float deltaTime) {
+    rotation += 2.0f * deltaTime;
+    rotation = fmod(rotation, 2.0f * glm::pi<float>());
+    if (rotation < 0.0f) rotation += 2.0f * glm::pi<float>();
+}
+
+void Character::rotateRight(float deltaTime) {
+    rotation -= 2.0f * deltaTime;
+    rotation = fmod(rotation, 2.0f * glm::pi<float>());
+    if (rotation < 0.0f) rotation += 2.0f * glm::pi<float>();
+}
+
+
+// --- Finn Implementations ---
+void Finn::startAttack() {
+    if (!isAttacking) {
+        isAttacking = true;
+        attackStartTime = simulationTime;
+    }
+}
+
+void Finn::update(float deltaTime) {
+    Character::update(deltaTime); // Call base class update
+    // Update attack state specific to Finn
+    if (isAttacking && (simulationTime - attackStartTime > 0.3f)) { // Attack duration
+        isAttacking = false;
+    }
+}
+
+// --- Jake Implementations ---
+float Jake::getStretchHeightOffset() const {
+    if (legStretch > 1.0f) {
+        return JAKE_BASE_LEG_LENGTH * (legStretch - 1.0f);
+    }
+    return 0.0f;
+}
+
+float Jake::getEffectiveGroundHeight() const {
+    return groundHeight + getStretchHeightOffset();
+}
+
+void Jake::update(float deltaTime) {
+    Character::update(deltaTime); // Call base class update FIRST
+
+    // --- Update Jake-specific properties ---
+    if (legStretch > 1.0f) {
+        legStretch -= 3.0f * deltaTime;
+        legStretch = std::max(1.0f, legStretch);
+    }
+    if(sizeMultiplier > 1.0f){
+        sizeMultiplier -= 2.0f * deltaTime;
+        sizeMultiplier = std::max(1.0f, sizeMultiplier);
+    }
+
+    // --- Adjust Position based on Stretch ---
+    // Ensure Jake is at the correct height IF he's not jumping
+    float targetGround = getEffectiveGroundHeight();
+    if (!isJumping && abs(position.y - targetGround) > 0.01f) {
+        position.y = targetGround;
+        if (currentVerticalSpeed > 0) currentVerticalSpeed = 0.0f; // Kill upward speed if snapped down
+    }
+    // Landing is handled correctly by Character::updateJump using targetGround.
+}
+
+
+// --- Cena ---
+
+// --- Character storage ---
+
+template <typename T>
+static Handle<T> toPoolHandle(CharacterHandle handle) {
+    Handle<T> poolHandle;
+    poolHandle.index = handle.index;
+    poolHandle.generation = handle.generation;
+    return poolHandle;
+}
+
+template <typename T>
+static Character* spawnInto(Pool<T>& pool, CharacterType type, glm::vec3 pos) {
+    Handle<T> poolHandle = pool.spawn(pos);
+    Character* character = pool.get(poolHandle);
+    character->handle.type = type;
+    character->handle.index = poolHandle.index;
+    character->handle.generation = poolHandle.generation;
+    if (character->isNPC) npcScheduler.scheduleNow(character);
+    return character;
+}
+
+void CharacterPools::reserve(CharacterType type, size_t count) {
+    switch (type) {
+        case CHARACTER_FINN: finns.reserve(count); break;
+        case CHARACTER_JAKE: jakes.reserve(count); break;
+        case CHARACTER_BMO: bmos.reserve(count); break;
+        case CHARACTER_PB: bubblegums.reserve(count); break;
+        case CHARACTER_ICE_KING: iceKings.reserve(count); break;
+        default: marcelines.reserve(count); break;
+    }
+}
+
+Character* CharacterPools::spawn(CharacterType type, glm::vec3 pos) {
+    switch (type) {
+        case CHARACTER_FINN: return spawnInto(finns, type, pos);
+        case CHARACTER_JAKE: return spawnInto(jakes, type, pos);
+        case CHARACTER_BMO: return spawnInto(bmos, type, pos);
+        case CHARACTER_PB: return spawnInto(bubblegums, type, pos);
+        case CHARACTER_ICE_KING: return spawnInto(iceKings, type, pos);
+        default: return spawnInto(marcelines, CHARACTER_MARCELINE, pos);
+    }
+}
+
+Character* CharacterPools::get(CharacterHandle handle) const {
+    switch (handle.type) {
+        case CHARACTER_FINN: return finns.get(toPoolHandle<Finn>(handle));
+        case CHARACTER_JAKE: return jakes.get(toPoolHandle<Jake>(handle));
+        case CHARACTER_BMO: return bmos.get(toPoolHandle<BMO>(handle));
+        case CHARACTER_PB: return bubblegums.get(toPoolHandle<PrincessBubblegum>(handle));
+        case CHARACTER_ICE_KING: return iceKings.get(toPoolHandle<IceKing>(handle));
+        default: return marcelines.get(toPoolHandle<Marceline>(handle));
+    }
+}
+
+void CharacterPools::despawn(Character* character) {
+    if (!character || get(character->handle) != character) return;
+    formations.forget(character);
+    CharacterHandle handle = character->handle;
+    switch (handle.type) {
+        case CHARACTER_FINN: finns.despawn(toPoolHandle<Finn>(handle)); break;
+        case CHARACTER_JAKE: jakes.despawn(toPoolHandle<Jake>(handle)); break;
+        case CHARACTER_BMO: bmos.despawn(toPoolHandle<BMO>(handle)); break;
+        case CHARACTER_PB: bubblegums.despawn(toPoolHandle<PrincessBubblegum>(handle)); break;
+        case CHARACTER_ICE_KING: iceKings.despawn(toPoolHandle<IceKing>(handle)); break;
+        default: marcelines.despawn(toPoolHandle<Marceline>(handle)); break;
+    }
+}
+
+void CharacterPools::clear() {
+    finns.clear();
+    jakes.clear();
+    bmos.clear();
+    bubblegums.clear();
+    iceKings.clear();
+    marcelines.clear();
+}
+
+size_t CharacterPools::size() const {
+    return finns.size() + jakes.size() + bmos.size() + bubblegums.size() + iceKings.size() + marcelines.size();
+}
+
+size_t CharacterPools::slabCount() const {
+    return finns.slabCount() + jakes.slabCount() + bmos.slabCount() + bubblegums.slabCount() +
+           iceKings.slabCount() + marcelines.slabCount();
+}
+
+size_t CharacterPools::memoryBytes() const {
+    return finns.memoryBytes() + jakes.memoryBytes() + bmos.memoryBytes() + bubblegums.memoryBytes() +
+           iceKings.memoryBytes() + marcelines.memoryBytes();
+}
+
+CharacterType characterType(const Character* character) {
+    if (character->handle.isValid()) return character->handle.type;
+    if (dynamic_cast<const Finn*>(character)) return CHARACTER_FINN;
+    if (dynamic_cast<const Jake*>(character)) return CHARACTER_JAKE;
+    if (dynamic_cast<const BMO*>(character)) return CHARACTER_BMO;
+    if (dynamic_cast<const PrincessBubblegum*>(character)) return CHARACTER_PB;
+    if (dynamic_cast<const IceKing*>(character)) return CHARACTER_ICE_KING;
+    return CHARACTER_MARCELINE;
+}
+
+bool isFlyer(const Character* character) {
+    CharacterType type = characterType(character);
+    return type == CHARACTER_ICE_KING || type == CHARACTER_MARCELINE;
+}
+
+void despawnCharacters(std::vector<Character*>& characters) {
+    for (Character* character : characters) characterPools.despawn(character);
+    characters.clear();
+    if (characterPools.size() == 0) {
+        npcScheduler.clear(); // Only stale entries left
+        formations.clear();
+    }
+}
+
+// --- NPC decision scheduler ---
+
+void NpcScheduler::push(Character* character, float deadline) {
+    Entry entry;
+    entry.deadline = deadline;
+    entry.ticket = ++character->decisionTicket;
+    entry.character = character;
+    entry.handle = character->handle;
+    heap.push(entry);
+}
+
+void NpcScheduler::scheduleNow(Character* character) {
+    push(character, -1.0f); // Due on the first tick
+}
+
+void NpcScheduler::schedule(Character* character, float deltaTime) {
+    if (!character->handle.isValid()) {
+        character->decisionDue = true; // Not pooled: no stable handle to queue, test every tick
+        return;
+    }
+
+    float timeLeft = character->decisionInterval - character->timeSinceLastDecision;
+    float arrival = timeLeft;
+    if (character->speed > 0.0f) {
+        arrival = (glm::distance(character->position, character->targetPosition) - 1.0f) / character->speed;
+    }
+    // One tick of slack: this tick's movement has not happened yet, and simulationTime rounds differently
+    // than timeSinceLastDecision
+    float wait = std::min(timeLeft, arrival) - deltaTime - 0.001f;
+    push(character, simulationTime + std::max(0.0f, wait));
+}
+
+void NpcScheduler::wakeDue(float now) {
+    while (!heap.empty() && heap.top().deadline <= now) {
+        Entry entry = heap.top();
+        heap.pop();
+        if (characterPools.get(entry.handle) != entry.character) continue; // Despawned
+        if (entry.character->decisionTicket != entry.ticket) continue;   // Rescheduled since
+        entry.character->decisionDue = true;
+        ++stats.wakeups;
+    }
+}
+
+void NpcScheduler::clear() {
+    heap = decltype(heap)();
+}
+
+void spawnCharacters(std::vector<Character*>& allCharacters) {
+    // Vector containing ALL controllable characters
+    allCharacters.push_back(characterPools.spawn(CHARACTER_FINN, glm::vec3(-5.0f, 0.0f, 5.0f))); // Index 0 - Start further left, slightly forward
+    allCharacters.push_back(characterPools.spawn(CHARACTER_JAKE, glm::vec3(5.0f, 0.0f, 5.0f)));  // Index 1 - Start further right, slightly forward
+
+    // NPCs (Indices 2, 3, 4, 5...)
+    allCharacters.push_back(characterPools.spawn(CHARACTER_BMO, glm::vec3(0.0f, 0.0f, -5.0f)));
+    allCharacters.push_back(characterPools.spawn(CHARACTER_PB, glm::vec3(-5.0f, 0.0f, -10.0f)));
+    allCharacters.push_back(characterPools.spawn(CHARACTER_ICE_KING, glm::vec3(0.0f, 5.0f, -15.0f))); // Start flying
+    allCharacters.push_back(characterPools.spawn(CHARACTER_MARCELINE, glm::vec3(5.0f, 4.0f, -8.0f)));  // Start flying
+}
+
+// Finn (0) and Jake (1) form a party while exactly one of them is controlled: the controlled
+// one leads and the other trails 3 units behind at 80% of its speed
+int partyGroup = -1;
+
+static void updateParty(std::vector<Character*>& allCharacters) {
+    bool finnControlled = allCharacters.size() >= 2 && allCharacters[0]->isUnderPlayerControl;
+    bool jakeControlled = allCharacters.size() >= 2 && allCharacters[1]->isUnderPlayerControl;
+    if (finnControlled != jakeControlled) {
+        Character* leader = allCharacters[finnControlled ? 0 : 1];
+        Character* follower = allCharacters[finnControlled ? 1 : 0];
+        if (!formations.isActive(partyGroup)) partyGroup = formations.createGroup(leader, FormationShape::Trail, 3.0f, 0.8f);
+        formations.setLeader(partyGroup, leader);
+        formations.join(partyGroup, follower);
+    } else if (formations.isActive(partyGroup)) {
+        formations.disband(partyGroup);
+    }
+}
+
+void updateWorld(std::vector<Character*>& allCharacters, int activeCharacterIndex, float deltaTime) {
+    bool valid = activeCharacterIndex >= 0 && activeCharacterIndex < (int)allCharacters.size();
+    updateWorld(allCharacters, &activeCharacterIndex, valid ? 1 : 0, deltaTime);
+}
+
+void updateWorld(std::vector<Character*>& allCharacters, const int* controlledIndices, size_t controlledCount, float deltaTime) {
+    simulationTime += deltaTime;
+    npcScheduler.wakeDue(simulationTime);
+
+    // Set player control flags before updating
+    for (Character* character : allCharacters) character->isUnderPlayerControl = false;
+    for (size_t i = 0; i < controlledCount; ++i) {
+        allCharacters[controlledIndices[i]]->isUnderPlayerControl = true;
+    }
+    // Flock steering from this tick's positions, before anybody moves
+    if (flocking.enabled) flocking.update(allCharacters);
+
+    updateParty(allCharacters);
+
+    // Update ALL characters (base update handles player control vs NPC wander).
+    // With simulation LOD, far characters skip ticks and catch up with the accumulated time.
+    glm::vec3 focus = controlledCount > 0 ? allCharacters[controlledIndices[0]]->position : CAMERA_POSITION;
+    for (size_t i = 0; i < allCharacters.size(); ++i) {
+        Character* character = allCharacters[i];
+        character->lodPendingTime += deltaTime;
+
+        int tier = 0;
+        if (simulationLod.enabled && !character->isUnderPlayerControl && character->formationGroup < 0) {
+            glm::vec3 offset = character->position - focus;
+            tier = simulationLod.tierFor(glm::dot(offset, offset));
+        }
+        character->lodTier = static_cast<uint8_t>(tier);
+        if ((simulationTick + i) % SimulationLod::TIER_INTERVALS[tier] != 0) continue;
+        ++simulationLod.updates[tier];
+        character->update(character->lodPendingTime);
+        character->lodPendingTime = 0.0f;
+    }
+    ++simulationTick;
+
+
+    // --- Lógica de Seguir ---
+    formations.update(deltaTime);
+}
+
+void applyPlayerInput(Character* character, PlayerInput input, float deltaTime) {
+    if (input & INPUT_FORWARD) character->moveForward(deltaTime);
+    if (input & INPUT_BACKWARD) character->moveBackward(deltaTime);
+    if (input & INPUT_LEFT) character->rotateLeft(deltaTime);
+    if (input & INPUT_RIGHT) character->rotateRight(deltaTime);
+    if (input & INPUT_HEAD_UP) character->headInclination = std::min(character->headInclination + 2.0f * deltaTime, glm::pi<float>() / 4.0f);
+    if (input & INPUT_HEAD_DOWN) character->headInclination = std::max(character->headInclination - 2.0f * deltaTime, -glm::pi<float>() / 4.0f);
+    if (input & INPUT_JUMP) {
+        character->startJump(character->initialJumpSpeed); // Use character's own jump speed
+    }
+
+    // Character Specific Actions (attack for Finn, stretch/grow for Jake)
+    if (Finn* finnPtr = dynamic_cast<Finn*>(character)) {
+        if (input & INPUT_ATTACK) finnPtr->startAttack();
+    } else if (Jake* jakePtr = dynamic_cast<Jake*>(character)) {
+        if (input & INPUT_STRETCH) jakePtr->legStretch = 3.0f;
+        if (input & INPUT_GROW) jakePtr->sizeMultiplier = 2.5f;
+    }
+}
@@ -0,0 +1,309 @@
+#ifndef ADVENTURE_CHARACTERS_H
+#define ADVENTURE_CHARACTERS_H
+
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <random>
+#include <vector>
+#include "Pool.h"
+
+// Simulation side of the Adventure Time prototype (maindede.cpp): characters,
+// NPC wandering and the per-tick world update. No GL here, so benchmarks and
+// headless tools can link it on their own.
+
+// --- Constantes e Configurações ---
+const float GROUND_SIZE = 60.0f; // Make ground larger for wandering
+const float WANDER_RADIUS = GROUND_SIZE / 2.0f - 5.0f; // Max distance from center for NPCs
+const float FLYING_MIN_Y = 2.0f;
+const float FLYING_MAX_Y = 8.0f;
+
+// --- Random Number Generator ---
+// Seeded by the caller (InputStream seed) before characters are spawned
+extern std::mt19937 gen;
+extern std::uniform_real_distribution<float> distrib; // For directions
+extern std::uniform_real_distribution<float> distrib01; // For probabilities/intervals
+extern std::uniform_real_distribution<float> distribFlyY;
+extern std::uniform_real_distribution<float> distribWander;
+
+extern float simulationTime; // Simulated seconds, advanced by updateWorld (game logic never reads glfwGetTime)
+extern uint32_t simulationTick; // Ticks run by updateWorld; staggers the LOD tiers
+
+const glm::vec3 CAMERA_POSITION(0.0f, 8.0f, 35.0f); // Fixed scene camera (renderWorld); LOD focus when nobody is controlled
+
+// --- Simulation level of detail ---
+// With LOD on, characters are put in tiers by distance to the focus (the controlled character,
+// or the camera). Tier t runs update() once every TIER_INTERVALS[t] ticks with the time it
+// accumulated meanwhile, staggered by index so each tick updates a similar share. Tiers are
+// recomputed every tick, so a character that comes closer is updated on that same tick with
+// all its pending time. The controlled character and its follower always stay in tier 0.
+// Off by default (--sim-lod): then every character is updated every tick, as before.
+struct SimulationLod {
+    static const int TIER_COUNT = 3;
+    static const int TIER_INTERVALS[TIER_COUNT];
+
+    bool enabled = false;
+    float tierRadius[TIER_COUNT - 1] = { 20.0f, 40.0f }; // Tier 0 up to 20 units, tier 1 up to 40, then tier 2
+    size_t updates[TIER_COUNT] = {}; // update() calls per tier since start
+
+    int tierFor(float distanceSquared) const;
+};
+
+extern SimulationLod simulationLod;
+
+// --sim-lod [near,mid]   enable simulation LOD, optionally with the tier radii
+void parseSimulationLod(int argc, char** argv);
+
+// --- Forward Declarations of Classes ---
+class Character;
+class Finn;
+class Jake;
+class BMO;
+class IceKing;
+class PrincessBubblegum;
+class Marceline;
+
+enum CharacterType { CHARACTER_FINN, CHARACTER_JAKE, CHARACTER_BMO, CHARACTER_PB, CHARACTER_ICE_KING, CHARACTER_MARCELINE, CHARACTER_TYPE_COUNT };
+
+// Generational reference into characterPools; stays safe to hold after the character is despawned
+struct CharacterHandle {
+    CharacterType type = CHARACTER_FINN;
+    uint32_t index = Handle<Character>::INVALID_INDEX;
+    uint32_t generation = 0;
+
+    bool isValid() const { return index != Handle<Character>::INVALID_INDEX; }
+};
+
+// --- Classe base Character ---
+class Character {
+public:
+    glm::vec3 position;
+    float rotation; // Y-axis rotation (radians) for facing direction
+    float headInclination; // X-axis rotation for looking up/down (radians)
+    float speed;
+    bool isJumping;
+    float currentVerticalSpeed;
+    float gravity;
+    float groundHeight;
+    float initialJumpSpeed; // Added member to store this
+
+    float legSwingAngle;
+    float armSwingAngle;
+    bool moving; // Set by movement input or NPC logic
+
+    // NPC Specific Wander Behavior
+    glm::vec3 targetPosition;
+    float timeSinceLastDecision;
+    float decisionInterval;
+    bool isNPC = false; // Flag to distinguish NPCs
+    bool isUnderPlayerControl = false; // Flag set in main loop
+    CharacterHandle handle; // Slot in characterPools (invalid for characters built on the stack)
+    bool decisionDue = true; // Set by npcScheduler when the next wander decision may be due
+    uint32_t decisionTicket = 0; // Matches the live npcScheduler entry; older entries are ignored
+    float lodPendingTime = 0.0f; // Simulated time not yet passed to update() (simulation LOD)
+    uint8_t lodTier = 0;
+    glm::vec3 velocity = glm::vec3(0.0f);      // Last wander move (flocking alignment)
+    glm::vec3 flockSteering = glm::vec3(0.0f); // Written by flocking.update before the flyers move
+    int32_t formationGroup = -1;  // Group this character follows in (formations), -1 if none
+    uint32_t formationSlot = 0;   // Index among that group's followers
+
+    Character(glm::vec3 pos, float rot, float inc, float spd, float jumpInitialSpd, float g, float grndHeight = 0.0f, bool npc = false); // Declaration only
+
+    virtual ~Character() {}
+
+    // Update method declaration
+    virtual void update(float deltaTime);
+
+    // NPC Wander Logic declarations
+    virtual void chooseNewTarget();
+    void updateNPCWander(float deltaTime); // Implementation moved later
+
+    // Player Character Methods declarations
+    void moveForward(float deltaTime);
+    void moveBackward(float deltaTime);
+    void rotateLeft(float deltaTime);
+    void rotateRight(float deltaTime);
+    void startJump(float jumpInitialSpeed); // Implementation moved later
+    void updateJump(float deltaTime); // Implementation moved later
+    void updateLimbSwing(float deltaTime);
+};
+
+// --- Classes Jogáveis (Finn e Jake) ---
+const float JAKE_BASE_LEG_LENGTH = 0.5f;
+
+class Finn : public Character {
+public:
+    bool isAttacking;
+    float attackStartTime;
+
+    // Constructor for Finn
+    Finn(glm::vec3 pos) : Character(pos, 0.0f, 0.0f, 7.0f, 10.0f, 25.0f, 0.0f, false), // Base stats for Finn, isNPC=false
+                          isAttacking(false), attackStartTime(0.0f) {}
+
+    // Finn-specific methods declaration
+    void startAttack();
+    void update(float deltaTime) override; // Override necessary
+};
+
+class Jake : public Character {
+public:
+    float legStretch;
+    float sizeMultiplier;
+
+    Jake(glm::vec3 pos) : Character(pos, 0.0f, 0.0f, 6.0f, 9.0f, 28.0f, 0.0f, false), // Base stats for Jake, isNPC=false
+                          legStretch(1.0f), sizeMultiplier(1.0f) {}
+
+    float getStretchHeightOffset() const;
+    float getEffectiveGroundHeight() const;
+    void update(float deltaTime) override; // Override necessary
+};
+
+// --- Classes NPC ---
+
+class BMO : public Character {
+public:
+    BMO(glm::vec3 pos) : Character(pos, 0.0f, 0.0f, 2.5f, 0.0f, 9.8f, 0.0f, true) {} // Slower speed, NPC=true
+
+    void chooseNewTarget() override;
+    void update(float deltaTime) override;
+};
+
+class PrincessBubblegum : public Character {
+public:
+    PrincessBubblegum(glm::vec3 pos) : Character(pos, 0.0f, 0.0f, 3.0f, 0.0f, 9.8f, 0.0f, true) {} // NPC=true
+
+    void chooseNewTarget() override;
+    void update(float deltaTime) override;
+};
+
+class IceKing : public Character {
+public:
+    IceKing(glm::vec3 pos) : Character(pos, 0.0f, 0.0f, 3.5f, 0.0f, 0.0f, 0.0f, true) { // NPC=true, No gravity needed
+        position.y = distribFlyY(gen); // Start flying
+        chooseNewTarget(); // Set initial flying target
+    }
+
+    void chooseNewTarget() override;
+    // Inherits Character::update, which calls updateNPCWander if not player-controlled
+};
+
+class Marceline : public Character {
+public:
+    Marceline(glm::vec3 pos) : Character(pos, 0.0f, 0.0f, 4.0f, 0.0f, 0.0f, 0.0f, true) { // NPC=true, Faster flyer, No gravity
+        position.y = distribFlyY(gen); // Start flying
+        chooseNewTarget(); // Set initial flying target
+    }
+     void chooseNewTarget() override;
+     // Inherits Character::update, which calls updateNPCWander if not player-controlled
+};
+
+// --- Character storage ---
+// One slab pool per type, so characters of the same type sit next to each other in memory.
+// Spawning and despawning are O(1) and reuse freed slots; the heap is only touched when a
+// pool runs out of slabs, so reserve() the expected counts before gameplay starts.
+class CharacterPools {
+public:
+    void reserve(CharacterType type, size_t count);
+    Character* spawn(CharacterType type, glm::vec3 pos);
+    void despawn(Character* character); // Ignores characters that are not (or no longer) pooled
+    Character* get(CharacterHandle handle) const; // nullptr once the character is gone
+    void clear();
+
+    size_t size() const;
+    size_t slabCount() const;
+    size_t memoryBytes() const; // Bytes held by the slabs, live or free
+
+private:
+    Pool<Finn> finns;
+    Pool<Jake> jakes;
+    Pool<BMO> bmos;
+    Pool<PrincessBubblegum> bubblegums;
+    Pool<IceKing> iceKings;
+    Pool<Marceline> marcelines;
+};
+
+extern CharacterPools characterPools;
+
+// Type of a character: its pool handle when pooled, dynamic_cast otherwise
+CharacterType characterType(const Character* character);
+// IceKing and Marceline
+bool isFlyer(const Character* character);
+
+// --- NPC decision scheduler ---
+// NPCs pick a new wander target when their decision interval runs out or when they get within
+// 1 unit of the target. Instead of every NPC testing that each tick, each one gets a deadline
+// in a min-heap: the earlier of the interval end and the predicted arrival (straight line at
+// 'speed'), moved one tick earlier so it is never late. updateWorld wakes only the NPCs whose
+// deadline has passed; they run the exact test and are rescheduled. Entries of despawned or
+// rescheduled NPCs are dropped when they reach the top.
+class NpcScheduler {
+public:
+    struct Stats {
+        size_t wakeups = 0;   // NPCs woken to run the decision test
+        size_t decisions = 0; // Tests that picked a new target
+    };
+
+    void scheduleNow(Character* character);
+    // Called after the decision test; deltaTime is the tick that just ran
+    void schedule(Character* character, float deltaTime);
+    // Flags every NPC whose deadline is <= now
+    void wakeDue(float now);
+    void clear();
+
+    size_t pending() const { return heap.size(); }
+    Stats stats;
+
+private:
+    struct Entry {
+        float deadline;
+        uint32_t ticket;
+        Character* character;
+        CharacterHandle handle;
+
+        bool operator>(const Entry& other) const { return deadline > other.deadline; }
+    };
+
+    void push(Character* character, float deadline);
+
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> heap;
+};
+
+extern NpcScheduler npcScheduler;
+
+// Despawns every character in the list and clears it
+void despawnCharacters(std::vector<Character*>& characters);
+
+// --- Cena ---
+// Finn (0), Jake (1), then the NPCs
+void spawnCharacters(std::vector<Character*>& allCharacters);
+// Formation group of the Finn/Jake party kept by updateWorld, -1 (or inactive) when there is none
+extern int partyGroup;
+// Advances simulationTime, updates every character, then moves the formation followers
+// (Finn and Jake: the controlled one leads, the other trails behind)
+void updateWorld(std::vector<Character*>& allCharacters, int activeCharacterIndex, float deltaTime);
+// Same with several controlled characters (one per player). Finn and Jake only form the party
+// when exactly one of them is controlled; the LOD focus is the first controlled character.
+void updateWorld(std::vector<Character*>& allCharacters, const int* controlledIndices, size_t controlledCount, float deltaTime);
+
+// --- Player input ---
+// One tick of input for one controlled character, a bit per action (the keys processInput reads)
+typedef uint16_t PlayerInput;
+enum PlayerInputBit : PlayerInput {
+    INPUT_FORWARD   = 1 << 0,  // W
+    INPUT_BACKWARD  = 1 << 1,  // S
+    INPUT_LEFT      = 1 << 2,  // A
+    INPUT_RIGHT     = 1 << 3,  // D
+    INPUT_HEAD_UP   = 1 << 4,  // Up
+    INPUT_HEAD_DOWN = 1 << 5,  // Down
+    INPUT_JUMP      = 1 << 6,  // Space
+    INPUT_ATTACK    = 1 << 7,  // E (Finn)
+    INPUT_STRETCH   = 1 << 8,  // P (Jake)
+    INPUT_GROW      = 1 << 9   // O (Jake)
+};
+
+// Moves/rotates/jumps 'character' and runs its specific actions; call before updateWorld
+void applyPlayerInput(Character* character, PlayerInput input, float deltaTime);
+
+#endif // ADVENTURE_CHARACTERS_H
@@ -0,0 +1,584 @@
+#include "AdventureDraw.h"
+#include "FrameArena.h"
+#include "Navigation.h"
+#include "OcclusionCulling.h"
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/constants.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+Mesh cubeMesh;
+Mesh pyramidMesh;
+Mesh coneMesh;
+Renderer* activeRenderer = nullptr;
+std::vector<TownBlock> townBlocks;
+OcclusionCuller* occlusionCuller = nullptr;
+
+// --- Implementações das Funções de Desenho (Colocadas aqui, após classes) ---
+
+void drawFinn(Finn* finn, const glm::mat4& view, const glm::mat4& projection) {
+    glm::mat4 finnModel = glm::mat4(1.0f);
+    finnModel = glm::translate(finnModel, finn->position);
+    finnModel = glm::rotate(finnModel, finn->rotation, glm::vec3(0.0f, 1.0f, 0.0f));
+
+    // Torso (Shirt)
+    glm::mat4 torsoModel = glm::translate(finnModel, glm::vec3(0.0f, 0.6f, 0.0f));
+    torsoModel = glm::scale(torsoModel, glm::vec3(0.5f, 0.7f, 0.3f));
+    drawShape(cubeMesh, torsoModel, COLOR_FINN_SHIRT);
+
+    // Head
+    glm::mat4 headModel = glm::translate(finnModel, glm::vec3(0.0f, 1.2f, 0.0f));
+    headModel = glm::rotate(headModel, finn->headInclination, glm::vec3(1.0f, 0.0f, 0.0f));
+    headModel = glm::scale(headModel, glm::vec3(0.4f, 0.4f, 0.4f));
+    drawShape(cubeMesh, headModel, COLOR_FINN_SKIN);
+
+    // Hat Base (on head)
+    glm::mat4 hatBaseModel = glm::translate(headModel, glm::vec3(0.0f, 0.1f, 0.0f)); // Slight offset from head center
+    hatBaseModel = glm::scale(hatBaseModel, glm::vec3(1.1f, 1.0f, 1.1f)); // Slightly larger than head scale
+    drawShape(cubeMesh, hatBaseModel, COLOR_FINN_HAT);
+
+    // Hat Ears (relative to hat base)
+    glm::mat4 earLModel = glm::translate(hatBaseModel, glm::vec3(-0.4f, 0.6f, 0.0f));
+    earLModel = glm::scale(earLModel, glm::vec3(0.2f, 0.4f, 0.2f));
+    drawShape(cubeMesh, earLModel, COLOR_FINN_HAT);
+    glm::mat4 earRModel = glm::translate(hatBaseModel, glm::vec3(0.4f, 0.6f, 0.0f));
+    earRModel = glm::scale(earRModel, glm::vec3(0.2f, 0.4f, 0.2f));
+    drawShape(cubeMesh, earRModel, COLOR_FINN_HAT);
+
+
+    // Legs (Pants) - Apply swing
+    glm::mat4 legLModel = glm::translate(finnModel, glm::vec3(-0.15f, 0.0f, 0.0f)); // Initial pos
+    legLModel = glm::translate(legLModel, glm::vec3(0.0f, 0.15f, 0.0f)); // Move pivot up
+    legLModel = glm::rotate(legLModel, finn->legSwingAngle, glm::vec3(1.0f, 0.0f, 0.0f)); // Rotate
+    legLModel = glm::translate(legLModel, glm::vec3(0.0f, -0.15f, 0.0f)); // Move back down
+    legLModel = glm::scale(legLModel, glm::vec3(0.2f, 0.5f, 0.2f));
+    drawShape(cubeMesh, legLModel, COLOR_FINN_PANTS);
+
+    glm::mat4 legRModel = glm::translate(finnModel, glm::vec3(0.15f, 0.0f, 0.0f)); // Initial pos
+    legRModel = glm::translate(legRModel, glm::vec3(0.0f, 0.15f, 0.0f)); // Pivot
+    legRModel = glm::rotate(legRModel, -finn->legSwingAngle, glm::vec3(1.0f, 0.0f, 0.0f)); // Rotate opposite
+    legRModel = glm::translate(legRModel, glm::vec3(0.0f, -0.15f, 0.0f)); // Move back down
+    legRModel = glm::scale(legRModel, glm::vec3(0.2f, 0.5f, 0.2f));
+    drawShape(cubeMesh, legRModel, COLOR_FINN_PANTS);
+
+    // Arms (Shirt color) - Apply swing
+    glm::mat4 armLModel = glm::translate(finnModel, glm::vec3(-0.35f, 0.9f, 0.0f)); // Initial pos at shoulder
+    armLModel = glm::rotate(armLModel, finn->armSwingAngle, glm::vec3(1.0f, 0.0f, 0.0f)); // Rotate from shoulder
+    armLModel = glm::translate(armLModel, glm::vec3(0.0f, -0.3f, 0.0f)); // Move down to arm center
+    armLModel = glm::scale(armLModel, glm::vec3(0.15f, 0.6f, 0.15f));
+    drawShape(cubeMesh, armLModel, COLOR_FINN_SHIRT); // Shirt sleeve
+
+    glm::mat4 armRModel = glm::translate(finnModel, glm::vec3(0.35f, 0.9f, 0.0f)); // Shoulder
+    // Attack animation for right arm
+    float rightArmAngle = -finn->armSwingAngle; // Default opposite swing
+    if(finn->isAttacking){
+         float attackProgress = simulationTime - finn->attackStartTime;
+         rightArmAngle = glm::radians(-90.0f + sin(attackProgress / 0.3f * glm::pi<float>()) * 90.0f); // Simple swing forward
+    }
+    armRModel = glm::rotate(armRModel, rightArmAngle, glm::vec3(1.0f, 0.0f, 0.0f)); // Rotate
+    armRModel = glm::translate(armRModel, glm::vec3(0.0f, -0.3f, 0.0f)); // Center
+    armRModel = glm::scale(armRModel, glm::vec3(0.15f, 0.6f, 0.15f));
+    drawShape(cubeMesh, armRModel, COLOR_FINN_SHIRT);
+
+    // Backpack
+    glm::mat4 packModel = glm::translate(finnModel, glm::vec3(0.0f, 0.6f, -0.2f));
+    packModel = glm::scale(packModel, glm::vec3(0.4f, 0.5f, 0.2f));
+    drawShape(cubeMesh, packModel, COLOR_FINN_BACKPACK);
+
+     // Sword (only when attacking)
+    if (finn->isAttacking) {
+        // Attach sword to the rotated right arm model
+        glm::mat4 swordModel = armRModel; // Start with the final arm model matrix
+        swordModel = glm::translate(swordModel, glm::vec3(0.0f, -0.7f, 0.1f)); // Position relative to arm center (down and slightly forward)
+        swordModel = glm::scale(swordModel, glm::vec3(0.1f / 0.15f, 1.0f / 0.6f, 0.5f / 0.15f)); // Counter-act arm scale, make blade long
+        swordModel = glm::scale(swordModel, glm::vec3(0.1f, 1.0f, 0.05f)); // Actual sword dimensions
+        drawShape(cubeMesh, swordModel, COLOR_SWORD_GREY);
+    }
+}
+
+void drawJake(Jake* jake, const glm::mat4& view, const glm::mat4& projection) {
+    // Base model incorporates position, rotation, and overall size multiplier
+    glm::mat4 jakeModelBase = glm::mat4(1.0f);
+    // Adjust base position by stretch offset so feet stay grounded when stretching
+    glm::vec3 basePos = jake->position - glm::vec3(0.0f, jake->getStretchHeightOffset(), 0.0f);
+    jakeModelBase = glm::translate(jakeModelBase, basePos);
+    jakeModelBase = glm::rotate(jakeModelBase, jake->rotation, glm::vec3(0.0f, 1.0f, 0.0f));
+    jakeModelBase = glm::scale(jakeModelBase, glm::vec3(jake->sizeMultiplier)); // Apply overall size
+
+
+    // Body (main part) - Scale Y by legStretch
+    glm::mat4 bodyModel = jakeModelBase;
+    float bodyCenterY = 0.5f * JAKE_BASE_LEG_LENGTH * jake->legStretch + 0.35f; // Center calculation based on stretched legs
+    bodyModel = glm::translate(bodyModel, glm::vec3(0.0f, bodyCenterY , 0.0f));
+    bodyModel = glm::scale(bodyModel, glm::vec3(0.8f, 0.7f * jake->legStretch, 0.6f)); // Stretch body vertically too
+    drawShape(cubeMesh, bodyModel, COLOR_JAKE_BODY);
+
+    // Head (Positioned relative to top of stretched body)
+    glm::mat4 headModel = jakeModelBase;
+     // Calculate top of the body including stretch
+    float bodyTopY = JAKE_BASE_LEG_LENGTH * jake->legStretch + 0.7f; // Approx top of stretched body block
+    headModel = glm::translate(headModel, glm::vec3(0.0f, bodyTopY + 0.25f, 0.1f)); // Position head above stretched body
+    headModel = glm::rotate(headModel, jake->headInclination, glm::vec3(1.0f, 0.0f, 0.0f));
+    headModel = glm::scale(headModel, glm::vec3(0.5f, 0.5f, 0.5f));
+    drawShape(cubeMesh, headModel, COLOR_JAKE_BODY);
+
+    // Legs - Scale Y by legStretch, apply swing
+    float legCenterY = 0.5f * JAKE_BASE_LEG_LENGTH * jake->legStretch; // Y center of stretched leg
+    float legPivotY = JAKE_BASE_LEG_LENGTH * jake->legStretch; // Pivot point at top of leg
+
+    glm::mat4 legLModel = jakeModelBase;
+    legLModel = glm::translate(legLModel, glm::vec3(-0.2f, 0.0f, 0.0f)); // Base position
+    legLModel = glm::translate(legLModel, glm::vec3(0.0f, legPivotY, 0.0f)); // Move to pivot
+    legLModel = glm::rotate(legLModel, jake->legSwingAngle, glm::vec3(1.0f, 0.0f, 0.0f)); // Rotate
+    legLModel = glm::translate(legLModel, glm::vec3(0.0f, -legCenterY, 0.0f)); // Move origin to center of stretched leg
+    legLModel = glm::scale(legLModel, glm::vec3(0.3f, JAKE_BASE_LEG_LENGTH * jake->legStretch, 0.3f)); // Scale stretched leg
+    drawShape(cubeMesh, legLModel, COLOR_JAKE_BODY);
+
+    glm::mat4 legRModel = jakeModelBase;
+    legRModel = glm::translate(legRModel, glm::vec3(0.2f, 0.0f, 0.0f)); // Base position
+    legRModel = glm::translate(legRModel, glm::vec3(0.0f, legPivotY, 0.0f)); // Move to pivot
+    legRModel = glm::rotate(legRModel, -jake->legSwingAngle, glm::vec3(1.0f, 0.0f, 0.0f)); // Rotate opposite
+    legRModel = glm::translate(legRModel, glm::vec3(0.0f, -legCenterY, 0.0f)); // Move origin to center
+    legRModel = glm::scale(legRModel, glm::vec3(0.3f, JAKE_BASE_LEG_LENGTH * jake->legStretch, 0.3f)); // Scale stretched leg
+    drawShape(cubeMesh, legRModel, COLOR_JAKE_BODY);
+
+    // Arms - Position relative to stretched body, apply swing
+    float armAttachY = legPivotY + 0.3f; // Attach point slightly above leg tops
+    float armCenterOffsetY = -0.3f; // Offset from attach point to arm center
+
+    glm::mat4 armLModel = jakeModelBase;
+    armLModel = glm::translate(armLModel, glm::vec3(-0.5f, armAttachY, 0.0f)); // Attach point
+    armLModel = glm::rotate(armLModel, jake->armSwingAngle, glm::vec3(1.0f, 0.0f, 0.0f)); // Rotate
+    armLModel = glm::translate(armLModel, glm::vec3(0.0f, armCenterOffsetY, 0.0f)); // Move origin to center
+    armLModel = glm::scale(armLModel, glm::vec3(0.2f, 0.6f, 0.2f)); // Scale arm
+    drawShape(cubeMesh, armLModel, COLOR_JAKE_BODY);
+
+    glm::mat4 armRModel = jakeModelBase;
+    armRModel = glm::translate(armRModel, glm::vec3(0.5f, armAttachY, 0.0f)); // Attach point
+    armRModel = glm::rotate(armRModel, -jake->armSwingAngle, glm::vec3(1.0f, 0.0f, 0.0f)); // Rotate opposite
+    armRModel = glm::translate(armRModel, glm::vec3(0.0f, armCenterOffsetY, 0.0f)); // Move origin to center
+    armRModel = glm::scale(armRModel, glm::vec3(0.2f, 0.6f, 0.2f)); // Scale arm
+    drawShape(cubeMesh, armRModel, COLOR_JAKE_BODY);
+}
+
+void drawBMO(BMO* bmo, const glm::mat4& view, const glm::mat4& projection) {
+    glm::mat4 bmoModel = glm::mat4(1.0f);
+    // BMO's origin should be at its base for ground placement
+    bmoModel = glm::translate(bmoModel, bmo->position + glm::vec3(0.0f, 0.4f, 0.0f)); // Center Y relative to base
+    bmoModel = glm::rotate(bmoModel, bmo->rotation, glm::vec3(0.0f, 1.0f, 0.0f));
+
+    // Main Body (Scale relative to the centered origin)
+    glm::mat4 bodyActual = glm::scale(bmoModel, glm::vec3(0.6f, 0.8f, 0.3f));
+    drawShape(cubeMesh, bodyActual, COLOR_BMO_BODY);
+
+    // Screen (relative to the MAIN body's model matrix 'bodyActual')
+    glm::mat4 screenModel = glm::translate(bodyActual, glm::vec3(0.0f, 0.1f, 0.51f)); // Move forward from body center
+    screenModel = glm::scale(screenModel, glm::vec3(0.7f, 0.6f, 0.05f)); // Scale relative to body scale
+    drawShape(cubeMesh, screenModel, COLOR_BMO_SCREEN);
+
+    // Buttons (relative to the MAIN body's model matrix 'bodyActual')
+    float btnRelSize = 0.15f; // Size relative to body's dimensions
+    glm::mat4 btnRedModel = glm::translate(bodyActual, glm::vec3(0.35f, -0.3f, 0.51f));
+    btnRedModel = glm::scale(btnRedModel, glm::vec3(btnRelSize, btnRelSize, 0.1f));
+    drawShape(cubeMesh, btnRedModel, COLOR_BMO_BUTTON_RED);
+
+    glm::mat4 btnBlueModel = glm::translate(bodyActual, glm::vec3(-0.35f, -0.15f, 0.51f));
+    btnBlueModel = glm::scale(btnBlueModel, glm::vec3(btnRelSize * 1.5f, btnRelSize, 0.1f)); // D-pad shape
+    drawShape(cubeMesh, btnBlueModel, COLOR_BMO_BUTTON_BLUE);
+
+    glm::mat4 btnYlwModel = glm::translate(bodyActual, glm::vec3(-0.30f, -0.35f, 0.51f)); // Position adjusted
+    btnYlwModel = glm::scale(btnYlwModel, glm::vec3(btnRelSize*0.8f, btnRelSize*0.8f, 0.1f));
+    drawShape(cubeMesh, btnYlwModel, COLOR_BMO_BUTTON_YELLOW);
+}
+
+void drawIceKing(IceKing* ik, const glm::mat4& view, const glm::mat4& projection) {
+    glm::mat4 ikModel = glm::mat4(1.0f);
+    // Position origin near base for easier height management when flying
+    ikModel = glm::translate(ikModel, ik->position + glm::vec3(0.0f, 0.75f, 0.0f)); // Mid-body Y approx
+    ikModel = glm::rotate(ikModel, ik->rotation, glm::vec3(0.0f, 1.0f, 0.0f));
+
+    // Body (Robe)
+    glm::mat4 bodyModel = glm::translate(ikModel, glm::vec3(0.0f, 0.0f, 0.0f)); // Centered at origin
+    bodyModel = glm::scale(bodyModel, glm::vec3(0.8f, 1.5f, 0.8f));
+    drawShape(cubeMesh, bodyModel, COLOR_ICE_KING_BODY);
+
+    // Head (placeholder, mostly covered) - relative to ikModel origin
+    glm::mat4 headModel = glm::translate(ikModel, glm::vec3(0.0f, 1.1f, 0.0f)); // Above body center
+    headModel = glm::scale(headModel, glm::vec3(0.5f, 0.5f, 0.5f));
+    drawShape(cubeMesh, headModel, COLOR_ICE_KING_BODY); // Use body color
+
+    // Beard (Multiple parts for shape) - relative to ikModel origin
+    glm::mat4 beard1 = glm::translate(ikModel, glm::vec3(0.0f, 0.6f, 0.3f)); // Front main, below head
+    beard1 = glm::scale(beard1, glm::vec3(0.9f, 1.2f, 0.4f));
+    drawShape(cubeMesh, beard1, COLOR_ICE_KING_BEARD);
+    glm::mat4 beard2 = glm::translate(ikModel, glm::vec3(0.0f, 0.1f, 0.4f)); // Lower front, extending down
+    beard2 = glm::scale(beard2, glm::vec3(0.6f, 0.6f, 0.3f));
+    drawShape(cubeMesh, beard2, COLOR_ICE_KING_BEARD);
+
+    // Nose - relative to ikModel origin
+    glm::mat4 noseModel = glm::translate(ikModel, glm::vec3(0.0f, 1.0f, 0.2f)); // Positioned near head center Z
+    noseModel = glm::rotate(noseModel, glm::radians(15.0f), glm::vec3(1.0f, 0.0f, 0.0f)); // Slight downward tilt
+    noseModel = glm::translate(noseModel, glm::vec3(0.0f, 0.0f, 0.3f)); // Move tip forward
+    noseModel = glm::scale(noseModel, glm::vec3(0.1f, 0.1f, 0.6f)); // Long and thin Z
+    drawShape(cubeMesh, noseModel, COLOR_ICE_KING_BODY); // Skin color
+
+    // Crown Base - relative to ikModel origin
+    glm::mat4 crownBase = glm::translate(ikModel, glm::vec3(0.0f, 1.4f, 0.0f)); // Above head
+    crownBase = glm::scale(crownBase, glm::vec3(0.6f, 0.2f, 0.6f));
+    drawShape(cubeMesh, crownBase, COLOR_ICE_KING_CROWN);
+
+    // Crown Gems - relative to crownBase position
+    float gemSize = 0.1f;
+    glm::mat4 gem1 = glm::translate(ikModel, glm::vec3(0.0f, 1.55f, 0.28f)); // Front Center, slightly higher than base top
+    gem1 = glm::scale(gem1, glm::vec3(gemSize));
+    drawShape(cubeMesh, gem1, COLOR_ICE_KING_GEM);
+    glm::mat4 gem2 = glm::translate(ikModel, glm::vec3(0.28f, 1.55f, 0.0f)); // Right Center
+    gem2 = glm::scale(gem2, glm::vec3(gemSize));
+    drawShape(cubeMesh, gem2, COLOR_ICE_KING_GEM);
+    glm::mat4 gem3 = glm::translate(ikModel, glm::vec3(-0.28f, 1.55f, 0.0f)); // Left Center
+    gem3 = glm::scale(gem3, glm::vec3(gemSize));
+    drawShape(cubeMesh, gem3, COLOR_ICE_KING_GEM);
+}
+
+void drawPB(PrincessBubblegum* pb, const glm::mat4& view, const glm::mat4& projection) {
+    glm::mat4 pbModel = glm::mat4(1.0f);
+    // Position origin at base
+    pbModel = glm::translate(pbModel, pb->position);
+    pbModel = glm::rotate(pbModel, pb->rotation, glm::vec3(0.0f, 1.0f, 0.0f));
+
+    // Dress (Main Body) - Origin at base center
+    glm::mat4 dressModel = glm::translate(pbModel, glm::vec3(0.0f, 0.9f, 0.0f)); // Center Y of dress block
+    dressModel = glm::scale(dressModel, glm::vec3(0.6f, 1.8f, 0.6f));
+    drawShape(cubeMesh, dressModel, COLOR_PB_DRESS);
+
+    // Head - relative to pbModel origin
+    glm::mat4 headModel = glm::translate(pbModel, glm::vec3(0.0f, 2.0f, 0.0f)); // Positioned above dress top
+    headModel = glm::scale(headModel, glm::vec3(0.5f, 0.5f, 0.5f));
+    drawShape(cubeMesh, headModel, COLOR_PB_SKIN);
+
+    // Hair (Simplified - blocks relative to head position)
+    glm::mat4 hairBack = glm::translate(pbModel, glm::vec3(0.0f, 1.8f, -0.3f)); // Behind head, lower part
+    hairBack = glm::scale(hairBack, glm::vec3(0.6f, 1.0f, 0.2f)); // Tall block down
+    drawShape(cubeMesh, hairBack, COLOR_PB_HAIR);
+    glm::mat4 hairTop = glm::translate(pbModel, glm::vec3(0.0f, 2.1f, -0.1f)); // Top/frontish hair mass
+    hairTop = glm::scale(hairTop, glm::vec3(0.6f, 0.4f, 0.6f));
+    drawShape(cubeMesh, hairTop, COLOR_PB_HAIR);
+
+    // Crown - relative to pbModel origin
+    glm::mat4 crownBase = glm::translate(pbModel, glm::vec3(0.0f, 2.3f, 0.0f)); // Above head
+    crownBase = glm::scale(crownBase, glm::vec3(0.3f, 0.1f, 0.3f)); // Smaller crown
+    drawShape(cubeMesh, crownBase, COLOR_PB_CROWN);
+    // Crown Gem - relative to crown position
+    glm::mat4 gem = glm::translate(pbModel, glm::vec3(0.0f, 2.38f, 0.14f)); // Single front gem, slightly above base top
+    gem = glm::scale(gem, glm::vec3(0.08f));
+    drawShape(cubeMesh, gem, COLOR_PB_GEM);
+
+    // Simple Arms (Optional) - relative to pbModel origin
+    glm::mat4 armL = glm::translate(pbModel, glm::vec3(-0.4f, 1.4f, 0.0f)); // Shoulder height approx
+    armL = glm::translate(armL, glm::vec3(0.0f, -0.4f, 0.0f)); // Center of arm
+    armL = glm::scale(armL, glm::vec3(0.15f, 0.8f, 0.15f));
+    drawShape(cubeMesh, armL, COLOR_PB_SKIN);
+    glm::mat4 armR = glm::translate(pbModel, glm::vec3(0.4f, 1.4f, 0.0f)); // Shoulder
+    armR = glm::translate(armR, glm::vec3(0.0f, -0.4f, 0.0f)); // Center
+    armR = glm::scale(armR, glm::vec3(0.15f, 0.8f, 0.15f));
+    drawShape(cubeMesh, armR, COLOR_PB_SKIN);
+}
+
+
+void drawMarceline(Marceline* marcy, const glm::mat4& view, const glm::mat4& projection) {
+    glm::mat4 marcyModel = glm::mat4(1.0f);
+    // Position origin at base/feet
+    marcyModel = glm::translate(marcyModel, marcy->position);
+    marcyModel = glm::rotate(marcyModel, marcy->rotation, glm::vec3(0.0f, 1.0f, 0.0f));
+
+    // Legs/Pants - Origin at center base
+    glm::mat4 legL = glm::translate(marcyModel, glm::vec3(-0.15f, 0.5f, 0.0f)); // Center Y of leg block
+    legL = glm::scale(legL, glm::vec3(0.2f, 1.0f, 0.2f));
+    drawShape(cubeMesh, legL, COLOR_MARCELINE_PANTS);
+    glm::mat4 legR = glm::translate(marcyModel, glm::vec3(0.15f, 0.5f, 0.0f)); // Center Y
+    legR = glm::scale(legR, glm::vec3(0.2f, 1.0f, 0.2f));
+    drawShape(cubeMesh, legR, COLOR_MARCELINE_PANTS);
+
+    // Body (Shirt) - Above legs
+    glm::mat4 bodyModel = glm::translate(marcyModel, glm::vec3(0.0f, 1.4f, 0.0f)); // Center Y of body block
+    bodyModel = glm::scale(bodyModel, glm::vec3(0.5f, 0.8f, 0.3f));
+    drawShape(cubeMesh, bodyModel, COLOR_MARCELINE_SHIRT);
+
+    // Head - Above body
+    glm::mat4 headModel = glm::translate(marcyModel, glm::vec3(0.0f, 2.0f, 0.0f)); // Center Y of head
+    headModel = glm::scale(headModel, glm::vec3(0.5f, 0.5f, 0.5f));
+    drawShape(cubeMesh, headModel, COLOR_MARCELINE_SKIN);
+
+    // Hair (Very Long - multiple blocks relative to marcyModel origin)
+    glm::mat4 hair1 = glm::translate(marcyModel, glm::vec3(0.0f, 1.2f, -0.2f)); // Back, covering body/head transition
+    hair1 = glm::scale(hair1, glm::vec3(0.6f, 2.0f, 0.3f)); // Long block
+    drawShape(cubeMesh, hair1, COLOR_MARCELINE_HAIR);
+    glm::mat4 hair2 = glm::translate(marcyModel, glm::vec3(0.0f, 0.0f, -0.3f)); // Lower back, near ground
+    hair2 = glm::scale(hair2, glm::vec3(0.5f, 1.0f, 0.3f));
+    drawShape(cubeMesh, hair2, COLOR_MARCELINE_HAIR);
+
+    // Simple Arms - Relative to marcyModel origin
+    glm::mat4 armL = glm::translate(marcyModel, glm::vec3(-0.4f, 1.4f, 0.0f)); // Shoulder height
+    armL = glm::translate(armL, glm::vec3(0.0f, -0.4f, 0.0f)); // Center arm
+    armL = glm::scale(armL, glm::vec3(0.15f, 0.8f, 0.15f));
+    drawShape(cubeMesh, armL, COLOR_MARCELINE_SKIN);
+    glm::mat4 armR = glm::translate(marcyModel, glm::vec3(0.4f, 1.4f, 0.0f)); // Shoulder height
+    armR = glm::translate(armR, glm::vec3(0.0f, -0.4f, 0.0f)); // Center arm
+    armR = glm::scale(armR, glm::vec3(0.15f, 0.8f, 0.15f));
+    drawShape(cubeMesh, armR, COLOR_MARCELINE_SKIN);
+
+    // Bass Guitar (Optional - simple representation)
+    // glm::mat4 bassBody = glm::translate(marcyModel, glm::vec3(-0.3f, 1.0f, 0.3f)); // Held position ~waist height
+    // bassBody = glm::rotate(bassBody, glm::radians(20.0f), glm::vec3(0.0f, 0.0f, 1.0f)); // Angle across body
+    // bassBody = glm::rotate(bassBody, glm::radians(-15.0f), glm::vec3(0.0f, 1.0f, 0.0f)); // Slight angle out
+    // bassBody = glm::scale(bassBody, glm::vec3(0.4f, 1.0f, 0.1f)); // Axe shape?
+    // drawShape(cubeMesh, bassBody, COLOR_MARCELINE_BASS);
+    // glm::mat4 bassNeck = glm::translate(bassBody, glm::vec3(0.0f, 0.8f, 0.0f)); // Extend neck from body center upwards
+    // bassNeck = glm::scale(bassNeck, glm::vec3(0.1f/0.4f, 1.0f/1.0f, 0.1f/0.1f)); // Counter-act body scale
+    // bassNeck = glm::scale(bassNeck, glm::vec3(0.08f, 1.2f, 0.08f)); // Actual neck dimensions
+    // drawShape(cubeMesh, bassNeck, COLOR_SWORD_GREY); // Neck color
+}
+
+
+void beginWorldFrame(Renderer& renderer, float coneScaleFactor, float aspect, glm::mat4& view, glm::mat4& projection) {
+    // Matrizes View/Projection (Camera adjusted slightly)
+    projection = glm::perspective(glm::radians(45.0f), aspect, 0.1f, 150.0f); // Increased far plane
+    glm::vec3 cameraPos = CAMERA_POSITION; // Pulled back further, slightly higher
+    glm::vec3 cameraTarget = glm::vec3(0.0f, 2.0f, 0.0f); // Look slightly lower
+    // Simple camera orbit around target (optional)
+    // float camX = sin(simulationTime * 0.1f) * 35.0f;
+    // float camZ = cos(simulationTime * 0.1f) * 35.0f;
+    // cameraPos = glm::vec3(camX, 8.0f, camZ);
+    view = glm::lookAt(cameraPos, cameraTarget, glm::vec3(0.0f, 1.0f, 0.0f));
+
+    renderer.beginFrame(view, projection, COLOR_SKY_BLUE);
+    activeRenderer = &renderer;
+
+    // --- Desenhar Objetos ---
+    // Chão (Larger)
+    glm::mat4 groundModel = glm::mat4(1.0f);
+    groundModel = glm::translate(groundModel, glm::vec3(0.0f, -0.5f, 0.0f));
+    groundModel = glm::scale(groundModel, glm::vec3(GROUND_SIZE, 1.0f, GROUND_SIZE));
+    drawShape(cubeMesh, groundModel, COLOR_GRASS_GREEN);
+
+    // Other scene objects (obstacles for the walkers with --nav, so they are drawn then)
+    glm::vec3 pyramidPos = PYRAMID_POSITION;
+    glm::vec3 conePos = CONE_POSITION;
+
+    // Pirâmide (Optional)
+    glm::mat4 pyramidModel = glm::mat4(1.0f);
+    pyramidModel = glm::translate(pyramidModel, glm::vec3(pyramidPos.x, pyramidPos.y + 1.0f, pyramidPos.z)); // Adjusted base Y
+    pyramidModel = glm::scale(pyramidModel, glm::vec3(2.0f, 2.0f, 2.0f));
+    if (navigation.enabled) drawShape(pyramidMesh, pyramidModel, glm::vec3(0.8f, 0.2f, 0.5f)); // Example color
+
+    // Cone (Optional)
+    glm::mat4 coneModel = glm::mat4(1.0f);
+    coneModel = glm::translate(coneModel, glm::vec3(conePos.x, conePos.y + (coneScaleFactor * 1.5f)/2.0f - 0.5f, conePos.z)); // Adjusted base Y
+    coneModel = glm::rotate(coneModel, simulationTime * glm::radians(30.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    coneModel = glm::scale(coneModel, glm::vec3(coneScaleFactor, coneScaleFactor * 1.5f, coneScaleFactor));
+    if (navigation.enabled) drawShape(coneMesh, coneModel, glm::vec3(0.5f, 0.2f, 0.8f)); // Example color
+
+    // Town houses; only the wall boxes go to the occlusion buffer (the roofs are thin at the edges)
+    if (occlusionCuller) occlusionCuller->beginFrame(view, projection);
+    for (const TownBlock& block : townBlocks) {
+        glm::mat4 wallModel = glm::translate(glm::mat4(1.0f), block.center);
+        wallModel = glm::scale(wallModel, block.size);
+        drawShape(cubeMesh, wallModel, COLOR_HOUSE_WALL);
+        glm::mat4 roofModel = glm::translate(glm::mat4(1.0f), block.center + glm::vec3(0.0f, block.size.y * 0.5f + 0.75f, 0.0f));
+        roofModel = glm::scale(roofModel, glm::vec3(block.size.x * 1.1f, 1.5f, block.size.z * 1.1f));
+        drawShape(pyramidMesh, roofModel, COLOR_HOUSE_ROOF);
+        if (occlusionCuller) occlusionCuller->addOccluder(cubeMesh, wallModel);
+    }
+    if (occlusionCuller) occlusionCuller->finishOccluders();
+}
+
+void parseTownOptions(int argc, char** argv) {
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--town") == 0 && i + 1 < argc) buildTown(std::max(0, std::atoi(argv[++i])));
+    }
+}
+
+void buildTown(int houses) {
+    if (houses == 0 || !townBlocks.empty()) return;
+
+    // Lots 8 units apart; the four around the origin are the plaza where Finn and Jake start,
+    // and the lots next to the pyramid and the cone stay empty
+    struct Lot { glm::vec3 center; float distance; };
+    std::vector<Lot> lots;
+    const float LOT_COORDS[6] = { -20.0f, -12.0f, -4.0f, 4.0f, 12.0f, 20.0f };
+    for (float z : LOT_COORDS) {
+        for (float x : LOT_COORDS) {
+            glm::vec3 center(x, 0.0f, z);
+            if (std::abs(x) < 5.0f && std::abs(z) < 5.0f) continue;
+            if (glm::length(center - PYRAMID_POSITION) < 6.5f || glm::length(center - CONE_POSITION) < 6.5f) continue;
+            lots.push_back({ center, glm::length(center) });
+        }
+    }
+    std::stable_sort(lots.begin(), lots.end(), [](const Lot& a, const Lot& b) { return a.distance < b.distance; });
+
+    houses = std::min<int>(houses, static_cast<int>(lots.size()));
+    for (int i = 0; i < houses; ++i) {
+        float height = 3.0f + (i % 3) * 1.5f;
+        TownBlock block;
+        block.size = glm::vec3(4.5f, height, 4.5f);
+        block.center = lots[i].center + glm::vec3(0.0f, height * 0.5f, 0.0f);
+        townBlocks.push_back(block);
+        // Square footprint as a disc through the middle of the sides (corners trimmed, like the pyramid)
+        if (navigation.enabled) navigation.grid.addObstacle(lots[i].center, block.size.x * 0.55f);
+    }
+}
+
+void characterBounds(const Character* character, CharacterType type, glm::vec3& boundsMin, glm::vec3& boundsMax) {
+    glm::vec3 base = character->position;
+    float halfWidth = 1.2f; // Arms, Finn's sword, Marceline's hair, any rotation
+    float top = 3.0f;
+    float bottom = -0.6f;
+    if (type == CHARACTER_JAKE) {
+        const Jake* jake = static_cast<const Jake*>(character);
+        // Model base drops by the stretch offset; legs + body + head scale with the stretch and size
+        base.y -= jake->getStretchHeightOffset();
+        halfWidth *= jake->sizeMultiplier;
+        top = jake->sizeMultiplier * (JAKE_BASE_LEG_LENGTH * jake->legStretch * 2.0f + 1.5f);
+        bottom = -0.2f * jake->sizeMultiplier;
+    }
+    boundsMin = base + glm::vec3(-halfWidth, bottom, -halfWidth);
+    boundsMax = base + glm::vec3(halfWidth, top, halfWidth);
+}
+
+bool isCharacterVisible(const Character* character, CharacterType type) {
+    if (!occlusionCuller) return true;
+    glm::vec3 boundsMin, boundsMax;
+    characterBounds(character, type, boundsMin, boundsMax);
+    return occlusionCuller->isVisible(boundsMin, boundsMax);
+}
+
+bool beginCharacter(Renderer& renderer, const Character* character, CharacterType type) {
+    if (!renderer.cullsObjects()) return isCharacterVisible(character, type);
+    glm::vec3 boundsMin, boundsMax;
+    characterBounds(character, type, boundsMin, boundsMax);
+    renderer.beginObject(boundsMin, boundsMax);
+    return true;
+}
+
+void renderWorld(Renderer& renderer, const std::vector<Character*>& allCharacters, float coneScaleFactor, float aspect) {
+    glm::mat4 view, projection;
+    beginWorldFrame(renderer, coneScaleFactor, aspect, view, projection);
+
+    // Draw ALL Characters, grouped by type so each draw function runs back to back.
+    // The grouped list is transient and lives in the frame arena (counting sort, order kept within a type).
+    size_t typeStart[CHARACTER_TYPE_COUNT + 1] = {};
+    for (const Character* character : allCharacters) ++typeStart[characterType(character) + 1];
+    for (int t = 0; t < CHARACTER_TYPE_COUNT; ++t) typeStart[t + 1] += typeStart[t];
+
+    FrameVector<Character*> grouped(allCharacters.size(), nullptr, ArenaAllocator<Character*>(frameArena.current()));
+    size_t cursor[CHARACTER_TYPE_COUNT];
+    std::copy(typeStart, typeStart + CHARACTER_TYPE_COUNT, cursor);
+    for (Character* character : allCharacters) grouped[cursor[characterType(character)]++] = character;
+
+    for (int t = 0; t < CHARACTER_TYPE_COUNT; ++t) {
+        for (size_t i = typeStart[t]; i < typeStart[t + 1]; ++i) {
+            Character* character = grouped[i];
+            if (!beginCharacter(renderer, character, static_cast<CharacterType>(t))) continue;
+            switch (t) {
+                case CHARACTER_FINN: drawFinn(static_cast<Finn*>(character), view, projection); break;
+                case CHARACTER_JAKE: drawJake(static_cast<Jake*>(character), view, projection); break;
+                case CHARACTER_BMO: drawBMO(static_cast<BMO*>(character), view, projection); break;
+                case CHARACTER_PB: drawPB(static_cast<PrincessBubblegum*>(character), view, projection); break;
+                case CHARACTER_ICE_KING: drawIceKing(static_cast<IceKing*>(character), view, projection); break;
+                default: drawMarceline(static_cast<Marceline*>(character), view, projection); break;
+            }
+            renderer.endObject();
+        }
+    }
+
+    renderer.endFrame();
+}
+
+
+// --- Geometry ---
+
+std::vector<glm::vec3> generateCubePositions() {
+     return {
+        // Frente (+Z) - CCW
+        glm::vec3(-0.5f, -0.5f, 0.5f), glm::vec3( 0.5f, -0.5f, 0.5f), glm::vec3( 0.5f,  0.5f, 0.5f),
+        glm::vec3( 0.5f,  0.5f, 0.5f), glm::vec3(-0.5f,  0.5f, 0.5f), glm::vec3(-0.5f, -0.5f, 0.5f),
+        // Trás (-Z) - CCW
+        glm::vec3( 0.5f, -0.5f,-0.5f), glm::vec3(-0.5f, -0.5f,-0.5f), glm::vec3(-0.5f,  0.5f,-0.5f),
+        glm::vec3(-0.5f,  0.5f,-0.5f), glm::vec3( 0.5f,  0.5f,-0.5f), glm::vec3( 0.5f, -0.5f,-0.5f),
+        // Esquerda (-X) - CCW
+        glm::vec3(-0.5f, -0.5f,-0.5f), glm::vec3(-0.5f, -0.5f, 0.5f), glm::vec3(-0.5f,  0.5f, 0.5f),
+        glm::vec3(-0.5f,  0.5f, 0.5f), glm::vec3(-0.5f,  0.5f,-0.5f), glm::vec3(-0.5f, -0.5f,-0.5f),
+        // Direita (+X) - CCW
+        glm::vec3( 0.5f, -0.5f, 0.5f), glm::vec3( 0.5f, -0.5f,-0.5f), glm::vec3( 0.5f,  0.5f,-0.5f),
+        glm::vec3( 0.5f,  0.5f,-0.5f), glm::vec3( 0.5f,  0.5f, 0.5f), glm::vec3( 0.5f, -0.5f, 0.5f),
+        // Baixo (-Y) - CCW
+        glm::vec3(-0.5f, -0.5f, 0.5f), glm::vec3(-0.5f, -0.5f,-0.5f), glm::vec3( 0.5f, -0.5f,-0.5f),
+        glm::vec3( 0.5f, -0.5f,-0.5f), glm::vec3( 0.5f, -0.5f, 0.5f), glm::vec3(-0.5f, -0.5f, 0.5f),
+        // Cima (+Y) - CCW
+        glm::vec3(-0.5f,  0.5f, 0.5f), glm::vec3( 0.5f,  0.5f, 0.5f), glm::vec3( 0.5f,  0.5f,-0.5f),
+        glm::vec3( 0.5f,  0.5f,-0.5f), glm::vec3(-0.5f,  0.5f,-0.5f), glm::vec3(-0.5f,  0.5f, 0.5f),
+    };
+}
+
+std::vector<glm::vec3> generatePyramidPositions() {
+    return {
+        // Faces laterais (CCW from outside)
+        glm::vec3( 0.0f,  0.5f,  0.0f), glm::vec3(-0.5f, -0.5f,  0.5f), glm::vec3( 0.5f, -0.5f,  0.5f), // Frente
+        glm::vec3( 0.0f,  0.5f,  0.0f), glm::vec3( 0.5f, -0.5f,  0.5f), glm::vec3( 0.5f, -0.5f, -0.5f), // Direita
+        glm::vec3( 0.0f,  0.5f,  0.0f), glm::vec3( 0.5f, -0.5f, -0.5f), glm::vec3(-0.5f, -0.5f, -0.5f), // Trás
+        glm::vec3( 0.0f,  0.5f,  0.0f), glm::vec3(-0.5f, -0.5f, -0.5f), glm::vec3(-0.5f, -0.5f,  0.5f), // Esquerda
+        // Base (CCW from top looking down)
+        glm::vec3(-0.5f, -0.5f, -0.5f), glm::vec3( 0.5f, -0.5f, -0.5f), glm::vec3( 0.5f, -0.5f,  0.5f), // Base 1
+        glm::vec3( 0.5f, -0.5f,  0.5f), glm::vec3(-0.5f, -0.5f,  0.5f), glm::vec3(-0.5f, -0.5f, -0.5f), // Base 2
+    };
+}
+
+std::vector<glm::vec3> generateConePositions(int slices) {
+    std::vector<glm::vec3> vertices;
+    glm::vec3 tip(0.0f, 0.5f, 0.0f);
+    glm::vec3 baseCenter(0.0f, -0.5f, 0.0f);
+    float radius = 0.5f;
+    float angleStep = 2.0f * glm::pi<float>() / slices;
+
+    for (int i = 0; i < slices; ++i) {
+        float angle1 = i * angleStep;
+        float angle2 = (i + 1) * angleStep;
+         // Explicitly handle wrap-around for vertex positions to avoid tiny gaps
+        glm::vec3 p1(radius * cos(angle1), -0.5f, radius * sin(angle1));
+        glm::vec3 p2(radius * cos(angle2), -0.5f, radius * sin(angle2));
+
+        // Lados (Triângulo: topo, base_i, base_i+1) - CCW from outside
+        vertices.push_back(tip);
+        vertices.push_back(p1);
+        vertices.push_back(p2);
+
+        // Base (Triângulo: centro, base_i+1, base_i) - CCW from top (looking down)
+        vertices.push_back(baseCenter);
+        vertices.push_back(p2);
+        vertices.push_back(p1);
+    }
+    return vertices;
+}
+
+
+const std::vector<glm::vec3>& characterPalette() {
+    static const std::vector<glm::vec3> colors = {
+        COLOR_FINN_SKIN, COLOR_FINN_SHIRT, COLOR_FINN_PANTS, COLOR_FINN_HAT, COLOR_FINN_BACKPACK, COLOR_BLACK,
+        COLOR_WHITE, COLOR_JAKE_BODY, COLOR_SKY_BLUE, COLOR_GRASS_GREEN, COLOR_SWORD_GREY, COLOR_BMO_BODY,
+        COLOR_BMO_SCREEN, COLOR_BMO_BUTTON_RED, COLOR_BMO_BUTTON_BLUE, COLOR_BMO_BUTTON_YELLOW,
+        COLOR_ICE_KING_BODY, COLOR_ICE_KING_BEARD, COLOR_ICE_KING_CROWN, COLOR_ICE_KING_GEM, COLOR_PB_SKIN,
+        COLOR_PB_HAIR, COLOR_PB_DRESS, COLOR_PB_CROWN, COLOR_PB_GEM, COLOR_MARCELINE_SKIN,
+        COLOR_MARCELINE_HAIR, COLOR_MARCELINE_SHIRT, COLOR_MARCELINE_PANTS, COLOR_MARCELINE_BASS,
+        COLOR_HOUSE_WALL, COLOR_HOUSE_ROOF
+    };
+    return colors;
+}
+
+void drawShape(const Mesh& mesh, glm::mat4 model, const glm::vec3& color) {
+    // Forward to the active backend (GLRenderer applies the mesh dequantization and wireframe mode)
+    if (activeRenderer) {
+        activeRenderer->drawMesh(mesh, model, color);
+    }
+}
@@ -0,0 +1,105 @@
+#ifndef ADVENTURE_DRAW_H
+#define ADVENTURE_DRAW_H
+
+#include <glm/glm.hpp>
+#include <vector>
+#include "Mesh.h"
+#include "Renderer.h"
+#include "AdventureCharacters.h"
+
+class OcclusionCuller;
+
+// Drawing side of the Adventure Time prototype: shared meshes, character
+// models built from cubes/pyramids/cones and the scene submission. Every
+// part goes through drawShape to the active Renderer (GL or software).
+
+// --- Cores Adventure Time ---
+const glm::vec3 COLOR_FINN_SKIN(1.0f, 0.85f, 0.7f);
+const glm::vec3 COLOR_FINN_SHIRT(0.2f, 0.7f, 0.9f);
+const glm::vec3 COLOR_FINN_PANTS(0.0f, 0.2f, 0.5f);
+const glm::vec3 COLOR_FINN_HAT(1.0f, 1.0f, 1.0f);
+const glm::vec3 COLOR_FINN_BACKPACK(0.1f, 0.6f, 0.1f);
+const glm::vec3 COLOR_BLACK(0.0f, 0.0f, 0.0f);
+const glm::vec3 COLOR_WHITE(1.0f, 1.0f, 1.0f);
+const glm::vec3 COLOR_JAKE_BODY(1.0f, 0.8f, 0.0f);
+const glm::vec3 COLOR_SKY_BLUE(0.5f, 0.8f, 1.0f);
+const glm::vec3 COLOR_GRASS_GREEN(0.3f, 0.7f, 0.3f);
+const glm::vec3 COLOR_SWORD_GREY(0.7f, 0.7f, 0.7f);
+// New Character Colors
+const glm::vec3 COLOR_BMO_BODY(0.4f, 0.8f, 0.75f); // Tealish
+const glm::vec3 COLOR_BMO_SCREEN(0.1f, 0.2f, 0.15f);
+const glm::vec3 COLOR_BMO_BUTTON_RED(1.0f, 0.2f, 0.2f);
+const glm::vec3 COLOR_BMO_BUTTON_BLUE(0.2f, 0.3f, 1.0f);
+const glm::vec3 COLOR_BMO_BUTTON_YELLOW(1.0f, 0.9f, 0.2f);
+const glm::vec3 COLOR_ICE_KING_BODY(0.6f, 0.8f, 1.0f); // Light Blue
+const glm::vec3 COLOR_ICE_KING_BEARD(0.9f, 0.95f, 1.0f); // Off-white
+const glm::vec3 COLOR_ICE_KING_CROWN(1.0f, 0.9f, 0.0f); // Yellow
+const glm::vec3 COLOR_ICE_KING_GEM(1.0f, 0.1f, 0.1f);   // Red
+const glm::vec3 COLOR_PB_SKIN(1.0f, 0.75f, 0.85f); // Pinkish skin
+const glm::vec3 COLOR_PB_HAIR(1.0f, 0.4f, 0.7f);   // Bright Pink
+const glm::vec3 COLOR_PB_DRESS(0.9f, 0.5f, 0.75f);  // Slightly darker pink
+const glm::vec3 COLOR_PB_CROWN(1.0f, 0.9f, 0.0f);   // Yellow
+const glm::vec3 COLOR_PB_GEM(0.2f, 0.7f, 0.8f);   // Blue gem
+const glm::vec3 COLOR_MARCELINE_SKIN(0.8f, 0.85f, 0.9f); // Greyish blue
+const glm::vec3 COLOR_MARCELINE_HAIR(0.15f, 0.15f, 0.2f); // Very Dark Grey
+const glm::vec3 COLOR_MARCELINE_SHIRT(0.7f, 0.1f, 0.1f);  // Dark Red
+const glm::vec3 COLOR_MARCELINE_PANTS(0.1f, 0.1f, 0.3f);  // Dark Blue
+const glm::vec3 COLOR_MARCELINE_BASS(0.9f, 0.1f, 0.1f); // Red Bass
+const glm::vec3 COLOR_HOUSE_WALL(0.85f, 0.72f, 0.55f);
+const glm::vec3 COLOR_HOUSE_ROOF(0.7f, 0.25f, 0.2f);
+
+// --- Shared meshes and backend ---
+extern Mesh cubeMesh;
+extern Mesh pyramidMesh;
+extern Mesh coneMesh;
+extern Renderer* activeRenderer; // Backend that receives drawShape calls (GL or software)
+
+std::vector<glm::vec3> generateCubePositions();
+std::vector<glm::vec3> generatePyramidPositions();
+std::vector<glm::vec3> generateConePositions(int slices = 16);
+void drawShape(const Mesh& mesh, glm::mat4 model, const glm::vec3& color);
+// Every COLOR_* constant above, for backends that index colors through a palette
+const std::vector<glm::vec3>& characterPalette();
+
+// --- Funções de Desenho dos Personagens (Declarations) ---
+void drawFinn(Finn* finn, const glm::mat4& view, const glm::mat4& projection);
+void drawJake(Jake* jake, const glm::mat4& view, const glm::mat4& projection);
+void drawBMO(BMO* bmo, const glm::mat4& view, const glm::mat4& projection);
+void drawIceKing(IceKing* ik, const glm::mat4& view, const glm::mat4& projection);
+void drawPB(PrincessBubblegum* pb, const glm::mat4& view, const glm::mat4& projection);
+void drawMarceline(Marceline* marcy, const glm::mat4& view, const glm::mat4& projection);
+
+// --- Town ---
+// Houses on the lots of a street grid around the central plaza (nearest lots first), drawn by
+// beginWorldFrame. Their walls are the occluders for --occlusion; with --nav they are obstacles.
+struct TownBlock {
+    glm::vec3 center; // Center of the wall box
+    glm::vec3 size;
+};
+extern std::vector<TownBlock> townBlocks;
+
+// Builds 'houses' houses (capped at the number of free lots) unless the town already exists
+void buildTown(int houses);
+// --town N   buildTown(N)
+void parseTownOptions(int argc, char** argv);
+
+// --- Occlusion culling ---
+// Set by main with --occlusion (null otherwise): beginWorldFrame rasterizes the house walls into
+// it and the character loops skip every character whose bounds are hidden or off screen.
+extern OcclusionCuller* occlusionCuller;
+
+// World-space box around everything draw<Type> emits for this character (loose but conservative)
+void characterBounds(const Character* character, CharacterType type, glm::vec3& boundsMin, glm::vec3& boundsMax);
+// True without a culler; counts the test in the culler statistics
+bool isCharacterVisible(const Character* character, CharacterType type);
+// Before drawing a character: hands its box to a renderer that culls on the GPU, otherwise runs
+// isCharacterVisible. False means skip it; after drawing, call renderer.endObject().
+bool beginCharacter(Renderer& renderer, const Character* character, CharacterType type);
+
+// Camera, ground and props: renderer.beginFrame and the scene up to the characters
+void beginWorldFrame(Renderer& renderer, float coneScaleFactor, float aspect, glm::mat4& view, glm::mat4& projection);
+// Camera, ground, props and all characters, between renderer.beginFrame/endFrame.
+// Scratch data comes from frameArena.current(): call frameArena.endFrame() once per frame.
+void renderWorld(Renderer& renderer, const std::vector<Character*>& allCharacters, float coneScaleFactor, float aspect);
+
+#endif // ADVENTURE_DRAW_H
@@ -0,0 +1,388 @@
+#include "AdventureEcs.h"
+#include "AdventureDraw.h"
+#include "Navigation.h"
+#include "Renderer.h"
+#include <glm/gtc/constants.hpp>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+const float ATTACK_DURATION = 0.3f;
+const float FOLLOW_TOLERANCE = 0.5f; // Same as the formations' slot tolerance
+
+// Jake::getStretchHeightOffset
+float stretchOffset(const Stretch* stretch) {
+    return stretch && stretch->legStretch > 1.0f ? JAKE_BASE_LEG_LENGTH * (stretch->legStretch - 1.0f) : 0.0f;
+}
+
+float wrapAngle(float angle) {
+    angle = std::fmod(angle, 2.0f * glm::pi<float>());
+    return angle < 0.0f ? angle + 2.0f * glm::pi<float>() : angle;
+}
+
+// chooseNewTarget of the NPC classes
+void chooseTarget(Wander& wander, bool flyer, float groundHeight) {
+    wander.target.x = distribWander(gen);
+    wander.target.y = flyer ? distribFlyY(gen) : groundHeight;
+    wander.target.z = distribWander(gen);
+    wander.timeSinceDecision = 0.0f;
+    wander.decisionInterval = wander.intervalMin + distrib01(gen) * wander.intervalRange;
+}
+}
+
+EcsInput ecsInput(PlayerInput input) {
+    EcsInput result;
+    result.forward = (input & INPUT_FORWARD) != 0;
+    result.backward = (input & INPUT_BACKWARD) != 0;
+    result.left = (input & INPUT_LEFT) != 0;
+    result.right = (input & INPUT_RIGHT) != 0;
+    result.headUp = (input & INPUT_HEAD_UP) != 0;
+    result.headDown = (input & INPUT_HEAD_DOWN) != 0;
+    result.jump = (input & INPUT_JUMP) != 0;
+    result.attack = (input & INPUT_ATTACK) != 0;
+    result.stretch = (input & INPUT_STRETCH) != 0;
+    result.grow = (input & INPUT_GROW) != 0;
+    return result;
+}
+
+AdventureEcs::AdventureEcs()
+    : finnPrototype(glm::vec3(0.0f)), jakePrototype(glm::vec3(0.0f)), bmoPrototype(glm::vec3(0.0f)),
+      pbPrototype(glm::vec3(0.0f)), iceKingPrototype(glm::vec3(0.0f)), marcelinePrototype(glm::vec3(0.0f)) {
+    // Registers every type before any system can run on a worker (componentId is not thread-safe the first time)
+    componentMask<Transform, Motion, JumpState, LimbSwing, Wander, Stretch, Attack, Appearance, Flyer,
+                  PlayerControlled, Follow, RandomResource, InputResource, RenderQueueResource>();
+
+    scheduler.addSystem("input", componentMask<InputResource, PlayerControlled>(),
+                        componentMask<Transform, Motion, JumpState, Stretch, Attack>(),
+                        [this](ThreadPool*) { inputSystem(); });
+    scheduler.addSystem("jump", componentMask<Stretch>(), componentMask<Transform, JumpState>(),
+                        [this](ThreadPool* pool) { jumpSystem(pool); });
+    scheduler.addSystem("limbs", componentMask<Motion>(), componentMask<LimbSwing>(),
+                        [this](ThreadPool* pool) { limbSwingSystem(pool); });
+    scheduler.addSystem("attack", 0, componentMask<Attack>(), [this](ThreadPool* pool) { attackSystem(pool); });
+    scheduler.addSystem("wander", componentMask<Appearance, Flyer, PlayerControlled, Follow>(),
+                        componentMask<Transform, Motion, JumpState, Wander, RandomResource>(),
+                        [this](ThreadPool*) { wanderSystem(); });
+    scheduler.addSystem("stretch", 0, componentMask<Transform, JumpState, Stretch>(),
+                        [this](ThreadPool* pool) { stretchSystem(pool); });
+    scheduler.addSystem("follow", componentMask<Follow, JumpState, Stretch, Flyer, PlayerControlled>(),
+                        componentMask<Transform, Motion>(), [this](ThreadPool*) { followSystem(); });
+    scheduler.addSystem("extract", componentMask<Transform, Appearance, LimbSwing, Stretch, Attack>(),
+                        componentMask<RenderQueueResource>(), [this](ThreadPool*) { extractSystem(); });
+}
+
+Entity AdventureEcs::spawn(CharacterType type, glm::vec3 position) {
+    // Speed, jump speed and gravity of each Character constructor
+    static const float STATS[CHARACTER_TYPE_COUNT][3] = {
+        { 7.0f, 10.0f, 25.0f }, { 6.0f, 9.0f, 28.0f }, { 2.5f, 0.0f, 9.8f },
+        { 3.0f, 0.0f, 9.8f }, { 3.5f, 0.0f, 0.0f }, { 4.0f, 0.0f, 0.0f }
+    };
+    // Decision interval ranges of each chooseNewTarget (min, range)
+    static const float INTERVALS[CHARACTER_TYPE_COUNT][2] = {
+        { 5.0f, 5.0f }, { 5.0f, 5.0f }, { 4.0f, 6.0f }, { 5.0f, 5.0f }, { 6.0f, 6.0f }, { 4.0f, 4.0f }
+    };
+
+    Transform transform{ position, 0.0f, 0.0f };
+    Motion motion{ STATS[type][0], 0 };
+    JumpState jump{ 0.0f, STATS[type][2], 0.0f, STATS[type][1], 0 };
+    Appearance appearance{ type };
+    // The Character constructor draws an interval; the first target is the spawn point (walkers)
+    // or a target picked right away (flyers)
+    Wander wander{ position, 0.0f, 5.0f + distrib01(gen) * 5.0f, INTERVALS[type][0], INTERVALS[type][1] };
+
+    switch (type) {
+        case CHARACTER_FINN:
+            return world.create(transform, motion, jump, appearance, LimbSwing{ 0.0f, 0.0f }, Attack{ 0.0f, 0 });
+        case CHARACTER_JAKE:
+            return world.create(transform, motion, jump, appearance, LimbSwing{ 0.0f, 0.0f }, Stretch{ 1.0f, 1.0f });
+        case CHARACTER_BMO:
+        case CHARACTER_PB:
+            return world.create(transform, motion, jump, appearance, wander);
+        default:
+            transform.position.y = distribFlyY(gen);
+            chooseTarget(wander, true, 0.0f);
+            return world.create(transform, motion, jump, appearance, wander, Flyer{});
+    }
+}
+
+void AdventureEcs::setControlled(Entity entity) {
+    world.remove<PlayerControlled>(controlled);
+    controlled = entity;
+    world.add(controlled, PlayerControlled{});
+}
+
+void AdventureEcs::follow(Entity follower, Entity leader, float spacing, float speedMultiplier) {
+    if (follower != leader) world.add(follower, Follow{ leader, spacing, speedMultiplier });
+}
+
+void AdventureEcs::clear() {
+    world.clear();
+    controlled = Entity();
+    for (std::vector<RenderItem>& queue : queues) queue.clear();
+}
+
+void AdventureEcs::step(float dt, ThreadPool* pool) {
+    simulationTime += dt;
+    deltaTime = dt;
+    scheduler.run(pool);
+}
+
+size_t AdventureEcs::renderItemCount() const {
+    size_t count = 0;
+    for (const std::vector<RenderItem>& queue : queues) count += queue.size();
+    return count;
+}
+
+void AdventureEcs::inputSystem() {
+    world.forEachChunk(componentMask<PlayerControlled, Transform, Motion, JumpState>(), 0, [&](const EcsChunk& chunk) {
+        Transform* transforms = chunk.column<Transform>();
+        Motion* motions = chunk.column<Motion>();
+        JumpState* jumps = chunk.column<JumpState>();
+        Stretch* stretches = chunk.column<Stretch>();
+        Attack* attacks = chunk.column<Attack>();
+        for (uint32_t i = 0; i < chunk.size(); ++i) {
+            Transform& transform = transforms[i];
+            Motion& motion = motions[i];
+            JumpState& jump = jumps[i];
+            glm::vec3 forward(std::sin(transform.rotation), 0.0f, std::cos(transform.rotation));
+            motion.moving = 0;
+            if (input.forward) {
+                transform.position += forward * motion.speed * deltaTime;
+                motion.moving = 1;
+            }
+            if (input.backward) {
+                transform.position -= forward * motion.speed * deltaTime;
+                motion.moving = 1;
+            }
+            if (input.left) transform.rotation = wrapAngle(transform.rotation + 2.0f * deltaTime);
+            if (input.right) transform.rotation = wrapAngle(transform.rotation - 2.0f * deltaTime);
+            if (input.headUp) transform.headInclination = std::min(transform.headInclination + 2.0f * deltaTime, glm::pi<float>() / 4.0f);
+            if (input.headDown) transform.headInclination = std::max(transform.headInclination - 2.0f * deltaTime, -glm::pi<float>() / 4.0f);
+            if (input.jump) {
+                float ground = jump.groundHeight + stretchOffset(stretches ? &stretches[i] : nullptr);
+                if (!jump.jumping && std::abs(transform.position.y - ground) < 0.15f) {
+                    jump.jumping = 1;
+                    jump.verticalSpeed = jump.initialSpeed;
+                }
+            }
+            if (attacks && input.attack && !attacks[i].attacking) {
+                attacks[i].attacking = 1;
+                attacks[i].startTime = simulationTime;
+            }
+            if (stretches && input.stretch) stretches[i].legStretch = 3.0f;
+            if (stretches && input.grow) stretches[i].sizeMultiplier = 2.5f;
+        }
+    });
+}
+
+void AdventureEcs::jumpSystem(ThreadPool* pool) {
+    parallelForChunks(world, componentMask<Transform, JumpState>(), 0, pool, [&](const EcsChunk& chunk) {
+        Transform* transforms = chunk.column<Transform>();
+        JumpState* jumps = chunk.column<JumpState>();
+        const Stretch* stretches = chunk.column<Stretch>();
+        for (uint32_t i = 0; i < chunk.size(); ++i) {
+            glm::vec3& position = transforms[i].position;
+            JumpState& jump = jumps[i];
+            if (position.y > jump.groundHeight || jump.verticalSpeed > 0.0f || jump.jumping) {
+                jump.verticalSpeed -= jump.gravity * deltaTime;
+            }
+            position.y += jump.verticalSpeed * deltaTime;
+            float ground = jump.groundHeight + stretchOffset(stretches ? &stretches[i] : nullptr);
+            if (position.y <= ground && jump.verticalSpeed <= 0.0f) {
+                position.y = ground;
+                jump.jumping = 0;
+                jump.verticalSpeed = 0.0f;
+            }
+        }
+    });
+}
+
+void AdventureEcs::limbSwingSystem(ThreadPool* pool) {
+    const float swingSpeed = 6.0f;
+    const float maxSwingAngle = glm::radians(40.0f);
+    const float armMultiplier = 1.2f;
+    float swing = std::sin(simulationTime * swingSpeed) * maxSwingAngle;
+    float damping = std::pow(0.1f, deltaTime);
+    parallelForChunks(world, componentMask<Motion, LimbSwing>(), 0, pool, [&](const EcsChunk& chunk) {
+        const Motion* motions = chunk.column<Motion>();
+        LimbSwing* limbs = chunk.column<LimbSwing>();
+        for (uint32_t i = 0; i < chunk.size(); ++i) {
+            LimbSwing& limb = limbs[i];
+            if (motions[i].moving) {
+                limb.leg = swing;
+                limb.arm = -swing * armMultiplier; // Arms swing opposite
+            } else {
+                limb.leg *= damping;
+                limb.arm *= damping;
+                if (std::abs(limb.leg) < 0.01f) limb.leg = 0.0f;
+                if (std::abs(limb.arm) < 0.01f) limb.arm = 0.0f;
+            }
+        }
+    });
+}
+
+void AdventureEcs::attackSystem(ThreadPool* pool) {
+    parallelForChunks(world, componentMask<Attack>(), 0, pool, [&](const EcsChunk& chunk) {
+        Attack* attacks = chunk.column<Attack>();
+        for (uint32_t i = 0; i < chunk.size(); ++i) {
+            if (attacks[i].attacking && simulationTime - attacks[i].startTime > ATTACK_DURATION) attacks[i].attacking = 0;
+        }
+    });
+}
+
+void AdventureEcs::wanderSystem() {
+    // Sequential: targets come from gen, in a fixed order
+    ComponentMask with = componentMask<Transform, Motion, JumpState, Wander>();
+    ComponentMask without = componentMask<PlayerControlled, Follow>();
+    world.forEachChunk(with, without, [&](const EcsChunk& chunk) {
+        Transform* transforms = chunk.column<Transform>();
+        Motion* motions = chunk.column<Motion>();
+        JumpState* jumps = chunk.column<JumpState>();
+        Wander* wanders = chunk.column<Wander>();
+        bool flyer = chunk.has<Flyer>();
+        bool steered = navigation.enabled && !flyer;
+        for (uint32_t i = 0; i < chunk.size(); ++i) {
+            Transform& transform = transforms[i];
+            JumpState& jump = jumps[i];
+            Wander& wander = wanders[i];
+            wander.timeSinceDecision += deltaTime;
+            if (wander.timeSinceDecision > wander.decisionInterval || glm::distance(transform.position, wander.target) < 1.0f) {
+                chooseTarget(wander, flyer, jump.groundHeight);
+                if (steered) wander.target = navigation.snapToWaypoint(wander.target);
+            }
+
+            glm::vec3 direction = wander.target - transform.position;
+            float distanceToTarget = glm::length(direction);
+            if (distanceToTarget > 0.1f) {
+                glm::vec3 moveDir = direction / distanceToTarget;
+                if (steered) moveDir = navigation.steer(transform.position, wander.target, moveDir);
+                transform.rotation = std::atan2(moveDir.x, moveDir.z);
+                transform.position += moveDir * motions[i].speed * deltaTime;
+                motions[i].moving = 1;
+                if (!flyer && !jump.jumping) transform.position.y = jump.groundHeight;
+            } else {
+                motions[i].moving = 0;
+                if (!flyer) {
+                    transform.position.y = jump.groundHeight;
+                    jump.jumping = 0;
+                    jump.verticalSpeed = 0.0f;
+                }
+            }
+        }
+    });
+}
+
+void AdventureEcs::stretchSystem(ThreadPool* pool) {
+    parallelForChunks(world, componentMask<Transform, JumpState, Stretch>(), 0, pool, [&](const EcsChunk& chunk) {
+        Transform* transforms = chunk.column<Transform>();
+        JumpState* jumps = chunk.column<JumpState>();
+        Stretch* stretches = chunk.column<Stretch>();
+        for (uint32_t i = 0; i < chunk.size(); ++i) {
+            Stretch& stretch = stretches[i];
+            if (stretch.legStretch > 1.0f) stretch.legStretch = std::max(1.0f, stretch.legStretch - 3.0f * deltaTime);
+            if (stretch.sizeMultiplier > 1.0f) stretch.sizeMultiplier = std::max(1.0f, stretch.sizeMultiplier - 2.0f * deltaTime);
+            // Jake stands on his legs whenever he is not jumping
+            JumpState& jump = jumps[i];
+            float ground = jump.groundHeight + stretchOffset(&stretch);
+            if (!jump.jumping && std::abs(transforms[i].position.y - ground) > 0.01f) {
+                transforms[i].position.y = ground;
+                if (jump.verticalSpeed > 0.0f) jump.verticalSpeed = 0.0f;
+            }
+        }
+    });
+}
+
+void AdventureEcs::followSystem() {
+    // Sequential: a follower reads its leader's Transform, which may itself be following
+    ComponentMask with = componentMask<Transform, Motion, JumpState, Follow>();
+    world.forEachChunk(with, componentMask<PlayerControlled>(), [&](const EcsChunk& chunk) {
+        Transform* transforms = chunk.column<Transform>();
+        Motion* motions = chunk.column<Motion>();
+        const JumpState* jumps = chunk.column<JumpState>();
+        const Follow* follows = chunk.column<Follow>();
+        const Stretch* stretches = chunk.column<Stretch>();
+        bool flyer = chunk.has<Flyer>();
+        for (uint32_t i = 0; i < chunk.size(); ++i) {
+            Transform& transform = transforms[i];
+            const Follow& follow = follows[i];
+            motions[i].moving = 0;
+            const Transform* leader = world.get<Transform>(follow.leader);
+            if (!leader) continue;
+
+            // The formations' Trail shape: head for the point 'spacing' short of the leader
+            glm::vec3 toLeader = leader->position - transform.position;
+            if (glm::length(toLeader) <= follow.spacing) continue;
+            glm::vec3 moveDir = glm::normalize(toLeader);
+            transform.rotation = std::atan2(moveDir.x, moveDir.z);
+            glm::vec3 toTarget = leader->position - moveDir * follow.spacing - transform.position;
+            if (glm::length(toTarget) <= FOLLOW_TOLERANCE) continue;
+            transform.position += glm::normalize(toTarget) * motions[i].speed * follow.speedMultiplier * deltaTime;
+            motions[i].moving = 1;
+            if (!flyer && !jumps[i].jumping) {
+                transform.position.y = jumps[i].groundHeight + stretchOffset(stretches ? &stretches[i] : nullptr);
+            }
+        }
+    });
+}
+
+void AdventureEcs::extractSystem() {
+    for (std::vector<RenderItem>& queue : queues) queue.clear();
+    world.forEachChunk(componentMask<Transform, Appearance>(), 0, [&](const EcsChunk& chunk) {
+        const Transform* transforms = chunk.column<Transform>();
+        const Appearance* appearances = chunk.column<Appearance>();
+        const LimbSwing* limbs = chunk.column<LimbSwing>();
+        const Stretch* stretches = chunk.column<Stretch>();
+        const Attack* attacks = chunk.column<Attack>();
+        for (uint32_t i = 0; i < chunk.size(); ++i) {
+            RenderItem item;
+            item.position = transforms[i].position;
+            item.rotation = transforms[i].rotation;
+            item.headInclination = transforms[i].headInclination;
+            item.legSwing = limbs ? limbs[i].leg : 0.0f;
+            item.armSwing = limbs ? limbs[i].arm : 0.0f;
+            item.legStretch = stretches ? stretches[i].legStretch : 1.0f;
+            item.sizeMultiplier = stretches ? stretches[i].sizeMultiplier : 1.0f;
+            item.attackStartTime = attacks ? attacks[i].startTime : 0.0f;
+            item.attacking = attacks ? attacks[i].attacking : 0;
+            queues[appearances[i].type].push_back(item);
+        }
+    });
+}
+
+void renderWorldEcs(Renderer& renderer, AdventureEcs& ecs, float coneScaleFactor, float aspect) {
+    glm::mat4 view, projection;
+    beginWorldFrame(renderer, coneScaleFactor, aspect, view, projection);
+
+    Character* prototypes[CHARACTER_TYPE_COUNT] = { &ecs.finnPrototype, &ecs.jakePrototype, &ecs.bmoPrototype,
+                                                    &ecs.pbPrototype, &ecs.iceKingPrototype, &ecs.marcelinePrototype };
+    for (int t = 0; t < CHARACTER_TYPE_COUNT; ++t) {
+        Character* character = prototypes[t];
+        for (const RenderItem& item : ecs.queues[t]) {
+            character->position = item.position;
+            character->rotation = item.rotation;
+            character->headInclination = item.headInclination;
+            character->legSwingAngle = item.legSwing;
+            character->armSwingAngle = item.armSwing;
+            if (t == CHARACTER_JAKE) {
+                ecs.jakePrototype.legStretch = item.legStretch;
+                ecs.jakePrototype.sizeMultiplier = item.sizeMultiplier;
+            }
+            if (!beginCharacter(renderer, character, static_cast<CharacterType>(t))) continue;
+            switch (t) {
+                case CHARACTER_FINN:
+                    ecs.finnPrototype.isAttacking = item.attacking != 0;
+                    ecs.finnPrototype.attackStartTime = item.attackStartTime;
+                    drawFinn(&ecs.finnPrototype, view, projection);
+                    break;
+                case CHARACTER_JAKE: drawJake(&ecs.jakePrototype, view, projection); break;
+                case CHARACTER_BMO: drawBMO(&ecs.bmoPrototype, view, projection); break;
+                case CHARACTER_PB: drawPB(&ecs.pbPrototype, view, projection); break;
+                case CHARACTER_ICE_KING: drawIceKing(&ecs.iceKingPrototype, view, projection); break;
+                default: drawMarceline(&ecs.marcelinePrototype, view, projection); break;
+            }
+            renderer.endObject();
+        }
+    }
+
+    renderer.endFrame();
+}
@@ -0,0 +1,167 @@
+#ifndef ADVENTURE_ECS_H
+#define ADVENTURE_ECS_H
+
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+#include "AdventureCharacters.h"
+#include "Ecs.h"
+
+class Renderer;
+class ThreadPool;
+
+// The Adventure Time characters as ECS entities (Ecs.h). The per-type virtual update()
+// overrides become components plus systems that each declare what they read and write:
+//   input    PlayerControlled entity: move/rotate/head tilt/jump, Finn's attack, Jake's stretch
+//   jump     gravity and landing (on Jake's stretched legs when he has Stretch)
+//   limbs    Finn/Jake arm and leg swing
+//   attack   ends Finn's attack after 0.3 s
+//   wander   NPC targets and movement (the only user of gen, declared as RandomResource)
+//   stretch  Jake's legs and size shrinking back, height snap
+//   follow   followers trail their leader at 'spacing' (the Finn/Jake follow)
+//   extract  copies what drawing needs into one render queue per type
+// With those sets the scheduler runs jump, limbs and attack side by side; the rest stay in
+// declaration order. Behaviour matches the Character classes tick for tick except that NPCs
+// test their wander decision every tick (cheap on packed chunks, so no npcScheduler) and
+// flocking, formation shapes and simulation LOD stay on the Character path.
+
+// --- Components ---
+struct Transform {
+    glm::vec3 position;
+    float rotation;
+    float headInclination;
+};
+
+struct Motion {
+    float speed;
+    uint8_t moving; // Set each tick by whoever moves the entity (input, wander, follow)
+};
+
+struct JumpState {
+    float verticalSpeed;
+    float gravity;
+    float groundHeight;
+    float initialSpeed;
+    uint8_t jumping;
+};
+
+struct LimbSwing { // Finn and Jake
+    float leg;
+    float arm;
+};
+
+struct Wander { // NPCs
+    glm::vec3 target;
+    float timeSinceDecision;
+    float decisionInterval;
+    float intervalMin;   // New intervals are intervalMin + distrib01 * intervalRange
+    float intervalRange;
+};
+
+struct Stretch { // Jake
+    float legStretch;
+    float sizeMultiplier;
+};
+
+struct Attack { // Finn
+    float startTime;
+    uint8_t attacking;
+};
+
+struct Appearance {
+    CharacterType type;
+};
+
+struct Flyer {};            // Wander targets in the air, no ground snap
+struct PlayerControlled {}; // Driven by EcsInput instead of wander/follow
+
+struct Follow {
+    Entity leader;
+    float spacing;
+    float speedMultiplier;
+};
+
+// --- Resources (never stored, only named in read/write sets) ---
+struct RandomResource {};      // gen
+struct InputResource {};       // AdventureEcs::input
+struct RenderQueueResource {}; // AdventureEcs render queues
+
+// One tick of player input for the PlayerControlled entity
+struct EcsInput {
+    bool forward = false;
+    bool backward = false;
+    bool left = false;
+    bool right = false;
+    bool headUp = false;
+    bool headDown = false;
+    bool jump = false;
+    bool attack = false;  // Finn
+    bool stretch = false; // Jake: long legs
+    bool grow = false;    // Jake: size
+};
+
+// The same tick as EcsInput, for the PlayerInput bits applyPlayerInput reads
+EcsInput ecsInput(PlayerInput input);
+
+// What the draw functions read, extracted once per tick
+struct RenderItem {
+    glm::vec3 position;
+    float rotation;
+    float headInclination;
+    float legSwing;
+    float armSwing;
+    float legStretch;
+    float sizeMultiplier;
+    float attackStartTime;
+    uint8_t attacking;
+};
+
+class AdventureEcs {
+public:
+    AdventureEcs(); // Registers the components and systems
+
+    // Same stats and starting state as the matching Character class
+    Entity spawn(CharacterType type, glm::vec3 position);
+    void setControlled(Entity entity); // Invalid entity: nobody
+    void follow(Entity follower, Entity leader, float spacing, float speedMultiplier = 0.8f);
+    void clear();
+
+    // Advances simulationTime and runs every system (in parallel with a pool)
+    void step(float deltaTime, ThreadPool* pool);
+
+    const std::vector<RenderItem>& renderQueue(CharacterType type) const { return queues[type]; }
+    size_t renderItemCount() const;
+
+    EcsWorld world;
+    SystemScheduler scheduler;
+    EcsInput input;
+
+private:
+    void inputSystem();
+    void jumpSystem(ThreadPool* pool);
+    void limbSwingSystem(ThreadPool* pool);
+    void attackSystem(ThreadPool* pool);
+    void wanderSystem();
+    void stretchSystem(ThreadPool* pool);
+    void followSystem();
+    void extractSystem();
+
+    friend void renderWorldEcs(Renderer& renderer, AdventureEcs& ecs, float coneScaleFactor, float aspect);
+
+    float deltaTime = 0.0f;
+    Entity controlled;
+    std::vector<RenderItem> queues[CHARACTER_TYPE_COUNT];
+    // Loaded from a RenderItem and passed to the Character draw functions. Built in the
+    // constructor, so they draw from gen like any spawn (before the entities are spawned).
+    Finn finnPrototype;
+    Jake jakePrototype;
+    BMO bmoPrototype;
+    PrincessBubblegum pbPrototype;
+    IceKing iceKingPrototype;
+    Marceline marcelinePrototype;
+};
+
+// renderWorld for an AdventureEcs: same camera, ground and props, characters from the render queues
+void renderWorldEcs(Renderer& renderer, AdventureEcs& ecs, float coneScaleFactor, float aspect);
+
+#endif // ADVENTURE_ECS_H
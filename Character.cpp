@@ -1,6 +1,6 @@
 #include "Character.h"
 #include <glm/gtc/matrix_transform.hpp>
-#include "Shader.h" // Inclui para usar Shader na assinatura de draw (embora seja virtual puro)
+#include "Renderer.h" // Inclui para usar Renderer na assinatura de draw (embora seja virtual puro)
 
 Character::Character(glm::vec3 startPos, float charHeight, float charSpeed, float charJump, float charGravity)
     : position(startPos),
@@ -67,6 +67,6 @@ glm::mat4 Character::getModelMatrix() const {
 }
 
 // Implementação de draw é virtual pura, então não há corpo aqui.
-// void Character::draw(Shader& shader, glm::mat4 view, glm::mat4 projection) {
+// void Character::draw(Renderer& renderer) {
 //     // Implementação vazia ou erro se chamado diretamente
 // }
\ No newline at end of file
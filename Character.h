@@ -4,8 +4,8 @@
 #include <glm/glm.hpp>
 #include <vector> // Para geometria no futuro, mas não essencial agora
 
-// Forward declaration para evitar include circular se Character precisar de Shader
-class Shader;
+// Forward declaration: o desenho é feito através da interface Renderer
+class Renderer;
 
 class Character {
 public:
@@ -35,9 +35,9 @@ public:
     virtual void startJump();
     virtual glm::mat4 getModelMatrix() const;
 
-    // Método de desenho (virtual puro ou com implementação padrão vazia)
-    // Requer view, projection e o shader para passar uniforms
-    virtual void draw(Shader& shader, glm::mat4 view, glm::mat4 projection) = 0; // Virtual puro exige implementação nas classes filhas
+    // Método de desenho (virtual puro)
+    // Envia as partes do corpo ao renderer (OpenGL ou software); view/projection ficam com o renderer
+    virtual void draw(Renderer& renderer) = 0; // Virtual puro exige implementação nas classes filhas
 
 protected:
     // Pode adicionar funções auxiliares aqui se necessário
@@ -0,0 +1,27 @@
+#include "CountingRenderer.h"
+#include "Mesh.h"
+
+void CountingRenderer::beginFrame(const glm::mat4& view, const glm::mat4& projection, const glm::vec3& clearColor) {
+    ++frames;
+    checksum += view[3][2] + projection[0][0];
+    if (target) target->beginFrame(view, projection, clearColor);
+}
+
+void CountingRenderer::drawMesh(const Mesh& mesh, const glm::mat4& model, const glm::vec3& color) {
+    ++drawCalls;
+    vertices += mesh.vertexCount;
+    checksum += model[3][0] + model[3][1] + model[3][2] + color.r;
+    if (target) target->drawMesh(mesh, model, color);
+}
+
+void CountingRenderer::endFrame() {
+    if (target) target->endFrame();
+}
+
+void CountingRenderer::beginObject(const glm::vec3& boundsMin, const glm::vec3& boundsMax) {
+    if (target) target->beginObject(boundsMin, boundsMax);
+}
+
+void CountingRenderer::endObject() {
+    if (target) target->endObject();
+}
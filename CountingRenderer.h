@@ -0,0 +1,32 @@
+#ifndef COUNTING_RENDERER_H
+#define COUNTING_RENDERER_H
+
+#include <cstddef>
+#include "Renderer.h"
+
+// Conta o que é submetido e, opcionalmente, repassa para outro renderer.
+// Sem destino funciona como renderer falso (benchmarks, teste de carga sem GPU);
+// com destino serve para medir draw calls do GLRenderer ou do rasterizador.
+class CountingRenderer : public Renderer {
+public:
+    explicit CountingRenderer(Renderer* forwardTo = nullptr) : target(forwardTo) {}
+
+    size_t frames = 0;
+    size_t drawCalls = 0;
+    size_t vertices = 0;
+    float checksum = 0.0f; // Depende das matrizes, então o cálculo delas não é descartado
+
+    void reset() { frames = drawCalls = vertices = 0; checksum = 0.0f; }
+
+    void beginFrame(const glm::mat4& view, const glm::mat4& projection, const glm::vec3& clearColor) override;
+    void drawMesh(const Mesh& mesh, const glm::mat4& model, const glm::vec3& color) override;
+    void endFrame() override;
+    void beginObject(const glm::vec3& boundsMin, const glm::vec3& boundsMax) override;
+    void endObject() override;
+    bool cullsObjects() const override { return target && target->cullsObjects(); }
+
+private:
+    Renderer* target;
+};
+
+#endif // COUNTING_RENDERER_H
@@ -0,0 +1,308 @@
+#include "Crowd.h"
+#include "AdventureDraw.h"
+#include "AdventureEcs.h"
+#include "CountingRenderer.h"
+#include "FrameArena.h"
+#include "Navigation.h"
+#include "Flocking.h"
+#include "OcclusionCulling.h"
+#include "ThreadPool.h"
+#include <glm/gtc/constants.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
+static const char* CROWD_TYPE_NAMES[CHARACTER_TYPE_COUNT] = { "finn", "jake", "bmo", "pb", "iceking", "marceline" };
+static std::string ecsSummary; // Scheduler stages and per-system times of the last --crowd-ecs run
+
+CrowdOptions parseCrowdOptions(int argc, char** argv) {
+    CrowdOptions options;
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(arg, "--crowd") == 0 && hasValue) {
+            std::stringstream list(argv[++i]);
+            std::string item;
+            while (std::getline(list, item, ',')) {
+                long long count = std::atoll(item.c_str());
+                if (count > 0) options.counts.push_back(count);
+            }
+            options.enabled = !options.counts.empty();
+        } else if (std::strcmp(arg, "--crowd-frames") == 0 && hasValue) {
+            options.frames = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(arg, "--crowd-mix") == 0 && hasValue) {
+            // Types left out of the list get weight 0
+            std::fill(options.mix, options.mix + CHARACTER_TYPE_COUNT, 0.0f);
+            std::stringstream list(argv[++i]);
+            std::string item;
+            while (std::getline(list, item, ',')) {
+                size_t eq = item.find('=');
+                std::string name = item.substr(0, eq);
+                float weight = eq == std::string::npos ? 1.0f : std::max(0.0f, static_cast<float>(std::atof(item.c_str() + eq + 1)));
+                for (int t = 0; t < CHARACTER_TYPE_COUNT; ++t) {
+                    if (name == CROWD_TYPE_NAMES[t]) options.mix[t] = weight;
+                }
+            }
+        } else if (std::strcmp(arg, "--crowd-spawn") == 0 && hasValue) {
+            std::string kind = argv[++i];
+            if (kind == "cluster") options.spawn = CrowdSpawn::Cluster;
+            else if (kind == "ring") options.spawn = CrowdSpawn::Ring;
+            else if (kind == "grid") options.spawn = CrowdSpawn::Grid;
+            else options.spawn = CrowdSpawn::Uniform;
+        } else if (std::strcmp(arg, "--crowd-formation") == 0 && hasValue) {
+            std::string value = argv[++i];
+            std::string shape = value.substr(0, value.find(','));
+            if (shape == "wedge") options.formationShape = FormationShape::Wedge;
+            else if (shape == "ring") options.formationShape = FormationShape::Ring;
+            else options.formationShape = FormationShape::Line;
+            size_t comma = value.find(',');
+            options.formationSize = comma == std::string::npos ? 20 : std::max(1, std::atoi(value.c_str() + comma + 1));
+        } else if (std::strcmp(arg, "--crowd-ecs") == 0) {
+            options.ecs = true;
+        } else if (std::strcmp(arg, "--crowd-raster") == 0) {
+            options.raster = true;
+        } else if (std::strcmp(arg, "--crowd-json") == 0 && hasValue) {
+            options.jsonPath = argv[++i];
+        }
+    }
+
+    float total = 0.0f;
+    for (float weight : options.mix) total += weight;
+    if (total <= 0.0f) std::fill(options.mix, options.mix + CHARACTER_TYPE_COUNT, 1.0f);
+    return options;
+}
+
+// Ground position for character 'index' of 'count' (y is set by the character type)
+static glm::vec3 spawnPosition(long long index, long long count, CrowdSpawn spawn) {
+    switch (spawn) {
+        case CrowdSpawn::Cluster: {
+            // Eight dense groups around the map, gaussian spread inside each
+            std::normal_distribution<float> spread(0.0f, 2.0f);
+            float angle = (index % 8) * glm::two_pi<float>() / 8.0f;
+            glm::vec3 center(std::cos(angle) * WANDER_RADIUS * 0.6f, 0.0f, std::sin(angle) * WANDER_RADIUS * 0.6f);
+            return center + glm::vec3(spread(gen), 0.0f, spread(gen));
+        }
+        case CrowdSpawn::Ring: {
+            float angle = index * glm::two_pi<float>() / static_cast<float>(count);
+            float radius = WANDER_RADIUS * (0.8f + 0.2f * distrib01(gen));
+            return glm::vec3(std::cos(angle) * radius, 0.0f, std::sin(angle) * radius);
+        }
+        case CrowdSpawn::Grid: {
+            long long side = static_cast<long long>(std::ceil(std::sqrt(static_cast<double>(count))));
+            float step = 2.0f * WANDER_RADIUS / static_cast<float>(std::max(1LL, side - 1));
+            return glm::vec3(-WANDER_RADIUS + (index % side) * step, 0.0f, -WANDER_RADIUS + (index / side) * step);
+        }
+        default:
+            return glm::vec3(distribWander(gen), 0.0f, distribWander(gen));
+    }
+}
+
+void spawnCrowd(std::vector<Character*>& characters, long long count, const CrowdOptions& options) {
+    std::discrete_distribution<int> pickType(options.mix, options.mix + CHARACTER_TYPE_COUNT);
+    characters.reserve(characters.size() + static_cast<size_t>(count));
+    for (long long i = 0; i < count; ++i) {
+        glm::vec3 pos = spawnPosition(i, count, options.spawn);
+        characters.push_back(characterPools.spawn(static_cast<CharacterType>(pickType(gen)), pos));
+    }
+}
+
+// Resident set size in bytes (0 where /proc is not available)
+static size_t residentBytes() {
+#ifdef __linux__
+    std::ifstream statm("/proc/self/statm");
+    size_t pages = 0, resident = 0;
+    if (statm >> pages >> resident) return resident * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+    return 0;
+}
+
+static double millisecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Characters culled by --occlusion during a run, from the culler totals before it
+static void recordOcclusion(CrowdResult& result, const OcclusionCuller::Stats& before, int frames) {
+    if (!occlusionCuller) return;
+    const OcclusionCuller::Stats& after = occlusionCuller->getStats();
+    result.outsidePerFrame = static_cast<double>(after.frustumCulled - before.frustumCulled) / frames;
+    result.occludedPerFrame = static_cast<double>(after.occluded - before.occluded) / frames;
+}
+
+// --crowd-ecs: the same crowd as entities, stepped by the AdventureEcs systems
+static CrowdResult runCrowdEcs(long long count, const CrowdOptions& options, Renderer& renderer, float aspect,
+                               const std::function<void()>& present) {
+    CrowdResult result;
+    result.count = count;
+
+    ThreadPool pool;
+    size_t residentBefore = residentBytes();
+    auto spawnStart = std::chrono::steady_clock::now();
+    AdventureEcs ecs;
+    std::discrete_distribution<int> pickType(options.mix, options.mix + CHARACTER_TYPE_COUNT);
+    std::vector<Entity> entities;
+    entities.reserve(static_cast<size_t>(count));
+    for (long long i = 0; i < count; ++i) {
+        glm::vec3 pos = spawnPosition(i, count, options.spawn);
+        entities.push_back(ecs.spawn(static_cast<CharacterType>(pickType(gen)), pos));
+    }
+    result.spawnMs = millisecondsSince(spawnStart);
+    size_t residentAfter = residentBytes();
+
+    if (options.formationSize > 0) {
+        size_t stride = static_cast<size_t>(options.formationSize) + 1;
+        for (size_t first = 0; first < entities.size(); first += stride) {
+            for (size_t i = first + 1; i < std::min(first + stride, entities.size()); ++i) ecs.follow(entities[i], entities[first], 1.5f, 1.5f);
+        }
+    }
+
+    result.bytesPerCharacter = static_cast<double>(ecs.world.memoryBytes()) / count;
+    if (residentAfter > residentBefore) {
+        result.residentBytesPerCharacter = static_cast<double>(residentAfter - residentBefore) / count;
+    }
+    result.updatesPerFrame = static_cast<double>(count); // Every system visits every matching entity each tick
+
+    CountingRenderer counter(&renderer);
+    OcclusionCuller::Stats occlusionBefore = occlusionCuller ? occlusionCuller->getStats() : OcclusionCuller::Stats();
+    for (int frame = 0; frame < options.frames; ++frame) {
+        auto simulationStart = std::chrono::steady_clock::now();
+        ecs.step(1.0f / 60.0f, &pool);
+        result.simulationMs += millisecondsSince(simulationStart);
+
+        auto submissionStart = std::chrono::steady_clock::now();
+        renderWorldEcs(counter, ecs, 1.5f, aspect);
+        result.submissionMs += millisecondsSince(submissionStart);
+
+        if (present) present();
+        frameArena.endFrame();
+    }
+    result.simulationMs /= options.frames;
+    result.submissionMs /= options.frames;
+    result.drawCalls = static_cast<double>(counter.drawCalls) / options.frames;
+    recordOcclusion(result, occlusionBefore, options.frames);
+
+    char line[128];
+    std::snprintf(line, sizeof(line), "ecs: %zu archetypes, %zu chunks, %u threads, stages ", ecs.world.archetypeCount(),
+                  ecs.world.chunkCount(), pool.size());
+    ecsSummary = line + ecs.scheduler.describe() + "\necs ms/frame:";
+    for (size_t s = 0; s < ecs.scheduler.systemCount(); ++s) {
+        std::snprintf(line, sizeof(line), " %s %.3f", ecs.scheduler.systemName(s).c_str(), ecs.scheduler.systemMs(s) / options.frames);
+        ecsSummary += line;
+    }
+
+    activeRenderer = nullptr;
+    return result;
+}
+
+CrowdResult runCrowd(long long count, const CrowdOptions& options, Renderer& renderer, float aspect,
+                     const std::function<void()>& present) {
+    if (options.ecs) return runCrowdEcs(count, options, renderer, aspect, present);
+    CrowdResult result;
+    result.count = count;
+
+    std::vector<Character*> characters;
+    size_t residentBefore = residentBytes();
+    auto spawnStart = std::chrono::steady_clock::now();
+    spawnCrowd(characters, count, options);
+    result.spawnMs = millisecondsSince(spawnStart);
+    size_t residentAfter = residentBytes();
+
+    // Formations: leader, then formationSize followers, repeated (followers run at 1.5x to keep up)
+    if (options.formationSize > 0) {
+        size_t stride = static_cast<size_t>(options.formationSize) + 1;
+        for (size_t first = 0; first < characters.size(); first += stride) {
+            int group = formations.createGroup(characters[first], options.formationShape, 1.5f, 1.5f);
+            for (size_t i = first + 1; i < std::min(first + stride, characters.size()); ++i) formations.join(group, characters[i]);
+        }
+    }
+
+    size_t bytes = characters.capacity() * sizeof(Character*) + characterPools.memoryBytes();
+    result.bytesPerCharacter = static_cast<double>(bytes) / count;
+    if (residentAfter > residentBefore) {
+        result.residentBytesPerCharacter = static_cast<double>(residentAfter - residentBefore) / count;
+    }
+
+    size_t updatesBefore = 0;
+    for (size_t updates : simulationLod.updates) updatesBefore += updates;
+
+    CountingRenderer counter(&renderer);
+    OcclusionCuller::Stats occlusionBefore = occlusionCuller ? occlusionCuller->getStats() : OcclusionCuller::Stats();
+    for (int frame = 0; frame < options.frames; ++frame) {
+        auto simulationStart = std::chrono::steady_clock::now();
+        updateWorld(characters, -1, 1.0f / 60.0f); // Nobody under player control: everyone wanders
+        result.simulationMs += millisecondsSince(simulationStart);
+
+        auto submissionStart = std::chrono::steady_clock::now();
+        renderWorld(counter, characters, 1.5f, aspect);
+        result.submissionMs += millisecondsSince(submissionStart);
+
+        if (present) present();
+        frameArena.endFrame();
+    }
+    result.simulationMs /= options.frames;
+    size_t updatesAfter = 0;
+    for (size_t updates : simulationLod.updates) updatesAfter += updates;
+    result.updatesPerFrame = static_cast<double>(updatesAfter - updatesBefore) / options.frames;
+    result.submissionMs /= options.frames;
+    result.drawCalls = static_cast<double>(counter.drawCalls) / options.frames;
+    recordOcclusion(result, occlusionBefore, options.frames);
+
+    activeRenderer = nullptr;
+    despawnCharacters(characters);
+    return result;
+}
+
+void printCrowdReport(const std::vector<CrowdResult>& results, const char* title) {
+    std::printf("%s\n%10s %10s %12s %14s %14s %12s %10s %10s\n", title, "characters", "spawn ms", "sim ms/frame",
+                "updates/frame", "submit ms/frame", "draws/frame", "B/char", "RSS B/char");
+    for (const CrowdResult& r : results) {
+        std::printf("%10lld %10.2f %12.3f %14.0f %14.3f %12.0f %10.0f %10.0f\n", r.count, r.spawnMs, r.simulationMs,
+                    r.updatesPerFrame, r.submissionMs, r.drawCalls, r.bytesPerCharacter, r.residentBytesPerCharacter);
+    }
+    if (!ecsSummary.empty()) std::printf("%s (last count)\n", ecsSummary.c_str());
+    if (occlusionCuller) {
+        for (const CrowdResult& r : results) {
+            std::printf("occlusion %lld: %.0f off screen and %.0f occluded per frame (%.1f%% culled)\n", r.count,
+                        r.outsidePerFrame, r.occludedPerFrame, 100.0 * (r.outsidePerFrame + r.occludedPerFrame) / r.count);
+        }
+        occlusionCuller->printStats("occlusion buffer");
+    }
+    if (navigation.enabled) {
+        const FlowFieldCache::Stats& nav = navigation.fields.stats;
+        std::printf("flow fields: %zu cached (%.1f KiB), %zu hits, %zu builds, %zu repairs, %zu evictions\n",
+                    navigation.fields.size(), navigation.fields.memoryBytes(navigation.grid) / 1024.0, nav.hits,
+                    nav.builds, nav.repairs, nav.evictions);
+    }
+    if (flocking.enabled && flocking.stats.flyers > 0) {
+        const Flocking::Stats& flock = flocking.stats;
+        std::printf("flocking: %.0f flyers/tick, %.1f candidates and %.1f neighbors per flyer\n",
+                    static_cast<double>(flock.flyers) / flock.ticks, static_cast<double>(flock.candidates) / flock.flyers,
+                    static_cast<double>(flock.neighbors) / flock.flyers);
+    }
+    std::fflush(stdout);
+}
+
+bool writeCrowdJson(const std::vector<CrowdResult>& results, const std::string& path) {
+    std::ofstream json(path);
+    json << "{\n  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const CrowdResult& r = results[i];
+        json << "    {\"characters\": " << r.count << ", \"spawn_ms\": " << r.spawnMs
+             << ", \"simulation_ms\": " << r.simulationMs << ", \"updates_per_frame\": " << r.updatesPerFrame
+             << ", \"submission_ms\": " << r.submissionMs
+             << ", \"draw_calls\": " << r.drawCalls << ", \"outside_per_frame\": " << r.outsidePerFrame
+             << ", \"occluded_per_frame\": " << r.occludedPerFrame << ", \"bytes_per_character\": " << r.bytesPerCharacter
+             << ", \"resident_bytes_per_character\": " << r.residentBytesPerCharacter << "}"
+             << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    json << "  ]\n}\n";
+    return static_cast<bool>(json);
+}
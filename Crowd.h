@@ -0,0 +1,67 @@
+#ifndef CROWD_H
+#define CROWD_H
+
+#include <functional>
+#include <string>
+#include <vector>
+#include "AdventureCharacters.h"
+#include "Formation.h"
+
+class Renderer;
+
+// Crowd stress mode for the Adventure Time scene.
+//   --crowd N[,N2,...]    run the stress scene for each character count (e.g. 100,1000,10000,100000)
+//   --crowd-frames N      frames simulated and submitted per count (default 120)
+//   --crowd-mix list      relative weights per type, e.g. "bmo=4,pb=4,iceking=1,marceline=1,finn=1,jake=1"
+//   --crowd-spawn kind    uniform | cluster | ring | grid (default uniform)
+//   --crowd-formation shape[,N]  line | wedge | ring: every N+1 characters (default 20), the first
+//                         leads and the others follow in formation (escort/parade load)
+//   --crowd-ecs           simulate and draw through AdventureEcs (entities in archetype chunks, systems
+//                         run by the scheduler on a ThreadPool); formations there always use the Trail shape
+//   --crowd-raster        headless only: rasterize with SoftwareRenderer instead of counting submissions
+//   --crowd-json file     also write the report as JSON
+// With --town and --occlusion the report also shows how many characters were culled per frame.
+// The RNG is seeded with --seed (same value + same options = same crowd).
+enum class CrowdSpawn { Uniform, Cluster, Ring, Grid };
+
+struct CrowdOptions {
+    bool enabled = false;
+    std::vector<long long> counts;
+    int frames = 120;
+    float mix[CHARACTER_TYPE_COUNT] = { 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f };
+    CrowdSpawn spawn = CrowdSpawn::Uniform;
+    FormationShape formationShape = FormationShape::Line;
+    int formationSize = 0; // Followers per leader, 0 = no formations
+    bool ecs = false;
+    bool raster = false;
+    std::string jsonPath;
+};
+
+CrowdOptions parseCrowdOptions(int argc, char** argv);
+
+// Spawns 'count' characters from characterPools with the configured type mix and spawn distribution
+void spawnCrowd(std::vector<Character*>& characters, long long count, const CrowdOptions& options);
+
+// Averages for one crowd size
+struct CrowdResult {
+    long long count = 0;
+    double spawnMs = 0.0;
+    double simulationMs = 0.0;   // updateWorld (or AdventureEcs::step) per frame
+    double updatesPerFrame = 0.0; // Character::update calls per frame (below 'count' with --sim-lod)
+    double submissionMs = 0.0;   // renderWorld per frame (CPU side; GL work is not waited on)
+    double drawCalls = 0.0;      // per frame
+    double outsidePerFrame = 0.0;  // Characters skipped by --occlusion: off screen...
+    double occludedPerFrame = 0.0; // ...and hidden behind the town walls
+    double bytesPerCharacter = 0.0;   // Pool slabs + pointer vector (ECS: chunks + entity table)
+    double residentBytesPerCharacter = 0.0; // Growth of the process RSS while spawning (Linux only, else 0)
+};
+
+// Runs one crowd size: spawn, 'frames' x (updateWorld + renderWorld into 'renderer'), cleanup.
+// 'present' runs after each frame (swap buffers in the windowed path; may be empty).
+CrowdResult runCrowd(long long count, const CrowdOptions& options, Renderer& renderer, float aspect,
+                     const std::function<void()>& present = nullptr);
+
+void printCrowdReport(const std::vector<CrowdResult>& results, const char* title);
+bool writeCrowdJson(const std::vector<CrowdResult>& results, const std::string& path);
+
+#endif // CROWD_H
@@ -0,0 +1,244 @@
+#include "Ecs.h"
+#include "ThreadPool.h"
+#include <chrono>
+#include <new>
+
+namespace {
+const std::align_val_t CHUNK_ALIGNMENT{64}; // Linha de cache
+
+size_t alignUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+}
+
+std::vector<ComponentInfo>& componentRegistry() {
+    static std::vector<ComponentInfo> registry;
+    return registry;
+}
+
+// --- Archetype ---
+
+Archetype::Archetype(ComponentMask componentMask) : mask(componentMask) {
+    const std::vector<ComponentInfo>& registry = componentRegistry();
+    size_t rowBytes = sizeof(Entity);
+    for (int id = 0; id < MAX_COMPONENTS; ++id) {
+        columnOffset[id] = NO_COLUMN;
+        columnSize[id] = 0;
+        if (!has(id)) continue;
+        components.push_back(id);
+        columnSize[id] = registry[id].size;
+        rowBytes += registry[id].size;
+    }
+
+    // Quantas linhas cabem no chunk com as colunas alinhadas (sempre pelo menos uma)
+    capacity = static_cast<uint32_t>(std::max<size_t>(1, CHUNK_BYTES / rowBytes));
+    for (;;) {
+        size_t offset = static_cast<size_t>(capacity) * sizeof(Entity); // Coluna de entidades primeiro
+        for (int id : components) {
+            offset = alignUp(offset, registry[id].align);
+            columnOffset[id] = offset;
+            offset += static_cast<size_t>(capacity) * columnSize[id];
+        }
+        if (offset <= CHUNK_BYTES || capacity == 1) {
+            chunkBytes = std::max(CHUNK_BYTES, offset); // Só passa de CHUNK_BYTES com componentes enormes
+            break;
+        }
+        --capacity;
+    }
+}
+
+Archetype::~Archetype() {
+    for (unsigned char* chunk : chunks) ::operator delete(chunk, CHUNK_ALIGNMENT);
+}
+
+uint32_t Archetype::push(Entity newEntity) {
+    if (size == chunks.size() * capacity) {
+        chunks.push_back(static_cast<unsigned char*>(::operator new(chunkBytes, CHUNK_ALIGNMENT)));
+    }
+    uint32_t row = size++;
+    entity(row) = newEntity;
+    return row;
+}
+
+void Archetype::pop() {
+    --size;
+    // Mantém um chunk vazio de folga, para quem entra e sai na borda não alocar toda vez
+    size_t used = (static_cast<size_t>(size) + capacity - 1) / capacity;
+    while (chunks.size() > used + 1) {
+        ::operator delete(chunks.back(), CHUNK_ALIGNMENT);
+        chunks.pop_back();
+    }
+}
+
+void Archetype::copyRow(uint32_t from, uint32_t to) {
+    for (int id : components) std::memcpy(component(to, id), component(from, id), columnSize[id]);
+    entity(to) = entity(from);
+}
+
+// --- EcsWorld ---
+
+uint32_t EcsWorld::archetypeFor(ComponentMask mask) {
+    auto found = archetypeIndex.find(mask);
+    if (found != archetypeIndex.end()) return found->second;
+    uint32_t index = static_cast<uint32_t>(archetypes.size());
+    archetypes.push_back(std::make_unique<Archetype>(mask));
+    archetypeIndex.emplace(mask, index);
+    return index;
+}
+
+Entity EcsWorld::allocateEntity() {
+    Entity entity;
+    if (!freeEntities.empty()) {
+        entity.index = freeEntities.back();
+        freeEntities.pop_back();
+    } else {
+        entity.index = static_cast<uint32_t>(locations.size());
+        locations.emplace_back();
+    }
+    Location& location = locations[entity.index];
+    location.alive = true;
+    entity.generation = location.generation;
+    ++liveCount;
+    return entity;
+}
+
+void EcsWorld::removeRow(uint32_t archetypeIndex, uint32_t row) {
+    Archetype& archetype = *archetypes[archetypeIndex];
+    uint32_t last = archetype.size - 1;
+    if (row != last) {
+        archetype.copyRow(last, row);
+        locations[archetype.entity(row).index].row = row;
+    }
+    archetype.pop();
+}
+
+void EcsWorld::destroy(Entity entity) {
+    if (!alive(entity)) return;
+    Location& location = locations[entity.index];
+    removeRow(location.archetype, location.row);
+    location.alive = false;
+    ++location.generation;
+    freeEntities.push_back(entity.index);
+    --liveCount;
+    ++structureVersion;
+}
+
+void EcsWorld::move(Entity entity, ComponentMask mask) {
+    uint32_t target = archetypeFor(mask); // Pode criar o arquétipo: pegar as referências depois
+    Location& location = locations[entity.index];
+    Archetype& from = *archetypes[location.archetype];
+    Archetype& to = *archetypes[target];
+    uint32_t newRow = to.push(entity);
+    for (int id : to.components) {
+        if (from.has(id)) std::memcpy(to.component(newRow, id), from.component(location.row, id), to.columnSize[id]);
+    }
+    removeRow(location.archetype, location.row);
+    location.archetype = target;
+    location.row = newRow;
+    ++structureVersion;
+}
+
+void EcsWorld::collectChunks(ComponentMask with, ComponentMask without, std::vector<EcsChunk>& chunks) const {
+    chunks.clear();
+    forEachChunk(with, without, [&](const EcsChunk& chunk) { chunks.push_back(chunk); });
+}
+
+const std::vector<EcsChunk>& EcsWorld::cachedChunks(ComponentMask with, ComponentMask without) const {
+    ChunkQuery* query = nullptr;
+    for (ChunkQuery& cached : chunkQueries) {
+        if (cached.with == with && cached.without == without) {
+            query = &cached;
+            break;
+        }
+    }
+    if (!query) {
+        chunkQueries.push_back({ with, without, structureVersion + 1, {} });
+        query = &chunkQueries.back();
+    }
+    if (query->version != structureVersion) {
+        collectChunks(with, without, query->chunks);
+        query->version = structureVersion;
+    }
+    return query->chunks;
+}
+
+void EcsWorld::clear() {
+    ++structureVersion;
+    archetypes.clear();
+    archetypeIndex.clear();
+    freeEntities.clear();
+    // Os índices continuam reservados com a geração avançada: handles antigos não voltam a valer
+    for (uint32_t i = 0; i < locations.size(); ++i) {
+        if (locations[i].alive) ++locations[i].generation;
+        locations[i].alive = false;
+        freeEntities.push_back(i);
+    }
+    liveCount = 0;
+}
+
+size_t EcsWorld::chunkCount() const {
+    size_t count = 0;
+    for (const std::unique_ptr<Archetype>& archetype : archetypes) count += archetype->chunks.size();
+    return count;
+}
+
+size_t EcsWorld::memoryBytes() const {
+    size_t bytes = locations.capacity() * sizeof(Location);
+    for (const std::unique_ptr<Archetype>& archetype : archetypes) bytes += archetype->chunks.size() * archetype->chunkBytes;
+    return bytes;
+}
+
+void parallelForChunks(const EcsWorld& world, ComponentMask with, ComponentMask without, ThreadPool* pool,
+                       const std::function<void(const EcsChunk&)>& fn) {
+    if (!pool || pool->size() == 1) {
+        world.forEachChunk(with, without, fn);
+        return;
+    }
+    const std::vector<EcsChunk>& chunks = world.cachedChunks(with, without);
+    pool->parallelFor(chunks.size(), [&](size_t index, unsigned) { fn(chunks[index]); });
+}
+
+// --- SystemScheduler ---
+
+void SystemScheduler::addSystem(const std::string& name, ComponentMask reads, ComponentMask writes, SystemFn run) {
+    System system{ name, reads, writes, std::move(run), 0 };
+    for (const System& earlier : systems) {
+        bool conflicts = (earlier.writes & (reads | writes)) != 0 || (writes & earlier.reads) != 0;
+        if (conflicts) system.stage = std::max(system.stage, earlier.stage + 1);
+    }
+    if (system.stage >= stages.size()) stages.resize(system.stage + 1);
+    stages[system.stage].push_back(systems.size());
+    systems.push_back(std::move(system));
+}
+
+void SystemScheduler::runSystem(System& system, ThreadPool* pool) {
+    auto start = std::chrono::steady_clock::now();
+    system.run(pool);
+    system.totalMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void SystemScheduler::run(ThreadPool* pool) {
+    for (const std::vector<size_t>& stage : stages) {
+        if (stage.size() == 1) {
+            runSystem(systems[stage[0]], pool);
+        } else if (pool) {
+            pool->parallelFor(stage.size(), [&](size_t index, unsigned) { runSystem(systems[stage[index]], nullptr); });
+        } else {
+            for (size_t system : stage) runSystem(systems[system], nullptr);
+        }
+    }
+}
+
+std::string SystemScheduler::describe() const {
+    std::string text;
+    for (const std::vector<size_t>& stage : stages) {
+        if (!text.empty()) text += ' ';
+        text += '[';
+        for (size_t i = 0; i < stage.size(); ++i) {
+            if (i > 0) text += ' ';
+            text += systems[stage[i]].name;
+        }
+        text += ']';
+    }
+    return text;
+}
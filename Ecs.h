@@ -0,0 +1,295 @@
+#ifndef ECS_H
+#define ECS_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+class ThreadPool;
+
+// Entity-component system por arquétipos.
+// Cada combinação de componentes (arquétipo) guarda suas entidades em chunks de
+// CHUNK_BYTES: dentro do chunk, uma coluna contígua por componente (SoA), então
+// um sistema que lê só Transform e Motion percorre só essas duas colunas.
+// Componentes são structs trivialmente copiáveis: mudar uma entidade de
+// arquétipo (add/remove) e o swap-remove do destroy são memcpy.
+// Componentes e recursos (tipos-marcador, como o gerador aleatório) usam a mesma
+// numeração, então um sistema declara o que lê e escreve com uma máscara só.
+
+using ComponentMask = uint64_t;
+const int MAX_COMPONENTS = 64;
+
+struct ComponentInfo {
+    size_t size;
+    size_t align;
+};
+
+// Tipos registrados, na ordem do primeiro componentId<T>()
+std::vector<ComponentInfo>& componentRegistry();
+
+// Id do componente (ou recurso) T. O registro não é protegido por mutex: registre
+// todos os tipos (ex.: com componentMask) antes de rodar sistemas em paralelo.
+template <typename T>
+int componentId() {
+    static_assert(std::is_trivially_copyable<T>::value, "componentes são movidos com memcpy");
+    static const int id = [] {
+        std::vector<ComponentInfo>& registry = componentRegistry();
+        registry.push_back({ sizeof(T), alignof(T) });
+        assert(registry.size() <= MAX_COMPONENTS);
+        return static_cast<int>(registry.size() - 1);
+    }();
+    return id;
+}
+
+template <typename... Ts>
+ComponentMask componentMask() {
+    return (ComponentMask(0) | ... | (ComponentMask(1) << componentId<Ts>()));
+}
+
+// Referência a uma entidade; como no Pool, a geração invalida handles antigos
+struct Entity {
+    static const uint32_t INVALID_INDEX = 0xFFFFFFFFu;
+
+    uint32_t index = INVALID_INDEX;
+    uint32_t generation = 0;
+
+    bool isValid() const { return index != INVALID_INDEX; }
+    bool operator==(const Entity& other) const { return index == other.index && generation == other.generation; }
+    bool operator!=(const Entity& other) const { return !(*this == other); }
+};
+
+// Entidades com a mesma combinação de componentes. As linhas ficam compactadas:
+// todos os chunks cheios menos o último, então a linha r está no chunk
+// r / capacity, posição r % capacity.
+struct Archetype {
+    static constexpr size_t CHUNK_BYTES = 16 * 1024;
+    static constexpr size_t NO_COLUMN = ~size_t(0);
+
+    explicit Archetype(ComponentMask mask);
+    ~Archetype();
+
+    Archetype(const Archetype&) = delete;
+    Archetype& operator=(const Archetype&) = delete;
+
+    bool has(int id) const { return (mask >> id) & 1; }
+    unsigned char* chunkOf(uint32_t row) const { return chunks[row / capacity]; }
+    void* component(uint32_t row, int id) const {
+        return chunkOf(row) + columnOffset[id] + static_cast<size_t>(row % capacity) * columnSize[id];
+    }
+    Entity& entity(uint32_t row) const {
+        return reinterpret_cast<Entity*>(chunkOf(row) + entityOffset)[row % capacity];
+    }
+
+    uint32_t push(Entity entity); // Nova linha no fim (componentes sem inicializar)
+    void pop();                   // Descarta a última linha (libera o chunk se ele esvaziou)
+    void copyRow(uint32_t from, uint32_t to); // Todas as colunas, e a entidade
+
+    ComponentMask mask;
+    std::vector<int> components; // Ids em ordem crescente
+    size_t columnOffset[MAX_COMPONENTS]; // NO_COLUMN para os ausentes
+    size_t columnSize[MAX_COMPONENTS];
+    size_t entityOffset = 0;
+    uint32_t capacity = 0;       // Linhas por chunk
+    size_t chunkBytes = CHUNK_BYTES;
+    uint32_t size = 0;
+    std::vector<unsigned char*> chunks;
+};
+
+// Visão de um chunk para os sistemas: colunas de 'size()' elementos
+class EcsChunk {
+public:
+    uint32_t size() const { return count; }
+    const Entity* entities() const { return reinterpret_cast<const Entity*>(memory + archetype->entityOffset); }
+    ComponentMask mask() const { return archetype->mask; }
+
+    // nullptr se o arquétipo não tem T (componentes opcionais)
+    template <typename T>
+    T* column() const {
+        int id = componentId<T>();
+        return archetype->has(id) ? reinterpret_cast<T*>(memory + archetype->columnOffset[id]) : nullptr;
+    }
+    template <typename T>
+    bool has() const { return archetype->has(componentId<T>()); }
+
+private:
+    friend class EcsWorld;
+    const Archetype* archetype = nullptr;
+    unsigned char* memory = nullptr;
+    uint32_t count = 0;
+};
+
+class EcsWorld {
+public:
+    EcsWorld() = default;
+    EcsWorld(const EcsWorld&) = delete;
+    EcsWorld& operator=(const EcsWorld&) = delete;
+
+    template <typename... Ts>
+    Entity create(const Ts&... components) {
+        ComponentMask mask = componentMask<Ts...>();
+        uint32_t archetype = archetypeFor(mask);
+        Entity entity = allocateEntity();
+        uint32_t row = archetypes[archetype]->push(entity);
+        ++structureVersion;
+        locations[entity.index].archetype = archetype;
+        locations[entity.index].row = row;
+        (std::memcpy(archetypes[archetype]->component(row, componentId<Ts>()), &components, sizeof(Ts)), ...);
+        return entity;
+    }
+
+    void destroy(Entity entity); // Ignora entidades que já não existem
+    bool alive(Entity entity) const {
+        return entity.index < locations.size() && locations[entity.index].alive &&
+               locations[entity.index].generation == entity.generation;
+    }
+
+    // nullptr se a entidade não existe ou não tem T. O ponteiro vale até a próxima mudança estrutural.
+    template <typename T>
+    T* get(Entity entity) const {
+        if (!alive(entity)) return nullptr;
+        const Location& location = locations[entity.index];
+        const Archetype& archetype = *archetypes[location.archetype];
+        int id = componentId<T>();
+        return archetype.has(id) ? static_cast<T*>(archetype.component(location.row, id)) : nullptr;
+    }
+    template <typename T>
+    bool has(Entity entity) const { return get<T>(entity) != nullptr; }
+
+    // Acrescenta T (ou só atribui, se já tem): a entidade muda de arquétipo
+    template <typename T>
+    void add(Entity entity, const T& component) {
+        if (!alive(entity)) return;
+        int id = componentId<T>();
+        if (!archetypes[locations[entity.index].archetype]->has(id)) {
+            move(entity, archetypes[locations[entity.index].archetype]->mask | (ComponentMask(1) << id));
+        }
+        *get<T>(entity) = component;
+    }
+    template <typename T>
+    void remove(Entity entity) {
+        if (!alive(entity)) return;
+        int id = componentId<T>();
+        if (archetypes[locations[entity.index].archetype]->has(id)) {
+            move(entity, archetypes[locations[entity.index].archetype]->mask & ~(ComponentMask(1) << id));
+        }
+    }
+
+    // Chunks dos arquétipos com todos os componentes de 'with' e nenhum de 'without'.
+    // Sem mudanças estruturais (create/destroy/add/remove) enquanto os chunks são usados.
+    void collectChunks(ComponentMask with, ComponentMask without, std::vector<EcsChunk>& chunks) const;
+    // A mesma lista guardada por consulta e refeita só depois de uma mudança estrutural, para
+    // quem percorre os mesmos chunks todo tick sem alocar. Vale até a próxima mudança
+    // estrutural ou consulta nova; só a thread principal chama.
+    const std::vector<EcsChunk>& cachedChunks(ComponentMask with, ComponentMask without) const;
+
+    template <typename Fn>
+    void forEachChunk(ComponentMask with, ComponentMask without, Fn&& fn) const {
+        for (const std::unique_ptr<Archetype>& archetype : archetypes) {
+            if ((archetype->mask & with) != with || (archetype->mask & without) != 0) continue;
+            for (uint32_t first = 0; first < archetype->size; first += archetype->capacity) {
+                EcsChunk chunk;
+                chunk.archetype = archetype.get();
+                chunk.memory = archetype->chunkOf(first);
+                chunk.count = std::min(archetype->capacity, archetype->size - first);
+                fn(chunk);
+            }
+        }
+    }
+
+    // fn(Entity, Ts&...) para cada entidade com todos os Ts
+    template <typename... Ts, typename Fn>
+    void forEach(Fn&& fn, ComponentMask without = 0) const {
+        forEachChunk(componentMask<Ts...>(), without, [&](const EcsChunk& chunk) {
+            const Entity* entities = chunk.entities();
+            std::tuple<Ts*...> columns(chunk.column<Ts>()...);
+            for (uint32_t i = 0; i < chunk.size(); ++i) fn(entities[i], std::get<Ts*>(columns)[i]...);
+        });
+    }
+
+    void clear();
+
+    size_t size() const { return liveCount; }
+    size_t archetypeCount() const { return archetypes.size(); }
+    size_t chunkCount() const;
+    size_t memoryBytes() const; // Chunks + tabela de entidades
+
+private:
+    struct Location {
+        uint32_t archetype = 0;
+        uint32_t row = 0;
+        uint32_t generation = 0;
+        bool alive = false;
+    };
+
+    uint32_t archetypeFor(ComponentMask mask);
+    Entity allocateEntity();
+    void removeRow(uint32_t archetype, uint32_t row); // Swap-remove: a última linha ocupa o buraco
+    void move(Entity entity, ComponentMask mask);
+
+    std::vector<std::unique_ptr<Archetype>> archetypes;
+    std::unordered_map<ComponentMask, uint32_t> archetypeIndex;
+    std::vector<Location> locations; // Por índice de entidade
+    std::vector<uint32_t> freeEntities;
+    size_t liveCount = 0;
+
+    struct ChunkQuery {
+        ComponentMask with;
+        ComponentMask without;
+        uint64_t version;
+        std::vector<EcsChunk> chunks;
+    };
+    uint64_t structureVersion = 0; // Avança a cada create/destroy/add/remove/clear
+    mutable std::vector<ChunkQuery> chunkQueries;
+};
+
+// Chama fn(chunk) para cada chunk; com pool, os chunks são divididos entre os workers
+void parallelForChunks(const EcsWorld& world, ComponentMask with, ComponentMask without, ThreadPool* pool,
+                       const std::function<void(const EcsChunk&)>& fn);
+
+// Sistemas com conjuntos de leitura/escrita declarados. Dois sistemas conflitam se
+// um escreve algo que o outro lê ou escreve; addSystem põe cada sistema no primeiro
+// estágio depois de todos os anteriores com que conflita, então a ordem de
+// declaração vale entre os que conflitam e o resto roda junto. run() executa os
+// estágios em ordem e os sistemas de um estágio em paralelo no ThreadPool.
+// Um sistema que fica sozinho no estágio recebe o pool para dividir o próprio
+// trabalho (parallelForChunks); nos outros casos recebe nullptr (o ThreadPool não
+// aninha parallelFor).
+class SystemScheduler {
+public:
+    using SystemFn = std::function<void(ThreadPool* pool)>;
+
+    void addSystem(const std::string& name, ComponentMask reads, ComponentMask writes, SystemFn run);
+    void run(ThreadPool* pool); // pool nulo: tudo em sequência, na ordem dos estágios
+
+    size_t stageCount() const { return stages.size(); }
+    std::string describe() const; // "[a] [b c] [d]": um colchete por estágio
+    double systemMs(size_t system) const { return systems[system].totalMs; } // Acumulado desde o início
+    const std::string& systemName(size_t system) const { return systems[system].name; }
+    size_t systemCount() const { return systems.size(); }
+
+private:
+    struct System {
+        std::string name;
+        ComponentMask reads;
+        ComponentMask writes;
+        SystemFn run;
+        size_t stage;
+        double totalMs = 0.0;
+    };
+
+    void runSystem(System& system, ThreadPool* pool);
+
+    std::vector<System> systems;
+    std::vector<std::vector<size_t>> stages;
+};
+
+#endif // ECS_H
@@ -0,0 +1,200 @@
+#include "Flocking.h"
+#include "AdventureCharacters.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define FLOCKING_SSE2 1
+#endif
+
+Flocking flocking;
+
+namespace {
+const int MAX_GRID_SIDE = 64;   // Far-off flyers share the border cells (still correct, just slower)
+const size_t SIMD_PADDING = 3;  // Extra slots so 4-wide loads never read past the arrays
+const float FAR_AWAY = 1e9f;
+
+#ifdef FLOCKING_SSE2
+float horizontalSum(__m128 v) {
+    __m128 shuffled = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1));
+    __m128 sums = _mm_add_ps(v, shuffled);
+    shuffled = _mm_movehl_ps(shuffled, sums);
+    return _mm_cvtss_f32(_mm_add_ss(sums, shuffled));
+}
+#endif
+}
+
+Flocking::Grid::Grid(LinearArena& arena)
+    : flyers(arena), cellOf(arena), cellStart(arena), xSorted(arena), ySorted(arena), zSorted(arena),
+      vxSorted(arena), vySorted(arena), vzSorted(arena), sortedFlyer(arena) {}
+
+void Flocking::update(const std::vector<Character*>& characters) {
+    Grid grid(frameArena.current());
+    FrameVector<Character*>& flyers = grid.flyers;
+    flyers.reserve(characters.size()); // Growing in the arena would leave every old block behind
+    for (Character* character : characters) {
+        if (character->isNPC && !character->isUnderPlayerControl && isFlyer(character)) flyers.push_back(character);
+    }
+    ++stats.ticks;
+    if (flyers.empty()) return;
+    stats.flyers += flyers.size();
+
+    buildGrid(grid);
+
+    for (size_t i = 0; i < flyers.size(); ++i) {
+        glm::vec3 separation(0.0f), velocitySum(0.0f), positionSum(0.0f);
+        int count = 0;
+        steer(grid, i, separation, velocitySum, positionSum, count);
+
+        glm::vec3 steering(0.0f);
+        if (count > 0) {
+            glm::vec3 position(grid.xSorted[i], grid.ySorted[i], grid.zSorted[i]);
+            steering += separationWeight * separation;
+            glm::vec3 meanVelocity = velocitySum / static_cast<float>(count);
+            float speed = glm::length(meanVelocity);
+            if (speed > 1e-4f) steering += alignmentWeight * (meanVelocity / speed);
+            glm::vec3 toCenter = positionSum / static_cast<float>(count) - position;
+            steering += cohesionWeight * (toCenter / neighborRadius); // 0..1 inside the neighbourhood
+            stats.neighbors += static_cast<size_t>(count);
+        }
+        flyers[grid.sortedFlyer[i]]->flockSteering = steering;
+    }
+}
+
+glm::vec3 Flocking::blend(glm::vec3 wanderDirection, glm::vec3 steering) const {
+    glm::vec3 desired = wanderDirection * wanderWeight + steering;
+    float length = glm::length(desired);
+    return length > 1e-4f ? desired / length : wanderDirection;
+}
+
+void Flocking::buildGrid(Grid& grid) {
+    size_t count = grid.flyers.size();
+    glm::vec3 lower(FAR_AWAY), upper(-FAR_AWAY);
+    for (const Character* flyer : grid.flyers) {
+        lower = glm::min(lower, flyer->position);
+        upper = glm::max(upper, flyer->position);
+    }
+    grid.origin = lower;
+    glm::vec3 extent = upper - lower;
+    for (int axis = 0; axis < 3; ++axis) {
+        grid.size[axis] = std::clamp(static_cast<int>(extent[axis] / neighborRadius) + 1, 1, MAX_GRID_SIDE);
+    }
+    size_t cellCount = static_cast<size_t>(grid.size[0]) * grid.size[1] * grid.size[2];
+
+    // Counting sort by cell; stable, so the order (and the float sums) only depend on the input order
+    grid.cellOf.resize(count);
+    grid.cellStart.assign(cellCount + 1, 0);
+    for (size_t i = 0; i < count; ++i) {
+        glm::vec3 local = (grid.flyers[i]->position - grid.origin) / neighborRadius;
+        int cx = std::min(static_cast<int>(local.x), grid.size[0] - 1);
+        int cy = std::min(static_cast<int>(local.y), grid.size[1] - 1);
+        int cz = std::min(static_cast<int>(local.z), grid.size[2] - 1);
+        grid.cellOf[i] = static_cast<uint32_t>((cz * grid.size[1] + cy) * grid.size[0] + cx);
+        ++grid.cellStart[grid.cellOf[i] + 1];
+    }
+    for (size_t c = 0; c < cellCount; ++c) grid.cellStart[c + 1] += grid.cellStart[c];
+
+    size_t padded = count + SIMD_PADDING;
+    for (FrameVector<float>* column : { &grid.xSorted, &grid.ySorted, &grid.zSorted, &grid.vxSorted, &grid.vySorted, &grid.vzSorted }) {
+        column->assign(padded, 0.0f);
+    }
+    std::fill(grid.xSorted.begin() + count, grid.xSorted.end(), FAR_AWAY);
+    grid.sortedFlyer.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t slot = grid.cellStart[grid.cellOf[i]]++;
+        const Character* flyer = grid.flyers[i];
+        grid.xSorted[slot] = flyer->position.x;
+        grid.ySorted[slot] = flyer->position.y;
+        grid.zSorted[slot] = flyer->position.z;
+        grid.vxSorted[slot] = flyer->velocity.x;
+        grid.vySorted[slot] = flyer->velocity.y;
+        grid.vzSorted[slot] = flyer->velocity.z;
+        grid.sortedFlyer[slot] = static_cast<uint32_t>(i);
+    }
+    // The scatter advanced each start to the next cell's start: shift back
+    for (size_t c = cellCount; c > 0; --c) grid.cellStart[c] = grid.cellStart[c - 1];
+    grid.cellStart[0] = 0;
+}
+
+void Flocking::steer(const Grid& grid, size_t i, glm::vec3& separation, glm::vec3& velocitySum, glm::vec3& positionSum, int& count) {
+    glm::vec3 position(grid.xSorted[i], grid.ySorted[i], grid.zSorted[i]);
+    glm::vec3 local = (position - grid.origin) / neighborRadius;
+    int cx = std::min(static_cast<int>(local.x), grid.size[0] - 1);
+    int cy = std::min(static_cast<int>(local.y), grid.size[1] - 1);
+    int cz = std::min(static_cast<int>(local.z), grid.size[2] - 1);
+    float radius2 = neighborRadius * neighborRadius;
+    float separation2 = separationRadius * separationRadius;
+
+#ifdef FLOCKING_SSE2
+    const __m128 px = _mm_set1_ps(position.x), py = _mm_set1_ps(position.y), pz = _mm_set1_ps(position.z);
+    const __m128 r2 = _mm_set1_ps(radius2), s2 = _mm_set1_ps(separation2);
+    const __m128 zero = _mm_setzero_ps(), one = _mm_set1_ps(1.0f);
+    const __m128 laneIndex = _mm_set_ps(3.0f, 2.0f, 1.0f, 0.0f);
+    __m128 sepX = zero, sepY = zero, sepZ = zero, velX = zero, velY = zero, velZ = zero;
+    __m128 posX = zero, posY = zero, posZ = zero, found = zero;
+#endif
+
+    // The flyer's own row first, then the other 8, until maxNeighbors are found
+    static const int ROW_ORDER[9][2] = { { 0, 0 }, { -1, 0 }, { 1, 0 }, { 0, -1 }, { 0, 1 }, { -1, -1 }, { 1, -1 }, { -1, 1 }, { 1, 1 } };
+    for (const int* offset : ROW_ORDER) {
+        int y = cy + offset[0], z = cz + offset[1];
+        if (y < 0 || z < 0 || y >= grid.size[1] || z >= grid.size[2]) continue;
+        // Cells x-1..x+1 of this row are contiguous after the sort
+        int row = (z * grid.size[1] + y) * grid.size[0];
+        uint32_t begin = grid.cellStart[row + std::max(cx - 1, 0)];
+        uint32_t end = grid.cellStart[row + std::min(cx + 1, grid.size[0] - 1) + 1];
+        stats.candidates += end - begin;
+
+#ifdef FLOCKING_SSE2
+        for (uint32_t j = begin; j < end; j += 4) {
+            __m128 dx = _mm_sub_ps(px, _mm_loadu_ps(&grid.xSorted[j]));
+            __m128 dy = _mm_sub_ps(py, _mm_loadu_ps(&grid.ySorted[j]));
+            __m128 dz = _mm_sub_ps(pz, _mm_loadu_ps(&grid.zSorted[j]));
+            __m128 d2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+            // Lanes past 'end' belong to the next row's cells: mask them out
+            __m128 inRange = _mm_cmplt_ps(laneIndex, _mm_set1_ps(static_cast<float>(end - j)));
+            __m128 near = _mm_and_ps(inRange, _mm_and_ps(_mm_cmplt_ps(d2, r2), _mm_cmpgt_ps(d2, zero))); // d2 == 0: itself
+            found = _mm_add_ps(found, _mm_and_ps(near, one));
+            velX = _mm_add_ps(velX, _mm_and_ps(near, _mm_loadu_ps(&grid.vxSorted[j])));
+            velY = _mm_add_ps(velY, _mm_and_ps(near, _mm_loadu_ps(&grid.vySorted[j])));
+            velZ = _mm_add_ps(velZ, _mm_and_ps(near, _mm_loadu_ps(&grid.vzSorted[j])));
+            posX = _mm_add_ps(posX, _mm_and_ps(near, _mm_loadu_ps(&grid.xSorted[j])));
+            posY = _mm_add_ps(posY, _mm_and_ps(near, _mm_loadu_ps(&grid.ySorted[j])));
+            posZ = _mm_add_ps(posZ, _mm_and_ps(near, _mm_loadu_ps(&grid.zSorted[j])));
+            // Push away with strength 1/distance: d / d^2 (masked lanes may hold inf/NaN, the AND clears them)
+            __m128 tooClose = _mm_and_ps(near, _mm_cmplt_ps(d2, s2));
+            __m128 inverse = _mm_div_ps(one, d2);
+            sepX = _mm_add_ps(sepX, _mm_and_ps(tooClose, _mm_mul_ps(dx, inverse)));
+            sepY = _mm_add_ps(sepY, _mm_and_ps(tooClose, _mm_mul_ps(dy, inverse)));
+            sepZ = _mm_add_ps(sepZ, _mm_and_ps(tooClose, _mm_mul_ps(dz, inverse)));
+        }
+        if (horizontalSum(found) >= maxNeighbors) break;
+#else
+        for (uint32_t j = begin; j < end; ++j) {
+            glm::vec3 offset = position - glm::vec3(grid.xSorted[j], grid.ySorted[j], grid.zSorted[j]);
+            float d2 = glm::dot(offset, offset);
+            if (d2 >= radius2 || d2 <= 0.0f) continue;
+            ++count;
+            velocitySum += glm::vec3(grid.vxSorted[j], grid.vySorted[j], grid.vzSorted[j]);
+            positionSum += glm::vec3(grid.xSorted[j], grid.ySorted[j], grid.zSorted[j]);
+            if (d2 < separation2) separation += offset / d2;
+        }
+        if (count >= maxNeighbors) break;
+#endif
+    }
+
+#ifdef FLOCKING_SSE2
+    count = static_cast<int>(horizontalSum(found));
+    separation = glm::vec3(horizontalSum(sepX), horizontalSum(sepY), horizontalSum(sepZ));
+    velocitySum = glm::vec3(horizontalSum(velX), horizontalSum(velY), horizontalSum(velZ));
+    positionSum = glm::vec3(horizontalSum(posX), horizontalSum(posY), horizontalSum(posZ));
+#endif
+}
+
+void parseFlockingOptions(int argc, char** argv) {
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--flock") == 0) flocking.enabled = true;
+    }
+}
@@ -0,0 +1,67 @@
+#ifndef FLOCKING_H
+#define FLOCKING_H
+
+#include "FrameArena.h"
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class Character;
+
+// Flocking for the flying NPCs (IceKing, Marceline). Once per tick, before the characters
+// update, every wandering flyer gets a steering vector from the flyers within
+// neighborRadius: separation (away from the ones that are too close), alignment (their
+// mean velocity) and cohesion (towards their centre). updateNPCWander blends it with the
+// direction to the wander target. Neighbours come from a uniform 3D grid rebuilt each tick
+// with a counting sort, so each flyer only tests the 27 cells around it, nearest rows first,
+// and stops at maxNeighbors; the test runs 4 neighbours at a time with SSE2 when available.
+// Off by default (--flock).
+struct Flocking {
+    bool enabled = false;
+    float neighborRadius = 3.0f;   // Grid cell size as well
+    float separationRadius = 1.2f;
+    float separationWeight = 1.5f;
+    float alignmentWeight = 0.6f;
+    float cohesionWeight = 0.4f;
+    float wanderWeight = 1.0f;     // Weight of the wander target direction in the blend
+    int maxNeighbors = 24;         // Stop searching once this many are found (dense flocks stay linear)
+
+    struct Stats {
+        size_t ticks = 0;
+        size_t flyers = 0;     // Flyers steered, summed over ticks
+        size_t candidates = 0; // Pairs tested against neighborRadius
+        size_t neighbors = 0;  // Pairs within neighborRadius
+    };
+    Stats stats;
+
+    // Writes Character::flockSteering for every flyer that wanders on its own this tick
+    void update(const std::vector<Character*>& characters);
+    // Direction for a flyer: its wander direction blended with its steering
+    glm::vec3 blend(glm::vec3 wanderDirection, glm::vec3 steering) const;
+
+private:
+    // Rebuilt each tick in frameArena.current(). Flyers are sorted by grid cell (x fastest),
+    // so the three cells of a row in x are one contiguous range of the *Sorted arrays.
+    struct Grid {
+        explicit Grid(LinearArena& arena);
+
+        FrameVector<Character*> flyers;
+        FrameVector<uint32_t> cellOf;
+        FrameVector<uint32_t> cellStart; // Prefix sums; cell c is [cellStart[c], cellStart[c + 1])
+        FrameVector<float> xSorted, ySorted, zSorted, vxSorted, vySorted, vzSorted;
+        FrameVector<uint32_t> sortedFlyer; // Index into flyers
+        glm::vec3 origin = glm::vec3(0.0f);
+        int size[3] = { 0, 0, 0 };
+    };
+
+    void buildGrid(Grid& grid);
+    void steer(const Grid& grid, size_t sortedIndex, glm::vec3& separation, glm::vec3& velocitySum, glm::vec3& positionSum, int& count);
+};
+
+extern Flocking flocking;
+
+// --flock   flying NPCs flock (separation/alignment/cohesion)
+void parseFlockingOptions(int argc, char** argv);
+
+#endif // FLOCKING_H
@@ -0,0 +1,242 @@
+#include "Formation.h"
+#include "AdventureCharacters.h"
+#include "FrameArena.h"
+#include <glm/gtc/constants.hpp>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+FormationSystem formations;
+
+namespace {
+const int INDEX_BITS = 16; // Group id = generation << INDEX_BITS | index
+const int INDEX_MASK = (1 << INDEX_BITS) - 1;
+const float SLOT_TOLERANCE = 0.5f; // Followers closer than this to their slot stand still
+}
+
+FormationSystem::Group* FormationSystem::find(int group) {
+    return const_cast<Group*>(static_cast<const FormationSystem*>(this)->find(group));
+}
+
+const FormationSystem::Group* FormationSystem::find(int group) const {
+    if (group < 0) return nullptr;
+    size_t index = static_cast<size_t>(group & INDEX_MASK);
+    if (index >= groups.size()) return nullptr;
+    const Group& candidate = groups[index];
+    if (!candidate.active || candidate.generation != static_cast<uint16_t>(group >> INDEX_BITS)) return nullptr;
+    return &candidate;
+}
+
+int FormationSystem::createGroup(Character* leader, FormationShape shape, float spacing, float speedMultiplier) {
+    int index;
+    if (!freeGroups.empty()) {
+        index = freeGroups.back();
+        freeGroups.pop_back();
+    } else {
+        index = static_cast<int>(groups.size());
+        groups.emplace_back();
+    }
+    Group& group = groups[index];
+    group.active = true;
+    group.leader = leader;
+    group.shape = shape;
+    group.spacing = spacing;
+    group.speedMultiplier = speedMultiplier;
+    ++activeGroups;
+    return (static_cast<int>(group.generation) << INDEX_BITS) | index;
+}
+
+void FormationSystem::disband(int id) {
+    Group* group = find(id);
+    if (!group) return;
+    for (Character* follower : group->followers) follower->formationGroup = -1;
+    group->followers.clear();
+    group->slots.clear();
+    group->leader = nullptr;
+    group->active = false;
+    group->generation = (group->generation + 1) & 0x7FFF; // Keeps ids positive
+    freeGroups.push_back(id & INDEX_MASK);
+    --activeGroups;
+}
+
+bool FormationSystem::isActive(int group) const {
+    return find(group) != nullptr;
+}
+
+void FormationSystem::setLeader(int id, Character* leader) {
+    Group* group = find(id);
+    if (!group || group->leader == leader) return;
+    if (leader->formationGroup == id) leave(leader);
+    group->leader = leader;
+}
+
+Character* FormationSystem::leader(int id) const {
+    const Group* group = find(id);
+    return group ? group->leader : nullptr;
+}
+
+size_t FormationSystem::followerCount(int id) const {
+    const Group* group = find(id);
+    return group ? group->followers.size() : 0;
+}
+
+void FormationSystem::join(int id, Character* follower) {
+    Group* group = find(id);
+    if (!group || follower == group->leader || follower->formationGroup == id) return;
+    leave(follower);
+    follower->formationGroup = id;
+    follower->formationSlot = static_cast<uint32_t>(group->followers.size());
+    group->followers.push_back(follower);
+    group->slotsDirty = true;
+}
+
+void FormationSystem::leave(Character* follower) {
+    Group* group = find(follower->formationGroup);
+    follower->formationGroup = -1;
+    if (!group) return;
+    // Swap-remove: the last follower takes the freed slot
+    uint32_t slot = follower->formationSlot;
+    Character* last = group->followers.back();
+    group->followers[slot] = last;
+    last->formationSlot = slot;
+    group->followers.pop_back();
+    group->slotsDirty = true;
+}
+
+void FormationSystem::forget(Character* character) {
+    if (character->formationGroup >= 0) leave(character);
+    if (activeGroups == 0) return;
+    for (size_t i = 0; i < groups.size(); ++i) {
+        if (groups[i].active && groups[i].leader == character) {
+            disband((static_cast<int>(groups[i].generation) << INDEX_BITS) | static_cast<int>(i));
+        }
+    }
+}
+
+void FormationSystem::forEachGroup(const std::function<void(int, Character*, FormationShape, float, float)>& fn) const {
+    for (size_t i = 0; i < groups.size(); ++i) {
+        const Group& group = groups[i];
+        if (group.active) fn((static_cast<int>(group.generation) << INDEX_BITS) | static_cast<int>(i), group.leader, group.shape, group.spacing, group.speedMultiplier);
+    }
+}
+
+void FormationSystem::clear() {
+    for (size_t i = 0; i < groups.size(); ++i) {
+        if (groups[i].active) disband((static_cast<int>(groups[i].generation) << INDEX_BITS) | static_cast<int>(i));
+    }
+    // Lowest slots first again: groups created after clear() are stored in creation order
+    std::sort(freeGroups.begin(), freeGroups.end(), std::greater<int>());
+}
+
+void FormationSystem::layoutSlots(Group& group) {
+    size_t count = group.followers.size();
+    float spacing = group.spacing;
+    group.slots.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        glm::vec3& slot = group.slots[i];
+        switch (group.shape) {
+            case FormationShape::Line:
+                slot = glm::vec3(0.0f, 0.0f, -spacing * (i + 1));
+                break;
+            case FormationShape::Wedge: {
+                float rank = static_cast<float>(i / 2 + 1);
+                float side = i % 2 == 0 ? -1.0f : 1.0f;
+                slot = glm::vec3(side * rank * spacing, 0.0f, -rank * spacing);
+                break;
+            }
+            case FormationShape::Ring: {
+                // Circumference grows with the group so neighbours stay 'spacing' apart
+                float radius = std::max(spacing, spacing * count / (2.0f * glm::pi<float>()));
+                float angle = 2.0f * glm::pi<float>() * i / count;
+                slot = glm::vec3(std::sin(angle) * radius, 0.0f, std::cos(angle) * radius);
+                break;
+            }
+            default:
+                slot = glm::vec3(0.0f); // Trail: computed from the bearing each tick
+                break;
+        }
+    }
+    group.slotsDirty = false;
+}
+
+void FormationSystem::update(float deltaTime) {
+    if (activeGroups == 0) return;
+    for (Group& group : groups) {
+        if (group.active && group.leader && !group.followers.empty()) solve(group, deltaTime);
+    }
+}
+
+void FormationSystem::solve(Group& group, float deltaTime) {
+    if (group.slotsDirty) layoutSlots(group);
+    size_t count = group.followers.size();
+    const float keepHeight = std::numeric_limits<float>::quiet_NaN();
+    // Scratch for this pass, from the frame arena
+    LinearArena& arena = frameArena.current();
+    FrameVector<glm::vec3> positions(count, glm::vec3(0.0f), arena);
+    FrameVector<float> speeds(count, 0.0f, arena);
+    FrameVector<float> groundHeights(count, keepHeight, arena); // NaN: keep the height (flyers, jumping)
+    FrameVector<float> rotations(count, 0.0f, arena);
+    FrameVector<uint8_t> moving(count, 0, arena);
+
+    // Gather
+    for (size_t i = 0; i < count; ++i) {
+        Character* follower = group.followers[i];
+        positions[i] = follower->position;
+        speeds[i] = follower->speed * group.speedMultiplier;
+        rotations[i] = follower->rotation;
+        moving[i] = 0;
+        float ground = keepHeight;
+        if (!follower->isJumping) {
+            CharacterType type = characterType(follower);
+            if (type == CHARACTER_JAKE) ground = static_cast<Jake*>(follower)->getEffectiveGroundHeight();
+            else if (type != CHARACTER_ICE_KING && type != CHARACTER_MARCELINE) ground = follower->groundHeight;
+        }
+        groundHeights[i] = ground;
+    }
+
+    // Solve
+    glm::vec3 leaderPosition = group.leader->position;
+    float spacing = group.spacing;
+    if (group.shape == FormationShape::Trail) {
+        for (size_t i = 0; i < count; ++i) {
+            glm::vec3 toLeader = leaderPosition - positions[i];
+            if (glm::length(toLeader) <= spacing) continue;
+            glm::vec3 moveDir = glm::normalize(toLeader);
+            rotations[i] = atan2(moveDir.x, moveDir.z); // Face the leader
+            glm::vec3 target = leaderPosition - moveDir * spacing;
+            glm::vec3 toTarget = target - positions[i];
+            if (glm::length(toTarget) <= SLOT_TOLERANCE) continue;
+            positions[i] += glm::normalize(toTarget) * speeds[i] * deltaTime;
+            moving[i] = 1;
+            if (!std::isnan(groundHeights[i])) positions[i].y = groundHeights[i];
+        }
+    } else {
+        float heading = group.leader->rotation;
+        glm::vec3 forward(std::sin(heading), 0.0f, std::cos(heading));
+        glm::vec3 right(-std::cos(heading), 0.0f, std::sin(heading));
+        for (size_t i = 0; i < count; ++i) {
+            const glm::vec3& slot = group.slots[i];
+            glm::vec3 toTarget = leaderPosition + right * slot.x + forward * slot.z - positions[i];
+            toTarget.y = 0.0f; // Slots are on the ground plane; flyers keep their height
+            float distance = glm::length(toTarget);
+            if (distance <= SLOT_TOLERANCE) {
+                rotations[i] = heading;
+                continue;
+            }
+            glm::vec3 moveDir = toTarget / distance;
+            positions[i] += moveDir * std::min(speeds[i] * deltaTime, distance);
+            rotations[i] = atan2(moveDir.x, moveDir.z);
+            moving[i] = 1;
+            if (!std::isnan(groundHeights[i])) positions[i].y = groundHeights[i];
+        }
+    }
+
+    // Scatter (the player keeps a controlled follower)
+    for (size_t i = 0; i < count; ++i) {
+        Character* follower = group.followers[i];
+        if (follower->isUnderPlayerControl) continue;
+        follower->position = positions[i];
+        follower->rotation = rotations[i];
+        follower->moving = moving[i] != 0;
+    }
+}
@@ -0,0 +1,74 @@
+#ifndef FORMATION_H
+#define FORMATION_H
+
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+class Character;
+
+// Leader/follower groups for the Adventure Time scene. Any character can lead a group of
+// followers that keep to slots around it:
+//   Trail  each follower heads for the point 'spacing' short of the leader, on its own
+//          bearing (the original Finn/Jake follow)
+//   Line   single file behind the leader
+//   Wedge  a V behind the leader, alternating sides
+//   Ring   evenly spaced on a circle around the leader
+// Slots are offsets in the leader's frame (x right, z forward), recomputed only when the
+// membership changes. Followers do not wander. Each tick update() runs one pass per group
+// over the group's contiguous arrays: gather the follower positions, solve every move,
+// scatter the results back; types are looked at only while gathering, and the solve loop
+// has no virtual calls.
+// Group ids carry a generation, so an id kept after disband() stays inactive even when
+// its slot is reused.
+enum class FormationShape { Trail, Line, Wedge, Ring };
+
+class FormationSystem {
+public:
+    int createGroup(Character* leader, FormationShape shape, float spacing, float speedMultiplier = 0.8f);
+    void disband(int group); // Followers go back to their own behaviour
+    bool isActive(int group) const;
+    void setLeader(int group, Character* leader); // A follower promoted to leader leaves its slot first
+    Character* leader(int group) const;
+    void join(int group, Character* follower); // Leaves its previous group first
+    void leave(Character* follower);
+    void forget(Character* character); // On despawn: leaves its group and disbands the ones it leads
+    void clear();
+
+    size_t followerCount(int group) const;
+    size_t groupCount() const { return activeGroups; }
+    // fn(id, leader, shape, spacing, speedMultiplier) for every active group
+    void forEachGroup(const std::function<void(int, Character*, FormationShape, float, float)>& fn) const;
+
+    // Moves every follower towards its slot; call after the characters' own update
+    void update(float deltaTime);
+
+private:
+    struct Group {
+        bool active = false;
+        uint16_t generation = 0;
+        Character* leader = nullptr;
+        FormationShape shape = FormationShape::Trail;
+        float spacing = 3.0f;
+        float speedMultiplier = 0.8f;
+        bool slotsDirty = false;            // Membership changed: layoutSlots() before the next solve
+        // Per follower, same index in each array
+        std::vector<Character*> followers;
+        std::vector<glm::vec3> slots;       // Leader-frame offsets (unused for Trail)
+    };
+
+    Group* find(int group);
+    const Group* find(int group) const;
+    void layoutSlots(Group& group);
+    void solve(Group& group, float deltaTime);
+
+    std::vector<Group> groups;
+    std::vector<int> freeGroups;
+    size_t activeGroups = 0;
+};
+
+extern FormationSystem formations;
+
+#endif // FORMATION_H
@@ -0,0 +1,52 @@
+#include "FrameArena.h"
+#include <algorithm>
+
+FrameArena frameArena;
+
+LinearArena::LinearArena(size_t initialCapacity) {
+    addBlock(initialCapacity);
+}
+
+void LinearArena::addBlock(size_t minimumSize) {
+    Block block;
+    block.size = std::max<size_t>(minimumSize, 4096);
+    block.memory.reset(new unsigned char[block.size]);
+    blocks.push_back(std::move(block));
+    ++heapBlocks;
+}
+
+void* LinearArena::allocate(size_t bytes, size_t alignment) {
+    Block* block = &blocks.back();
+    uintptr_t base = reinterpret_cast<uintptr_t>(block->memory.get());
+    size_t start = ((base + block->offset + alignment - 1) & ~(uintptr_t)(alignment - 1)) - base;
+    if (start + bytes > block->size) {
+        // Bloco cheio: o próximo dobra o tamanho (com folga para o alinhamento)
+        addBlock(std::max(block->size * 2, bytes + alignment));
+        block = &blocks.back();
+        base = reinterpret_cast<uintptr_t>(block->memory.get());
+        start = ((base + alignment - 1) & ~(uintptr_t)(alignment - 1)) - base;
+    }
+    block->offset = start + bytes;
+    usedBytes += bytes;
+    peakBytes = std::max(peakBytes, usedBytes);
+    return block->memory.get() + start;
+}
+
+void LinearArena::reset() {
+    if (blocks.size() > 1) {
+        // Consolida num bloco só que cabe o pico, para o próximo quadro não precisar crescer
+        size_t total = capacity();
+        blocks.clear();
+        addBlock(total);
+    }
+    blocks.back().offset = 0;
+    usedBytes = 0;
+}
+
+size_t LinearArena::capacity() const {
+    size_t total = 0;
+    for (const Block& block : blocks) total += block.size;
+    return total;
+}
+
+FrameArena::FrameArena(size_t initialCapacity) : arena(initialCapacity) {}
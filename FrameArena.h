@@ -0,0 +1,91 @@
+#ifndef FRAME_ARENA_H
+#define FRAME_ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Alocador linear (bump): allocate só avança um ponteiro e reset libera tudo de uma vez.
+// Quando o bloco enche, um bloco extra é pego do heap; no próximo reset os blocos são
+// trocados por um só do tamanho do pico, então depois do primeiro quadro "grande" o
+// uso volta a não tocar no heap. Não é thread-safe.
+class LinearArena {
+public:
+    explicit LinearArena(size_t initialCapacity = 64 * 1024);
+
+    LinearArena(const LinearArena&) = delete;
+    LinearArena& operator=(const LinearArena&) = delete;
+
+    void* allocate(size_t bytes, size_t alignment = alignof(std::max_align_t));
+    void reset();
+
+    size_t used() const { return usedBytes; }
+    size_t capacity() const;
+    size_t peak() const { return peakBytes; }
+    size_t heapAllocations() const { return heapBlocks; } // Blocos pedidos ao heap desde a criação
+
+private:
+    struct Block {
+        std::unique_ptr<unsigned char[]> memory;
+        size_t size = 0;
+        size_t offset = 0;
+    };
+
+    void addBlock(size_t minimumSize);
+
+    std::vector<Block> blocks; // O último é o ativo
+    size_t usedBytes = 0;
+    size_t peakBytes = 0;
+    size_t heapBlocks = 0;
+};
+
+// Arena do quadro: tudo que é alocado nela vale até o próximo endFrame(), que a zera.
+// Nada passa de um quadro para o outro, então um buffer basta. Uma thread por vez: a
+// principal ou, no passo do ECS, a que roda o wanderSystem (o único sistema que usa a
+// arena, via Navigation).
+class FrameArena {
+public:
+    explicit FrameArena(size_t initialCapacity = 64 * 1024);
+
+    LinearArena& current() { return arena; }
+
+    void endFrame() { arena.reset(); }
+
+    size_t heapAllocations() const { return arena.heapAllocations(); }
+
+private:
+    LinearArena arena;
+};
+
+extern FrameArena frameArena;
+
+// Adaptador para containers da STL; deallocate não faz nada (a memória volta no reset da arena)
+template <typename T>
+class ArenaAllocator {
+public:
+    using value_type = T;
+
+    ArenaAllocator(LinearArena& arena) : arena(&arena) {}
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) : arena(other.arena) {}
+
+    T* allocate(size_t count) { return static_cast<T*>(arena->allocate(count * sizeof(T), alignof(T))); }
+    void deallocate(T*, size_t) {}
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>& other) const { return arena == other.arena; }
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U>& other) const { return arena != other.arena; }
+
+private:
+    template <typename U> friend class ArenaAllocator;
+    LinearArena* arena;
+};
+
+// Vetor temporário do quadro: FrameVector<int> lista(frameArena.current());
+// Não pode sobreviver ao endFrame() seguinte.
+template <typename T>
+using FrameVector = std::vector<T, ArenaAllocator<T>>;
+
+#endif // FRAME_ARENA_H
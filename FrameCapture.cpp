@@ -0,0 +1,164 @@
+#include "FrameCapture.h"
+#include "SoftwareRenderer.h"
+#include <cstring>
+#include <iostream>
+
+bool createRenderTarget(RenderTarget& target, int width, int height) {
+    target.width = width;
+    target.height = height;
+
+    glGenFramebuffers(1, &target.framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, target.framebuffer);
+
+    glGenRenderbuffers(1, &target.colorBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, target.colorBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, target.colorBuffer);
+
+    glGenRenderbuffers(1, &target.depthBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, target.depthBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, target.depthBuffer);
+
+    bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    if (!complete) {
+        std::cerr << "Offscreen framebuffer is incomplete" << std::endl;
+        destroyRenderTarget(target);
+    }
+    return complete;
+}
+
+void destroyRenderTarget(RenderTarget& target) {
+    if (target.depthBuffer) glDeleteRenderbuffers(1, &target.depthBuffer);
+    if (target.colorBuffer) glDeleteRenderbuffers(1, &target.colorBuffer);
+    if (target.framebuffer) glDeleteFramebuffers(1, &target.framebuffer);
+    target = RenderTarget();
+}
+
+void bindRenderTarget(const RenderTarget& target) {
+    glBindFramebuffer(GL_FRAMEBUFFER, target.framebuffer);
+    glViewport(0, 0, target.width, target.height);
+}
+
+void blitToScreen(const RenderTarget& target, int screenWidth, int screenHeight) {
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, target.framebuffer);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+    glBlitFramebuffer(0, 0, target.width, target.height, 0, 0, screenWidth, screenHeight,
+                      GL_COLOR_BUFFER_BIT, GL_LINEAR);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glViewport(0, 0, screenWidth, screenHeight);
+}
+
+FrameCapture::FrameCapture(const CaptureOptions& options, int width, int height, bool useGL)
+    : options(options), width(width), height(height), useGL(useGL), writer(options) {
+    if (!useGL) return;
+
+    GLsizeiptr size = static_cast<GLsizeiptr>(width) * height * 4;
+    for (Slot& slot : slots) {
+        glGenBuffers(1, &slot.pbo);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+        glBufferData(GL_PIXEL_PACK_BUFFER, size, nullptr, GL_STREAM_READ);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+}
+
+FrameCapture::~FrameCapture() {
+    finish();
+    if (!useGL) return;
+    for (Slot& slot : slots) {
+        if (slot.pbo) glDeleteBuffers(1, &slot.pbo);
+    }
+}
+
+bool FrameCapture::shouldCapture() {
+    return options.enabled && (frameCounter++ % options.every) == 0;
+}
+
+void FrameCapture::captureFramebuffer(GLuint framebuffer) {
+    if (!useGL) return;
+    int frameIndex = frameCounter;
+    if (!shouldCapture()) return;
+
+    retire(false);
+    if (pending == RING_SIZE) {
+        // A GPU está RING_SIZE capturas atrás: espera a mais antiga para liberar o slot
+        ++readbackStalls;
+        while (pending == RING_SIZE) retire(true);
+    }
+
+    Slot& slot = slots[(oldest + pending) % RING_SIZE];
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr); // Retorna sem esperar a GPU
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+
+    slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    slot.frameIndex = frameIndex;
+    ++pending;
+}
+
+void FrameCapture::captureSoftware(const SoftwareRenderer& renderer) {
+    int frameIndex = frameCounter;
+    if (!shouldCapture()) return;
+
+    CapturedFrame frame;
+    frame.index = frameIndex;
+    frame.width = renderer.getWidth();
+    frame.height = renderer.getHeight();
+    frame.channels = 3;
+    frame.bottomUp = false;
+    frame.pixels = writer.acquirePixels();
+    renderer.readPixelsRGB(frame.pixels);
+    writer.push(std::move(frame));
+}
+
+void FrameCapture::retire(bool wait) {
+    while (pending > 0) {
+        Slot& slot = slots[oldest];
+        GLenum status = glClientWaitSync(slot.fence, wait ? GL_SYNC_FLUSH_COMMANDS_BIT : 0,
+                                         wait ? 1000000000ull : 0); // Até 1 s quando bloqueante
+        if (status == GL_TIMEOUT_EXPIRED) return;
+        glDeleteSync(slot.fence);
+        slot.fence = nullptr;
+
+        CapturedFrame frame;
+        frame.index = slot.frameIndex;
+        frame.width = width;
+        frame.height = height;
+        frame.channels = 4;
+        frame.bottomUp = true;
+        frame.pixels = writer.acquirePixels();
+        frame.pixels.resize(static_cast<size_t>(width) * height * 4);
+
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+        const void* mapped = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, frame.pixels.size(), GL_MAP_READ_BIT);
+        if (mapped) {
+            std::memcpy(frame.pixels.data(), mapped, frame.pixels.size());
+            glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        }
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+        oldest = (oldest + 1) % RING_SIZE;
+        --pending;
+        if (mapped) writer.push(std::move(frame));
+
+        wait = false; // Só a mais antiga precisa bloquear; as demais saem se já estiverem prontas
+    }
+}
+
+void FrameCapture::finish() {
+    while (useGL && pending > 0) retire(true);
+    writer.flush();
+}
+
+void FrameCapture::printStats(const char* title) {
+    writer.printStats(title);
+    if (readbackStalls) {
+        std::cout << "  " << readbackStalls << " readbacks waited for the GPU (PBO ring full)" << std::endl;
+    }
+}
@@ -0,0 +1,72 @@
+#ifndef FRAME_CAPTURE_H
+#define FRAME_CAPTURE_H
+
+#include <GL/glew.h>
+#include "FrameWriter.h"
+
+class SoftwareRenderer;
+
+// Alvo de renderização fora da tela: FBO com cor RGBA8 e profundidade de 24 bits.
+// O quadro é desenhado aqui e copiado para a janela com blitToScreen, então a
+// resolução capturada não muda quando a janela é redimensionada.
+struct RenderTarget {
+    GLuint framebuffer = 0;
+    GLuint colorBuffer = 0;
+    GLuint depthBuffer = 0;
+    int width = 0;
+    int height = 0;
+};
+
+bool createRenderTarget(RenderTarget& target, int width, int height);
+void destroyRenderTarget(RenderTarget& target);
+void bindRenderTarget(const RenderTarget& target);
+void blitToScreen(const RenderTarget& target, int screenWidth, int screenHeight);
+
+// Captura assíncrona: glReadPixels vai para um anel de PBOs com uma fence por
+// leitura, e o buffer só é mapeado quadros depois, quando a GPU já terminou.
+// Assim a leitura não sincroniza o pipeline; a conversão e a gravação ficam
+// com o FrameWriter, em outra thread.
+class FrameCapture {
+public:
+    static const int RING_SIZE = 3; // Latência máxima da leitura, em quadros capturados
+
+    // width/height: tamanho do framebuffer lido. Sem contexto GL (headless) use só captureSoftware.
+    FrameCapture(const CaptureOptions& options, int width, int height, bool useGL = true);
+    ~FrameCapture(); // Chama finish()
+
+    FrameCapture(const FrameCapture&) = delete;
+    FrameCapture& operator=(const FrameCapture&) = delete;
+
+    // Chamar uma vez por quadro, depois de desenhar e antes de glfwSwapBuffers
+    void captureFramebuffer(GLuint framebuffer);
+    // Equivalente para o rasterizador de software (cópia direta, sem PBO)
+    void captureSoftware(const SoftwareRenderer& renderer);
+
+    // Lê todos os PBOs pendentes e espera a thread de escrita
+    void finish();
+
+    size_t getReadbackStalls() const { return readbackStalls; }
+    void printStats(const char* title);
+
+private:
+    struct Slot {
+        GLuint pbo = 0;
+        GLsync fence = nullptr;
+        int frameIndex = 0;
+    };
+
+    bool shouldCapture();
+    void retire(bool wait);   // Entrega ao writer os slots prontos, do mais antigo ao mais novo
+
+    CaptureOptions options;
+    int width, height;
+    bool useGL;
+    Slot slots[RING_SIZE];
+    int oldest = 0;
+    int pending = 0;
+    int frameCounter = 0;     // Quadros vistos (capturados ou não)
+    size_t readbackStalls = 0; // Vezes em que o anel estava cheio e foi preciso esperar a GPU
+    FrameWriter writer;
+};
+
+#endif // FRAME_CAPTURE_H
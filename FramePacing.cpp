@@ -0,0 +1,134 @@
+#include "FramePacing.h"
+#include "InputState.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+LatencyOptions parseLatencyOptions(int argc, char** argv) {
+    LatencyOptions options;
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(arg, "--latency") == 0) {
+            options.measure = true;
+        } else if (std::strcmp(arg, "--swap-interval") == 0 && hasValue) {
+            options.swapInterval = std::max(0, std::atoi(argv[++i]));
+        } else if (std::strcmp(arg, "--pacing") == 0) {
+            options.pacing = true;
+        }
+    }
+    return options;
+}
+
+// --- LatencyTracker ---
+
+LatencyTracker::LatencyTracker(bool enabled) : enabled(enabled) {}
+
+LatencyTracker::~LatencyTracker() {
+    for (int i = 0; i < pendingCount; ++i) glDeleteSync(pending[(oldest + i) % MAX_PENDING].fence);
+}
+
+void LatencyTracker::frameSubmitted(int64_t inputNs, int64_t sampleNs, int64_t submitNs) {
+    if (!enabled) return;
+    while (pendingCount == MAX_PENDING) retire(true);
+
+    Pending& frame = pending[(oldest + pendingCount) % MAX_PENDING];
+    frame.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    frame.inputNs = inputNs;
+    frame.sampleNs = sampleNs;
+    frame.submitNs = submitNs;
+    ++pendingCount;
+}
+
+bool LatencyTracker::retire(bool wait) {
+    Pending& frame = pending[oldest];
+    GLenum status = glClientWaitSync(frame.fence, wait ? GL_SYNC_FLUSH_COMMANDS_BIT : 0,
+                                     wait ? 1000000000ull : 0);
+    if (status == GL_TIMEOUT_EXPIRED) return false;
+    int64_t presentNs = inputClockNs();
+    glDeleteSync(frame.fence);
+    frame.fence = nullptr;
+
+    if (status != GL_WAIT_FAILED) {
+        if (frame.inputNs) inputToPresentMs.push_back((presentNs - frame.inputNs) * 1e-6f);
+        sampleToPresentMs.push_back((presentNs - frame.sampleNs) * 1e-6f);
+        submitToPresentMs.push_back((presentNs - frame.submitNs) * 1e-6f);
+    }
+    oldest = (oldest + 1) % MAX_PENDING;
+    --pendingCount;
+    return true;
+}
+
+void LatencyTracker::poll() {
+    while (pendingCount > 0 && retire(false)) {}
+}
+
+void LatencyTracker::finish() {
+    while (pendingCount > 0) retire(true);
+}
+
+static void printDistribution(const char* name, std::vector<float> values) {
+    if (values.empty()) {
+        std::printf("  %-18s no samples\n", name);
+        return;
+    }
+    std::sort(values.begin(), values.end());
+    double sum = 0.0;
+    for (float value : values) sum += value;
+    auto percentile = [&values](double p) { return values[std::min(values.size() - 1, static_cast<size_t>(p * values.size()))]; };
+    std::printf("  %-18s mean %6.2f ms  p50 %6.2f  p95 %6.2f  p99 %6.2f  max %6.2f  (%zu frames)\n", name,
+                sum / values.size(), percentile(0.50), percentile(0.95), percentile(0.99), values.back(), values.size());
+}
+
+void LatencyTracker::printReport(const char* title) {
+    if (!enabled) return;
+    finish();
+    std::printf("%s latency:\n", title);
+    printDistribution("input -> present", inputToPresentMs);
+    printDistribution("sample -> present", sampleToPresentMs);
+    printDistribution("submit -> present", submitToPresentMs);
+    std::fflush(stdout);
+}
+
+// --- FramePacer ---
+
+FramePacer::FramePacer(bool enabled) : enabled(enabled) {}
+
+void FramePacer::waitForInput() {
+    if (!enabled || frames < 8) return; // Sem histórico ainda para prever o prazo
+
+    int64_t target = lastSwapNs + static_cast<int64_t>(periodNs - workNs - marginNs);
+    int64_t now = inputClockNs();
+    if (target <= now) return;
+    std::this_thread::sleep_for(std::chrono::nanoseconds(target - now));
+    sleptMs += (inputClockNs() - now) * 1e-6;
+}
+
+void FramePacer::frameSwapped(int64_t sampleNs, int64_t submitNs) {
+    int64_t now = inputClockNs();
+    double work = static_cast<double>(submitNs - sampleNs);
+    if (frames > 0) {
+        double interval = static_cast<double>(now - lastSwapNs);
+        if (frames > 8 && interval > periodNs * 1.5) {
+            // Perdeu o vsync: mais folga, e o intervalo longo não entra na média do período
+            ++missedDeadlines;
+            marginNs = std::min(marginNs * 2.0, periodNs * 0.5);
+        } else {
+            periodNs = frames == 1 ? interval : periodNs * 0.9 + interval * 0.1;
+            marginNs = std::max(1e6, marginNs * 0.99);
+        }
+    }
+    workNs = frames == 0 ? work : std::max(work, workNs * 0.9 + work * 0.1); // Reage rápido a picos
+    lastSwapNs = now;
+    ++frames;
+}
+
+void FramePacer::printReport(const char* title) const {
+    if (!enabled) return;
+    std::printf("%s pacing: period %.2f ms, work %.2f ms, margin %.2f ms, slept %.1f ms/frame, %d missed deadlines\n",
+                title, periodNs * 1e-6, workNs * 1e-6, marginNs * 1e-6, frames ? sleptMs / frames : 0.0, missedDeadlines);
+    std::fflush(stdout);
+}
@@ -0,0 +1,94 @@
+#ifndef FRAME_PACING_H
+#define FRAME_PACING_H
+
+#include <GL/glew.h>
+#include <cstdint>
+#include <vector>
+
+// Opções de latência e ritmo de quadros (só com janela):
+//   --latency            mede entrada -> tela por quadro e imprime o relatório ao sair
+//   --swap-interval N    glfwSwapInterval(N) (0 = sem vsync); sem a opção vale o padrão do jogo
+//   --pacing             lê a entrada o mais tarde possível antes do prazo previsto do próximo vsync
+struct LatencyOptions {
+    bool measure = false;
+    int swapInterval = -1;
+    bool pacing = false;
+};
+
+LatencyOptions parseLatencyOptions(int argc, char** argv);
+
+// Mede, por quadro, quanto tempo a entrada levou para virar imagem. Cada quadro carrega
+// o horário do evento de entrada mais antigo que ele consumiu (0 se nenhum), o horário
+// em que a entrada foi lida e o do envio (antes do SwapBuffers). Depois do swap entra uma
+// fence; quando ela sinaliza, a GPU terminou o quadro, que é o nosso "present" (a
+// varredura do monitor ainda soma até um período de vsync). As fences são consultadas sem
+// bloquear a cada quadro, então a resolução é de um quadro no pior caso.
+class LatencyTracker {
+public:
+    explicit LatencyTracker(bool enabled);
+    ~LatencyTracker();
+
+    LatencyTracker(const LatencyTracker&) = delete;
+    LatencyTracker& operator=(const LatencyTracker&) = delete;
+
+    bool isEnabled() const { return enabled; }
+
+    // Chamar logo depois de glfwSwapBuffers
+    void frameSubmitted(int64_t inputNs, int64_t sampleNs, int64_t submitNs);
+    // Recolhe as fences que já sinalizaram (não bloqueia)
+    void poll();
+    // Espera as fences pendentes
+    void finish();
+
+    void printReport(const char* title);
+
+private:
+    struct Pending {
+        GLsync fence = nullptr;
+        int64_t inputNs = 0;
+        int64_t sampleNs = 0;
+        int64_t submitNs = 0;
+    };
+
+    bool retire(bool wait);
+
+    static const int MAX_PENDING = 8; // Quadros em voo; acima disso o mais antigo é esperado
+
+    bool enabled;
+    Pending pending[MAX_PENDING];
+    int oldest = 0;
+    int pendingCount = 0;
+
+    std::vector<float> inputToPresentMs;  // Só quadros que consumiram algum evento
+    std::vector<float> sampleToPresentMs; // Leitura da entrada -> GPU terminou
+    std::vector<float> submitToPresentMs; // Envio -> GPU terminou
+};
+
+// Ritmo adaptativo: com vsync, dorme no começo do quadro até
+//   último retorno do swap + período previsto - trabalho previsto - margem
+// e só então lê a entrada, então ela fica o mais nova possível quando o quadro sai.
+// Período e trabalho são médias móveis; a margem dobra quando um vsync é perdido e
+// volta a cair devagar enquanto os quadros chegam a tempo.
+class FramePacer {
+public:
+    explicit FramePacer(bool enabled);
+
+    // Início do quadro, antes de glfwPollEvents
+    void waitForInput();
+    // Depois de glfwSwapBuffers; sampleNs/submitNs como no LatencyTracker
+    void frameSwapped(int64_t sampleNs, int64_t submitNs);
+
+    void printReport(const char* title) const;
+
+private:
+    bool enabled;
+    int64_t lastSwapNs = 0;
+    double periodNs = 0.0;  // Intervalo entre swaps
+    double workNs = 0.0;    // Leitura da entrada -> envio
+    double marginNs = 2e6;
+    int frames = 0;
+    int missedDeadlines = 0;
+    double sleptMs = 0.0;
+};
+
+#endif // FRAME_PACING_H
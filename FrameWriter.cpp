@@ -0,0 +1,173 @@
+#include "FrameWriter.h"
+#include "ImageWriter.h"
+#include <algorithm> // Para std::max
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+static bool endsWith(const std::string& text, const char* suffix) {
+    size_t length = std::strlen(suffix);
+    return text.size() >= length && text.compare(text.size() - length, length, suffix) == 0;
+}
+
+CaptureOptions parseCaptureOptions(int argc, char** argv) {
+    CaptureOptions options;
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(arg, "--capture") == 0 && hasValue) {
+            options.enabled = true;
+            options.path = argv[++i];
+        } else if (std::strcmp(arg, "--capture-every") == 0 && hasValue) {
+            options.every = std::max(1, std::atoi(argv[++i]));
+        }
+    }
+
+    if (endsWith(options.path, ".png")) {
+        options.format = CaptureFormat::PNG;
+    } else if (endsWith(options.path, ".raw") || endsWith(options.path, ".rgb")) {
+        options.format = CaptureFormat::RawVideo;
+    } else {
+        options.format = CaptureFormat::PPM;
+    }
+    return options;
+}
+
+FrameWriter::FrameWriter(const CaptureOptions& options) : options(options) {
+    if (!options.enabled) return; // Sem captura, sem thread
+    if (options.format == CaptureFormat::RawVideo) {
+        videoFile = std::fopen(options.path.c_str(), "wb");
+        if (!videoFile) std::cerr << "Failed to open " << options.path << std::endl;
+    }
+    sparePixels.reserve(options.maxQueuedFrames);
+    worker = std::thread(&FrameWriter::run, this);
+}
+
+FrameWriter::~FrameWriter() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    queueChanged.notify_all();
+    if (worker.joinable()) worker.join();
+    if (videoFile) std::fclose(videoFile);
+}
+
+std::vector<uint8_t> FrameWriter::acquirePixels() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (sparePixels.empty()) return std::vector<uint8_t>();
+    std::vector<uint8_t> pixels = std::move(sparePixels.back());
+    sparePixels.pop_back();
+    return pixels;
+}
+
+void FrameWriter::push(CapturedFrame&& frame) {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (queue.size() >= options.maxQueuedFrames) {
+        // Disco mais lento que o jogo: espera em vez de descartar (a captura precisa ser completa)
+        auto start = std::chrono::steady_clock::now();
+        queueChanged.wait(lock, [this] { return queue.size() < options.maxQueuedFrames; });
+        stats.stallMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+    queue.push_back(std::move(frame));
+    lock.unlock();
+    queueChanged.notify_all();
+}
+
+void FrameWriter::flush() {
+    std::unique_lock<std::mutex> lock(mutex);
+    queueChanged.wait(lock, [this] { return queue.empty() && !busy; });
+}
+
+FrameWriter::Stats FrameWriter::getStats() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return stats;
+}
+
+void FrameWriter::printStats(const char* title) {
+    Stats s = getStats();
+    std::cout << title << ": " << s.framesWritten << " frames captured to " << options.path
+              << " (" << s.bytesWritten / (1024.0 * 1024.0) << " MiB, writer " << s.writeMs
+              << " ms, game stalled " << s.stallMs << " ms";
+    if (s.failures) std::cout << ", " << s.failures << " failed";
+    std::cout << ")" << std::endl;
+}
+
+void FrameWriter::run() {
+    for (;;) {
+        CapturedFrame frame;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            queueChanged.wait(lock, [this] { return stopping || !queue.empty(); });
+            if (queue.empty()) return; // stopping e nada mais a gravar
+            frame = std::move(queue.front());
+            queue.pop_front();
+            busy = true;
+        }
+        queueChanged.notify_all(); // Libera um push que esperava espaço
+
+        auto start = std::chrono::steady_clock::now();
+        bool ok = write(frame);
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            busy = false;
+            stats.writeMs += ms;
+            if (ok) {
+                ++stats.framesWritten;
+                stats.bytesWritten += static_cast<size_t>(frame.width) * frame.height * 3;
+            } else {
+                ++stats.failures;
+            }
+            if (sparePixels.size() < options.maxQueuedFrames) sparePixels.push_back(std::move(frame.pixels));
+        }
+        queueChanged.notify_all(); // Acorda flush()
+    }
+}
+
+std::string FrameWriter::framePath(int index) const {
+    std::string pattern = options.path;
+    if (pattern.find('%') == std::string::npos) {
+        // Sem padrão explícito: insere _00000 antes da extensão
+        size_t dot = pattern.rfind('.');
+        if (dot == std::string::npos) dot = pattern.size();
+        pattern.insert(dot, "_%05d");
+    }
+    char buffer[1024];
+    std::snprintf(buffer, sizeof(buffer), pattern.c_str(), index);
+    return buffer;
+}
+
+bool FrameWriter::write(CapturedFrame& frame) {
+    // Converte para RGB8 de cima para baixo (GL entrega RGBA de baixo para cima)
+    const uint8_t* src = frame.pixels.data();
+    size_t pixelCount = static_cast<size_t>(frame.width) * frame.height;
+    if (frame.pixels.size() < pixelCount * frame.channels) return false;
+
+    rgb.resize(pixelCount * 3);
+    for (int y = 0; y < frame.height; ++y) {
+        int srcRow = frame.bottomUp ? frame.height - 1 - y : y;
+        const uint8_t* in = src + static_cast<size_t>(srcRow) * frame.width * frame.channels;
+        uint8_t* out = rgb.data() + static_cast<size_t>(y) * frame.width * 3;
+        if (frame.channels == 3) {
+            std::memcpy(out, in, static_cast<size_t>(frame.width) * 3);
+            continue;
+        }
+        for (int x = 0; x < frame.width; ++x) {
+            out[x * 3 + 0] = in[x * frame.channels + 0];
+            out[x * 3 + 1] = in[x * frame.channels + 1];
+            out[x * 3 + 2] = in[x * frame.channels + 2];
+        }
+    }
+
+    switch (options.format) {
+        case CaptureFormat::PNG:
+            return writePNG(framePath(frame.index).c_str(), frame.width, frame.height, rgb);
+        case CaptureFormat::RawVideo:
+            return videoFile && std::fwrite(rgb.data(), 1, rgb.size(), videoFile) == rgb.size();
+        default:
+            return writePPM(framePath(frame.index).c_str(), frame.width, frame.height, rgb);
+    }
+}
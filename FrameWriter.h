@@ -0,0 +1,89 @@
+#ifndef FRAME_WRITER_H
+#define FRAME_WRITER_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+enum class CaptureFormat {
+    PPM,      // Um arquivo por quadro
+    PNG,      // Um arquivo por quadro
+    RawVideo  // Um único arquivo RGB24 contínuo (ffmpeg -f rawvideo -pix_fmt rgb24 -s LxA)
+};
+
+// Opções de captura de quadros, comuns aos dois executáveis e aos modos janela/headless:
+//   --capture caminho      ativa a captura; a extensão escolhe o formato (.ppm, .png, .raw/.rgb)
+//                          e, nos formatos de imagem, um '%d' no nome recebe o número do quadro
+//   --capture-every N      captura 1 a cada N quadros (padrão 1)
+struct CaptureOptions {
+    bool enabled = false;
+    std::string path;
+    CaptureFormat format = CaptureFormat::PPM;
+    int every = 1;
+    size_t maxQueuedFrames = 16; // Acima disso o jogo espera a thread de escrita
+};
+
+CaptureOptions parseCaptureOptions(int argc, char** argv);
+
+// Quadro lido da GPU ou do rasterizador de software, ainda no formato de origem
+struct CapturedFrame {
+    int index = 0;
+    int width = 0;
+    int height = 0;
+    int channels = 3;       // 4 quando vem do glReadPixels (GL_RGBA)
+    bool bottomUp = false;  // true para linhas na ordem do GL (de baixo para cima)
+    std::vector<uint8_t> pixels;
+};
+
+// Converte e grava quadros numa thread própria, para que o loop do jogo
+// só pague a cópia do buffer. A ordem de gravação é a ordem de push.
+class FrameWriter {
+public:
+    struct Stats {
+        size_t framesWritten = 0;
+        size_t bytesWritten = 0;
+        size_t failures = 0;
+        double writeMs = 0.0;  // Tempo gasto na thread de escrita
+        double stallMs = 0.0;  // Tempo que push esperou com a fila cheia
+    };
+
+    explicit FrameWriter(const CaptureOptions& options);
+    ~FrameWriter(); // Grava o que restou na fila antes de retornar
+
+    FrameWriter(const FrameWriter&) = delete;
+    FrameWriter& operator=(const FrameWriter&) = delete;
+
+    // Buffer de pixels já gravado, para reaproveitar (vazio se não houver); depois de alguns
+    // quadros a captura não aloca mais, porque todo buffer que volta da thread de escrita é reusado
+    std::vector<uint8_t> acquirePixels();
+    void push(CapturedFrame&& frame);
+    void flush(); // Espera a fila esvaziar
+
+    Stats getStats();
+    void printStats(const char* title);
+
+private:
+    void run();
+    bool write(CapturedFrame& frame);
+    std::string framePath(int index) const;
+
+    CaptureOptions options;
+    FILE* videoFile = nullptr;
+    std::vector<uint8_t> rgb; // Rascunho da thread de escrita
+
+    std::mutex mutex;
+    std::condition_variable queueChanged;
+    std::deque<CapturedFrame> queue;
+    std::vector<std::vector<uint8_t>> sparePixels;
+    bool busy = false;
+    bool stopping = false;
+    Stats stats;
+    std::thread worker;
+};
+
+#endif // FRAME_WRITER_H
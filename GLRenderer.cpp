@@ -0,0 +1,86 @@
+#include "GLRenderer.h"
+#include "Mesh.h"
+#include "Lighting.h"
+#include <glm/gtc/type_ptr.hpp>
+#include <algorithm>
+
+GLRenderer::GLRenderer(GLuint program)
+    : program(program),
+      modelLoc(glGetUniformLocation(program, "model")),
+      viewLoc(glGetUniformLocation(program, "view")),
+      projectionLoc(glGetUniformLocation(program, "projection")),
+      colorLoc(glGetUniformLocation(program, "objectColor")),
+      normalMatrixLoc(glGetUniformLocation(program, "normalMatrix")),
+      sunDirectionLoc(glGetUniformLocation(program, "sunDirection")),
+      sunColorLoc(glGetUniformLocation(program, "sunColor")),
+      ambientColorLoc(glGetUniformLocation(program, "ambientColor")),
+      clusteredLightsLoc(glGetUniformLocation(program, "clusteredLights")),
+      clusterDimsLoc(glGetUniformLocation(program, "clusterDims")),
+      clusterTileScaleLoc(glGetUniformLocation(program, "clusterTileScale")),
+      clusterSliceLoc(glGetUniformLocation(program, "clusterSlice")),
+      lightDataLoc(glGetUniformLocation(program, "lightData")),
+      clusterRangesLoc(glGetUniformLocation(program, "clusterRanges")),
+      lightIndicesLoc(glGetUniformLocation(program, "lightIndices")) {}
+
+void GLRenderer::beginFrame(const glm::mat4& view, const glm::mat4& projection, const glm::vec3& clearColor) {
+    glClearColor(clearColor.r, clearColor.g, clearColor.b, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    glUseProgram(program);
+    glUniformMatrix4fv(viewLoc, 1, GL_FALSE, glm::value_ptr(view));
+    glUniformMatrix4fv(projectionLoc, 1, GL_FALSE, glm::value_ptr(projection));
+
+    glm::vec3 viewSunDirection = glm::normalize(glm::mat3(view) * sunDirection);
+    glUniform3fv(sunDirectionLoc, 1, glm::value_ptr(viewSunDirection));
+    glUniform3fv(sunColorLoc, 1, glm::value_ptr(sunColor));
+    glUniform3fv(ambientColorLoc, 1, glm::value_ptr(ambientColor));
+    bool clustered = lighting && lighting->isUploaded() && clusteredLightsLoc >= 0;
+    glUniform1i(clusteredLightsLoc, clustered ? 1 : 0);
+    if (clustered) {
+        // Os blocos dividem o viewport atual (janela ou alvo de captura)
+        GLint viewport[4];
+        glGetIntegerv(GL_VIEWPORT, viewport);
+        lighting->bindTextures(0);
+        glUniform1i(lightDataLoc, 0);
+        glUniform1i(clusterRangesLoc, 1);
+        glUniform1i(lightIndicesLoc, 2);
+        glUniform3i(clusterDimsLoc, LightClusters::TILES_X, LightClusters::TILES_Y, LightClusters::SLICES);
+        glUniform2f(clusterTileScaleLoc, static_cast<float>(LightClusters::TILES_X) / std::max(1, viewport[2]),
+                    static_cast<float>(LightClusters::TILES_Y) / std::max(1, viewport[3]));
+        glUniform2f(clusterSliceLoc, lighting->sliceScale, lighting->sliceBias);
+    }
+    glPolygonMode(GL_FRONT_AND_BACK, wireframe ? GL_LINE : GL_FILL);
+}
+
+void GLRenderer::drawMesh(const Mesh& mesh, const glm::mat4& model, const glm::vec3& color) {
+    if (mesh.vertexCount == 0 || mesh.vao == 0) return;
+
+    // A desquantização das posições da malha é aplicada antes da matriz model
+    glm::mat4 finalModel = model * mesh.dequantization;
+    glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(finalModel));
+    glUniform3fv(colorLoc, 1, glm::value_ptr(color));
+    if (normalMatrixLoc >= 0) {
+        // As normais não são quantizadas: só a model entra na matriz delas. A cofatora da parte 3x3
+        // (determinante * inversa transposta) tem a mesma direção sem a divisão, então continua finita
+        // com escala 0 (a normal sai no eixo achatado). O sinal do determinante desfaz o espelhamento, e
+        // a maior coluna vai a 1 para o teste de "sem normal" do lit.frag não pegar peças pequenas
+        glm::mat3 m(model);
+        glm::mat3 normalMatrix(glm::cross(m[1], m[2]), glm::cross(m[2], m[0]), glm::cross(m[0], m[1]));
+        float determinant = glm::dot(m[0], normalMatrix[0]);
+        float largest = std::max(glm::length(normalMatrix[0]), std::max(glm::length(normalMatrix[1]), glm::length(normalMatrix[2])));
+        if (largest > 0.0f) {
+            float factor = (determinant < 0.0f ? -1.0f : 1.0f) / largest;
+            for (int column = 0; column < 3; ++column) normalMatrix[column] = normalMatrix[column] * factor;
+        }
+        glUniformMatrix3fv(normalMatrixLoc, 1, GL_FALSE, glm::value_ptr(normalMatrix));
+    }
+
+    glBindVertexArray(mesh.vao);
+    glDrawArrays(GL_TRIANGLES, 0, mesh.vertexCount);
+    glBindVertexArray(0);
+}
+
+void GLRenderer::endFrame() {
+    // A troca de buffers continua com o chamador (glfwSwapBuffers)
+    glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+}
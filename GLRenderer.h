@@ -0,0 +1,51 @@
+#ifndef GL_RENDERER_H
+#define GL_RENDERER_H
+
+#include <GL/glew.h>
+#include "Renderer.h"
+
+class LightClusters;
+
+// Backend OpenGL: um glDrawArrays por malha, como o drawShape original.
+// Usa um programa com os uniforms 'model', 'view', 'projection' e 'objectColor'.
+// Com shaders/lit.* também envia a normalMatrix de cada malha, a luz direcional e, se houver,
+// as luzes pontuais em clusters (texture buffers nas unidades 0 a 2). Uniforms que o programa
+// não tem ficam com localização -1 e são ignorados.
+class GLRenderer : public Renderer {
+public:
+    explicit GLRenderer(GLuint program);
+
+    bool wireframe = false;       // glPolygonMode(GL_LINE) durante o quadro
+
+    // Iluminação (em espaço do mundo; convertida para espaço de visão em beginFrame)
+    glm::vec3 sunDirection = glm::vec3(-0.3f, -1.0f, -0.5f); // Sentido em que a luz viaja
+    glm::vec3 sunColor = glm::vec3(0.75f);
+    glm::vec3 ambientColor = glm::vec3(0.35f);
+    const LightClusters* lighting = nullptr; // Luzes pontuais já enviadas (upload) para este quadro
+
+    void beginFrame(const glm::mat4& view, const glm::mat4& projection, const glm::vec3& clearColor) override;
+    void drawMesh(const Mesh& mesh, const glm::mat4& model, const glm::vec3& color) override;
+    void endFrame() override;
+
+    GLuint getProgram() const { return program; }
+
+private:
+    GLuint program;
+    GLint modelLoc;
+    GLint viewLoc;
+    GLint projectionLoc;
+    GLint colorLoc;
+    GLint normalMatrixLoc;
+    GLint sunDirectionLoc;
+    GLint sunColorLoc;
+    GLint ambientColorLoc;
+    GLint clusteredLightsLoc;
+    GLint clusterDimsLoc;
+    GLint clusterTileScaleLoc;
+    GLint clusterSliceLoc;
+    GLint lightDataLoc;
+    GLint clusterRangesLoc;
+    GLint lightIndicesLoc;
+};
+
+#endif // GL_RENDERER_H
@@ -81,24 +81,52 @@ std::vector<glm::vec3> generateCylinderPositions(int segments) {
     return vertices;
 }
 
-void setupGeometry(const std::vector<glm::vec3>& vertices, GLuint& vao, GLuint& vbo, GLsizei& vertexCount) {
-    if (vertices.empty()) return;
-
-    glGenVertexArrays(1, &vao);
-    glGenBuffers(1, &vbo);
+std::vector<glm::vec3> generateCubeNormals() {
+    // Mesma ordem de faces de generateCubePositions, 6 vértices por face
+    const glm::vec3 faceNormals[6] = {
+        { 0.0f,  0.0f,  1.0f}, // Frente
+        { 0.0f,  0.0f, -1.0f}, // Trás
+        {-1.0f,  0.0f,  0.0f}, // Esquerda
+        { 1.0f,  0.0f,  0.0f}, // Direita
+        { 0.0f,  1.0f,  0.0f}, // Topo
+        { 0.0f, -1.0f,  0.0f}  // Base
+    };
+    std::vector<glm::vec3> normals;
+    normals.reserve(36);
+    for (const glm::vec3& normal : faceNormals) normals.insert(normals.end(), 6, normal);
+    return normals;
+}
 
-    glBindVertexArray(vao);
+std::vector<glm::vec3> generateCylinderNormals(int segments) {
+    std::vector<glm::vec3> normals;
+    normals.reserve(static_cast<size_t>(segments) * 12);
+    float angleStep = 2.0f * glm::pi<float>() / segments;
 
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(glm::vec3), vertices.data(), GL_STATIC_DRAW);
+    // Topo e base: normal do eixo
+    normals.insert(normals.end(), static_cast<size_t>(segments) * 3, glm::vec3(0.0f, 1.0f, 0.0f));
+    normals.insert(normals.end(), static_cast<size_t>(segments) * 3, glm::vec3(0.0f, -1.0f, 0.0f));
 
-    // Atributo de Posição (layout = 0)
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), (void*)0);
-    glEnableVertexAttribArray(0);
+    // Lateral: normal radial de cada coluna, na ordem dos dois triângulos de generateCylinderPositions
+    for (int i = 0; i < segments; ++i) {
+        glm::vec3 current(cos(i * angleStep), 0.0f, sin(i * angleStep));
+        glm::vec3 next(cos((i + 1) * angleStep), 0.0f, sin((i + 1) * angleStep));
+        normals.push_back(current);
+        normals.push_back(current);
+        normals.push_back(next);
+        normals.push_back(current);
+        normals.push_back(next);
+        normals.push_back(next);
+    }
+    return normals;
+}
 
-    // Desvincula o VBO e o VAO para evitar modificações acidentais
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+void setupGeometry(const std::vector<glm::vec3>& vertices, Mesh& mesh, VertexFormat format) {
+    // Posições quantizadas (GL_SHORT / GL_INT_2_10_10_10_REV) com escala/bias por malha
+    uploadMesh(vertices, mesh, format);
+}
 
-    vertexCount = static_cast<GLsizei>(vertices.size());
+void setupGeometry(const std::vector<glm::vec3>& vertices, const std::vector<glm::vec3>& normals, Mesh& mesh,
+                   VertexFormat format) {
+    // Normais em GL_INT_2_10_10_10_REV normalizado, intercaladas com as posições
+    uploadMesh(vertices, normals, mesh, format);
 }
\ No newline at end of file
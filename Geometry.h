@@ -5,6 +5,7 @@
 #include <GL/glew.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/constants.hpp> // Para pi()
+#include "Mesh.h"
 
 // Gera os vértices de um cubo centrado na origem com lado 2
 std::vector<glm::vec3> generateCubePositions();
@@ -12,7 +13,17 @@ std::vector<glm::vec3> generateCubePositions();
 // Gera os vértices de um cilindro centrado na origem, eixo Y, raio 1, altura 2
 std::vector<glm::vec3> generateCylinderPositions(int segments = 32);
 
-// Configura VAO e VBO para um conjunto de vértices
-void setupGeometry(const std::vector<glm::vec3>& vertices, GLuint& vao, GLuint& vbo, GLsizei& vertexCount);
+// Normais dos vértices de generateCubePositions (uma por face)
+std::vector<glm::vec3> generateCubeNormals();
+
+// Normais dos vértices de generateCylinderPositions: tampas planas, lateral suave
+std::vector<glm::vec3> generateCylinderNormals(int segments = 32);
+
+// Configura VAO e VBO para um conjunto de vértices.
+// O formato das posições é escolhido pelos limites da malha (ver Mesh.h)
+void setupGeometry(const std::vector<glm::vec3>& vertices, Mesh& mesh, VertexFormat format = VertexFormat::Auto);
+// Idem, com uma normal por vértice (atributo 1, usado por shaders/lit.*)
+void setupGeometry(const std::vector<glm::vec3>& vertices, const std::vector<glm::vec3>& normals, Mesh& mesh,
+                   VertexFormat format = VertexFormat::Auto);
 
 #endif // GEOMETRY_H
\ No newline at end of file
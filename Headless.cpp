@@ -0,0 +1,67 @@
+#include "Headless.h"
+#include "ImageWriter.h"
+#include <algorithm> // Para std::max
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+HeadlessOptions parseHeadlessOptions(int argc, char** argv) {
+    HeadlessOptions options;
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(arg, "--headless") == 0) {
+            options.enabled = true;
+        } else if (std::strcmp(arg, "--frames") == 0 && hasValue) {
+            options.frames = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(arg, "--size") == 0 && hasValue) {
+            int w = 0, h = 0;
+            if (std::sscanf(argv[++i], "%dx%d", &w, &h) == 2 && w > 0 && h > 0) {
+                options.width = w;
+                options.height = h;
+            }
+        } else if (std::strcmp(arg, "--threads") == 0 && hasValue) {
+            options.threads = static_cast<unsigned>(std::max(0, std::atoi(argv[++i])));
+        } else if (std::strcmp(arg, "--output") == 0 && hasValue) {
+            options.outputPath = argv[++i];
+        }
+    }
+    return options;
+}
+
+void HeadlessReport::addFrame(double simMs, const SoftwareRenderer::Stats& renderStats) {
+    ++frames;
+    simulationMs += simMs;
+    geometryMs += renderStats.geometryMs;
+    rasterMs += renderStats.rasterMs;
+    drawCalls += renderStats.drawCalls;
+    triangles += renderStats.trianglesSubmitted;
+    culled += renderStats.trianglesCulled;
+}
+
+void HeadlessReport::print(const char* title) const {
+    if (frames == 0) return;
+    double frameMs = (simulationMs + geometryMs + rasterMs) / frames;
+    std::cout << title << ": " << frames << " frames\n"
+              << "  simulation " << simulationMs / frames << " ms, geometry " << geometryMs / frames
+              << " ms, raster " << rasterMs / frames << " ms (" << (frameMs > 0.0 ? 1000.0 / frameMs : 0.0) << " fps)\n"
+              << "  " << drawCalls / frames << " draws, " << triangles / frames << " triangles, "
+              << culled / frames << " culled per frame" << std::endl;
+}
+
+bool saveHeadlessFrame(const HeadlessOptions& options, const SoftwareRenderer& renderer) {
+    if (options.outputPath.empty()) return true;
+
+    std::vector<uint8_t> rgb;
+    renderer.readPixelsRGB(rgb);
+    const std::string& path = options.outputPath;
+    bool png = path.size() >= 4 && path.compare(path.size() - 4, 4, ".png") == 0;
+    bool ok = png ? writePNG(path.c_str(), renderer.getWidth(), renderer.getHeight(), rgb)
+                  : writePPM(path.c_str(), renderer.getWidth(), renderer.getHeight(), rgb);
+    if (!ok) {
+        std::cerr << "Failed to write " << options.outputPath << std::endl;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,44 @@
+#ifndef HEADLESS_H
+#define HEADLESS_H
+
+#include <string>
+#include "SoftwareRenderer.h"
+
+// Opções do modo headless (sem janela nem GPU), comuns aos dois executáveis:
+//   --headless             ativa o modo
+//   --frames N             quadros simulados/renderizados (padrão 300)
+//   --size LxA             resolução (padrão 1280x720)
+//   --threads N            threads do rasterizador (0 = todos os núcleos)
+//   --output arquivo.ppm   grava o último quadro (PNG se terminar em .png)
+struct HeadlessOptions {
+    bool enabled = false;
+    int frames = 300;
+    int width = 1280;
+    int height = 720;
+    unsigned threads = 0;
+    float fixedDeltaTime = 1.0f / 60.0f; // Passo fixo: execuções repetidas produzem os mesmos quadros
+    std::string outputPath;
+};
+
+HeadlessOptions parseHeadlessOptions(int argc, char** argv);
+
+// Acumula tempos por quadro e imprime a média no final
+class HeadlessReport {
+public:
+    void addFrame(double simulationMs, const SoftwareRenderer::Stats& renderStats);
+    void print(const char* title) const;
+
+private:
+    int frames = 0;
+    double simulationMs = 0.0;
+    double geometryMs = 0.0;
+    double rasterMs = 0.0;
+    size_t drawCalls = 0;
+    size_t triangles = 0;
+    size_t culled = 0;
+};
+
+// Grava o quadro atual do rasterizador em PPM ou PNG (se outputPath não estiver vazio)
+bool saveHeadlessFrame(const HeadlessOptions& options, const SoftwareRenderer& renderer);
+
+#endif // HEADLESS_H
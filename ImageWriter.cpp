@@ -0,0 +1,108 @@
+#include "ImageWriter.h"
+#include <algorithm> // Para std::min
+#include <cstdio>
+
+bool writePPM(const char* path, int width, int height, const std::vector<uint8_t>& rgb) {
+    if (rgb.size() < static_cast<size_t>(width) * height * 3) return false;
+
+    FILE* file = std::fopen(path, "wb");
+    if (!file) return false;
+    std::fprintf(file, "P6\n%d %d\n255\n", width, height);
+    size_t written = std::fwrite(rgb.data(), 1, static_cast<size_t>(width) * height * 3, file);
+    std::fclose(file);
+    return written == static_cast<size_t>(width) * height * 3;
+}
+
+// --- PNG ---
+
+struct Crc32Table {
+    uint32_t values[256];
+    Crc32Table() {
+        for (uint32_t n = 0; n < 256; ++n) {
+            uint32_t c = n;
+            for (int k = 0; k < 8; ++k) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            values[n] = c;
+        }
+    }
+};
+
+static uint32_t crc32Update(uint32_t crc, const uint8_t* data, size_t size) {
+    static const Crc32Table table; // Inicialização thread-safe (C++11)
+    for (size_t i = 0; i < size; ++i) crc = table.values[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    return crc;
+}
+
+static void appendU32(std::vector<uint8_t>& out, uint32_t value) {
+    out.push_back(static_cast<uint8_t>(value >> 24));
+    out.push_back(static_cast<uint8_t>(value >> 16));
+    out.push_back(static_cast<uint8_t>(value >> 8));
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+static void appendChunk(std::vector<uint8_t>& out, const char type[4], const std::vector<uint8_t>& data) {
+    appendU32(out, static_cast<uint32_t>(data.size()));
+    size_t typeStart = out.size();
+    out.insert(out.end(), type, type + 4);
+    out.insert(out.end(), data.begin(), data.end());
+    uint32_t crc = crc32Update(0xFFFFFFFFu, out.data() + typeStart, out.size() - typeStart);
+    appendU32(out, crc ^ 0xFFFFFFFFu);
+}
+
+bool writePNG(const char* path, int width, int height, const std::vector<uint8_t>& rgb) {
+    size_t rowBytes = static_cast<size_t>(width) * 3;
+    if (width <= 0 || height <= 0 || rgb.size() < rowBytes * height) return false;
+
+    // Dados filtrados: cada linha começa com o filtro 0 (None)
+    std::vector<uint8_t> raw;
+    raw.reserve((rowBytes + 1) * height);
+    for (int y = 0; y < height; ++y) {
+        raw.push_back(0);
+        raw.insert(raw.end(), rgb.begin() + y * rowBytes, rgb.begin() + (y + 1) * rowBytes);
+    }
+
+    // Stream zlib com blocos "stored" de até 65535 bytes
+    std::vector<uint8_t> idat;
+    idat.reserve(raw.size() + raw.size() / 65535 * 5 + 16);
+    idat.push_back(0x78);
+    idat.push_back(0x01);
+    uint32_t adlerA = 1, adlerB = 0;
+    size_t offset = 0;
+    do {
+        size_t blockSize = std::min<size_t>(65535, raw.size() - offset);
+        bool last = offset + blockSize == raw.size();
+        idat.push_back(last ? 1 : 0);
+        idat.push_back(static_cast<uint8_t>(blockSize));
+        idat.push_back(static_cast<uint8_t>(blockSize >> 8));
+        idat.push_back(static_cast<uint8_t>(~blockSize));
+        idat.push_back(static_cast<uint8_t>(~blockSize >> 8));
+        for (size_t i = 0; i < blockSize; ++i) {
+            uint8_t byte = raw[offset + i];
+            idat.push_back(byte);
+            adlerA = (adlerA + byte) % 65521;
+            adlerB = (adlerB + adlerA) % 65521;
+        }
+        offset += blockSize;
+    } while (offset < raw.size());
+    appendU32(idat, (adlerB << 16) | adlerA);
+
+    std::vector<uint8_t> header;
+    appendU32(header, static_cast<uint32_t>(width));
+    appendU32(header, static_cast<uint32_t>(height));
+    header.push_back(8); // Bits por canal
+    header.push_back(2); // RGB
+    header.push_back(0); // Deflate
+    header.push_back(0); // Filtro adaptativo padrão
+    header.push_back(0); // Sem entrelaçamento
+
+    static const uint8_t signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    std::vector<uint8_t> file(signature, signature + 8);
+    appendChunk(file, "IHDR", header);
+    appendChunk(file, "IDAT", idat);
+    appendChunk(file, "IEND", std::vector<uint8_t>());
+
+    FILE* out = std::fopen(path, "wb");
+    if (!out) return false;
+    size_t written = std::fwrite(file.data(), 1, file.size(), out);
+    std::fclose(out);
+    return written == file.size();
+}
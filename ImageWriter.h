@@ -0,0 +1,15 @@
+#ifndef IMAGE_WRITER_H
+#define IMAGE_WRITER_H
+
+#include <cstdint>
+#include <vector>
+
+// Grava uma imagem RGB8 (linhas de cima para baixo) como PPM binário (P6)
+bool writePPM(const char* path, int width, int height, const std::vector<uint8_t>& rgb);
+
+// Grava uma imagem RGB8 (linhas de cima para baixo) como PNG.
+// Usa blocos deflate sem compressão: não depende de zlib e é rápido o bastante
+// para a thread de captura; os arquivos ficam do tamanho de um PPM.
+bool writePNG(const char* path, int width, int height, const std::vector<uint8_t>& rgb);
+
+#endif // IMAGE_WRITER_H
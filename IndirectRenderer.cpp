@@ -0,0 +1,698 @@
+#include "IndirectRenderer.h"
+#include "OcclusionCulling.h"
+#include <glm/gtc/type_ptr.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <unordered_map>
+
+// Vértice do buffer compartilhado (12 bytes): posição Short4 nos limites da malha + normal empacotada
+// (0 = sem normal)
+struct BatchVertex {
+    int16_t position[4];
+    uint32_t normal;
+
+    bool operator==(const BatchVertex& other) const { return std::memcmp(this, &other, sizeof(BatchVertex)) == 0; }
+};
+
+struct BatchVertexHash {
+    size_t operator()(const BatchVertex& vertex) const {
+        uint32_t words[3];
+        static_assert(sizeof(words) == sizeof(BatchVertex), "BatchVertexHash: o vértice inteiro entra no hash");
+        std::memcpy(words, &vertex, sizeof(words));
+        size_t hash = 2166136261u;
+        for (uint32_t word : words) hash = (hash ^ word) * 16777619u;
+        return hash;
+    }
+};
+
+// --- Culling na GPU ---
+static const GLuint CULL_GROUP_SIZE = 256;
+
+// Uma invocação por caixa: frustum pelos cantos em espaço de recorte e, com Hi-Z, o mesmo teste de
+// OcclusionCuller::isVisible. visible[i] = 0 ou 1; os descartes vão para os contadores atômicos.
+static const char* CULL_SHADER = R"(#version 430 core
+layout (local_size_x = 256) in;
+
+struct Bounds { vec4 lo; vec4 hi; };
+layout (std430, binding = 0) readonly buffer Objects { Bounds objects[]; };
+layout (std430, binding = 1) writeonly buffer Visibility { uint visible[]; };
+layout (std430, binding = 2) readonly buffer HiZ { float hiz[]; };
+layout (binding = 0, offset = 0) uniform atomic_uint frustumCulled;
+layout (binding = 0, offset = 4) uniform atomic_uint occluded;
+
+uniform uint objectCount;
+uniform mat4 viewProjection;
+uniform int hizLevels;       // 0: só o frustum
+uniform ivec3 hizLevel[16];  // Início em hiz, largura e altura de cada nível
+
+bool hidden(vec2 ndcMin, vec2 ndcMax, float nearest)
+{
+    // Retângulo no nível 0 alargado em um pixel, depois o nível em que cobre no máximo 2x2 texels
+    ivec2 size = hizLevel[0].yz;
+    int x0 = max(0, int(floor((ndcMin.x * 0.5 + 0.5) * float(size.x))) - 1);
+    int x1 = min(size.x - 1, int(floor((ndcMax.x * 0.5 + 0.5) * float(size.x))) + 1);
+    int y0 = max(0, int(floor((ndcMin.y * 0.5 + 0.5) * float(size.y))) - 1);
+    int y1 = min(size.y - 1, int(floor((ndcMax.y * 0.5 + 0.5) * float(size.y))) + 1);
+    if (x0 > x1 || y0 > y1) return false;
+    int level = 0;
+    while (level + 1 < hizLevels && ((x1 >> level) - (x0 >> level) > 1 || (y1 >> level) - (y0 >> level) > 1)) ++level;
+    ivec3 l = hizLevel[level];
+    float farthest = 0.0;
+    for (int y = y0 >> level; y <= (y1 >> level); ++y) {
+        for (int x = x0 >> level; x <= (x1 >> level); ++x) farthest = max(farthest, hiz[l.x + y * l.y + x]);
+    }
+    return nearest > farthest;
+}
+
+void main()
+{
+    uint i = gl_GlobalInvocationID.x;
+    if (i >= objectCount) return;
+    Bounds box = objects[i];
+    uint outsideAll = 31u;
+    bool crossesNear = false;
+    vec3 ndcMin = vec3(3.0e38), ndcMax = vec3(-3.0e38);
+    for (int c = 0; c < 8; ++c) {
+        vec3 corner = vec3((c & 1) != 0 ? box.hi.x : box.lo.x, (c & 2) != 0 ? box.hi.y : box.lo.y,
+                           (c & 4) != 0 ? box.hi.z : box.lo.z);
+        vec4 clip = viewProjection * vec4(corner, 1.0);
+        uint outside = (clip.x < -clip.w ? 1u : 0u) | (clip.x > clip.w ? 2u : 0u)
+                     | (clip.y < -clip.w ? 4u : 0u) | (clip.y > clip.w ? 8u : 0u) | (clip.z > clip.w ? 16u : 0u);
+        outsideAll &= outside;
+        if (clip.w <= 1e-5 || clip.z < -clip.w) {
+            crossesNear = true;
+            continue;
+        }
+        vec3 ndc = clip.xyz / clip.w;
+        ndcMin = min(ndcMin, ndc);
+        ndcMax = max(ndcMax, ndc);
+    }
+    uint result = 1u;
+    if (outsideAll != 0u) {
+        result = 0u;
+        atomicCounterIncrement(frustumCulled);
+    } else if (!crossesNear && hizLevels > 0 && hidden(ndcMin.xy, ndcMax.xy, ndcMin.z * 0.5 + 0.5)) {
+        result = 0u;
+        atomicCounterIncrement(occluded);
+    }
+    visible[i] = result;
+}
+)";
+
+// Uma invocação por parte: as de objetos visíveis vão para a faixa da sua malha em 'instances'
+static const char* COMPACT_SHADER = R"(#version 430 core
+layout (local_size_x = 256) in;
+
+struct Instance { uint words[6]; }; // IndirectInstance, copiado sem decodificar
+struct Part { Instance instance; uint slot; uint object; };
+struct Command { uint count; uint instanceCount; uint firstIndex; int baseVertex; uint baseInstance; };
+layout (std430, binding = 0) readonly buffer Parts { Part parts[]; };
+layout (std430, binding = 1) readonly buffer Visibility { uint visible[]; };
+layout (std430, binding = 3) buffer Commands { Command commands[]; };
+layout (std430, binding = 4) writeonly buffer Instances { Instance instances[]; };
+layout (binding = 0, offset = 8) uniform atomic_uint visibleParts;
+
+uniform uint partCount;
+
+void main()
+{
+    uint i = gl_GlobalInvocationID.x;
+    if (i >= partCount) return;
+    uint object = parts[i].object;
+    if (object != 0xFFFFFFFFu && visible[object] == 0u) return;
+    uint slot = parts[i].slot;
+    uint index = atomicAdd(commands[slot].instanceCount, 1u);
+    instances[commands[slot].baseInstance + index] = parts[i].instance;
+    atomicCounterIncrement(visibleParts);
+}
+)";
+
+static GLuint createComputeProgram(const char* source) {
+    GLuint shader = glCreateShader(GL_COMPUTE_SHADER);
+    glShaderSource(shader, 1, &source, nullptr);
+    glCompileShader(shader);
+    GLint success = 0;
+    char infoLog[1024];
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+    if (!success) {
+        glGetShaderInfoLog(shader, sizeof(infoLog), nullptr, infoLog);
+        std::fprintf(stderr, "Erro ao compilar o compute shader de culling:\n%s\n", infoLog);
+        glDeleteShader(shader);
+        return 0;
+    }
+    GLuint program = glCreateProgram();
+    glAttachShader(program, shader);
+    glLinkProgram(program);
+    glDeleteShader(shader);
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if (!success) {
+        glGetProgramInfoLog(program, sizeof(infoLog), nullptr, infoLog);
+        std::fprintf(stderr, "Erro ao linkar o compute shader de culling:\n%s\n", infoLog);
+        glDeleteProgram(program);
+        return 0;
+    }
+    return program;
+}
+
+// glBufferData com pelo menos 16 bytes: um buffer de armazenamento vazio não pode ser vinculado
+static void streamBuffer(GLenum target, GLuint buffer, size_t bytes, const void* data, GLenum usage) {
+    static const uint32_t zeros[4] = { 0, 0, 0, 0 };
+    glBindBuffer(target, buffer);
+    if (bytes == 0) {
+        glBufferData(target, sizeof(zeros), zeros, usage);
+    } else {
+        glBufferData(target, static_cast<GLsizeiptr>(bytes), data, usage);
+    }
+}
+
+// float -> half (IEEE 754 binary16) arredondando; subnormais viram zero e o que não cabe satura
+static uint16_t packHalf(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    uint32_t sign = (bits >> 16) & 0x8000u;
+    int exponent = static_cast<int>((bits >> 23) & 0xFFu) - 127 + 15;
+    uint32_t mantissa = bits & 0x7FFFFFu;
+    if (exponent <= 0) return static_cast<uint16_t>(sign);
+    if (exponent >= 31) return static_cast<uint16_t>(sign | 0x7BFFu);
+    uint32_t magnitude = (static_cast<uint32_t>(exponent) << 10) | (mantissa >> 13);
+    if (mantissa & 0x1000u) ++magnitude; // O vai-um pode subir o expoente, o que continua certo
+    return static_cast<uint16_t>(sign | std::min(magnitude, 0x7BFFu));
+}
+
+// Os shaders leem os registros com estes tamanhos (atributos com stride fixo e structs std430)
+static_assert(sizeof(IndirectInstance) == 24, "IndirectInstance: 24 bytes, sem preenchimento implícito");
+static_assert(sizeof(BatchDraw) == 32, "BatchDraw: mesmo layout da struct Part do compute shader");
+
+// As três componentes guardadas valem no máximo 1/sqrt(2) em módulo: 10 bits nessa faixa. Com um número
+// par de passos o zero é exato, e rotações em torno de um eixo só (as mais comuns aqui) não ganham inclinação
+static const float QUATERNION_RANGE = 0.70710678f;
+static const float QUATERNION_STEPS = 1022.0f;
+
+IndirectInstance encodeInstance(const glm::mat4& model, uint8_t paletteIndex) {
+    IndirectInstance instance;
+    instance.position[0] = model[3][0];
+    instance.position[1] = model[3][1];
+    instance.position[2] = model[3][2];
+
+    // Colunas da parte 3x3 = eixos da rotação multiplicados pela escala. Espelhada (determinante
+    // negativo), a escala em x fica negativa e a rotação continua própria
+    glm::vec3 axis[3] = { glm::vec3(model[0]), glm::vec3(model[1]), glm::vec3(model[2]) };
+    bool mirrored = glm::dot(glm::cross(axis[0], axis[1]), axis[2]) < 0.0f;
+    float scale[3];
+    for (int i = 0; i < 3; ++i) {
+        float squared = glm::dot(axis[i], axis[i]);
+        if (squared > 1e-30f) {
+            scale[i] = std::sqrt(squared);
+            axis[i] = axis[i] * (1.0f / scale[i]);
+        } else {
+            scale[i] = 0.0f;
+            axis[i] = glm::vec3(0.0f);
+            axis[i][i] = 1.0f; // Escala zero: qualquer eixo serve
+        }
+    }
+    if (mirrored) {
+        scale[0] = -scale[0];
+        axis[0] = -axis[0];
+    }
+    for (int i = 0; i < 3; ++i) instance.scale[i] = packHalf(scale[i]);
+
+    // Quatérnio (x, y, z, w) da matriz de rotação, r(linha, coluna) = axis[coluna][linha]. Como
+    // 4w² = 1 + traço e 4x² = 1 + 2r(0,0) - traço (idem y e z), o maior entre traço e diagonal indica a
+    // maior componente; os eixos são ortonormais, então q já sai unitário
+    auto r = [&](int row, int column) { return axis[column][row]; };
+    float trace = r(0, 0) + r(1, 1) + r(2, 2);
+    int largest = 3;
+    float largestValue = trace;
+    for (int i = 0; i < 3; ++i) {
+        if (r(i, i) > largestValue) {
+            largest = i;
+            largestValue = r(i, i);
+        }
+    }
+    // As outras saem de somas e diferenças fora da diagonal, todas divididas por 4 * (maior componente):
+    // xy, xz, yz (r(i,j) + r(j,i)) e wx, wy, wz (diferenças). A tabela diz quais três ficam guardadas,
+    // na ordem x, y, z, w sem a maior, e evita um desvio imprevisível por parte
+    static const int STORED[4][3] = { { 0, 1, 3 }, { 0, 2, 4 }, { 1, 2, 5 }, { 3, 4, 5 } };
+    float k = 0.5f / std::sqrt(std::max(1.0f + 2.0f * largestValue - trace, 1e-12f));
+    float terms[6] = { (r(0, 1) + r(1, 0)) * k, (r(0, 2) + r(2, 0)) * k, (r(1, 2) + r(2, 1)) * k,
+                       (r(2, 1) - r(1, 2)) * k, (r(0, 2) - r(2, 0)) * k, (r(1, 0) - r(0, 1)) * k };
+
+    // Smallest three: a maior componente (positiva pela raiz; q e -q seriam a mesma rotação) é omitida e
+    // as outras valem no máximo 1/sqrt(2) em módulo
+    uint32_t packed = static_cast<uint32_t>(largest) << 30;
+    for (int i = 0; i < 3; ++i) {
+        float component = std::clamp(terms[STORED[largest][i]], -QUATERNION_RANGE, QUATERNION_RANGE);
+        float code = (component + QUATERNION_RANGE) * (QUATERNION_STEPS / (2.0f * QUATERNION_RANGE));
+        packed |= static_cast<uint32_t>(code + 0.5f) << (10 * i); // code >= 0: arredonda para o mais próximo
+    }
+    instance.rotation = packed;
+    instance.palette = paletteIndex;
+    instance.padding = 0;
+    return instance;
+}
+
+DrawBatch::DrawBatch() {
+    // Posição normalizada (valor/32767 em [-1, 1]): o caminho indireto exige GL 4.3, então vale a regra
+    // de normalização do 4.2 e a conversão é exata. A escala da malha vai para a escala da instância,
+    // onde cabe num half; inteiros não normalizados precisariam de fatores ~1/32767, abaixo da sua faixa
+    layout.add(VertexAttribute::Position, VertexFormat::Short4, true);
+    layout.add(VertexAttribute::Normal, VertexFormat::Int2101010Rev, true);
+}
+
+void DrawBatch::add(int slot, const glm::mat4& model, const glm::vec3& color) {
+    // model * T(bias) * S(extent): a desquantização da malha entra na translação e na escala da instância
+    const MeshRange& range = ranges[slot];
+    glm::mat4 folded(model[0] * range.extent.x, model[1] * range.extent.y, model[2] * range.extent.z,
+                     model * glm::vec4(range.bias, 1.0f));
+    draws.push_back({ encodeInstance(folded, paletteIndex(color)), static_cast<uint32_t>(slot), currentObject });
+}
+
+int DrawBatch::meshSlot(const Mesh& mesh) {
+    for (size_t slot = 0; slot < meshes.size(); ++slot) {
+        if (meshes[slot] == &mesh) return static_cast<int>(slot);
+    }
+
+    // As malhas vêm como listas de triângulos; os vértices iguais viram um só índice
+    MeshRange range;
+    range.firstIndex = static_cast<GLuint>(indices.size());
+    range.baseVertex = static_cast<GLint>(vertices.size() / sizeof(BatchVertex));
+
+    // Quantização própria da malha (a de Mesh::layout depende do formato escolhido para o caminho direto).
+    // Um eixo degenerado fica com extensão 1: os valores guardados nele são todos 0
+    MeshBounds bounds = computeBounds(mesh.positions);
+    MeshQuantization quantization = computeQuantization(bounds, VertexFormat::Short4);
+    glm::vec3 halfExtent = (bounds.max - bounds.min) * 0.5f;
+    range.bias = quantization.bias;
+    for (int axis = 0; axis < 3; ++axis) range.extent[axis] = halfExtent[axis] > 1e-8f ? halfExtent[axis] : 1.0f;
+    VertexLayout positionLayout;
+    positionLayout.add(VertexAttribute::Position, VertexFormat::Short4, true);
+    std::vector<uint8_t> positions = packVertices(mesh.positions, {}, positionLayout, quantization);
+
+    std::unordered_map<BatchVertex, uint32_t, BatchVertexHash> unique;
+    for (size_t v = 0; v < mesh.positions.size(); ++v) {
+        BatchVertex vertex;
+        std::memcpy(vertex.position, positions.data() + v * sizeof(vertex.position), sizeof(vertex.position));
+        // A posição guardada é S(extent)^-1 * (p - bias), então a normal vai multiplicada por S(extent)
+        // (a inversa transposta); o shader a divide pela escala da instância, que já inclui a extensão
+        glm::vec3 normal = v < mesh.normals.size() ? mesh.normals[v] * range.extent : glm::vec3(0.0f);
+        float length = glm::length(normal);
+        vertex.normal = length > 0.0f ? packNormal(normal / length) : 0u;
+        auto inserted = unique.emplace(vertex, static_cast<uint32_t>(unique.size()));
+        if (inserted.second) {
+            const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&vertex);
+            vertices.insert(vertices.end(), bytes, bytes + sizeof(BatchVertex));
+        }
+        indices.push_back(inserted.first->second);
+    }
+    range.indexCount = static_cast<GLuint>(indices.size()) - range.firstIndex;
+
+    int slot = static_cast<int>(ranges.size());
+    ranges.push_back(range);
+    meshes.push_back(&mesh);
+    geometryChanged = true;
+    return slot;
+}
+
+uint8_t DrawBatch::paletteIndex(const glm::vec3& color) {
+    if (color == lastColor) return lastPaletteIndex;
+    size_t best = palette.size();
+    for (size_t i = 0; i < palette.size(); ++i) {
+        if (glm::vec3(palette[i]) == color) {
+            best = i;
+            break;
+        }
+    }
+    if (best == palette.size()) {
+        if (palette.size() < MAX_PALETTE) {
+            palette.push_back(glm::vec4(color, 1.0f));
+            paletteChanged = true;
+        } else {
+            float bestDistance = 0.0f;
+            for (size_t i = 0; i < palette.size(); ++i) {
+                glm::vec3 delta = glm::vec3(palette[i]) - color;
+                float distance = glm::dot(delta, delta);
+                if (i == 0 || distance < bestDistance) {
+                    best = i;
+                    bestDistance = distance;
+                }
+            }
+            ++paletteMisses;
+            return static_cast<uint8_t>(best); // Não entra no cache: a cor não é exata
+        }
+    }
+    lastColor = color;
+    lastPaletteIndex = static_cast<uint8_t>(best);
+    return lastPaletteIndex;
+}
+
+void DrawBatch::clear() {
+    draws.clear();
+    objects.clear();
+    currentObject = NO_OBJECT;
+}
+
+void DrawBatch::beginObject(const glm::vec3& boundsMin, const glm::vec3& boundsMax) {
+    currentObject = static_cast<uint32_t>(objects.size());
+    objects.push_back({ glm::vec4(boundsMin, 1.0f), glm::vec4(boundsMax, 1.0f) });
+}
+
+void DrawBatch::build() {
+    // Ordenação por contagem: quantidade por malha, início de cada faixa e cópia na ordem das malhas
+    slotStart.assign(ranges.size() + 1, 0);
+    for (const BatchDraw& draw : draws) ++slotStart[draw.slot + 1];
+    commands.clear();
+    for (size_t slot = 0; slot < ranges.size(); ++slot) {
+        GLuint count = slotStart[slot + 1];
+        slotStart[slot + 1] += slotStart[slot];
+        if (count == 0 || ranges[slot].indexCount == 0) continue;
+        const MeshRange& range = ranges[slot];
+        commands.push_back({ range.indexCount, count, range.firstIndex, range.baseVertex, slotStart[slot] });
+    }
+    instances.resize(draws.size());
+    for (const BatchDraw& draw : draws) instances[slotStart[draw.slot]++] = draw.instance;
+}
+
+void DrawBatch::buildCommands() {
+    slotStart.assign(ranges.size() + 1, 0);
+    for (const BatchDraw& draw : draws) ++slotStart[draw.slot + 1];
+    commands.resize(ranges.size());
+    for (size_t slot = 0; slot < ranges.size(); ++slot) {
+        const MeshRange& range = ranges[slot];
+        commands[slot] = { range.indexCount, 0, range.firstIndex, range.baseVertex, slotStart[slot] };
+        slotStart[slot + 1] += slotStart[slot];
+    }
+}
+
+IndirectRenderer::IndirectRenderer(GLuint program, bool gpuCulling) : GLRenderer(program), gpuCulling(gpuCulling) {
+    glGenVertexArrays(1, &vao);
+    glGenBuffers(1, &vertexBuffer);
+    glGenBuffers(1, &indexBuffer);
+    glGenBuffers(1, &instanceBuffer);
+    glGenBuffers(1, &commandBuffer);
+
+    glBindVertexArray(vao);
+    glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+    batch.layout.apply();
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer); // Fica registrado no VAO
+
+    // Atributos por instância (os campos de IndirectInstance); os inteiros vão com glVertexAttribIPointer
+    glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+    const GLsizei stride = sizeof(IndirectInstance);
+    glVertexAttribPointer(POSITION_LOCATION, 3, GL_FLOAT, GL_FALSE, stride,
+                          reinterpret_cast<void*>(offsetof(IndirectInstance, position)));
+    glVertexAttribIPointer(ROTATION_LOCATION, 1, GL_UNSIGNED_INT, stride,
+                           reinterpret_cast<void*>(offsetof(IndirectInstance, rotation)));
+    glVertexAttribPointer(SCALE_LOCATION, 3, GL_HALF_FLOAT, GL_FALSE, stride,
+                          reinterpret_cast<void*>(offsetof(IndirectInstance, scale)));
+    glVertexAttribIPointer(PALETTE_LOCATION, 1, GL_UNSIGNED_BYTE, stride,
+                           reinterpret_cast<void*>(offsetof(IndirectInstance, palette)));
+    for (GLuint location = POSITION_LOCATION; location <= PALETTE_LOCATION; ++location) {
+        glVertexAttribDivisor(location, 1);
+        glEnableVertexAttribArray(location);
+    }
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    // Paleta: texture buffer RGBA32F, como os dados das luzes pontuais
+    glGenBuffers(1, &paletteBuffer);
+    glGenTextures(1, &paletteTexture);
+    paletteLoc = glGetUniformLocation(program, "palette");
+
+    if (gpuCulling) {
+        cullProgram = createComputeProgram(CULL_SHADER);
+        compactProgram = createComputeProgram(COMPACT_SHADER);
+        if (cullProgram == 0 || compactProgram == 0) {
+            std::fprintf(stderr, "Culling na GPU desligado: os draws seguem sem culling\n");
+            this->gpuCulling = false;
+            return;
+        }
+        objectCountLoc = glGetUniformLocation(cullProgram, "objectCount");
+        viewProjectionLoc = glGetUniformLocation(cullProgram, "viewProjection");
+        hizLevelsLoc = glGetUniformLocation(cullProgram, "hizLevels");
+        hizLevelLoc = glGetUniformLocation(cullProgram, "hizLevel");
+        partCountLoc = glGetUniformLocation(compactProgram, "partCount");
+        glGenBuffers(1, &partBuffer);
+        glGenBuffers(1, &objectBuffer);
+        glGenBuffers(1, &visibilityBuffer);
+        glGenBuffers(1, &hizBuffer);
+        static const uint32_t zeros[4] = { 0, 0, 0, 0 };
+        for (CounterSlot& slot : counterSlots) {
+            glGenBuffers(1, &slot.buffer);
+            glBindBuffer(GL_ATOMIC_COUNTER_BUFFER, slot.buffer);
+            glBufferData(GL_ATOMIC_COUNTER_BUFFER, sizeof(zeros), zeros, GL_DYNAMIC_READ);
+        }
+        glBindBuffer(GL_ATOMIC_COUNTER_BUFFER, 0);
+    }
+}
+
+IndirectRenderer::~IndirectRenderer() {
+    glDeleteVertexArrays(1, &vao);
+    glDeleteTextures(1, &paletteTexture);
+    GLuint buffers[9] = { vertexBuffer, indexBuffer, instanceBuffer, commandBuffer, paletteBuffer,
+                          partBuffer, objectBuffer, visibilityBuffer, hizBuffer };
+    glDeleteBuffers(9, buffers); // Os nomes 0 são ignorados
+    for (CounterSlot& slot : counterSlots) {
+        if (slot.fence) glDeleteSync(slot.fence);
+        glDeleteBuffers(1, &slot.buffer);
+    }
+    if (cullProgram) glDeleteProgram(cullProgram);
+    if (compactProgram) glDeleteProgram(compactProgram);
+}
+
+void IndirectRenderer::beginFrame(const glm::mat4& view, const glm::mat4& projection, const glm::vec3& clearColor) {
+    GLRenderer::beginFrame(view, projection, clearColor);
+    viewProjection = projection * view;
+    glUniform1i(paletteLoc, static_cast<GLint>(PALETTE_UNIT)); // O programa já está em uso
+    batch.clear();
+}
+
+void IndirectRenderer::reservePalette(const std::vector<glm::vec3>& colors) {
+    for (const glm::vec3& color : colors) batch.paletteIndex(color);
+}
+
+void IndirectRenderer::drawMesh(const Mesh& mesh, const glm::mat4& model, const glm::vec3& color) {
+    if (mesh.positions.empty()) return;
+    // As posições do buffer compartilhado não são quantizadas: a model vai como está, só compactada
+    batch.add(batch.meshSlot(mesh), model, color);
+}
+
+void IndirectRenderer::uploadGeometry() {
+    glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+    glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(batch.vertices.size()), batch.vertices.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(vao);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>(batch.indices.size() * sizeof(uint32_t)),
+                 batch.indices.data(), GL_STATIC_DRAW);
+    glBindVertexArray(0);
+    batch.geometryChanged = false;
+}
+
+void IndirectRenderer::bindPalette() {
+    glActiveTexture(GL_TEXTURE0 + PALETTE_UNIT);
+    glBindTexture(GL_TEXTURE_BUFFER, paletteTexture);
+    if (batch.paletteChanged) {
+        // Só cresce quando aparece uma cor nova, então não precisa de orphaning
+        glBindBuffer(GL_TEXTURE_BUFFER, paletteBuffer);
+        glBufferData(GL_TEXTURE_BUFFER, static_cast<GLsizeiptr>(batch.palette.size() * sizeof(glm::vec4)),
+                     batch.palette.data(), GL_STATIC_DRAW);
+        glBindBuffer(GL_TEXTURE_BUFFER, 0);
+        glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, paletteBuffer);
+        batch.paletteChanged = false;
+    }
+    glActiveTexture(GL_TEXTURE0);
+}
+
+void IndirectRenderer::endFrame() {
+    if (gpuCulling) {
+        submitCulled();
+        GLRenderer::endFrame();
+        return;
+    }
+
+    auto buildStart = std::chrono::steady_clock::now();
+    batch.build();
+    stats.buildMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - buildStart).count();
+    ++stats.frames;
+    stats.draws += batch.drawCount();
+
+    if (!batch.commands.empty()) {
+        if (batch.geometryChanged) uploadGeometry();
+        bindPalette();
+
+        // Realocar a cada quadro (orphaning) evita esperar a GPU terminar o quadro anterior
+        size_t instanceBytes = batch.instances.size() * sizeof(IndirectInstance);
+        size_t commandBytes = batch.commands.size() * sizeof(DrawElementsIndirectCommand);
+        glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+        glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(instanceBytes), batch.instances.data(), GL_STREAM_DRAW);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer);
+        glBufferData(GL_DRAW_INDIRECT_BUFFER, static_cast<GLsizeiptr>(commandBytes), batch.commands.data(), GL_STREAM_DRAW);
+
+        glBindVertexArray(vao);
+        glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, nullptr, static_cast<GLsizei>(batch.commands.size()), 0);
+        glBindVertexArray(0);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+        stats.commands += batch.commands.size();
+        ++stats.multiDraws;
+        stats.instanceBytes += instanceBytes + commandBytes;
+    }
+    GLRenderer::endFrame();
+}
+
+void IndirectRenderer::readCounters(bool wait) {
+    while (pendingCounters > 0) {
+        CounterSlot& slot = counterSlots[oldestCounter];
+        GLenum status = glClientWaitSync(slot.fence, wait ? GL_SYNC_FLUSH_COMMANDS_BIT : 0,
+                                         wait ? 1000000000ull : 0); // Até 1 s quando bloqueante
+        if (status == GL_TIMEOUT_EXPIRED) return;
+        glDeleteSync(slot.fence);
+        slot.fence = nullptr;
+
+        // A fence sinalizou: a leitura não espera a GPU
+        uint32_t counters[3] = { 0, 0, 0 };
+        glBindBuffer(GL_ATOMIC_COUNTER_BUFFER, slot.buffer);
+        glGetBufferSubData(GL_ATOMIC_COUNTER_BUFFER, 0, sizeof(counters), counters);
+        glBindBuffer(GL_ATOMIC_COUNTER_BUFFER, 0);
+        ++stats.countedFrames;
+        stats.frustumCulled += counters[0];
+        stats.occluded += counters[1];
+        stats.visibleParts += counters[2];
+        stats.countedParts += slot.parts;
+
+        oldestCounter = (oldestCounter + 1) % COUNTER_RING_SIZE;
+        --pendingCounters;
+        wait = false; // Só a mais antiga precisa bloquear
+    }
+}
+
+void IndirectRenderer::submitCulled() {
+    auto buildStart = std::chrono::steady_clock::now();
+    batch.buildCommands(); // Só contagem por malha: as partes vão na ordem em que chegaram
+    const std::vector<BatchDraw>& parts = batch.getDraws();
+    const std::vector<ObjectBounds>& objects = batch.getObjects();
+
+    // Pirâmide Hi-Z da CPU, níveis em sequência
+    GLint hizLevel[MAX_HIZ_LEVELS * 3] = {};
+    int hizLevels = 0;
+    hizData.clear();
+    if (occlusion && occlusion->hasDepth()) {
+        hizLevels = std::min(occlusion->levelCount(), MAX_HIZ_LEVELS);
+        for (int level = 0; level < hizLevels; ++level) {
+            int width = occlusion->levelWidth(level), height = occlusion->levelHeight(level);
+            hizLevel[level * 3] = static_cast<GLint>(hizData.size());
+            hizLevel[level * 3 + 1] = width;
+            hizLevel[level * 3 + 2] = height;
+            const float* depth = occlusion->levelData(level);
+            hizData.insert(hizData.end(), depth, depth + static_cast<size_t>(width) * height);
+        }
+    }
+    stats.buildMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - buildStart).count();
+    ++stats.frames;
+    stats.draws += parts.size();
+    stats.objects += objects.size();
+
+    readCounters(false);
+    if (parts.empty()) return;
+    if (pendingCounters == COUNTER_RING_SIZE) {
+        // A GPU está COUNTER_RING_SIZE quadros atrás: espera o mais antigo para liberar o slot
+        ++stats.counterStalls;
+        readCounters(true);
+    }
+    CounterSlot& counterSlot = counterSlots[(oldestCounter + pendingCounters) % COUNTER_RING_SIZE];
+    if (batch.geometryChanged) uploadGeometry();
+    bindPalette();
+
+    size_t partBytes = parts.size() * sizeof(BatchDraw);
+    size_t objectBytes = objects.size() * sizeof(ObjectBounds);
+    size_t commandBytes = batch.commands.size() * sizeof(DrawElementsIndirectCommand);
+    streamBuffer(GL_SHADER_STORAGE_BUFFER, partBuffer, partBytes, parts.data(), GL_STREAM_DRAW);
+    streamBuffer(GL_SHADER_STORAGE_BUFFER, objectBuffer, objectBytes, objects.data(), GL_STREAM_DRAW);
+    streamBuffer(GL_SHADER_STORAGE_BUFFER, visibilityBuffer, objects.size() * sizeof(uint32_t), nullptr, GL_DYNAMIC_COPY);
+    streamBuffer(GL_SHADER_STORAGE_BUFFER, hizBuffer, hizData.size() * sizeof(float), hizData.data(), GL_STREAM_DRAW);
+    streamBuffer(GL_SHADER_STORAGE_BUFFER, instanceBuffer, parts.size() * sizeof(IndirectInstance), nullptr, GL_DYNAMIC_COPY);
+    streamBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer, commandBytes, batch.commands.data(), GL_STREAM_DRAW);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    static const uint32_t zeros[4] = { 0, 0, 0, 0 };
+    glBindBuffer(GL_ATOMIC_COUNTER_BUFFER, counterSlot.buffer);
+    glBufferSubData(GL_ATOMIC_COUNTER_BUFFER, 0, sizeof(zeros), zeros);
+    glBindBuffer(GL_ATOMIC_COUNTER_BUFFER, 0);
+
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, objectBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, visibilityBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, hizBuffer);
+    glBindBufferBase(GL_ATOMIC_COUNTER_BUFFER, 0, counterSlot.buffer);
+    if (!objects.empty()) {
+        glUseProgram(cullProgram);
+        glUniform1ui(objectCountLoc, static_cast<GLuint>(objects.size()));
+        glUniformMatrix4fv(viewProjectionLoc, 1, GL_FALSE, glm::value_ptr(viewProjection));
+        glUniform1i(hizLevelsLoc, hizLevels);
+        glUniform3iv(hizLevelLoc, MAX_HIZ_LEVELS, hizLevel);
+        glDispatchCompute((static_cast<GLuint>(objects.size()) + CULL_GROUP_SIZE - 1) / CULL_GROUP_SIZE, 1, 1);
+        glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+    }
+
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, partBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, commandBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 4, instanceBuffer);
+    glUseProgram(compactProgram);
+    glUniform1ui(partCountLoc, static_cast<GLuint>(parts.size()));
+    glDispatchCompute((static_cast<GLuint>(parts.size()) + CULL_GROUP_SIZE - 1) / CULL_GROUP_SIZE, 1, 1);
+    // BUFFER_UPDATE: a leitura dos contadores e o glBufferSubData que os zera vêm depois dos atomics
+    glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT | GL_ATOMIC_COUNTER_BARRIER_BIT |
+                    GL_BUFFER_UPDATE_BARRIER_BIT);
+    for (GLuint binding = 0; binding <= 4; ++binding) glBindBufferBase(GL_SHADER_STORAGE_BUFFER, binding, 0);
+    glBindBufferBase(GL_ATOMIC_COUNTER_BUFFER, 0, 0);
+    counterSlot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    counterSlot.parts = parts.size();
+    ++pendingCounters;
+
+    // Os comandos das malhas sem partes visíveis ficam com instanceCount 0 e não desenham nada
+    glUseProgram(getProgram());
+    glBindVertexArray(vao);
+    glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, nullptr, static_cast<GLsizei>(batch.commands.size()), 0);
+    glBindVertexArray(0);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+    stats.commands += batch.commands.size();
+    ++stats.multiDraws;
+    stats.instanceBytes += partBytes + objectBytes + commandBytes + hizData.size() * sizeof(float);
+}
+
+void IndirectRenderer::printStats(const char* title) const {
+    if (stats.frames == 0) return;
+    double frames = static_cast<double>(stats.frames);
+    std::printf("%s: %.0f draws in %.0f indirect commands and %.2f multi-draw calls per frame, "
+                "%.1f KiB uploaded, batching %.3f ms per frame (%d meshes in the shared buffer, %zu palette colors, "
+                "%zu approximated)\n",
+                title, stats.draws / frames, stats.commands / frames, stats.multiDraws / frames,
+                stats.instanceBytes / frames / 1024.0, stats.buildMs / frames, batch.meshCount(),
+                batch.palette.size(), batch.paletteMisses);
+    if (gpuCulling && stats.countedFrames > 0) {
+        double counted = static_cast<double>(stats.countedFrames);
+        double objects = std::max(1.0, static_cast<double>(stats.objects) / frames);
+        std::printf("%s GPU culling: %.0f objects per frame, %.1f%% outside the frustum, %.1f%% occluded; "
+                    "%.0f of %.0f parts drawn per frame (%zu counter stalls)\n",
+                    title, stats.objects / frames, 100.0 * stats.frustumCulled / counted / objects,
+                    100.0 * stats.occluded / counted / objects, stats.visibleParts / counted,
+                    stats.countedParts / counted, stats.counterStalls);
+    }
+    std::fflush(stdout);
+}
+
+bool indirectDrawSupported() {
+    return GLEW_VERSION_4_3;
+}
+
+DrawPathOptions parseDrawPathOptions(int argc, char** argv) {
+    DrawPathOptions options;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--no-indirect") == 0) options.indirect = false;
+        else if (std::strcmp(argv[i], "--gpu-cull") == 0) options.gpuCulling = true;
+    }
+    return options;
+}
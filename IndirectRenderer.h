@@ -0,0 +1,231 @@
+#ifndef INDIRECT_RENDERER_H
+#define INDIRECT_RENDERER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <GL/glew.h>
+#include "GLRenderer.h"
+#include "Mesh.h"
+
+class OcclusionCuller;
+
+// Registro lido por glMultiDrawElementsIndirect (o layout é fixo pelo GL)
+struct DrawElementsIndirectCommand {
+    GLuint count;         // Índices da malha
+    GLuint instanceCount; // Draws desta malha no quadro
+    GLuint firstIndex;
+    GLint baseVertex;
+    GLuint baseInstance;  // Primeiro registro da malha em 'instances'
+};
+
+// Dados de um draw, lidos pelo vertex shader como atributos por instância (24 bytes, contra 80 de uma
+// mat4 + cor). A model é guardada como T * R * S: posição em float, rotação em quatérnio "smallest three"
+// (as três menores componentes em 10 bits cada e, nos 2 bits de cima, qual foi omitida; ela é
+// reconstruída com sqrt), escala por eixo em half e a cor como índice na paleta do DrawBatch.
+struct IndirectInstance {
+    float position[3];
+    uint32_t rotation;
+    uint16_t scale[3]; // half; negativa em x se a model espelha
+    uint8_t palette;
+    uint8_t padding;
+};
+
+// A model precisa ser translação * rotação * escala (sem cisalhamento), que é como os draws a montam
+IndirectInstance encodeInstance(const glm::mat4& model, uint8_t paletteIndex);
+
+// Um drawMesh gravado. O layout é o mesmo da struct Part do compute shader de compactação (std430)
+struct BatchDraw {
+    IndirectInstance instance;
+    uint32_t slot;        // Malha no buffer compartilhado
+    uint32_t object;      // Índice em DrawBatch::objects, ou DrawBatch::NO_OBJECT
+};
+
+// Caixa de um objeto em espaço do mundo (w não é usado)
+struct ObjectBounds {
+    glm::vec4 min;
+    glm::vec4 max;
+};
+
+// Parte em CPU do caminho indireto (não chama o GL). As malhas desenhadas entram, na primeira vez,
+// num buffer de vértices e índices compartilhado (posição Short4 nos limites da malha + normal 2_10_10_10,
+// 12 bytes, vértices repetidos fundidos); a desquantização de cada malha vai para a instância. Os draws do quadro são agrupados por malha com uma ordenação por contagem: cada malha usada
+// vira UM comando, com instanceCount = número de draws e baseInstance = onde começam os seus registros.
+class DrawBatch {
+public:
+    static const uint32_t NO_OBJECT = 0xFFFFFFFFu; // Sempre visível (cenário)
+    static const int MAX_PALETTE = 256;            // O índice da cor tem 8 bits
+
+    DrawBatch();
+
+    // Posição da malha no buffer compartilhado; na primeira vez copia a geometria (Mesh::positions)
+    int meshSlot(const Mesh& mesh);
+    int meshCount() const { return static_cast<int>(ranges.size()); }
+
+    void clear();
+    // Os draws entre beginObject e endObject pertencem a essa caixa
+    void beginObject(const glm::vec3& boundsMin, const glm::vec3& boundsMax);
+    void endObject() { currentObject = NO_OBJECT; }
+    void add(int slot, const glm::mat4& model, const glm::vec3& color);
+    size_t drawCount() const { return draws.size(); }
+    const std::vector<BatchDraw>& getDraws() const { return draws; }
+    const std::vector<ObjectBounds>& getObjects() const { return objects; }
+
+    // Sem culling: monta 'commands' e 'instances' a partir dos draws desde o último clear
+    void build();
+    // Culling na GPU: um comando por malha (mesmo as não usadas) com instanceCount 0 e baseInstance no
+    // início da faixa reservada para a malha; o compute shader preenche as contagens e 'instances'
+    void buildCommands();
+
+    // Geometria compartilhada (layout: posição Short4 normalizada + normal)
+    VertexLayout layout;
+    std::vector<uint8_t> vertices;
+    std::vector<uint32_t> indices;
+    bool geometryChanged = false; // Uma malha nova entrou desde que o chamador zerou a flag
+
+    // Paleta de cores: cada cor nova entra na primeira vez; cheia, a cor vai para a mais próxima
+    uint8_t paletteIndex(const glm::vec3& color);
+    std::vector<glm::vec4> palette;  // w não é usado (texture buffer RGBA32F)
+    bool paletteChanged = false;     // Uma cor nova entrou desde que o chamador zerou a flag
+    size_t paletteMisses = 0;        // Cores aproximadas por falta de espaço na paleta
+
+    std::vector<DrawElementsIndirectCommand> commands;
+    std::vector<IndirectInstance> instances;
+
+private:
+    struct MeshRange {
+        GLuint firstIndex;
+        GLuint indexCount;
+        GLint baseVertex;
+        glm::vec3 bias;   // Desquantização da malha no buffer: posição = bias + extent * valor/32767
+        glm::vec3 extent;
+    };
+
+    // Pelo endereço (as malhas vivem o jogo inteiro); são poucas, então a busca é linear
+    std::vector<const Mesh*> meshes;
+    std::vector<MeshRange> ranges;
+    std::vector<BatchDraw> draws;
+    std::vector<ObjectBounds> objects;
+    uint32_t currentObject = NO_OBJECT;
+    std::vector<uint32_t> slotStart;
+    glm::vec3 lastColor = glm::vec3(-1.0f); // Partes seguidas costumam repetir a cor
+    uint8_t lastPaletteIndex = 0;
+};
+
+// Backend OpenGL 4.3: o mesmo fluxo do GLRenderer (e os mesmos uniforms de câmera e luz), mas drawMesh
+// só grava o draw; endFrame envia os registros por instância e os comandos e desenha o quadro inteiro
+// com um glMultiDrawElementsIndirect. O baseInstance de cada comando desloca a leitura dos atributos por
+// instância (divisor 1), então cada draw acha a própria model e cor sem gl_DrawID (que é do 4.6).
+// O programa precisa ler os campos de IndirectInstance nas localizações 2 a 5 ('aPosition', 'aRotation',
+// 'aScale' e 'aPalette') e as cores no samplerBuffer 'palette' (ver shaders/lit_indirect.vert).
+//
+// Com gpuCulling, a visibilidade sai da CPU: endFrame envia todas as caixas de objeto (beginObject) e
+// todas as partes, e dois compute shaders fazem o resto. O primeiro testa cada caixa contra o frustum e,
+// se 'occlusion' tiver profundidade, contra a pirâmide Hi-Z dele (o mesmo teste do OcclusionCuller). O
+// segundo percorre as partes e copia as de objetos visíveis para a faixa da sua malha, reservando a
+// posição com atomicAdd no instanceCount do comando; os totais vão para contadores atômicos.
+class IndirectRenderer : public GLRenderer {
+public:
+    static const GLuint POSITION_LOCATION = 2;
+    static const GLuint ROTATION_LOCATION = 3; // uint
+    static const GLuint SCALE_LOCATION = 4;
+    static const GLuint PALETTE_LOCATION = 5;  // uint
+    static const GLuint PALETTE_UNIT = 3;      // As unidades 0 a 2 são das luzes pontuais
+    static const int MAX_HIZ_LEVELS = 16;
+
+    explicit IndirectRenderer(GLuint program, bool gpuCulling = false);
+    ~IndirectRenderer() override;
+    IndirectRenderer(const IndirectRenderer&) = delete;
+    IndirectRenderer& operator=(const IndirectRenderer&) = delete;
+
+    // Pirâmide Hi-Z usada pelo culling na GPU (montada na CPU a cada quadro); nullptr = só frustum
+    const OcclusionCuller* occlusion = nullptr;
+
+    // Cores que entram na paleta já no início (as demais entram no primeiro draw que as usa)
+    void reservePalette(const std::vector<glm::vec3>& colors);
+
+    void beginFrame(const glm::mat4& view, const glm::mat4& projection, const glm::vec3& clearColor) override;
+    void drawMesh(const Mesh& mesh, const glm::mat4& model, const glm::vec3& color) override;
+    void endFrame() override;
+    void beginObject(const glm::vec3& boundsMin, const glm::vec3& boundsMax) override { batch.beginObject(boundsMin, boundsMax); }
+    void endObject() override { batch.endObject(); }
+    bool cullsObjects() const override { return gpuCulling; }
+
+    // Totais desde a criação
+    struct Stats {
+        size_t frames = 0;
+        size_t draws = 0;          // drawMesh recebidos
+        size_t commands = 0;       // Comandos indiretos por quadro
+        size_t multiDraws = 0;     // Chamadas de glMultiDrawElementsIndirect
+        size_t instanceBytes = 0;  // Enviados por quadro: registros (ou partes e caixas) + comandos
+        double buildMs = 0.0;      // Agrupamento na CPU
+        // Culling na GPU, lidos dos contadores atômicos quando a fence do quadro sinaliza
+        size_t objects = 0;
+        size_t countedFrames = 0;
+        size_t frustumCulled = 0;
+        size_t occluded = 0;
+        size_t visibleParts = 0;
+        size_t countedParts = 0;   // Partes dos quadros contados
+        size_t counterStalls = 0;  // Vezes em que o anel de contadores estava cheio e foi preciso esperar a GPU
+    };
+    const Stats& getStats() const { return stats; }
+    void printStats(const char* title) const;
+
+private:
+    void uploadGeometry();
+    void bindPalette();
+    void submitCulled();
+    void readCounters(bool wait); // Soma os slots prontos, do mais antigo ao mais novo
+
+    DrawBatch batch;
+    bool gpuCulling;
+    glm::mat4 viewProjection = glm::mat4(1.0f);
+    GLuint vao = 0;
+    GLuint vertexBuffer = 0;
+    GLuint indexBuffer = 0;
+    GLuint instanceBuffer = 0;
+    GLuint commandBuffer = 0;
+    GLuint paletteBuffer = 0;
+    GLuint paletteTexture = 0;
+    GLint paletteLoc = -1;
+
+    // Culling na GPU
+    GLuint cullProgram = 0;
+    GLuint compactProgram = 0;
+    GLuint partBuffer = 0;
+    GLuint objectBuffer = 0;
+    GLuint visibilityBuffer = 0;
+    GLuint hizBuffer = 0;
+    // Contadores atômicos num anel com uma fence por quadro, como os PBOs do FrameCapture:
+    // um slot só é lido (e zerado para reuso) depois que a GPU terminou os compute shaders dele
+    static const int COUNTER_RING_SIZE = 3;
+    struct CounterSlot {
+        GLuint buffer = 0;
+        GLsync fence = nullptr;
+        size_t parts = 0; // Partes do quadro que usou o slot
+    };
+    CounterSlot counterSlots[COUNTER_RING_SIZE];
+    int oldestCounter = 0;
+    int pendingCounters = 0;
+    GLint objectCountLoc = -1;
+    GLint viewProjectionLoc = -1;
+    GLint hizLevelsLoc = -1;
+    GLint hizLevelLoc = -1;
+    GLint partCountLoc = -1;
+    std::vector<float> hizData;
+    Stats stats;
+};
+
+// glMultiDrawElementsIndirect com baseInstance e compute shaders (contexto 4.3 ou mais novo)
+bool indirectDrawSupported();
+
+// --no-indirect   usa o GLRenderer (um glDrawArrays por parte) mesmo com GL 4.3
+// --gpu-cull      culling por personagem em compute shaders (frustum; com --occlusion também Hi-Z)
+struct DrawPathOptions {
+    bool indirect = true;
+    bool gpuCulling = false;
+};
+
+DrawPathOptions parseDrawPathOptions(int argc, char** argv);
+
+#endif // INDIRECT_RENDERER_H
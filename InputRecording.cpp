@@ -0,0 +1,162 @@
+#include "InputRecording.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+
+static const char INPUT_MAGIC[4] = { 'C', 'G', 'I', 'R' };
+static const uint32_t INPUT_VERSION = 1;
+
+InputKeyMap::InputKeyMap(std::initializer_list<int> glfwKeys) : keys(glfwKeys) {
+    if (keys.size() > 32) keys.resize(32);
+}
+
+int InputKeyMap::bit(int glfwKey) const {
+    for (size_t i = 0; i < keys.size(); ++i) {
+        if (keys[i] == glfwKey) return static_cast<int>(i);
+    }
+    return -1;
+}
+
+InputOptions parseInputOptions(int argc, char** argv) {
+    InputOptions options;
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(arg, "--record") == 0 && hasValue) {
+            options.recordPath = argv[++i];
+        } else if (std::strcmp(arg, "--replay") == 0 && hasValue) {
+            options.replayPath = argv[++i];
+        } else if (std::strcmp(arg, "--seed") == 0 && hasValue) {
+            options.hasSeed = true;
+            options.seed = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        }
+    }
+    return options;
+}
+
+// --- Leitura/escrita little-endian ---
+
+static void writeU32(std::vector<uint8_t>& out, uint32_t value) {
+    for (int i = 0; i < 4; ++i) out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+}
+
+static bool readU32(const std::vector<uint8_t>& in, size_t& offset, uint32_t& value) {
+    if (offset + 4 > in.size()) return false;
+    value = 0;
+    for (int i = 0; i < 4; ++i) value |= static_cast<uint32_t>(in[offset + i]) << (8 * i);
+    offset += 4;
+    return true;
+}
+
+static uint32_t floatBits(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+static float bitsToFloat(uint32_t bits) {
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+InputStream::InputStream(const InputKeyMap& keyMap, const InputOptions& options)
+    : keyMap(keyMap), recordPath(options.recordPath) {
+    seed = options.hasSeed ? options.seed : std::random_device{}();
+
+    if (!options.replayPath.empty()) {
+        replaying = load(options.replayPath);
+        if (!replaying) std::cerr << "Failed to load input replay " << options.replayPath << std::endl;
+    }
+    // Gravar durante um replay regrava a mesma sequência (útil para migrar versões do formato)
+    recording = !recordPath.empty();
+}
+
+InputStream::~InputStream() {
+    if (recording) save();
+}
+
+InputFrame InputStream::next(const InputFrame& live) {
+    previousKeys = current.keys;
+    if (replaying) {
+        current = cursor < frames.size() ? frames[cursor++] : InputFrame();
+        return current;
+    }
+
+    current = live;
+    if (recording) frames.push_back(live);
+    return current;
+}
+
+bool InputStream::isDown(int glfwKey) const {
+    int bit = keyMap.bit(glfwKey);
+    return bit >= 0 && (current.keys & (1u << bit)) != 0;
+}
+
+bool InputStream::wasPressed(int glfwKey) const {
+    int bit = keyMap.bit(glfwKey);
+    return bit >= 0 && (current.keys & ~previousKeys & (1u << bit)) != 0;
+}
+
+bool InputStream::save() {
+    std::vector<uint8_t> data(INPUT_MAGIC, INPUT_MAGIC + 4);
+    writeU32(data, INPUT_VERSION);
+    writeU32(data, seed);
+    writeU32(data, static_cast<uint32_t>(keyMap.getKeys().size()));
+    for (int key : keyMap.getKeys()) writeU32(data, static_cast<uint32_t>(key));
+    writeU32(data, static_cast<uint32_t>(frames.size()));
+    for (const InputFrame& frame : frames) {
+        writeU32(data, floatBits(frame.deltaTime));
+        writeU32(data, frame.keys);
+    }
+
+    FILE* file = std::fopen(recordPath.c_str(), "wb");
+    if (!file) {
+        std::cerr << "Failed to write input recording " << recordPath << std::endl;
+        return false;
+    }
+    bool ok = std::fwrite(data.data(), 1, data.size(), file) == data.size();
+    std::fclose(file);
+    if (ok) {
+        std::cout << "Recorded " << frames.size() << " input ticks (seed " << seed << ") to " << recordPath << std::endl;
+    }
+    return ok;
+}
+
+bool InputStream::load(const std::string& path) {
+    FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) return false;
+    std::vector<uint8_t> data;
+    uint8_t buffer[4096];
+    size_t n;
+    while ((n = std::fread(buffer, 1, sizeof(buffer), file)) > 0) data.insert(data.end(), buffer, buffer + n);
+    std::fclose(file);
+
+    if (data.size() < 4 || std::memcmp(data.data(), INPUT_MAGIC, 4) != 0) return false;
+    size_t offset = 4;
+    uint32_t version, fileSeed, keyCount;
+    if (!readU32(data, offset, version) || version != INPUT_VERSION) return false;
+    if (!readU32(data, offset, fileSeed) || !readU32(data, offset, keyCount)) return false;
+
+    // As teclas precisam bater com as do jogo, senão os bits significariam outra coisa
+    if (keyCount != keyMap.getKeys().size()) return false;
+    for (uint32_t i = 0; i < keyCount; ++i) {
+        uint32_t key;
+        if (!readU32(data, offset, key) || static_cast<int>(key) != keyMap.getKeys()[i]) return false;
+    }
+
+    uint32_t frameCount;
+    if (!readU32(data, offset, frameCount) || data.size() - offset < static_cast<size_t>(frameCount) * 8) return false;
+    // Lidos num vetor à parte: um arquivo truncado não deixa a gravação atual pela metade
+    std::vector<InputFrame> loaded(frameCount);
+    for (InputFrame& frame : loaded) {
+        uint32_t dtBits;
+        if (!readU32(data, offset, dtBits) || !readU32(data, offset, frame.keys)) return false;
+        frame.deltaTime = bitsToFloat(dtBits);
+    }
+    frames.swap(loaded);
+    seed = fileSeed;
+    return true;
+}
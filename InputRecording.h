@@ -0,0 +1,88 @@
+#ifndef INPUT_RECORDING_H
+#define INPUT_RECORDING_H
+
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+// Estado da entrada num tick da simulação: o dt usado e um bit por tecla rastreada
+struct InputFrame {
+    float deltaTime = 0.0f;
+    uint32_t keys = 0;
+};
+
+// Teclas que o jogo consulta; a posição na lista é o bit gravado (máximo 32).
+// A lista é salva no arquivo, então um replay de outro jogo/versão é recusado.
+class InputKeyMap {
+public:
+    InputKeyMap(std::initializer_list<int> glfwKeys);
+
+    int bit(int glfwKey) const; // -1 se a tecla não é rastreada
+    const std::vector<int>& getKeys() const { return keys; }
+
+private:
+    std::vector<int> keys;
+};
+
+// Opções de gravação/reprodução, comuns aos dois executáveis e aos modos janela/headless:
+//   --record arquivo   grava a entrada de cada tick (teclas + dt) e a semente do RNG
+//   --replay arquivo   ignora o teclado e reproduz o arquivo; o jogo termina junto com ele
+//   --seed N           semente do RNG (sem ela, uma aleatória; no replay vale a do arquivo)
+struct InputOptions {
+    std::string recordPath;
+    std::string replayPath;
+    bool hasSeed = false;
+    uint32_t seed = 0;
+};
+
+InputOptions parseInputOptions(int argc, char** argv);
+
+// Fonte de entrada por tick: ao vivo, ao vivo + gravação, ou reprodução.
+// O loop chama next() uma vez por tick e consulta isDown()/wasPressed() no lugar de glfwGetKey;
+// a máscara ao vivo vem do InputState (eventos do GLFW).
+//
+// Arquivo (little-endian): "CGIR", versão, semente, nº de teclas, códigos GLFW
+// das teclas, nº de ticks e então 8 bytes por tick (dt float + máscara uint32).
+class InputStream {
+public:
+    InputStream(const InputKeyMap& keyMap, const InputOptions& options);
+    ~InputStream(); // Salva a gravação, se houver
+
+    InputStream(const InputStream&) = delete;
+    InputStream& operator=(const InputStream&) = delete;
+
+    // Semente que o jogo deve usar no RNG (do arquivo, quando em replay)
+    uint32_t getSeed() const { return seed; }
+
+    bool isRecording() const { return recording; }
+    bool isReplaying() const { return replaying; }
+    bool finished() const { return replaying && cursor >= frames.size(); }
+    size_t frameCount() const { return frames.size(); }
+
+    // Avança um tick. Em replay devolve o quadro gravado (ignorando 'live');
+    // caso contrário devolve 'live' e o grava se --record foi pedido.
+    InputFrame next(const InputFrame& live);
+
+    // Estado da tecla no tick atual (teclas não rastreadas contam como soltas)
+    bool isDown(int glfwKey) const;
+    // Borda de descida: pressionada neste tick e solta no anterior
+    bool wasPressed(int glfwKey) const;
+
+    bool save();
+
+private:
+    bool load(const std::string& path);
+
+    const InputKeyMap& keyMap;
+    std::string recordPath;
+    bool recording = false;
+    bool replaying = false;
+    uint32_t seed = 0;
+    std::vector<InputFrame> frames;
+    size_t cursor = 0;
+    InputFrame current;
+    uint32_t previousKeys = 0;
+};
+
+#endif // INPUT_RECORDING_H
@@ -0,0 +1,68 @@
+#include "InputState.h"
+#include <GLFW/glfw3.h>
+#include <chrono>
+
+int64_t inputClockNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+bool InputEventQueue::push(const InputEvent& event) {
+    if (events.push(event)) return true;
+    droppedEvents.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+static void keyCallback(GLFWwindow* window, int key, int /*scancode*/, int action, int /*mods*/) {
+    if (action == GLFW_REPEAT) return;
+    if (key == GLFW_KEY_ESCAPE && action == GLFW_PRESS) glfwSetWindowShouldClose(window, true);
+
+    InputEvent event;
+    event.timeNs = inputClockNs();
+    event.code = key;
+    event.action = action;
+    event.type = InputEvent::Key;
+    static_cast<InputEventQueue*>(glfwGetWindowUserPointer(window))->push(event);
+}
+
+static void mouseButtonCallback(GLFWwindow* window, int button, int action, int /*mods*/) {
+    InputEvent event;
+    event.timeNs = inputClockNs();
+    event.code = button;
+    event.action = action;
+    event.type = InputEvent::MouseButton;
+    static_cast<InputEventQueue*>(glfwGetWindowUserPointer(window))->push(event);
+}
+
+void installInputCallbacks(GLFWwindow* window, InputEventQueue& queue) {
+    glfwSetWindowUserPointer(window, &queue);
+    glfwSetKeyCallback(window, keyCallback);
+    glfwSetMouseButtonCallback(window, mouseButtonCallback);
+}
+
+InputState::InputState(const InputKeyMap& keyMap) : keyMap(keyMap) {}
+
+uint32_t InputState::update(InputEventQueue& queue) {
+    uint32_t pressedThisTick = 0;
+    oldestTickEventNs = 0;
+    InputEvent event;
+    while (queue.pop(event)) {
+        if (oldestTickEventNs == 0) oldestTickEventNs = event.timeNs;
+        lastEventNs = event.timeNs;
+        if (event.type == InputEvent::MouseButton) {
+            if (event.code < 0 || event.code >= 32) continue;
+            if (event.action == GLFW_PRESS) mouseButtons |= 1u << event.code;
+            else mouseButtons &= ~(1u << event.code);
+            continue;
+        }
+
+        int bit = keyMap.bit(event.code);
+        if (bit < 0) continue;
+        if (event.action == GLFW_PRESS) {
+            keysDown |= 1u << bit;
+            pressedThisTick |= 1u << bit;
+        } else {
+            keysDown &= ~(1u << bit);
+        }
+    }
+    return keysDown | pressedThisTick;
+}
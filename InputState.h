@@ -0,0 +1,65 @@
+#ifndef INPUT_STATE_H
+#define INPUT_STATE_H
+
+#include <atomic>
+#include <cstdint>
+#include "InputRecording.h"
+#include "SpscQueue.h"
+
+struct GLFWwindow;
+
+// Relógio dos eventos (steady_clock em ns); a medição de latência usa o mesmo
+int64_t inputClockNs();
+
+// Evento de teclado/mouse como chegou do GLFW, com o instante (steady_clock, ns)
+struct InputEvent {
+    enum Type : uint8_t { Key, MouseButton };
+
+    int64_t timeNs = 0;
+    int code = 0;    // GLFW_KEY_* ou GLFW_MOUSE_BUTTON_*
+    int action = 0;  // GLFW_PRESS ou GLFW_RELEASE (repetições do SO não entram na fila)
+    Type type = Key;
+};
+
+// Produtor: callbacks do GLFW (thread principal, dentro de glfwPollEvents).
+// Consumidor: quem roda a simulação (InputState::update).
+class InputEventQueue {
+public:
+    bool push(const InputEvent& event);
+    bool pop(InputEvent& event) { return events.pop(event); }
+
+    size_t dropped() const { return droppedEvents.load(std::memory_order_relaxed); } // Fila cheia
+
+private:
+    SpscQueue<InputEvent, 256> events;
+    std::atomic<size_t> droppedEvents{0};
+};
+
+// Liga os callbacks de tecla e botão do mouse da janela à fila (usa o user pointer da janela).
+// Esc fecha a janela direto no callback.
+void installInputCallbacks(GLFWwindow* window, InputEventQueue& queue);
+
+// Junta os eventos de um tick no estado das teclas rastreadas pelo InputKeyMap.
+// Uma tecla apertada e solta entre dois ticks ainda aparece como pressionada
+// naquele tick, então toques curtos não se perdem. As bordas (wasPressed) ficam
+// no InputStream, para valerem igual no replay.
+class InputState {
+public:
+    explicit InputState(const InputKeyMap& keyMap);
+
+    // Consome a fila e devolve a máscara de teclas do tick
+    uint32_t update(InputEventQueue& queue);
+
+    bool isMouseDown(int button) const { return button >= 0 && button < 32 && (mouseButtons & (1u << button)) != 0; }
+    int64_t lastEventTimeNs() const { return lastEventNs; } // Instante do evento mais recente já consumido
+    int64_t tickEventTimeNs() const { return oldestTickEventNs; } // Evento mais antigo do último update (0 se nenhum)
+
+private:
+    const InputKeyMap& keyMap;
+    uint32_t keysDown = 0;
+    uint32_t mouseButtons = 0;
+    int64_t lastEventNs = 0;
+    int64_t oldestTickEventNs = 0;
+};
+
+#endif // INPUT_STATE_H
@@ -0,0 +1,208 @@
+#include "Lighting.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+int LightClusters::sliceOf(float depth) const {
+    int slice = static_cast<int>(std::floor(std::log(depth) * sliceScale + sliceBias));
+    return std::clamp(slice, 0, SLICES - 1);
+}
+
+// Bloco da tela de uma coordenada NDC em [-1, 1]
+static int tileOf(float ndc, int tiles) {
+    int tile = static_cast<int>(std::floor((ndc * 0.5f + 0.5f) * tiles));
+    return std::clamp(tile, 0, tiles - 1);
+}
+
+// Faixa de v/d para v em [lo, hi] e d em [nearDepth, farDepth] (d > 0): v/d é monótono em cada
+// variável, então os extremos estão nos cantos
+static void projectedRange(float lo, float hi, float nearDepth, float farDepth, float& outMin, float& outMax) {
+    float a = lo / nearDepth, b = lo / farDepth, c = hi / nearDepth, d = hi / farDepth;
+    outMin = std::min(std::min(a, b), std::min(c, d));
+    outMax = std::max(std::max(a, b), std::max(c, d));
+}
+
+// Faixa em espaço de visão de um bloco [ndcLow, ndcHigh] da tela entre duas profundidades
+static void tileRange(float ndcLow, float ndcHigh, float nearDepth, float farDepth, float scale,
+                      float& outMin, float& outMax) {
+    outMin = std::min(ndcLow * nearDepth, ndcLow * farDepth) / scale;
+    outMax = std::max(ndcHigh * nearDepth, ndcHigh * farDepth) / scale;
+}
+
+// Distância de v ao intervalo [lo, hi] (0 dentro dele)
+static float axisDistance(float v, float lo, float hi) {
+    return v < lo ? lo - v : (v > hi ? v - hi : 0.0f);
+}
+
+void LightClusters::build(const std::vector<PointLight>& lights, const glm::mat4& view, const glm::mat4& projection,
+                          float nearPlane, float farPlane) {
+    auto start = std::chrono::steady_clock::now();
+
+    // Fatias exponenciais: fatia s cobre [near * (far/near)^(s/S), near * (far/near)^((s+1)/S)]
+    float logRatio = std::log(farPlane / nearPlane);
+    sliceScale = SLICES / logRatio;
+    sliceBias = -SLICES * std::log(nearPlane) / logRatio;
+    sliceDepths.resize(SLICES + 1);
+    for (int s = 0; s <= SLICES; ++s) {
+        sliceDepths[s] = nearPlane * std::pow(farPlane / nearPlane, static_cast<float>(s) / SLICES);
+    }
+
+    // Perspectiva simétrica: ndc.x = scaleX * x / d e ndc.y = scaleY * y / d, com d = -z
+    const float scaleX = projection[0][0];
+    const float scaleY = projection[1][1];
+    const float tileWidth = 2.0f / TILES_X;  // Em NDC
+    const float tileHeight = 2.0f / TILES_Y;
+
+    lightData.clear();
+    pairClusters.clear();
+    pairLights.clear();
+    for (const PointLight& light : lights) {
+        glm::vec3 center = glm::vec3(view * glm::vec4(light.position, 1.0f));
+        float radius = light.radius;
+        float depth = -center.z;
+        float minDepth = std::max(depth - radius, nearPlane);
+        float maxDepth = std::min(depth + radius, farPlane);
+        if (minDepth >= maxDepth) continue; // Atrás da câmera ou depois do far
+
+        // Blocos cobertos pela caixa da esfera
+        float x0, x1, y0, y1;
+        projectedRange(center.x - radius, center.x + radius, minDepth, maxDepth, x0, x1);
+        projectedRange(center.y - radius, center.y + radius, minDepth, maxDepth, y0, y1);
+        x0 *= scaleX; x1 *= scaleX;
+        y0 *= scaleY; y1 *= scaleY;
+        if (x1 < -1.0f || x0 > 1.0f || y1 < -1.0f || y0 > 1.0f) continue;
+        int tileX0 = tileOf(x0, TILES_X), tileX1 = tileOf(x1, TILES_X);
+        int tileY0 = tileOf(y0, TILES_Y), tileY1 = tileOf(y1, TILES_Y);
+        int slice0 = sliceOf(minDepth), slice1 = sliceOf(maxDepth);
+
+        // Esfera contra a caixa (em espaço de visão) de cada froxel da faixa
+        uint32_t index = static_cast<uint32_t>(lightData.size() / 2);
+        size_t firstPair = pairClusters.size();
+        float radius2 = radius * radius;
+        for (int slice = slice0; slice <= slice1; ++slice) {
+            float nearDepth = sliceDepths[slice], farDepth = sliceDepths[slice + 1];
+            float dz = axisDistance(depth, nearDepth, farDepth);
+            float distanceZ2 = dz * dz;
+            if (distanceZ2 > radius2) continue;
+            for (int tileY = tileY0; tileY <= tileY1; ++tileY) {
+                float ndcY = tileY * tileHeight - 1.0f;
+                float lowY, highY;
+                tileRange(ndcY, ndcY + tileHeight, nearDepth, farDepth, scaleY, lowY, highY);
+                float dy = axisDistance(center.y, lowY, highY);
+                float distanceYZ2 = distanceZ2 + dy * dy;
+                if (distanceYZ2 > radius2) continue;
+                for (int tileX = tileX0; tileX <= tileX1; ++tileX) {
+                    float ndcX = tileX * tileWidth - 1.0f;
+                    float lowX, highX;
+                    tileRange(ndcX, ndcX + tileWidth, nearDepth, farDepth, scaleX, lowX, highX);
+                    float dx = axisDistance(center.x, lowX, highX);
+                    if (distanceYZ2 + dx * dx > radius2) continue;
+                    pairClusters.push_back(static_cast<uint32_t>(clusterIndex(tileX, tileY, slice)));
+                    pairLights.push_back(index);
+                }
+            }
+        }
+        if (pairClusters.size() == firstPair) continue;
+        lightData.push_back(glm::vec4(center, radius));
+        lightData.push_back(glm::vec4(light.color, 0.0f));
+    }
+
+    // Ordenação por contagem: quantidade por cluster, somas acumuladas (fim de cada faixa) e
+    // preenchimento de trás para frente, que deixa o início de cada faixa no lugar certo e os
+    // índices de cada cluster em ordem crescente
+    clusterRanges.assign(CLUSTER_COUNT * 2, 0);
+    for (uint32_t cluster : pairClusters) ++clusterRanges[cluster * 2 + 1];
+    uint32_t offset = 0;
+    size_t activeClusters = 0;
+    size_t maxPerCluster = 0;
+    for (int cluster = 0; cluster < CLUSTER_COUNT; ++cluster) {
+        uint32_t count = clusterRanges[cluster * 2 + 1];
+        offset += count;
+        clusterRanges[cluster * 2] = offset;
+        if (count) ++activeClusters;
+        maxPerCluster = std::max<size_t>(maxPerCluster, count);
+    }
+    lightIndices.resize(pairClusters.size());
+    for (size_t i = pairClusters.size(); i-- > 0;) {
+        lightIndices[--clusterRanges[pairClusters[i] * 2]] = pairLights[i];
+    }
+
+    ++stats.builds;
+    stats.lights += lights.size();
+    stats.visibleLights += lightData.size() / 2;
+    stats.indices += lightIndices.size();
+    stats.activeClusters += activeClusters;
+    stats.maxPerCluster = std::max(stats.maxPerCluster, maxPerCluster);
+    stats.buildMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void LightClusters::upload() {
+    bool created = !isUploaded();
+    if (created) {
+        glGenBuffers(3, buffers);
+        glGenTextures(3, textures);
+    }
+    // Um texture buffer vazio ganha um texel de zeros (a faixa de todo cluster tem quantidade 0)
+    static const uint32_t empty[4] = {0, 0, 0, 0};
+    const GLenum formats[3] = {GL_RGBA32F, GL_RG32UI, GL_R32UI};
+    const void* data[3] = {lightData.data(), clusterRanges.data(), lightIndices.data()};
+    const size_t bytes[3] = {lightData.size() * sizeof(glm::vec4), clusterRanges.size() * sizeof(uint32_t),
+                             lightIndices.size() * sizeof(uint32_t)};
+    for (int i = 0; i < 3; ++i) {
+        glBindBuffer(GL_TEXTURE_BUFFER, buffers[i]);
+        // Realocar a cada quadro evita esperar a GPU terminar de ler os dados do quadro anterior
+        if (bytes[i] == 0) {
+            glBufferData(GL_TEXTURE_BUFFER, sizeof(empty), empty, GL_STREAM_DRAW);
+        } else {
+            glBufferData(GL_TEXTURE_BUFFER, static_cast<GLsizeiptr>(bytes[i]), data[i], GL_STREAM_DRAW);
+        }
+        if (created) {
+            glBindTexture(GL_TEXTURE_BUFFER, textures[i]);
+            glTexBuffer(GL_TEXTURE_BUFFER, formats[i], buffers[i]);
+        }
+    }
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
+void LightClusters::bindTextures(GLuint firstUnit) const {
+    for (GLuint i = 0; i < 3; ++i) {
+        glActiveTexture(GL_TEXTURE0 + firstUnit + i);
+        glBindTexture(GL_TEXTURE_BUFFER, textures[i]);
+    }
+    glActiveTexture(GL_TEXTURE0);
+}
+
+void LightClusters::destroy() {
+    if (!isUploaded()) return;
+    glDeleteTextures(3, textures);
+    glDeleteBuffers(3, buffers);
+    for (int i = 0; i < 3; ++i) textures[i] = buffers[i] = 0;
+}
+
+void LightClusters::printStats(const char* title) const {
+    if (stats.builds == 0) return;
+    double builds = static_cast<double>(stats.builds);
+    std::printf("%s: %.0f lights (%.0f visible), %.0f cluster entries in %.0f of %d clusters "
+                "(%.1f lights per lit cluster, worst %zu), build %.3f ms/frame\n",
+                title, stats.lights / builds, stats.visibleLights / builds, stats.indices / builds,
+                stats.activeClusters / builds, CLUSTER_COUNT,
+                stats.activeClusters ? static_cast<double>(stats.indices) / stats.activeClusters : 0.0,
+                stats.maxPerCluster, stats.buildMs / builds);
+    std::fflush(stdout);
+}
+
+LightingOptions parseLightingOptions(int argc, char** argv) {
+    LightingOptions options;
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(arg, "--lights") == 0 && hasValue) {
+            options.lights = std::max(0, std::atoi(argv[++i]));
+        }
+    }
+    return options;
+}
@@ -0,0 +1,85 @@
+#ifndef LIGHTING_H
+#define LIGHTING_H
+
+#include <cstdint>
+#include <vector>
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+// Luz pontual: a contribuição cai suavemente até zero em 'radius'
+struct PointLight {
+    glm::vec3 position = glm::vec3(0.0f); // Espaço do mundo
+    float radius = 1.0f;
+    glm::vec3 color = glm::vec3(1.0f);    // Já multiplicada pela intensidade
+};
+
+// Iluminação em clusters: o frustum da câmera é dividido em froxels (TILES_X x TILES_Y blocos da
+// tela x SLICES fatias de profundidade exponenciais entre near e far). A cada quadro a CPU testa a
+// esfera de cada luz contra a caixa de cada froxel que ela pode tocar e monta, por cluster, a lista
+// das luzes que o atingem. O shader (shaders/lit.frag) acha o cluster do fragmento por gl_FragCoord
+// e pela profundidade e só avalia essas luzes, então o custo por fragmento depende das luzes perto
+// dele e não do total da cena.
+//
+// Os três buffers vão para a GPU como texture buffers (GL 3.1+), já que o jogo usa um contexto 3.3:
+//   lightData      RGBA32F, 2 texels por luz visível: posição em espaço de visão + raio, cor
+//   clusterRanges  RG32UI, 1 texel por cluster: início em lightIndices e quantidade
+//   lightIndices   R32UI, índices em lightData
+class LightClusters {
+public:
+    static const int TILES_X = 16;
+    static const int TILES_Y = 9;
+    static const int SLICES = 24;
+    static const int CLUSTER_COUNT = TILES_X * TILES_Y * SLICES;
+
+    // 'projection' deve ser uma perspectiva simétrica (glm::perspective) com os mesmos near e far
+    void build(const std::vector<PointLight>& lights, const glm::mat4& view, const glm::mat4& projection,
+               float nearPlane, float farPlane);
+
+    // Mesmo cálculo do shader: fatia de uma profundidade (distância positiva ao longo de -Z)
+    int sliceOf(float depth) const;
+    int clusterIndex(int tileX, int tileY, int slice) const { return (slice * TILES_Y + tileY) * TILES_X + tileX; }
+
+    // Resultado do último build (em CPU; upload() envia para a GPU)
+    std::vector<glm::vec4> lightData;
+    std::vector<uint32_t> clusterRanges;
+    std::vector<uint32_t> lightIndices;
+    float sliceScale = 0.0f; // fatia = log(profundidade) * sliceScale + sliceBias
+    float sliceBias = 0.0f;
+
+    // Cria os buffers na primeira chamada e depois só substitui o conteúdo (precisa de contexto GL)
+    void upload();
+    // Vincula os três texture buffers às unidades firstUnit, firstUnit + 1 e firstUnit + 2
+    void bindTextures(GLuint firstUnit) const;
+    bool isUploaded() const { return textures[0] != 0; }
+    void destroy();
+
+    // Totais desde o início (um build por quadro)
+    struct Stats {
+        size_t builds = 0;
+        size_t lights = 0;           // Luzes recebidas
+        size_t visibleLights = 0;    // ...que tocam algum cluster
+        size_t indices = 0;          // Pares (cluster, luz)
+        size_t activeClusters = 0;   // Clusters com pelo menos uma luz
+        size_t maxPerCluster = 0;    // Pior cluster de todos os builds
+        double buildMs = 0.0;
+    };
+    const Stats& getStats() const { return stats; }
+    void printStats(const char* title) const;
+
+private:
+    std::vector<float> sliceDepths;      // SLICES + 1 limites de profundidade
+    std::vector<uint32_t> pairClusters;  // Pares do build, antes da ordenação por cluster
+    std::vector<uint32_t> pairLights;
+    GLuint buffers[3] = {0, 0, 0};
+    GLuint textures[3] = {0, 0, 0};
+    Stats stats;
+};
+
+// --lights N   N luzes pontuais dinâmicas na cena do Mario (padrão 0: só a luz direcional)
+struct LightingOptions {
+    int lights = 0;
+};
+
+LightingOptions parseLightingOptions(int argc, char** argv);
+
+#endif // LIGHTING_H
@@ -1,25 +1,25 @@
 #include "Mario.h"
-#include "Shader.h"
+#include "Renderer.h"
 #include "Constants.h"
 #include <glm/gtc/matrix_transform.hpp>
 #include <cmath> // Para sin, cos
 #include <algorithm> // Para std::lerp (interpolação)
 
-// Funções/Variáveis externas (drawShape, VAOs/Counts)
-extern void drawShape(GLuint vao, GLsizei count, Shader& shader, glm::mat4 model, glm::vec3 color);
-extern GLuint cubeVAO;
-extern GLsizei cubeVertexCount;
+// Malha externa (definida em main.cpp)
+extern Mesh cubeMesh;
 
 Mario::Mario(glm::vec3 startPos)
     : Character(startPos, 1.8f, PLAYER_SPEED, PLAYER_JUMP_SPEED, GRAVITY),
       headTilt(0.0f),
       isWalking(false),
-      walkCycleTimer(0.0f)
+      walkCycleTimer(0.0f),
+      animationTime(0.0f)
 {}
 
 // Sobrescreve updatePhysics para gerenciar timer de caminhada
 void Mario::updatePhysics(float deltaTime) {
     Character::updatePhysics(deltaTime); // Chama base
+    animationTime += deltaTime;
 
     // Atualiza timer de animação de caminhada com base na velocidade horizontal
     float horizontalSpeed = glm::length(glm::vec2(velocity.x, velocity.z));
@@ -40,8 +40,8 @@ void Mario::updatePhysics(float deltaTime) {
 
 
 // Função auxiliar de desenho de partes (sem alterações)
-void Mario::drawPart(GLuint vao, GLsizei count, Shader& shader, glm::mat4 model, glm::vec3 color) {
-    drawShape(vao, count, shader, model, color);
+void Mario::drawPart(const Mesh& mesh, Renderer& renderer, glm::mat4 model, glm::vec3 color) {
+    renderer.drawMesh(mesh, model, color);
 }
 
 // --- Funções Auxiliares de Animação Refinadas ---
@@ -77,7 +77,7 @@ glm::mat4 Mario::getJumpRotation(bool isLeftLimb, const glm::vec3& rotationAxis,
 
     // Aplica um balanço extra se estiver no pico (Vy perto de 0 mas não no chão)
      if (abs(velocity.y) < 1.0f && !onGround) {
-          angleDegrees += sin( (glfwGetTime() * 4.0f) + (isLeftLimb ? glm::pi<float>() : 0.0f) ) * 5.0f; // Pequeno balanço no pico
+          angleDegrees += sin( (animationTime * 4.0f) + (isLeftLimb ? glm::pi<float>() : 0.0f) ) * 5.0f; // Pequeno balanço no pico
      }
 
 
@@ -90,10 +90,7 @@ glm::mat4 Mario::getJumpRotation(bool isLeftLimb, const glm::vec3& rotationAxis,
 
 
 // --- Desenho do Mario Atualizado ---
-void Mario::draw(Shader& shader, glm::mat4 view, glm::mat4 projection) {
-    shader.setMat4("view", view);
-    shader.setMat4("projection", projection);
-
+void Mario::draw(Renderer& renderer) {
     glm::mat4 baseModel = getModelMatrix();
 
     // --- Parâmetros de Animação ---
@@ -130,36 +127,36 @@ void Mario::draw(Shader& shader, glm::mat4 view, glm::mat4 projection) {
     headTransform = glm::rotate(headTransform, glm::radians(headTilt), glm::vec3(1.0f, 0.0f, 0.0f));
 
     // Cabeça Base (Pele)
-    drawPart(cubeVAO, cubeVertexCount, shader, glm::scale(headTransform, glm::vec3(0.3f)), skin);
+    drawPart(cubeMesh, renderer, glm::scale(headTransform, glm::vec3(0.3f)), skin);
     // Nariz (Pele) - Maior e mais à frente
-    drawPart(cubeVAO, cubeVertexCount, shader, glm::scale(glm::translate(headTransform, glm::vec3(0.0f, -0.02f, 0.28f)), glm::vec3(0.16f, 0.18f, 0.22f)), skin);
+    drawPart(cubeMesh, renderer, glm::scale(glm::translate(headTransform, glm::vec3(0.0f, -0.02f, 0.28f)), glm::vec3(0.16f, 0.18f, 0.22f)), skin);
     // Bigode (Marrom) - Mais largo e espesso
-    drawPart(cubeVAO, cubeVertexCount, shader, glm::scale(glm::translate(headTransform, glm::vec3(0.0f, -0.14f, 0.26f)), glm::vec3(0.4f, 0.1f, 0.12f)), brown);
+    drawPart(cubeMesh, renderer, glm::scale(glm::translate(headTransform, glm::vec3(0.0f, -0.14f, 0.26f)), glm::vec3(0.4f, 0.1f, 0.12f)), brown);
     // Boné (Vermelho) - Sem alterações
-    drawPart(cubeVAO, cubeVertexCount, shader, glm::scale(glm::translate(headTransform, glm::vec3(0.0f, 0.2f, 0.0f)), glm::vec3(0.35f, 0.15f, 0.35f)), red);
+    drawPart(cubeMesh, renderer, glm::scale(glm::translate(headTransform, glm::vec3(0.0f, 0.2f, 0.0f)), glm::vec3(0.35f, 0.15f, 0.35f)), red);
     // Aba do boné - Sem alterações
-    drawPart(cubeVAO, cubeVertexCount, shader, glm::scale(glm::translate(headTransform, glm::vec3(0.0f, 0.15f, 0.22f)), glm::vec3(0.35f, 0.05f, 0.15f)), red);
+    drawPart(cubeMesh, renderer, glm::scale(glm::translate(headTransform, glm::vec3(0.0f, 0.15f, 0.22f)), glm::vec3(0.35f, 0.05f, 0.15f)), red);
 
     // --- Desenhar Corpo (com leve Bob) ---
     float torsoBob = onGround ? (0.03f * sin(walkCycleTimer * 2.0f)) : 0.0f; // Bob só no chão
     glm::vec3 torsoOffset = glm::vec3(0.0f, 0.9f + torsoBob, 0.0f);
-    drawPart(cubeVAO, cubeVertexCount, shader, glm::scale(glm::translate(baseModel, torsoOffset), glm::vec3(0.4f, 0.5f, 0.2f)), blue);
+    drawPart(cubeMesh, renderer, glm::scale(glm::translate(baseModel, torsoOffset), glm::vec3(0.4f, 0.5f, 0.2f)), blue);
 
     // --- Desenhar Pernas e Braços (Animados) ---
     // Aplica a matriz de animação à matriz base ANTES de transladar/escalar a parte
     glm::mat4 leftLegModel = baseModel * leftLegAnim;
-    drawPart(cubeVAO, cubeVertexCount, shader, glm::scale(glm::translate(leftLegModel, glm::vec3(-0.15f, 0.4f, 0.0f)), glm::vec3(0.15f, 0.4f, 0.15f)), blue);
-    drawPart(cubeVAO, cubeVertexCount, shader, glm::scale(glm::translate(leftLegModel, glm::vec3(-0.15f, 0.05f, 0.05f)), glm::vec3(0.15f, 0.1f, 0.2f)), brown); // Sapato Esquerdo
+    drawPart(cubeMesh, renderer, glm::scale(glm::translate(leftLegModel, glm::vec3(-0.15f, 0.4f, 0.0f)), glm::vec3(0.15f, 0.4f, 0.15f)), blue);
+    drawPart(cubeMesh, renderer, glm::scale(glm::translate(leftLegModel, glm::vec3(-0.15f, 0.05f, 0.05f)), glm::vec3(0.15f, 0.1f, 0.2f)), brown); // Sapato Esquerdo
 
     glm::mat4 rightLegModel = baseModel * rightLegAnim;
-    drawPart(cubeVAO, cubeVertexCount, shader, glm::scale(glm::translate(rightLegModel, glm::vec3(0.15f, 0.4f, 0.0f)), glm::vec3(0.15f, 0.4f, 0.15f)), blue);
-    drawPart(cubeVAO, cubeVertexCount, shader, glm::scale(glm::translate(rightLegModel, glm::vec3(0.15f, 0.05f, 0.05f)), glm::vec3(0.15f, 0.1f, 0.2f)), brown); // Sapato Direito
+    drawPart(cubeMesh, renderer, glm::scale(glm::translate(rightLegModel, glm::vec3(0.15f, 0.4f, 0.0f)), glm::vec3(0.15f, 0.4f, 0.15f)), blue);
+    drawPart(cubeMesh, renderer, glm::scale(glm::translate(rightLegModel, glm::vec3(0.15f, 0.05f, 0.05f)), glm::vec3(0.15f, 0.1f, 0.2f)), brown); // Sapato Direito
 
     glm::mat4 leftArmModel = baseModel * leftArmAnim;
-    drawPart(cubeVAO, cubeVertexCount, shader, glm::scale(glm::translate(leftArmModel, glm::vec3(-0.5f, 0.9f, 0.0f)), glm::vec3(0.1f, 0.4f, 0.15f)), red);
-    drawPart(cubeVAO, cubeVertexCount, shader, glm::scale(glm::translate(leftArmModel, glm::vec3(-0.5f, 0.55f, 0.0f)), glm::vec3(0.12f, 0.12f, 0.12f)), skin); // Mão Esquerda
+    drawPart(cubeMesh, renderer, glm::scale(glm::translate(leftArmModel, glm::vec3(-0.5f, 0.9f, 0.0f)), glm::vec3(0.1f, 0.4f, 0.15f)), red);
+    drawPart(cubeMesh, renderer, glm::scale(glm::translate(leftArmModel, glm::vec3(-0.5f, 0.55f, 0.0f)), glm::vec3(0.12f, 0.12f, 0.12f)), skin); // Mão Esquerda
 
     glm::mat4 rightArmModel = baseModel * rightArmAnim;
-    drawPart(cubeVAO, cubeVertexCount, shader, glm::scale(glm::translate(rightArmModel, glm::vec3(0.5f, 0.9f, 0.0f)), glm::vec3(0.1f, 0.4f, 0.15f)), red);
-    drawPart(cubeVAO, cubeVertexCount, shader, glm::scale(glm::translate(rightArmModel, glm::vec3(0.5f, 0.55f, 0.0f)), glm::vec3(0.12f, 0.12f, 0.12f)), skin); // Mão Direita
+    drawPart(cubeMesh, renderer, glm::scale(glm::translate(rightArmModel, glm::vec3(0.5f, 0.9f, 0.0f)), glm::vec3(0.1f, 0.4f, 0.15f)), red);
+    drawPart(cubeMesh, renderer, glm::scale(glm::translate(rightArmModel, glm::vec3(0.5f, 0.55f, 0.0f)), glm::vec3(0.12f, 0.12f, 0.12f)), skin); // Mão Direita
 }
\ No newline at end of file
@@ -3,19 +3,21 @@
 
 #include <GL/glew.h>
 #include "Character.h"
+#include "Mesh.h"
 #include <glm/gtc/constants.hpp> // Para pi
 
-class Shader;
+class Renderer;
 
 class Mario : public Character {
 public:
     float headTilt;      // Inclinação da cabeça em graus
     bool isWalking;      // Estado de caminhada para animação
     float walkCycleTimer; // Timer para animação de caminhada
+    float animationTime;  // Tempo simulado acumulado (substitui glfwGetTime: mesma animação com ou sem janela)
 
     Mario(glm::vec3 startPos = glm::vec3(0.0f, 0.0f, 0.0f));
 
-    void draw(Shader& shader, glm::mat4 view, glm::mat4 projection) override;
+    void draw(Renderer& renderer) override;
 
     // Sobrescreve para atualizar estado de animação
     void updatePhysics(float deltaTime) override;
@@ -29,11 +31,12 @@ private:
     glm::vec3 yellow = glm::vec3(1.0f, 1.0f, 0.0f);
 
     // Função auxiliar de desenho (sem alterações na assinatura)
-    void drawPart(GLuint vao, GLsizei count, Shader& shader, glm::mat4 model, glm::vec3 color);
+    void drawPart(const Mesh& mesh, Renderer& renderer, glm::mat4 model, glm::vec3 color);
 
-    // Função auxiliar para calcular transformações animadas
-    glm::mat4 getAnimatedPartTransform(float amplitude, float phaseOffset, const glm::vec3& rotationAxis, const glm::vec3& pivotOffset);
-    glm::mat4 getJumpPoseTransform(bool isLeft, const glm::vec3& rotationAxis, const glm::vec3& pivotOffset);
+protected:
+    // Função auxiliar para calcular transformações animadas (protegidas para os benchmarks)
+    glm::mat4 getWalkRotation(float amplitudeDegrees, float phaseOffset, const glm::vec3& rotationAxis, const glm::vec3& pivotOffset);
+    glm::mat4 getJumpRotation(bool isLeftLimb, const glm::vec3& rotationAxis, const glm::vec3& pivotOffset);
 };
 
 #endif // MARIO_H
\ No newline at end of file
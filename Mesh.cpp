@@ -0,0 +1,244 @@
+#include "Mesh.h"
+#include <glm/gtc/matrix_transform.hpp>
+#include <cmath>     // Para round, fabs
+#include <cstring>   // Para memcpy
+#include <algorithm> // Para std::max, std::min
+
+// Maior valor inteiro usado por eixo em cada formato quantizado
+static float quantizationLimit(VertexFormat format) {
+    switch (format) {
+        case VertexFormat::Short4:        return 32767.0f;
+        case VertexFormat::Int2101010Rev: return 511.0f;
+        default:                          return 1.0f;
+    }
+}
+
+static int quantizeComponent(float value, float bias, float scale, float limit) {
+    float q = std::round((value - bias) / scale);
+    return static_cast<int>(std::max(-limit, std::min(limit, q)));
+}
+
+// Empacota três inteiros com sinal de 10 bits (w = 0) no layout 2_10_10_10_REV
+static uint32_t packInt2101010(int x, int y, int z) {
+    return (static_cast<uint32_t>(x) & 0x3FFu)
+         | ((static_cast<uint32_t>(y) & 0x3FFu) << 10)
+         | ((static_cast<uint32_t>(z) & 0x3FFu) << 20);
+}
+
+GLsizei vertexFormatSize(VertexFormat format) {
+    switch (format) {
+        case VertexFormat::Short4:        return 4 * sizeof(int16_t);
+        case VertexFormat::Int2101010Rev: return sizeof(uint32_t);
+        default:                          return 3 * sizeof(float);
+    }
+}
+
+void VertexLayout::add(VertexAttribute attribute, VertexFormat format, bool normalized) {
+    if (attributeCount >= MAX_ATTRIBUTES) return;
+
+    VertexAttributeDesc& desc = attributes[attributeCount++];
+    desc.attribute = attribute;
+    desc.format = format;
+    desc.normalized = normalized ? GL_TRUE : GL_FALSE;
+    desc.offset = static_cast<GLuint>(stride);
+    switch (format) {
+        case VertexFormat::Short4:
+            desc.components = 4;
+            desc.type = GL_SHORT;
+            break;
+        case VertexFormat::Int2101010Rev:
+            desc.components = 4; // O GL exige tamanho 4 para formatos empacotados
+            desc.type = GL_INT_2_10_10_10_REV;
+            break;
+        default:
+            desc.format = VertexFormat::Float3;
+            desc.components = 3;
+            desc.type = GL_FLOAT;
+            break;
+    }
+    stride += vertexFormatSize(desc.format);
+}
+
+const VertexAttributeDesc* VertexLayout::find(VertexAttribute attribute) const {
+    for (int i = 0; i < attributeCount; ++i) {
+        if (attributes[i].attribute == attribute) return &attributes[i];
+    }
+    return nullptr;
+}
+
+void VertexLayout::apply() const {
+    for (int i = 0; i < attributeCount; ++i) {
+        const VertexAttributeDesc& desc = attributes[i];
+        GLuint location = static_cast<GLuint>(desc.attribute);
+        glVertexAttribPointer(location, desc.components, desc.type, desc.normalized, stride,
+                              reinterpret_cast<void*>(static_cast<uintptr_t>(desc.offset)));
+        glEnableVertexAttribArray(location);
+    }
+}
+
+glm::mat4 MeshQuantization::matrix() const {
+    return glm::scale(glm::translate(glm::mat4(1.0f), bias), scale);
+}
+
+MeshBounds computeBounds(const std::vector<glm::vec3>& positions) {
+    MeshBounds bounds;
+    if (positions.empty()) return bounds;
+
+    bounds.min = bounds.max = positions[0];
+    for (const glm::vec3& p : positions) {
+        bounds.min = glm::min(bounds.min, p);
+        bounds.max = glm::max(bounds.max, p);
+    }
+    return bounds;
+}
+
+MeshQuantization computeQuantization(const MeshBounds& bounds, VertexFormat format) {
+    MeshQuantization quantization;
+    if (format != VertexFormat::Short4 && format != VertexFormat::Int2101010Rev) {
+        return quantization; // Float3: identidade
+    }
+
+    float limit = quantizationLimit(format);
+    glm::vec3 halfExtent = (bounds.max - bounds.min) * 0.5f;
+    quantization.bias = (bounds.max + bounds.min) * 0.5f;
+    for (int axis = 0; axis < 3; ++axis) {
+        // Eixo degenerado (malha plana): todos os valores armazenados são 0
+        quantization.scale[axis] = halfExtent[axis] > 1e-8f ? halfExtent[axis] / limit : 1.0f;
+    }
+    return quantization;
+}
+
+VertexFormat choosePositionFormat(const std::vector<glm::vec3>& positions, float maxRelativeError) {
+    MeshBounds bounds = computeBounds(positions);
+    glm::vec3 extent = bounds.max - bounds.min;
+    float tolerance = maxRelativeError * std::max(extent.x, std::max(extent.y, extent.z));
+
+    // Do menor para o maior: 4 bytes, 8 bytes e, por fim, float sem perda
+    const VertexFormat candidates[] = { VertexFormat::Int2101010Rev, VertexFormat::Short4 };
+    for (VertexFormat format : candidates) {
+        MeshQuantization quantization = computeQuantization(bounds, format);
+        float limit = quantizationLimit(format);
+        float maxError = 0.0f;
+        for (const glm::vec3& p : positions) {
+            for (int axis = 0; axis < 3; ++axis) {
+                int q = quantizeComponent(p[axis], quantization.bias[axis], quantization.scale[axis], limit);
+                float reconstructed = quantization.bias[axis] + quantization.scale[axis] * static_cast<float>(q);
+                maxError = std::max(maxError, std::fabs(reconstructed - p[axis]));
+            }
+        }
+        if (maxError <= tolerance) return format;
+    }
+    return VertexFormat::Float3;
+}
+
+uint32_t packNormal(const glm::vec3& normal) {
+    // Normalizado: o shader recebe valor/511 em [-1, 1]
+    return packInt2101010(quantizeComponent(normal.x, 0.0f, 1.0f / 511.0f, 511.0f),
+                          quantizeComponent(normal.y, 0.0f, 1.0f / 511.0f, 511.0f),
+                          quantizeComponent(normal.z, 0.0f, 1.0f / 511.0f, 511.0f));
+}
+
+std::vector<uint8_t> packVertices(const std::vector<glm::vec3>& positions,
+                                  const std::vector<glm::vec3>& normals,
+                                  const VertexLayout& layout,
+                                  const MeshQuantization& quantization) {
+    std::vector<uint8_t> data(positions.size() * layout.stride);
+
+    for (size_t v = 0; v < positions.size(); ++v) {
+        uint8_t* vertex = data.data() + v * layout.stride;
+
+        for (int i = 0; i < layout.attributeCount; ++i) {
+            const VertexAttributeDesc& desc = layout.attributes[i];
+            uint8_t* dst = vertex + desc.offset;
+
+            if (desc.attribute == VertexAttribute::Normal) {
+                glm::vec3 n = v < normals.size() ? normals[v] : glm::vec3(0.0f, 1.0f, 0.0f);
+                if (desc.format == VertexFormat::Float3) {
+                    std::memcpy(dst, &n[0], sizeof(glm::vec3));
+                } else {
+                    uint32_t packed = packNormal(n);
+                    std::memcpy(dst, &packed, sizeof(packed));
+                }
+                continue;
+            }
+
+            const glm::vec3& p = positions[v];
+            float limit = quantizationLimit(desc.format);
+            switch (desc.format) {
+                case VertexFormat::Short4: {
+                    int16_t packed[4] = { 0, 0, 0, 0 };
+                    for (int axis = 0; axis < 3; ++axis) {
+                        packed[axis] = static_cast<int16_t>(quantizeComponent(p[axis], quantization.bias[axis], quantization.scale[axis], limit));
+                    }
+                    std::memcpy(dst, packed, sizeof(packed));
+                    break;
+                }
+                case VertexFormat::Int2101010Rev: {
+                    uint32_t packed = packInt2101010(quantizeComponent(p.x, quantization.bias.x, quantization.scale.x, limit),
+                                                     quantizeComponent(p.y, quantization.bias.y, quantization.scale.y, limit),
+                                                     quantizeComponent(p.z, quantization.bias.z, quantization.scale.z, limit));
+                    std::memcpy(dst, &packed, sizeof(packed));
+                    break;
+                }
+                default:
+                    std::memcpy(dst, &p[0], sizeof(glm::vec3));
+                    break;
+            }
+        }
+    }
+    return data;
+}
+
+void buildMesh(const std::vector<glm::vec3>& positions, const std::vector<glm::vec3>& normals,
+               Mesh& mesh, VertexFormat positionFormat) {
+    if (positionFormat == VertexFormat::Auto) {
+        positionFormat = choosePositionFormat(positions);
+    }
+
+    mesh.positions = positions;
+    mesh.normals = normals;
+    mesh.layout = VertexLayout();
+    mesh.layout.add(VertexAttribute::Position, positionFormat, false);
+    if (!normals.empty()) {
+        mesh.layout.add(VertexAttribute::Normal, VertexFormat::Int2101010Rev, true);
+    }
+    mesh.quantization = computeQuantization(computeBounds(positions), positionFormat);
+    mesh.dequantization = mesh.quantization.matrix();
+    mesh.vertexCount = static_cast<GLsizei>(positions.size());
+}
+
+void uploadMesh(const std::vector<glm::vec3>& positions, const std::vector<glm::vec3>& normals,
+                Mesh& mesh, VertexFormat positionFormat) {
+    if (positions.empty()) return;
+
+    buildMesh(positions, normals, mesh, positionFormat);
+
+    std::vector<uint8_t> data = packVertices(positions, normals, mesh.layout, mesh.quantization);
+
+    glGenVertexArrays(1, &mesh.vao);
+    glGenBuffers(1, &mesh.vbo);
+
+    glBindVertexArray(mesh.vao);
+    glBindBuffer(GL_ARRAY_BUFFER, mesh.vbo);
+    glBufferData(GL_ARRAY_BUFFER, data.size(), data.data(), GL_STATIC_DRAW);
+
+    mesh.layout.apply();
+
+    // Desvincula o VBO e o VAO para evitar modificações acidentais
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
+}
+
+void uploadMesh(const std::vector<glm::vec3>& positions, Mesh& mesh, VertexFormat positionFormat) {
+    uploadMesh(positions, std::vector<glm::vec3>(), mesh, positionFormat);
+}
+
+void destroyMesh(Mesh& mesh) {
+    if (mesh.vao) glDeleteVertexArrays(1, &mesh.vao);
+    if (mesh.vbo) glDeleteBuffers(1, &mesh.vbo);
+    mesh.vao = 0;
+    mesh.vbo = 0;
+    mesh.vertexCount = 0;
+    mesh.positions.clear();
+    mesh.normals.clear();
+}
@@ -0,0 +1,109 @@
+#ifndef MESH_H
+#define MESH_H
+
+#include <vector>
+#include <cstdint>
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+// Formatos de armazenamento de um atributo de vértice
+enum class VertexFormat {
+    Auto,          // Escolhido a partir dos limites da malha (ver choosePositionFormat)
+    Float3,        // 3 x GL_FLOAT (12 bytes)
+    Short4,        // 4 x GL_SHORT (8 bytes, w é preenchimento)
+    Int2101010Rev  // GL_INT_2_10_10_10_REV (4 bytes)
+};
+
+// Atributos conhecidos pelos shaders (o valor é o 'layout (location = N)')
+enum class VertexAttribute {
+    Position = 0,
+    Normal = 1
+};
+
+// Descrição de um atributo dentro do vértice intercalado
+struct VertexAttributeDesc {
+    VertexAttribute attribute;
+    VertexFormat format;
+    GLint components;     // Componentes armazenados (4 para formatos empacotados)
+    GLenum type;
+    GLboolean normalized;
+    GLuint offset;        // Deslocamento em bytes dentro do vértice
+};
+
+// Layout de um vértice intercalado (posição e, opcionalmente, normal)
+struct VertexLayout {
+    static const int MAX_ATTRIBUTES = 2;
+
+    VertexAttributeDesc attributes[MAX_ATTRIBUTES];
+    int attributeCount = 0;
+    GLsizei stride = 0;
+
+    void add(VertexAttribute attribute, VertexFormat format, bool normalized);
+    const VertexAttributeDesc* find(VertexAttribute attribute) const;
+
+    // Chama glVertexAttribPointer para cada atributo (VAO e VBO já vinculados)
+    void apply() const;
+};
+
+// Tamanho em bytes de um atributo no formato dado
+GLsizei vertexFormatSize(VertexFormat format);
+
+// Desquantização por malha: posição = bias + scale * valorArmazenado
+// Posições quantizadas são enviadas como inteiros NÃO normalizados e o fator
+// 1/32767 (ou 1/511) fica em 'scale'; assim o resultado é exato em qualquer
+// versão do GL (a regra de normalização de inteiros com sinal mudou no 4.2).
+struct MeshQuantization {
+    glm::vec3 scale = glm::vec3(1.0f);
+    glm::vec3 bias = glm::vec3(0.0f);
+
+    glm::mat4 matrix() const;
+};
+
+struct MeshBounds {
+    glm::vec3 min = glm::vec3(0.0f);
+    glm::vec3 max = glm::vec3(0.0f);
+};
+
+// Malha estática: cópia em CPU (backends sem GPU, buffers compartilhados) e, se enviada, VAO/VBO
+struct Mesh {
+    std::vector<glm::vec3> positions; // Posições em espaço de objeto, sem quantização
+    std::vector<glm::vec3> normals;   // Vazio se a malha não tiver normais
+    GLuint vao = 0;
+    GLuint vbo = 0;
+    GLsizei vertexCount = 0;
+    VertexLayout layout;
+    MeshQuantization quantization;
+    glm::mat4 dequantization = glm::mat4(1.0f); // Cache de quantization.matrix(), aplicado antes da matriz model
+};
+
+MeshBounds computeBounds(const std::vector<glm::vec3>& positions);
+
+// Escolhe o menor formato cujo erro máximo de reconstrução fica abaixo de
+// maxRelativeError * (maior dimensão da caixa envolvente da malha)
+VertexFormat choosePositionFormat(const std::vector<glm::vec3>& positions, float maxRelativeError = 1e-3f);
+
+// Quantização das posições para os limites da malha
+MeshQuantization computeQuantization(const MeshBounds& bounds, VertexFormat format);
+
+// Empacota uma normal unitária em GL_INT_2_10_10_10_REV (lida normalizada)
+uint32_t packNormal(const glm::vec3& normal);
+
+// Gera o buffer intercalado de vértices para o layout dado
+std::vector<uint8_t> packVertices(const std::vector<glm::vec3>& positions,
+                                  const std::vector<glm::vec3>& normals,
+                                  const VertexLayout& layout,
+                                  const MeshQuantization& quantization);
+
+// Preenche a parte em CPU da malha (posições, layout, quantização) sem chamar o GL.
+// Usado diretamente pelos modos headless, onde não existe contexto.
+void buildMesh(const std::vector<glm::vec3>& positions, const std::vector<glm::vec3>& normals,
+               Mesh& mesh, VertexFormat positionFormat = VertexFormat::Auto);
+
+// buildMesh + configura VAO e VBO da malha. 'normals' pode ser vazio.
+void uploadMesh(const std::vector<glm::vec3>& positions, const std::vector<glm::vec3>& normals,
+                Mesh& mesh, VertexFormat positionFormat = VertexFormat::Auto);
+void uploadMesh(const std::vector<glm::vec3>& positions, Mesh& mesh, VertexFormat positionFormat = VertexFormat::Auto);
+
+void destroyMesh(Mesh& mesh);
+
+#endif // MESH_H
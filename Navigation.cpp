@@ -0,0 +1,400 @@
+#include "Navigation.h"
+#include "AdventureCharacters.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+Navigation navigation;
+
+namespace {
+const size_t MAX_HISTORY = 32;   // Obstacle changes a cached field can catch up with by repair()
+const size_t FIELD_CACHE_SIZE = 128; // Holds every waypoint field of the default grid
+
+const float DIAGONAL_COST = 1.41421356f;
+// Neighbour offsets in the same order as FlowField::STEP_DIRECTIONS
+const int STEP_DX[8] = { 1, -1, 0, 0, 1, 1, -1, -1 };
+const int STEP_DY[8] = { 0, 0, 1, -1, 1, -1, 1, -1 };
+
+// Moving from (x, y) by step s: inside the grid, not blocked, no cutting past a blocked corner
+bool canStep(const NavGrid& grid, int x, int y, int s) {
+    int width = grid.width();
+    int nx = x + STEP_DX[s], ny = y + STEP_DY[s];
+    if (nx < 0 || ny < 0 || nx >= width || ny >= width) return false;
+    if (grid.blocked(ny * width + nx)) return false;
+    if (s >= 4 && (grid.blocked(y * width + nx) || grid.blocked(ny * width + x))) return false;
+    return true;
+}
+
+float stepCost(int s) { return s >= 4 ? DIAGONAL_COST : 1.0f; }
+}
+
+// --- NavRect ---
+
+void NavRect::include(const NavRect& other) {
+    if (other.empty()) return;
+    if (empty()) { *this = other; return; }
+    minX = std::min(minX, other.minX);
+    minY = std::min(minY, other.minY);
+    maxX = std::max(maxX, other.maxX);
+    maxY = std::max(maxY, other.maxY);
+}
+
+// --- NavGrid ---
+
+NavGrid::NavGrid(float worldSize, float cellSize)
+    : cellsPerSide(std::max(1, static_cast<int>(std::ceil(worldSize / cellSize)))),
+      size(cellSize), origin(-worldSize / 2.0f),
+      coverage(static_cast<size_t>(cellsPerSide) * cellsPerSide, 0) {}
+
+int NavGrid::cellAt(glm::vec3 position) const {
+    int x = static_cast<int>(std::floor((position.x - origin) / size));
+    int y = static_cast<int>(std::floor((position.z - origin) / size));
+    x = std::clamp(x, 0, cellsPerSide - 1);
+    y = std::clamp(y, 0, cellsPerSide - 1);
+    return y * cellsPerSide + x;
+}
+
+glm::vec3 NavGrid::cellCenter(int cell) const {
+    int x = cell % cellsPerSide, y = cell / cellsPerSide;
+    return glm::vec3(origin + (x + 0.5f) * size, 0.0f, origin + (y + 0.5f) * size);
+}
+
+NavRect NavGrid::footprint(const Obstacle& obstacle) const {
+    // Cells whose centre lies within the inflated radius
+    float r = obstacle.radius + AGENT_RADIUS;
+    NavRect rect;
+    rect.minX = std::max(0, static_cast<int>(std::ceil((obstacle.center.x - r - origin) / size - 0.5f)));
+    rect.minY = std::max(0, static_cast<int>(std::ceil((obstacle.center.z - r - origin) / size - 0.5f)));
+    rect.maxX = std::min(cellsPerSide - 1, static_cast<int>(std::floor((obstacle.center.x + r - origin) / size - 0.5f)));
+    rect.maxY = std::min(cellsPerSide - 1, static_cast<int>(std::floor((obstacle.center.z + r - origin) / size - 0.5f)));
+    return rect;
+}
+
+void NavGrid::rasterize(const Obstacle& obstacle, int delta) {
+    float r = obstacle.radius + AGENT_RADIUS;
+    NavRect rect = footprint(obstacle);
+    for (int y = rect.minY; y <= rect.maxY; ++y) {
+        for (int x = rect.minX; x <= rect.maxX; ++x) {
+            glm::vec3 center = cellCenter(y * cellsPerSide + x);
+            float dx = center.x - obstacle.center.x, dz = center.z - obstacle.center.z;
+            if (dx * dx + dz * dz <= r * r) coverage[y * cellsPerSide + x] += delta;
+        }
+    }
+}
+
+void NavGrid::apply(const Obstacle* removed, const Obstacle* added) {
+    NavRect area;
+    if (removed) area.include(footprint(*removed));
+    if (added) area.include(footprint(*added));
+    if (area.empty()) return;
+
+    // Remember which cells of the area were blocked, then diff after the update
+    FrameVector<uint8_t> before(frameArena.current());
+    before.reserve(static_cast<size_t>(area.maxX - area.minX + 1) * (area.maxY - area.minY + 1));
+    for (int y = area.minY; y <= area.maxY; ++y)
+        for (int x = area.minX; x <= area.maxX; ++x) before.push_back(blocked(y * cellsPerSide + x));
+
+    if (removed) rasterize(*removed, -1);
+    if (added) rasterize(*added, 1);
+
+    NavRect changed;
+    size_t i = 0;
+    for (int y = area.minY; y <= area.maxY; ++y) {
+        for (int x = area.minX; x <= area.maxX; ++x, ++i) {
+            if (before[i] == blocked(y * cellsPerSide + x)) continue;
+            NavRect cell;
+            cell.minX = cell.maxX = x;
+            cell.minY = cell.maxY = y;
+            changed.include(cell);
+        }
+    }
+    if (changed.empty()) return;
+
+    ++currentVersion;
+    history.push_back({ currentVersion, changed });
+    if (history.size() > MAX_HISTORY) history.erase(history.begin());
+}
+
+int NavGrid::addObstacle(glm::vec3 center, float radius) {
+    obstacleList.push_back({ center, radius, true });
+    apply(nullptr, &obstacleList.back());
+    return static_cast<int>(obstacleList.size()) - 1;
+}
+
+void NavGrid::moveObstacle(int id, glm::vec3 center, float radius) {
+    Obstacle& obstacle = obstacleList[id];
+    if (!obstacle.alive) return;
+    Obstacle previous = obstacle;
+    obstacle.center = center;
+    obstacle.radius = radius;
+    apply(&previous, &obstacle);
+}
+
+void NavGrid::removeObstacle(int id) {
+    Obstacle& obstacle = obstacleList[id];
+    if (!obstacle.alive) return;
+    obstacle.alive = false;
+    apply(&obstacle, nullptr);
+}
+
+bool NavGrid::changesSince(uint32_t sinceVersion, NavRect& changed) const {
+    changed = NavRect();
+    if (sinceVersion == currentVersion) return true;
+    if (history.empty() || history.front().version > sinceVersion + 1) return false;
+    for (const Change& change : history) {
+        if (change.version > sinceVersion) changed.include(change.cells);
+    }
+    return true;
+}
+
+// --- FlowField ---
+
+const glm::vec3 FlowField::STEP_DIRECTIONS[9] = {
+    glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(-1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f), glm::vec3(0.0f, 0.0f, -1.0f),
+    glm::vec3(0.70710678f, 0.0f, 0.70710678f), glm::vec3(0.70710678f, 0.0f, -0.70710678f),
+    glm::vec3(-0.70710678f, 0.0f, 0.70710678f), glm::vec3(-0.70710678f, 0.0f, -0.70710678f),
+    glm::vec3(0.0f),
+};
+
+void FlowField::push(OpenHeap& open, float cost, int cell) {
+    open.push_back({ cost, cell });
+    std::push_heap(open.begin(), open.end(), std::greater<OpenEntry>());
+}
+
+int FlowField::next(const NavGrid& grid, int cell) const {
+    uint8_t s = step[cell];
+    if (s == NO_STEP) return -1;
+    return cell + STEP_DY[s] * grid.width() + STEP_DX[s];
+}
+
+void FlowField::propagate(const NavGrid& grid, OpenHeap& open) {
+    int width = grid.width();
+    while (!open.empty()) {
+        std::pop_heap(open.begin(), open.end(), std::greater<OpenEntry>());
+        OpenEntry current = open.back();
+        open.pop_back();
+        if (current.cost > distance[current.cell]) continue; // Stale entry
+
+        int x = current.cell % width, y = current.cell / width;
+        for (int s = 0; s < 8; ++s) {
+            if (!canStep(grid, x, y, s)) continue;
+            int neighbour = current.cell + STEP_DY[s] * width + STEP_DX[s];
+            float cost = current.cost + stepCost(s);
+            if (cost < distance[neighbour]) {
+                distance[neighbour] = cost;
+                step[neighbour] = static_cast<uint8_t>(s ^ (s < 4 ? 1 : 3)); // Opposite of s: back towards current
+                push(open, cost, neighbour);
+            }
+        }
+    }
+}
+
+void FlowField::build(const NavGrid& grid, int goal) {
+    size_t cells = static_cast<size_t>(grid.cellCount());
+    goalCell = goal;
+    gridVersion = grid.version();
+    distance.assign(cells, UNREACHABLE);
+    step.assign(cells, NO_STEP);
+    if (grid.blocked(goal)) return; // Nothing reaches a blocked goal
+    distance[goal] = 0.0f;
+    OpenHeap open(frameArena.current());
+    open.reserve(cells); // Arena growth leaves the old block behind: start at one entry per cell
+    push(open, 0.0f, goal);
+    propagate(grid, open);
+}
+
+void FlowField::repair(const NavGrid& grid, const NavRect& changed) {
+    enum : uint8_t { UNKNOWN, AFFECTED, CLEAN };
+    int width = grid.width();
+    size_t cells = static_cast<size_t>(grid.cellCount());
+    gridVersion = grid.version();
+
+    // 1. Affected cells: the changed ones, plus every cell whose path to the goal passes
+    //    through one of them (or through a diagonal that now cuts a blocked corner).
+    //    Unreachable cells are affected too: a removed obstacle may have opened a way.
+    LinearArena& arena = frameArena.current();
+    FrameVector<uint8_t> affected(cells, UNKNOWN, arena);
+    FrameVector<int32_t> chain(arena);
+    for (int y = changed.minY; y <= changed.maxY; ++y)
+        for (int x = changed.minX; x <= changed.maxX; ++x) affected[y * width + x] = AFFECTED;
+
+    for (size_t start = 0; start < cells; ++start) {
+        if (affected[start] != UNKNOWN) continue;
+        chain.clear();
+        int cell = static_cast<int>(start);
+        uint8_t result;
+        for (;;) {
+            if (affected[cell] != UNKNOWN) { result = affected[cell]; break; }
+            chain.push_back(cell);
+            if (cell == goalCell) { result = CLEAN; break; }
+            if (step[cell] == NO_STEP || !canStep(grid, cell % width, cell / width, step[cell])) { result = AFFECTED; break; }
+            cell = next(grid, cell);
+        }
+        for (int32_t visited : chain) affected[visited] = result;
+    }
+
+    // 2. Forget the affected cells, then seed them from their clean neighbours (and the goal)
+    for (size_t cell = 0; cell < cells; ++cell) {
+        if (affected[cell] != AFFECTED) continue;
+        distance[cell] = UNREACHABLE;
+        step[cell] = NO_STEP;
+    }
+    OpenHeap open(arena);
+    open.reserve(cells);
+    if (affected[goalCell] == AFFECTED && !grid.blocked(goalCell)) {
+        distance[goalCell] = 0.0f;
+        push(open, 0.0f, goalCell);
+    }
+    for (size_t i = 0; i < cells; ++i) {
+        int cell = static_cast<int>(i);
+        if (affected[cell] != AFFECTED || cell == goalCell || grid.blocked(cell)) continue;
+        int x = cell % width, y = cell / width;
+        for (int s = 0; s < 8; ++s) {
+            if (!canStep(grid, x, y, s)) continue;
+            int neighbour = cell + STEP_DY[s] * width + STEP_DX[s];
+            if (affected[neighbour] != CLEAN || distance[neighbour] >= UNREACHABLE) continue;
+            float cost = distance[neighbour] + stepCost(s);
+            if (cost < distance[cell]) {
+                distance[cell] = cost;
+                step[cell] = static_cast<uint8_t>(s);
+            }
+        }
+        if (distance[cell] < UNREACHABLE) push(open, distance[cell], cell);
+    }
+
+    // Clean cells around the change relax their neighbours again: a freed cell can open a
+    // diagonal between two cells that were not affected themselves
+    for (int y = std::max(0, changed.minY - 1); y <= std::min(width - 1, changed.maxY + 1); ++y) {
+        for (int x = std::max(0, changed.minX - 1); x <= std::min(width - 1, changed.maxX + 1); ++x) {
+            int cell = y * width + x;
+            if (affected[cell] == CLEAN && distance[cell] < UNREACHABLE) push(open, distance[cell], cell);
+        }
+    }
+
+    // 3. Dijkstra from the seeds; it also lowers clean cells that a freed cell now shortens
+    propagate(grid, open);
+}
+
+// --- FlowFieldCache ---
+
+FlowFieldCache::FlowFieldCache(size_t capacity) : capacity(std::max<size_t>(1, capacity)) {
+    entries.reserve(this->capacity); // Returned references stay valid until the next eviction
+}
+
+const FlowField& FlowFieldCache::get(const NavGrid& grid, int goalCell) {
+    if (slotForCell.size() != static_cast<size_t>(grid.cellCount())) {
+        clear();
+        slotForCell.assign(static_cast<size_t>(grid.cellCount()), -1);
+    }
+
+    int32_t slot = slotForCell[goalCell];
+    if (slot >= 0) {
+        Entry& entry = entries[slot];
+        entry.lastUsed = ++useClock;
+        if (entry.field.version() == grid.version()) {
+            ++stats.hits;
+            return entry.field;
+        }
+        NavRect changed;
+        if (grid.changesSince(entry.field.version(), changed)) {
+            entry.field.repair(grid, changed);
+            ++stats.repairs;
+        } else {
+            entry.field.build(grid, goalCell);
+            ++stats.builds;
+        }
+        return entry.field;
+    }
+
+    if (entries.size() < capacity) {
+        entries.emplace_back();
+        slot = static_cast<int32_t>(entries.size()) - 1;
+    } else {
+        slot = 0;
+        for (size_t i = 1; i < entries.size(); ++i) {
+            if (entries[i].lastUsed < entries[slot].lastUsed) slot = static_cast<int32_t>(i);
+        }
+        slotForCell[entries[slot].field.goal()] = -1;
+        ++stats.evictions;
+    }
+    Entry& entry = entries[slot];
+    entry.lastUsed = ++useClock;
+    entry.field.build(grid, goalCell);
+    slotForCell[goalCell] = slot;
+    ++stats.builds;
+    return entry.field;
+}
+
+void FlowFieldCache::clear() {
+    entries.clear();
+    std::fill(slotForCell.begin(), slotForCell.end(), -1);
+}
+
+size_t FlowFieldCache::memoryBytes(const NavGrid& grid) const {
+    // distance + step per cell, per cached field
+    return entries.size() * static_cast<size_t>(grid.cellCount()) * (sizeof(float) + sizeof(uint8_t));
+}
+
+// --- Navigation ---
+
+Navigation::Navigation() : grid(GROUND_SIZE, 1.0f), fields(FIELD_CACHE_SIZE) {}
+
+glm::vec3 Navigation::snapToWaypoint(glm::vec3 target) const {
+    int width = grid.width();
+    int perSide = std::max(1, width / WAYPOINT_SPACING);
+    auto waypointCell = [&](int i, int j) {
+        int x = WAYPOINT_SPACING / 2 + i * WAYPOINT_SPACING, y = WAYPOINT_SPACING / 2 + j * WAYPOINT_SPACING;
+        return std::min(y, width - 1) * width + std::min(x, width - 1);
+    };
+
+    int cell = grid.cellAt(target);
+    int i = std::clamp(static_cast<int>(std::lround(static_cast<float>(cell % width - WAYPOINT_SPACING / 2) / WAYPOINT_SPACING)), 0, perSide - 1);
+    int j = std::clamp(static_cast<int>(std::lround(static_cast<float>(cell / width - WAYPOINT_SPACING / 2) / WAYPOINT_SPACING)), 0, perSide - 1);
+    int best = waypointCell(i, j);
+    if (grid.blocked(best)) {
+        // Rare (an obstacle on the waypoint): nearest free one
+        best = -1;
+        float bestDistance = 0.0f;
+        for (int wj = 0; wj < perSide; ++wj) {
+            for (int wi = 0; wi < perSide; ++wi) {
+                int candidate = waypointCell(wi, wj);
+                if (grid.blocked(candidate)) continue;
+                glm::vec3 offset = grid.cellCenter(candidate) - glm::vec3(target.x, 0.0f, target.z);
+                float d = glm::dot(offset, offset);
+                if (best < 0 || d < bestDistance) { best = candidate; bestDistance = d; }
+            }
+        }
+        if (best < 0) return target;
+    }
+    glm::vec3 center = grid.cellCenter(best);
+    return glm::vec3(center.x, target.y, center.z);
+}
+
+glm::vec3 Navigation::steer(glm::vec3 position, glm::vec3 target, glm::vec3 fallback) {
+    int cell = grid.cellAt(position);
+    int goal = grid.cellAt(target);
+    if (cell == goal) return fallback; // Last cell: straight to the exact target
+    const FlowField& field = fields.get(grid, goal);
+    return field.hasPath(cell) ? field.direction(cell) : fallback;
+}
+
+void parseNavigationOptions(int argc, char** argv) {
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--nav") == 0) navigation.enabled = true;
+    }
+}
+
+static float coneObstacleRadius(float coneScaleFactor) {
+    return 0.5f * coneScaleFactor; // Base radius of generateConePositions is 0.5
+}
+
+void addSceneObstacles(float coneScaleFactor) {
+    if (!navigation.enabled || navigation.pyramidObstacle >= 0) return;
+    navigation.pyramidObstacle = navigation.grid.addObstacle(PYRAMID_POSITION, 1.2f); // 2x2 base, corners trimmed
+    navigation.coneObstacle = navigation.grid.addObstacle(CONE_POSITION, coneObstacleRadius(coneScaleFactor));
+}
+
+void updateSceneObstacles(float coneScaleFactor) {
+    if (navigation.coneObstacle < 0) return;
+    navigation.grid.moveObstacle(navigation.coneObstacle, CONE_POSITION, coneObstacleRadius(coneScaleFactor));
+}
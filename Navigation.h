@@ -0,0 +1,176 @@
+#ifndef NAVIGATION_H
+#define NAVIGATION_H
+
+#include "FrameArena.h"
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Grid navigation for walking NPCs (Adventure Time). The ground is split into square
+// cells; obstacles (circles on the XZ plane) mark cells as blocked. For a destination
+// cell a FlowField stores, per cell, the path cost to the goal (Dijkstra over the
+// 8-connected grid) and the direction of the next cell on that path, so any number of
+// agents heading to the same place just read their cell: O(1) per agent and tick.
+// Fields are cached per destination and repaired, not rebuilt, when obstacles change.
+
+struct NavRect {
+    int minX = 0, minY = 0, maxX = -1, maxY = -1; // Inclusive cell bounds; empty when max < min
+
+    bool empty() const { return maxX < minX || maxY < minY; }
+    void include(const NavRect& other);
+};
+
+class NavGrid {
+public:
+    NavGrid(float worldSize, float cellSize);
+
+    // Obstacles are discs on the ground, inflated by AGENT_RADIUS when rasterized
+    int addObstacle(glm::vec3 center, float radius);
+    void moveObstacle(int id, glm::vec3 center, float radius); // No-op if the covered cells stay the same
+    void removeObstacle(int id);
+
+    int width() const { return cellsPerSide; }
+    int cellCount() const { return cellsPerSide * cellsPerSide; }
+    float cellSize() const { return size; }
+    bool blocked(int cell) const { return coverage[cell] != 0; }
+    int cellAt(glm::vec3 position) const; // Clamped to the grid
+    glm::vec3 cellCenter(int cell) const;
+
+    // Bumped whenever the set of blocked cells changes
+    uint32_t version() const { return currentVersion; }
+    // Union of the cells changed after 'sinceVersion'; false if that history was already dropped
+    bool changesSince(uint32_t sinceVersion, NavRect& changed) const;
+
+    struct Obstacle {
+        glm::vec3 center;
+        float radius;
+        bool alive;
+    };
+    const std::vector<Obstacle>& obstacles() const { return obstacleList; }
+
+    static constexpr float AGENT_RADIUS = 0.5f;
+
+private:
+    struct Change {
+        uint32_t version;
+        NavRect cells;
+    };
+
+    NavRect footprint(const Obstacle& obstacle) const;
+    void rasterize(const Obstacle& obstacle, int delta);
+    // Takes 'removed' off the grid and puts 'added' on it, recording the cells that flipped
+    void apply(const Obstacle* removed, const Obstacle* added);
+
+    int cellsPerSide;
+    float size;
+    float origin; // World X/Z of the grid corner
+    std::vector<uint8_t> coverage; // Obstacles covering each cell
+    std::vector<Obstacle> obstacleList;
+    std::vector<Change> history; // Most recent changes, oldest first
+    uint32_t currentVersion = 0;
+};
+
+class FlowField {
+public:
+    static constexpr float UNREACHABLE = 1e30f;
+
+    void build(const NavGrid& grid, int goalCell);
+    // Recomputes only the cells whose cost or path goes through 'changed'
+    void repair(const NavGrid& grid, const NavRect& changed);
+
+    // Direction (XZ, unit length) towards the next cell on the way to the goal;
+    // zero in the goal cell and in cells that cannot reach it
+    glm::vec3 direction(int cell) const { return STEP_DIRECTIONS[step[cell]]; }
+    bool hasPath(int cell) const { return step[cell] != NO_STEP; }
+    float cost(int cell) const { return distance[cell]; }
+    int goal() const { return goalCell; }
+    uint32_t version() const { return gridVersion; }
+
+private:
+    static constexpr uint8_t NO_STEP = 8;
+    static const glm::vec3 STEP_DIRECTIONS[9]; // 8 neighbours, then zero for NO_STEP
+
+    struct OpenEntry {
+        float cost;
+        int cell;
+        bool operator>(const OpenEntry& other) const { return cost > other.cost; }
+    };
+    using OpenHeap = FrameVector<OpenEntry>; // Heap storage from frameArena.current()
+
+    static void push(OpenHeap& open, float cost, int cell);
+    void propagate(const NavGrid& grid, OpenHeap& open); // Dijkstra from whatever is in 'open'
+    int next(const NavGrid& grid, int cell) const; // Cell 'step' points to, -1 for NO_STEP
+
+    int goalCell = -1;
+    uint32_t gridVersion = 0;
+    std::vector<float> distance;
+    std::vector<uint8_t> step;     // Neighbour towards the goal; NO_STEP for the goal and unreachable cells
+};
+
+// Fields by destination cell, least recently used evicted first. Lookups go through a
+// per-cell slot table, so get() is O(1) when the field is cached and up to date.
+class FlowFieldCache {
+public:
+    explicit FlowFieldCache(size_t capacity);
+
+    const FlowField& get(const NavGrid& grid, int goalCell);
+    void clear();
+
+    size_t size() const { return entries.size(); }
+    size_t memoryBytes(const NavGrid& grid) const;
+
+    struct Stats {
+        size_t hits = 0;
+        size_t builds = 0;    // Fields computed from scratch (miss or history too old)
+        size_t repairs = 0;   // Fields brought up to date after an obstacle change
+        size_t evictions = 0;
+    };
+    Stats stats;
+
+private:
+    struct Entry {
+        FlowField field;
+        uint64_t lastUsed = 0;
+    };
+
+    size_t capacity;
+    uint64_t useClock = 0;
+    std::vector<Entry> entries;
+    std::vector<int32_t> slotForCell; // Cell -> index in entries, -1 if not cached
+};
+
+// Navigation used by updateNPCWander. Walkers pick their wander targets among a
+// lattice of waypoints (one every WAYPOINT_SPACING cells) so many NPCs share each
+// field; flyers ignore it. Off by default (--nav), which keeps the old straight
+// lines and replays recorded without it.
+struct Navigation {
+    static const int WAYPOINT_SPACING = 6;
+
+    bool enabled = false;
+    NavGrid grid;
+    FlowFieldCache fields;
+    int pyramidObstacle = -1;
+    int coneObstacle = -1;
+
+    Navigation();
+
+    glm::vec3 snapToWaypoint(glm::vec3 target) const; // Nearest free waypoint (same Y)
+    // Unit direction for a walker at 'position' heading to 'target'; 'fallback' when off-grid or unreachable
+    glm::vec3 steer(glm::vec3 position, glm::vec3 target, glm::vec3 fallback);
+};
+
+extern Navigation navigation;
+
+// Props of renderWorld that become obstacles with --nav
+const glm::vec3 PYRAMID_POSITION(15.0f, 0.0f, -15.0f);
+const glm::vec3 CONE_POSITION(-15.0f, 0.0f, -15.0f);
+
+// --nav   walking NPCs path around the scene obstacles
+void parseNavigationOptions(int argc, char** argv);
+// Registers the pyramid and cone of renderWorld as obstacles (and shows them)
+void addSceneObstacles(float coneScaleFactor);
+// Follows the cone size changes (I/K keys); repairs happen lazily on the next get()
+void updateSceneObstacles(float coneScaleFactor);
+
+#endif // NAVIGATION_H
@@ -0,0 +1,155 @@
+#include "OcclusionCulling.h"
+#include "Mesh.h"
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+static double millisecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+OcclusionCuller::OcclusionCuller(int width, int height, unsigned threadCount)
+    : width(width), height(height), rasterizer(width, height, threadCount) {
+    rasterizer.cullBackFaces = true; // Oclusores são fechados: as faces de trás nunca ficam na frente
+    // Níveis até 1x1; o tamanho de cada um arredonda para cima
+    int levelWidth = width, levelHeight = height;
+    for (;;) {
+        levels.push_back({ levelWidth, levelHeight, std::vector<float>(static_cast<size_t>(levelWidth) * levelHeight, 1.0f) });
+        if (levelWidth == 1 && levelHeight == 1) break;
+        levelWidth = (levelWidth + 1) / 2;
+        levelHeight = (levelHeight + 1) / 2;
+    }
+}
+
+void OcclusionCuller::beginFrame(const glm::mat4& view, const glm::mat4& projection) {
+    viewProjection = projection * view;
+    rasterizer.beginFrame(view, projection, glm::vec3(0.0f));
+    hasOccluders = false;
+    ++stats.frames;
+}
+
+void OcclusionCuller::addOccluder(const Mesh& mesh, const glm::mat4& model) {
+    rasterizer.drawMesh(mesh, model, glm::vec3(1.0f));
+    hasOccluders = true;
+    ++stats.occluders;
+}
+
+void OcclusionCuller::finishOccluders() {
+    if (!hasOccluders) return;
+
+    auto rasterStart = std::chrono::steady_clock::now();
+    rasterizer.endFrame();
+    stats.rasterMs += millisecondsSince(rasterStart);
+    stats.occluderTriangles += rasterizer.getStats().trianglesSubmitted;
+
+    auto pyramidStart = std::chrono::steady_clock::now();
+    Level& base = levels[0];
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) base.depth[static_cast<size_t>(y) * width + x] = rasterizer.depth(x, y);
+    }
+    // Cada texel: o mais distante dos 2x2 de baixo (a última linha/coluna de um nível ímpar repete)
+    for (size_t l = 1; l < levels.size(); ++l) {
+        const Level& below = levels[l - 1];
+        Level& level = levels[l];
+        for (int y = 0; y < level.height; ++y) {
+            const float* row0 = &below.depth[static_cast<size_t>(2 * y) * below.width];
+            const float* row1 = &below.depth[static_cast<size_t>(std::min(2 * y + 1, below.height - 1)) * below.width];
+            float* out = &level.depth[static_cast<size_t>(y) * level.width];
+            for (int x = 0; x < level.width; ++x) {
+                int x0 = 2 * x, x1 = std::min(2 * x + 1, below.width - 1);
+                out[x] = std::max(std::max(row0[x0], row0[x1]), std::max(row1[x0], row1[x1]));
+            }
+        }
+    }
+    stats.pyramidMs += millisecondsSince(pyramidStart);
+}
+
+float OcclusionCuller::levelDepth(int level, int x, int y) const {
+    const Level& l = levels[level];
+    return l.depth[static_cast<size_t>(y) * l.width + x];
+}
+
+bool OcclusionCuller::isVisible(const glm::vec3& boundsMin, const glm::vec3& boundsMax) {
+    ++stats.tested;
+
+    // Cantos em espaço de recorte: fora do frustum se todos estão do mesmo lado de um plano
+    unsigned outsideAll = 0x1Fu;
+    bool crossesNear = false;
+    float minX = FLT_MAX, maxX = -FLT_MAX, minY = FLT_MAX, maxY = -FLT_MAX, minZ = FLT_MAX;
+    for (int i = 0; i < 8; ++i) {
+        glm::vec3 corner((i & 1) ? boundsMax.x : boundsMin.x, (i & 2) ? boundsMax.y : boundsMin.y,
+                         (i & 4) ? boundsMax.z : boundsMin.z);
+        glm::vec4 clip = viewProjection * glm::vec4(corner, 1.0f);
+        unsigned outside = (clip.x < -clip.w ? 1u : 0u) | (clip.x > clip.w ? 2u : 0u)
+                         | (clip.y < -clip.w ? 4u : 0u) | (clip.y > clip.w ? 8u : 0u)
+                         | (clip.z > clip.w ? 16u : 0u);
+        outsideAll &= outside;
+        if (clip.w <= 1e-5f || clip.z < -clip.w) {
+            crossesNear = true;
+            continue;
+        }
+        float invW = 1.0f / clip.w;
+        minX = std::min(minX, clip.x * invW); maxX = std::max(maxX, clip.x * invW);
+        minY = std::min(minY, clip.y * invW); maxY = std::max(maxY, clip.y * invW);
+        minZ = std::min(minZ, clip.z * invW);
+    }
+    if (outsideAll) {
+        ++stats.frustumCulled;
+        return false;
+    }
+    if (crossesNear || !hasOccluders) return true;
+
+    // Retângulo em pixels do nível 0, alargado em um pixel (amostragem no centro do pixel)
+    int x0 = std::max(0, static_cast<int>(std::floor((minX * 0.5f + 0.5f) * width)) - 1);
+    int x1 = std::min(width - 1, static_cast<int>(std::floor((maxX * 0.5f + 0.5f) * width)) + 1);
+    int y0 = std::max(0, static_cast<int>(std::floor((minY * 0.5f + 0.5f) * height)) - 1);
+    int y1 = std::min(height - 1, static_cast<int>(std::floor((maxY * 0.5f + 0.5f) * height)) + 1);
+    if (x0 > x1 || y0 > y1) return true;
+
+    int level = 0;
+    while (level + 1 < levelCount() && ((x1 >> level) - (x0 >> level) > 1 || (y1 >> level) - (y0 >> level) > 1)) ++level;
+    float farthest = 0.0f;
+    for (int y = y0 >> level; y <= (y1 >> level); ++y) {
+        for (int x = x0 >> level; x <= (x1 >> level); ++x) farthest = std::max(farthest, levelDepth(level, x, y));
+    }
+    float nearest = minZ * 0.5f + 0.5f;
+    if (nearest > farthest) {
+        ++stats.occluded;
+        return false;
+    }
+    return true;
+}
+
+void OcclusionCuller::printStats(const char* title) const {
+    if (stats.frames == 0) return;
+    double frames = static_cast<double>(stats.frames);
+    double tested = static_cast<double>(std::max<size_t>(1, stats.tested));
+    std::printf("%s: %.0f tested/frame, %.1f%% outside the frustum, %.1f%% occluded; %.0f occluders (%.0f triangles), "
+                "raster %.3f ms, Hi-Z %.3f ms per frame (%dx%d, %d levels)\n",
+                title, stats.tested / frames, 100.0 * stats.frustumCulled / tested, 100.0 * stats.occluded / tested,
+                stats.occluders / frames, stats.occluderTriangles / frames, stats.rasterMs / frames,
+                stats.pyramidMs / frames, width, height, levelCount());
+    std::fflush(stdout);
+}
+
+OcclusionOptions parseOcclusionOptions(int argc, char** argv) {
+    OcclusionOptions options;
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(arg, "--occlusion") == 0) {
+            options.enabled = true;
+        } else if (std::strcmp(arg, "--occlusion-size") == 0 && hasValue) {
+            int w = 0, h = 0;
+            if (std::sscanf(argv[++i], "%dx%d", &w, &h) == 2 && w > 0 && h > 0) {
+                options.width = w;
+                options.height = h;
+            }
+        }
+    }
+    return options;
+}
@@ -0,0 +1,84 @@
+#ifndef OCCLUSION_CULLING_H
+#define OCCLUSION_CULLING_H
+
+#include <cstddef>
+#include <vector>
+#include <glm/glm.hpp>
+#include "SoftwareRenderer.h"
+
+struct Mesh;
+
+// Culling por oclusão na CPU, antes da submissão dos draws.
+//
+// A cada quadro os maiores oclusores da cena (paredes, casas) são rasterizados num buffer de
+// profundidade pequeno pelo SoftwareRenderer (tiles, SSE2). Desse buffer sai uma pirâmide Hi-Z:
+// cada texel do nível n guarda a profundidade MAIS DISTANTE dos 2x2 texels do nível n-1. Para testar
+// uma caixa, os 8 cantos são projetados; se ela não sai do frustum, escolhe-se o nível em que o
+// retângulo dela cobre no máximo 2x2 texels, e a caixa está escondida quando o ponto mais próximo
+// dela fica atrás do texel mais distante desse retângulo. O teste é conservador (na dúvida, visível):
+// caixas que cruzam o plano near são sempre visíveis e o retângulo é alargado em um pixel.
+class OcclusionCuller {
+public:
+    // Resolução do buffer de oclusão; threadCount como no SoftwareRenderer (0 = todos os núcleos)
+    OcclusionCuller(int width = 256, int height = 144, unsigned threadCount = 1);
+
+    void beginFrame(const glm::mat4& view, const glm::mat4& projection);
+    // Só o que é sólido e fecha a vista: o teste assume que o oclusor é opaco em toda a área
+    void addOccluder(const Mesh& mesh, const glm::mat4& model);
+    // Rasteriza os oclusores e monta a pirâmide; sem oclusores, só o teste de frustum vale
+    void finishOccluders();
+
+    // Caixa alinhada aos eixos em espaço do mundo: false se estiver fora do frustum ou escondida
+    bool isVisible(const glm::vec3& boundsMin, const glm::vec3& boundsMax);
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    int levelCount() const { return static_cast<int>(levels.size()); }
+    // Profundidade da janela [0, 1] do nível 'level' (0 = buffer rasterizado)
+    float levelDepth(int level, int x, int y) const;
+    // Nível inteiro, linha a linha (para enviar a pirâmide à GPU)
+    int levelWidth(int level) const { return levels[level].width; }
+    int levelHeight(int level) const { return levels[level].height; }
+    const float* levelData(int level) const { return levels[level].depth.data(); }
+    // A pirâmide do quadro atual vale (houve oclusores e finishOccluders já rodou)
+    bool hasDepth() const { return hasOccluders; }
+
+    // Totais desde a criação
+    struct Stats {
+        size_t frames = 0;
+        size_t occluders = 0;
+        size_t occluderTriangles = 0;
+        size_t tested = 0;
+        size_t frustumCulled = 0;
+        size_t occluded = 0;
+        double rasterMs = 0.0;   // Oclusores no SoftwareRenderer
+        double pyramidMs = 0.0;  // Cópia do nível 0 e redução dos níveis
+    };
+    const Stats& getStats() const { return stats; }
+    void printStats(const char* title) const;
+
+private:
+    struct Level {
+        int width, height;
+        std::vector<float> depth;
+    };
+
+    int width, height;
+    SoftwareRenderer rasterizer;
+    glm::mat4 viewProjection = glm::mat4(1.0f);
+    std::vector<Level> levels;
+    bool hasOccluders = false;
+    Stats stats;
+};
+
+// --occlusion          testa cada personagem contra o buffer de oclusão antes de desenhar
+// --occlusion-size WxH resolução do buffer (padrão 256x144)
+struct OcclusionOptions {
+    bool enabled = false;
+    int width = 256;
+    int height = 144;
+};
+
+OcclusionOptions parseOcclusionOptions(int argc, char** argv);
+
+#endif // OCCLUSION_CULLING_H
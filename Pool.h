@@ -0,0 +1,160 @@
+#ifndef POOL_H
+#define POOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+// Referência a um objeto de um Pool<T>. A geração muda sempre que o slot é
+// liberado, então um handle antigo para de resolver em vez de apontar para
+// o objeto que reutilizou o slot.
+template <typename T>
+struct Handle {
+    static const uint32_t INVALID_INDEX = 0xFFFFFFFFu;
+
+    uint32_t index = INVALID_INDEX;
+    uint32_t generation = 0;
+
+    bool isValid() const { return index != INVALID_INDEX; }
+    bool operator==(const Handle& other) const { return index == other.index && generation == other.generation; }
+    bool operator!=(const Handle& other) const { return !(*this == other); }
+};
+
+// Alocador por tipo em slabs: cada slab guarda SLAB_SIZE objetos T contíguos e
+// não se move depois de criado (ponteiros continuam válidos até o despawn).
+// spawn/despawn são O(1) por lista livre (LIFO, reaproveita o slot mais
+// recente, ainda quente no cache). O heap só é usado quando todos os slabs
+// estão cheios; chamar reserve() no carregamento evita isso durante o jogo.
+template <typename T>
+class Pool {
+public:
+    static const uint32_t SLAB_SIZE = 256;
+
+    Pool() = default;
+    ~Pool() { clear(); }
+
+    Pool(const Pool&) = delete;
+    Pool& operator=(const Pool&) = delete;
+
+    // Garante espaço para 'count' objetos vivos sem novas alocações
+    void reserve(size_t count) {
+        while (capacity() < count) addSlab();
+    }
+
+    template <typename... Args>
+    Handle<T> spawn(Args&&... args) {
+        if (freeHead == NO_SLOT) addSlab();
+
+        uint32_t index = freeHead;
+        Slab& slab = *slabs[index / SLAB_SIZE];
+        uint32_t offset = index % SLAB_SIZE;
+        freeHead = slab.nextFree[offset];
+
+        new (slab.object(offset)) T(std::forward<Args>(args)...);
+        slab.alive[offset] = true;
+        ++liveCount;
+
+        Handle<T> handle;
+        handle.index = index;
+        handle.generation = slab.generation[offset];
+        return handle;
+    }
+
+    // Destrói o objeto e devolve o slot à lista livre. Handles antigos são ignorados.
+    bool despawn(Handle<T> handle) {
+        if (!get(handle)) return false;
+
+        Slab& slab = *slabs[handle.index / SLAB_SIZE];
+        uint32_t offset = handle.index % SLAB_SIZE;
+        slab.object(offset)->~T();
+        slab.alive[offset] = false;
+        if (++slab.generation[offset] == 0) slab.generation[offset] = 1; // 0 nunca é uma geração viva
+        slab.nextFree[offset] = freeHead;
+        freeHead = handle.index;
+        --liveCount;
+        return true;
+    }
+
+    // nullptr se o handle for inválido ou de um objeto já liberado
+    T* get(Handle<T> handle) const {
+        if (!handle.isValid() || handle.index >= capacity()) return nullptr;
+        Slab& slab = *slabs[handle.index / SLAB_SIZE];
+        uint32_t offset = handle.index % SLAB_SIZE;
+        if (!slab.alive[offset] || slab.generation[offset] != handle.generation) return nullptr;
+        return slab.object(offset);
+    }
+
+    // Percorre os objetos vivos em ordem de memória
+    template <typename Function>
+    void forEach(Function function) {
+        for (auto& slab : slabs) {
+            for (uint32_t offset = 0; offset < SLAB_SIZE; ++offset) {
+                if (slab->alive[offset]) function(*slab->object(offset));
+            }
+        }
+    }
+
+    // Destrói todos os objetos vivos; os slabs continuam reservados
+    void clear() {
+        for (size_t s = 0; s < slabs.size(); ++s) {
+            Slab& slab = *slabs[s];
+            for (uint32_t offset = 0; offset < SLAB_SIZE; ++offset) {
+                if (!slab.alive[offset]) continue;
+                slab.object(offset)->~T();
+                slab.alive[offset] = false;
+                if (++slab.generation[offset] == 0) slab.generation[offset] = 1;
+            }
+        }
+        liveCount = 0;
+        rebuildFreeList();
+    }
+
+    size_t size() const { return liveCount; }
+    size_t capacity() const { return slabs.size() * SLAB_SIZE; }
+    size_t slabCount() const { return slabs.size(); } // Também é o número de alocações no heap
+    size_t memoryBytes() const { return slabs.size() * sizeof(Slab); }
+
+private:
+    static const uint32_t NO_SLOT = 0xFFFFFFFFu;
+
+    struct Slab {
+        alignas(T) unsigned char storage[SLAB_SIZE * sizeof(T)];
+        uint32_t generation[SLAB_SIZE];
+        uint32_t nextFree[SLAB_SIZE];
+        bool alive[SLAB_SIZE];
+
+        T* object(uint32_t offset) { return std::launder(reinterpret_cast<T*>(storage + offset * sizeof(T))); }
+    };
+
+    void addSlab() {
+        std::unique_ptr<Slab> slab(new Slab);
+        for (uint32_t offset = 0; offset < SLAB_SIZE; ++offset) {
+            slab->generation[offset] = 1;
+            slab->alive[offset] = false;
+        }
+        slabs.push_back(std::move(slab));
+        rebuildFreeList();
+    }
+
+    // Lista livre em ordem crescente de índice: objetos novos ocupam a memória na ordem
+    void rebuildFreeList() {
+        freeHead = NO_SLOT;
+        for (size_t s = slabs.size(); s-- > 0;) {
+            Slab& slab = *slabs[s];
+            for (uint32_t offset = SLAB_SIZE; offset-- > 0;) {
+                if (slab.alive[offset]) continue;
+                slab.nextFree[offset] = freeHead;
+                freeHead = static_cast<uint32_t>(s * SLAB_SIZE + offset);
+            }
+        }
+    }
+
+    std::vector<std::unique_ptr<Slab>> slabs;
+    uint32_t freeHead = NO_SLOT;
+    size_t liveCount = 0;
+};
+
+#endif // POOL_H
@@ -0,0 +1,32 @@
+#ifndef RENDERER_H
+#define RENDERER_H
+
+#include <glm/glm.hpp>
+
+struct Mesh;
+
+// Interface comum aos backends de desenho (OpenGL e rasterizador de software).
+// Recebe o mesmo fluxo que drawShape produz: malha, matriz model e cor,
+// com view/projection fixas durante o quadro.
+class Renderer {
+public:
+    virtual ~Renderer() = default;
+
+    // Limpa os alvos e define a câmera do quadro
+    virtual void beginFrame(const glm::mat4& view, const glm::mat4& projection, const glm::vec3& clearColor) = 0;
+
+    // Enfileira (ou desenha imediatamente) uma malha com cor sólida
+    virtual void drawMesh(const Mesh& mesh, const glm::mat4& model, const glm::vec3& color) = 0;
+
+    // Conclui o quadro (o backend de software rasteriza aqui)
+    virtual void endFrame() = 0;
+
+    // Caixa envolvente (espaço do mundo) das malhas enviadas até endObject. Só os backends que
+    // descartam objetos sozinhos (culling na GPU) usam; os outros ignoram.
+    virtual void beginObject(const glm::vec3& boundsMin, const glm::vec3& boundsMax) { (void)boundsMin; (void)boundsMax; }
+    virtual void endObject() {}
+    // true se o backend já testa cada objeto contra o frustum (e o Hi-Z): o chamador pode pular o teste na CPU
+    virtual bool cullsObjects() const { return false; }
+};
+
+#endif // RENDERER_H
@@ -0,0 +1,794 @@
+#include "Replication.h"
+#include <glm/gtc/constants.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+const uint32_t NET_MAGIC = 0x50525441; // "ATRP"
+const int SOCKET_BUFFER_BYTES = 4 << 20; // A tick of views for many clients fits in the kernel buffers
+const int GRID_SHIFT = 12;               // 16 x 16 cells of 8 units over the quantized x/z range
+const int GRID_SIZE = 65536 >> GRID_SHIFT;
+
+enum NetPacketType : uint8_t { NET_HELLO = 1, NET_ACK, NET_BYE, NET_VIEW };
+
+// Datagrams are raw structs: both ends are the same build (loopback/LAN tests)
+struct NetPacketHeader {
+    uint32_t magic;
+    uint8_t type;
+    uint8_t reserved;
+    uint16_t fragmentIndex;
+    uint32_t sequence; // VIEW: the view; HELLO/ACK: the last view decoded
+    uint16_t fragmentCount;
+    uint16_t reserved2;
+};
+
+struct NetControl { // HELLO and ACK body
+    float focusX;
+    float focusZ;
+    float radius;
+};
+
+// Field groups of a changed entity
+enum NetField : uint8_t {
+    FIELD_XZ = 1u << 0,
+    FIELD_Y = 1u << 1,
+    FIELD_ROTATION = 1u << 2,
+    FIELD_HEAD = 1u << 3,
+    FIELD_LIMBS = 1u << 4,
+    FIELD_JAKE = 1u << 5,
+    FIELD_STATE = 1u << 6,
+    FIELD_TYPE = 1u << 7,
+    FIELD_ALL = 0xFF,
+};
+
+static_assert(sizeof(NetEntity) == 16, "NetEntity has no padding: views are hashed as raw bytes");
+
+uint16_t quantize16(float value, float min, float max) {
+    float t = std::clamp((value - min) / (max - min), 0.0f, 1.0f);
+    return static_cast<uint16_t>(std::lround(t * 65535.0f));
+}
+
+float dequantize16(uint16_t value, float min, float max) {
+    return min + (max - min) * (value / 65535.0f);
+}
+
+int8_t quantizeSigned8(float value, float range) {
+    return static_cast<int8_t>(std::lround(std::clamp(value / range, -1.0f, 1.0f) * 127.0f));
+}
+
+uint8_t quantizeUnsigned8(float value, float max) {
+    return static_cast<uint8_t>(std::lround(std::clamp(value / max, 0.0f, 1.0f) * 255.0f));
+}
+
+uint8_t changedFields(const NetEntity& a, const NetEntity& b) {
+    uint8_t mask = 0;
+    if (a.x != b.x || a.z != b.z) mask |= FIELD_XZ;
+    if (a.y != b.y) mask |= FIELD_Y;
+    if (a.rotation != b.rotation) mask |= FIELD_ROTATION;
+    if (a.headInclination != b.headInclination) mask |= FIELD_HEAD;
+    if (a.legSwing != b.legSwing || a.armSwing != b.armSwing) mask |= FIELD_LIMBS;
+    if (a.legStretch != b.legStretch || a.sizeMultiplier != b.sizeMultiplier) mask |= FIELD_JAKE;
+    if (a.attack != b.attack || a.flags != b.flags) mask |= FIELD_STATE;
+    if (a.type != b.type) mask |= FIELD_TYPE;
+    return mask;
+}
+
+// --- Byte writing/reading ---
+void put8(std::vector<uint8_t>& out, uint8_t value) { out.push_back(value); }
+
+void put16(std::vector<uint8_t>& out, uint16_t value) {
+    out.push_back(static_cast<uint8_t>(value));
+    out.push_back(static_cast<uint8_t>(value >> 8));
+}
+
+void put32(std::vector<uint8_t>& out, uint32_t value) {
+    for (int shift = 0; shift < 32; shift += 8) out.push_back(static_cast<uint8_t>(value >> shift));
+}
+
+void patch32(std::vector<uint8_t>& out, size_t at, uint32_t value) {
+    for (int i = 0; i < 4; ++i) out[at + i] = static_cast<uint8_t>(value >> (8 * i));
+}
+
+void putVarint(std::vector<uint8_t>& out, uint32_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+// 16-bit step (wrapping) as a zigzag varint: small moves take one byte
+void putStep(std::vector<uint8_t>& out, uint16_t from, uint16_t to) {
+    int16_t step = static_cast<int16_t>(static_cast<uint16_t>(to - from));
+    putVarint(out, static_cast<uint32_t>((step << 1) ^ (step >> 15)) & 0xFFFFu);
+}
+
+struct Reader {
+    const uint8_t* data;
+    size_t size;
+    size_t at = 0;
+    bool ok = true;
+
+    bool has(size_t bytes) {
+        if (at + bytes > size) ok = false;
+        return ok;
+    }
+    uint8_t get8() { return has(1) ? data[at++] : 0; }
+    uint16_t get16() {
+        if (!has(2)) return 0;
+        uint16_t value = static_cast<uint16_t>(data[at] | (data[at + 1] << 8));
+        at += 2;
+        return value;
+    }
+    uint32_t get32() {
+        if (!has(4)) return 0;
+        uint32_t value = 0;
+        for (int i = 0; i < 4; ++i) value |= static_cast<uint32_t>(data[at + i]) << (8 * i);
+        at += 4;
+        return value;
+    }
+    uint32_t getVarint() {
+        uint32_t value = 0;
+        for (int shift = 0; shift < 35; shift += 7) {
+            uint8_t byte = get8();
+            if (!ok) return 0;
+            value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) return value;
+        }
+        ok = false;
+        return 0;
+    }
+    uint16_t getStep(uint16_t from) {
+        uint32_t zigzag = getVarint();
+        int32_t step = static_cast<int32_t>(zigzag >> 1) ^ -static_cast<int32_t>(zigzag & 1);
+        return static_cast<uint16_t>(from + step);
+    }
+};
+
+void putEntity(std::vector<uint8_t>& out, uint8_t mask, const NetEntity& entity, const NetEntity* base) {
+    put8(out, mask);
+    if (mask & FIELD_XZ) {
+        if (base) {
+            putStep(out, base->x, entity.x);
+            putStep(out, base->z, entity.z);
+        } else {
+            put16(out, entity.x);
+            put16(out, entity.z);
+        }
+    }
+    if (mask & FIELD_Y) {
+        if (base) putStep(out, base->y, entity.y);
+        else put16(out, entity.y);
+    }
+    if (mask & FIELD_ROTATION) {
+        if (base) putStep(out, base->rotation, entity.rotation);
+        else put16(out, entity.rotation);
+    }
+    if (mask & FIELD_HEAD) put8(out, static_cast<uint8_t>(entity.headInclination));
+    if (mask & FIELD_LIMBS) {
+        put8(out, static_cast<uint8_t>(entity.legSwing));
+        put8(out, static_cast<uint8_t>(entity.armSwing));
+    }
+    if (mask & FIELD_JAKE) {
+        put8(out, entity.legStretch);
+        put8(out, entity.sizeMultiplier);
+    }
+    if (mask & FIELD_STATE) {
+        put8(out, entity.attack);
+        put8(out, entity.flags);
+    }
+    if (mask & FIELD_TYPE) put8(out, entity.type);
+}
+
+// 'entity' holds the baseline value (or anything, for a new entity: every field is then read)
+void getEntity(Reader& in, uint8_t mask, NetEntity& entity, bool hasBase) {
+    if (mask & FIELD_XZ) {
+        entity.x = hasBase ? in.getStep(entity.x) : in.get16();
+        entity.z = hasBase ? in.getStep(entity.z) : in.get16();
+    }
+    if (mask & FIELD_Y) entity.y = hasBase ? in.getStep(entity.y) : in.get16();
+    if (mask & FIELD_ROTATION) entity.rotation = hasBase ? in.getStep(entity.rotation) : in.get16();
+    if (mask & FIELD_HEAD) entity.headInclination = static_cast<int8_t>(in.get8());
+    if (mask & FIELD_LIMBS) {
+        entity.legSwing = static_cast<int8_t>(in.get8());
+        entity.armSwing = static_cast<int8_t>(in.get8());
+    }
+    if (mask & FIELD_JAKE) {
+        entity.legStretch = in.get8();
+        entity.sizeMultiplier = in.get8();
+    }
+    if (mask & FIELD_STATE) {
+        entity.attack = in.get8();
+        entity.flags = in.get8();
+    }
+    if (mask & FIELD_TYPE) entity.type = in.get8();
+}
+
+double millisecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+sockaddr_in toSockaddr(const NetAddress& address) {
+    sockaddr_in result;
+    std::memset(&result, 0, sizeof(result));
+    result.sin_family = AF_INET;
+    result.sin_addr.s_addr = htonl(address.ip);
+    result.sin_port = htons(address.port);
+    return result;
+}
+}
+
+// --- Quantization ---
+
+void quantizeCharacter(const Character* character, NetEntity& entity) {
+    entity.x = quantize16(character->position.x, -NET_XZ_RANGE, NET_XZ_RANGE);
+    entity.y = quantize16(character->position.y, NET_Y_MIN, NET_Y_MAX);
+    entity.z = quantize16(character->position.z, -NET_XZ_RANGE, NET_XZ_RANGE);
+    float turns = character->rotation / (2.0f * glm::pi<float>());
+    entity.rotation = static_cast<uint16_t>(std::lround((turns - std::floor(turns)) * 65536.0f) & 0xFFFF);
+    entity.headInclination = quantizeSigned8(character->headInclination, glm::pi<float>() / 4.0f);
+    entity.legSwing = quantizeSigned8(character->legSwingAngle, glm::pi<float>() / 2.0f);
+    entity.armSwing = quantizeSigned8(character->armSwingAngle, glm::pi<float>() / 2.0f);
+    entity.legStretch = 0;
+    entity.sizeMultiplier = 0;
+    entity.attack = 0;
+    CharacterType type = characterType(character);
+    if (type == CHARACTER_JAKE) {
+        const Jake* jake = static_cast<const Jake*>(character);
+        entity.legStretch = quantizeUnsigned8(jake->legStretch, 4.0f);
+        entity.sizeMultiplier = quantizeUnsigned8(jake->sizeMultiplier, 4.0f);
+    } else if (type == CHARACTER_FINN) {
+        const Finn* finn = static_cast<const Finn*>(character);
+        if (finn->isAttacking) entity.attack = std::max<uint8_t>(1, quantizeUnsigned8(simulationTime - finn->attackStartTime, 0.3f));
+    }
+    entity.type = static_cast<uint8_t>(type);
+    entity.flags = (character->isJumping ? NET_JUMPING : 0) | (character->moving ? NET_MOVING : 0);
+}
+
+glm::vec3 netPosition(const NetEntity& entity) {
+    return glm::vec3(dequantize16(entity.x, -NET_XZ_RANGE, NET_XZ_RANGE), dequantize16(entity.y, NET_Y_MIN, NET_Y_MAX),
+                     dequantize16(entity.z, -NET_XZ_RANGE, NET_XZ_RANGE));
+}
+
+uint32_t netViewChecksum(const NetView& view) {
+    // FNV-1a over the ids and the raw entities
+    uint32_t hash = 2166136261u;
+    auto mix = [&](const void* data, size_t bytes) {
+        const uint8_t* p = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < bytes; ++i) hash = (hash ^ p[i]) * 16777619u;
+    };
+    mix(view.ids.data(), view.ids.size() * sizeof(uint32_t));
+    mix(view.entities.data(), view.entities.size() * sizeof(NetEntity));
+    return hash;
+}
+
+// --- NetViewHistory ---
+
+const NetView* NetViewHistory::find(uint32_t sequence) const {
+    const NetView& view = views[sequence % SIZE];
+    return sequence != 0 && view.sequence == sequence ? &view : nullptr;
+}
+
+NetView& NetViewHistory::store(uint32_t sequence) {
+    NetView& view = views[sequence % SIZE];
+    view.sequence = sequence;
+    view.clear();
+    return view;
+}
+
+void NetViewHistory::clear() {
+    for (NetView& view : views) {
+        view.sequence = 0;
+        view.clear();
+    }
+}
+
+// --- Delta encoding ---
+
+void encodeNetView(const NetView& view, const NetView* baseline, std::vector<uint8_t>& payload) {
+    payload.clear();
+    put32(payload, view.sequence);
+    put32(payload, baseline ? baseline->sequence : 0);
+    put32(payload, view.tick);
+    put32(payload, static_cast<uint32_t>(view.ids.size()));
+    put32(payload, netViewChecksum(view));
+
+    // Ids that left the view since the baseline
+    size_t countAt = payload.size();
+    put32(payload, 0);
+    uint32_t removed = 0;
+    uint32_t previous = 0;
+    if (baseline) {
+        size_t i = 0;
+        for (uint32_t id : baseline->ids) {
+            while (i < view.ids.size() && view.ids[i] < id) ++i;
+            if (i < view.ids.size() && view.ids[i] == id) continue;
+            putVarint(payload, id - previous);
+            previous = id;
+            ++removed;
+        }
+    }
+    patch32(payload, countAt, removed);
+
+    // New entities in full, the others only when a field group changed
+    countAt = payload.size();
+    put32(payload, 0);
+    uint32_t changed = 0;
+    previous = 0;
+    size_t j = 0;
+    for (size_t i = 0; i < view.ids.size(); ++i) {
+        uint32_t id = view.ids[i];
+        const NetEntity* base = nullptr;
+        if (baseline) {
+            while (j < baseline->ids.size() && baseline->ids[j] < id) ++j;
+            if (j < baseline->ids.size() && baseline->ids[j] == id) base = &baseline->entities[j];
+        }
+        uint8_t mask = base ? changedFields(*base, view.entities[i]) : static_cast<uint8_t>(FIELD_ALL);
+        if (mask == 0) continue;
+        putVarint(payload, id - previous);
+        previous = id;
+        putEntity(payload, mask, view.entities[i], base);
+        ++changed;
+    }
+    patch32(payload, countAt, changed);
+}
+
+NetDecodeResult decodeNetView(const std::vector<uint8_t>& payload, const NetViewHistory& history, NetView& view) {
+    Reader in{ payload.data(), payload.size() };
+    uint32_t sequence = in.get32();
+    uint32_t baselineSequence = in.get32();
+    uint32_t tick = in.get32();
+    uint32_t count = in.get32();
+    uint32_t checksum = in.get32();
+    uint32_t removedCount = in.get32();
+    if (!in.ok || sequence == 0) return NetDecodeResult::Corrupt;
+    const NetView* baseline = nullptr;
+    if (baselineSequence != 0) {
+        baseline = history.find(baselineSequence);
+        if (!baseline) return NetDecodeResult::MissingBaseline;
+    }
+
+    // Two cursors: the removed ids, then the changed entities right after them
+    Reader removed = in;
+    for (uint32_t i = 0; i < removedCount && in.ok; ++i) in.getVarint();
+    uint32_t changedCount = in.get32();
+    if (!in.ok || (removedCount > 0 && !baseline)) return NetDecodeResult::Corrupt;
+    Reader& changed = in;
+    // Both counts come off the wire, so bound them before they size anything: every changed entity takes
+    // at least two bytes (id delta and mask), and the view holds at most the baseline plus the changed ones
+    size_t baseCount = baseline ? baseline->ids.size() : 0;
+    if (changedCount > (in.size - in.at) / 2 || count > baseCount + changedCount) return NetDecodeResult::Corrupt;
+
+    view.clear();
+    view.sequence = sequence;
+    view.tick = tick;
+    view.ids.reserve(count);
+    view.entities.reserve(count);
+
+    const uint32_t NONE = UINT32_MAX;
+    uint32_t nextRemoved = NONE, removedLeft = removedCount, removedId = 0;
+    auto advanceRemoved = [&]() {
+        nextRemoved = NONE;
+        if (removedLeft == 0) return;
+        --removedLeft;
+        removedId += removed.getVarint();
+        nextRemoved = removedId;
+    };
+    uint32_t nextChanged = NONE, changedLeft = changedCount, changedId = 0;
+    auto advanceChanged = [&]() {
+        nextChanged = NONE;
+        if (changedLeft == 0) return;
+        --changedLeft;
+        changedId += changed.getVarint();
+        nextChanged = changedId;
+    };
+    advanceRemoved();
+    advanceChanged();
+
+    size_t j = 0;
+    while ((j < baseCount || nextChanged != NONE) && removed.ok && changed.ok) {
+        uint32_t baseId = j < baseCount ? baseline->ids[j] : NONE;
+        if (baseId < nextChanged) {
+            if (baseId == nextRemoved) {
+                advanceRemoved();
+            } else {
+                view.ids.push_back(baseId);
+                view.entities.push_back(baseline->entities[j]);
+            }
+            ++j;
+            continue;
+        }
+        uint8_t mask = changed.get8();
+        NetEntity entity{};
+        bool hasBase = baseId == nextChanged;
+        if (hasBase) {
+            entity = baseline->entities[j++];
+        } else if (mask != FIELD_ALL) {
+            return NetDecodeResult::Corrupt; // A new entity must come in full
+        }
+        getEntity(changed, mask, entity, hasBase);
+        view.ids.push_back(nextChanged);
+        view.entities.push_back(entity);
+        if (view.ids.size() > count) return NetDecodeResult::Corrupt;
+        advanceChanged();
+    }
+    if (!removed.ok || !changed.ok || nextRemoved != NONE || view.ids.size() != count) return NetDecodeResult::Corrupt;
+    return netViewChecksum(view) == checksum ? NetDecodeResult::Ok : NetDecodeResult::ChecksumMismatch;
+}
+
+// --- UDP ---
+
+std::string NetAddress::toString() const {
+    char text[32];
+    std::snprintf(text, sizeof(text), "%u.%u.%u.%u:%u", ip >> 24, (ip >> 16) & 0xFF, (ip >> 8) & 0xFF, ip & 0xFF, port);
+    return text;
+}
+
+bool parseNetAddress(const std::string& text, NetAddress& address) {
+    size_t colon = text.rfind(':');
+    std::string host = text.substr(0, colon);
+    if (colon != std::string::npos) {
+        int port = std::atoi(text.c_str() + colon + 1);
+        if (port <= 0 || port > 65535) return false;
+        address.port = static_cast<uint16_t>(port);
+    }
+    if (host == "localhost") host = "127.0.0.1";
+    in_addr parsed;
+    if (inet_pton(AF_INET, host.c_str(), &parsed) != 1) return false;
+    address.ip = ntohl(parsed.s_addr);
+    return true;
+}
+
+UdpSocket::~UdpSocket() {
+    close();
+}
+
+bool UdpSocket::open(const NetAddress& bindAddress) {
+    close();
+    handle = ::socket(AF_INET, SOCK_DGRAM, 0);
+    if (handle < 0) return false;
+    setsockopt(handle, SOL_SOCKET, SO_SNDBUF, &SOCKET_BUFFER_BYTES, sizeof(SOCKET_BUFFER_BYTES));
+    setsockopt(handle, SOL_SOCKET, SO_RCVBUF, &SOCKET_BUFFER_BYTES, sizeof(SOCKET_BUFFER_BYTES));
+    sockaddr_in address = toSockaddr(bindAddress);
+    if (::bind(handle, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        fcntl(handle, F_SETFL, fcntl(handle, F_GETFL, 0) | O_NONBLOCK) != 0) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void UdpSocket::close() {
+    if (handle >= 0) ::close(handle);
+    handle = -1;
+}
+
+bool UdpSocket::send(const NetAddress& to, const void* data, size_t bytes) {
+    sockaddr_in address = toSockaddr(to);
+    return ::sendto(handle, data, bytes, 0, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == static_cast<ssize_t>(bytes);
+}
+
+int UdpSocket::receive(NetAddress& from, void* data, size_t capacity) {
+    sockaddr_in address;
+    socklen_t length = sizeof(address);
+    ssize_t bytes = ::recvfrom(handle, data, capacity, 0, reinterpret_cast<sockaddr*>(&address), &length);
+    if (bytes < 0) return -1;
+    from.ip = ntohl(address.sin_addr.s_addr);
+    from.port = ntohs(address.sin_port);
+    return static_cast<int>(bytes);
+}
+
+// --- ReplicationServer ---
+
+bool ReplicationServer::open(const NetAddress& bindAddress) {
+    return socket.open(bindAddress);
+}
+
+ReplicationServer::Client* ReplicationServer::findClient(const NetAddress& address) {
+    for (const std::unique_ptr<Client>& client : clients) {
+        if (client->address == address) return client.get();
+    }
+    return nullptr;
+}
+
+void ReplicationServer::receive(double now) {
+    uint8_t buffer[1500];
+    NetAddress from;
+    int bytes;
+    while ((bytes = socket.receive(from, buffer, sizeof(buffer))) >= 0) {
+        NetPacketHeader header;
+        if (bytes < (int)sizeof(header)) continue;
+        std::memcpy(&header, buffer, sizeof(header));
+        if (header.magic != NET_MAGIC) continue;
+
+        Client* client = findClient(from);
+        if (!client && header.type == NET_HELLO) {
+            if (clients.size() >= MAX_CLIENTS) {
+                ++stats.refused;
+                continue;
+            }
+            clients.push_back(std::make_unique<Client>());
+            client = clients.back().get();
+            client->address = from;
+            std::printf("client %s joined (%zu connected)\n", from.toString().c_str(), clients.size());
+        }
+        if (!client) continue;
+        client->lastHeard = now;
+
+        if (header.type == NET_BYE) {
+            std::printf("client %s left\n", from.toString().c_str());
+            clients.erase(std::find_if(clients.begin(), clients.end(), [&](const std::unique_ptr<Client>& c) { return c.get() == client; }));
+            continue;
+        }
+        if (bytes >= (int)(sizeof(header) + sizeof(NetControl))) {
+            NetControl control;
+            std::memcpy(&control, buffer + sizeof(header), sizeof(control));
+            client->focusX = control.focusX;
+            client->focusZ = control.focusZ;
+            client->radius = std::max(0.0f, control.radius);
+        }
+        // Only a view the server still remembers can be a baseline
+        if (header.type == NET_ACK && header.sequence > client->acked && client->sent.find(header.sequence)) {
+            client->acked = header.sequence;
+        }
+    }
+
+    for (size_t i = 0; i < clients.size();) {
+        if (now - clients[i]->lastHeard > CLIENT_TIMEOUT) {
+            std::printf("client %s timed out\n", clients[i]->address.toString().c_str());
+            clients.erase(clients.begin() + i);
+        } else {
+            ++i;
+        }
+    }
+}
+
+void ReplicationServer::buildGrid() {
+    // Counting sort of the character ids by cell: running totals give each cell's end, filling
+    // from the back moves them to the starts and keeps the ids ascending inside each cell
+    const size_t cells = GRID_SIZE * GRID_SIZE;
+    cellStart.assign(cells + 1, 0);
+    for (const NetEntity& entity : quantized) ++cellStart[(entity.z >> GRID_SHIFT) * GRID_SIZE + (entity.x >> GRID_SHIFT)];
+    for (size_t cell = 1; cell < cells; ++cell) cellStart[cell] += cellStart[cell - 1];
+    cellStart[cells] = static_cast<uint32_t>(quantized.size());
+    cellItems.resize(quantized.size());
+    for (size_t i = quantized.size(); i-- > 0;) {
+        const NetEntity& entity = quantized[i];
+        cellItems[--cellStart[(entity.z >> GRID_SHIFT) * GRID_SIZE + (entity.x >> GRID_SHIFT)]] = static_cast<uint32_t>(i);
+    }
+}
+
+void ReplicationServer::collectInterest(const Client& client, NetView& view) {
+    if (client.radius <= 0.0f) {
+        view.ids.resize(quantized.size());
+        for (size_t i = 0; i < quantized.size(); ++i) view.ids[i] = static_cast<uint32_t>(i);
+        view.entities.assign(quantized.begin(), quantized.end());
+        return;
+    }
+    auto cellOf = [](float coordinate) {
+        return std::clamp(static_cast<int>(quantize16(coordinate, -NET_XZ_RANGE, NET_XZ_RANGE)) >> GRID_SHIFT, 0, GRID_SIZE - 1);
+    };
+    int minX = cellOf(client.focusX - client.radius), maxX = cellOf(client.focusX + client.radius);
+    int minZ = cellOf(client.focusZ - client.radius), maxZ = cellOf(client.focusZ + client.radius);
+    float radiusSquared = client.radius * client.radius;
+    for (int cz = minZ; cz <= maxZ; ++cz) {
+        for (int cx = minX; cx <= maxX; ++cx) {
+            size_t cell = cz * GRID_SIZE + cx;
+            for (uint32_t k = cellStart[cell]; k < cellStart[cell + 1]; ++k) {
+                glm::vec3 position = netPosition(quantized[cellItems[k]]);
+                float dx = position.x - client.focusX, dz = position.z - client.focusZ;
+                if (dx * dx + dz * dz <= radiusSquared) view.ids.push_back(cellItems[k]);
+            }
+        }
+    }
+    std::sort(view.ids.begin(), view.ids.end());
+    view.entities.resize(view.ids.size());
+    for (size_t i = 0; i < view.ids.size(); ++i) view.entities[i] = quantized[view.ids[i]];
+}
+
+void ReplicationServer::sendPayload(Client& client, uint32_t sequence) {
+    size_t fragmentCount = std::max<size_t>(1, (payload.size() + NET_MAX_FRAGMENT - 1) / NET_MAX_FRAGMENT);
+    if (fragmentCount > UINT16_MAX) {
+        ++stats.oversized;
+        return;
+    }
+    NetPacketHeader header{ NET_MAGIC, NET_VIEW, 0, 0, sequence, static_cast<uint16_t>(fragmentCount), 0 };
+    for (size_t fragment = 0; fragment < fragmentCount; ++fragment) {
+        size_t begin = fragment * NET_MAX_FRAGMENT;
+        size_t bytes = std::min(NET_MAX_FRAGMENT, payload.size() - begin);
+        header.fragmentIndex = static_cast<uint16_t>(fragment);
+        packet.resize(sizeof(header) + bytes);
+        std::memcpy(packet.data(), &header, sizeof(header));
+        std::memcpy(packet.data() + sizeof(header), payload.data() + begin, bytes);
+        socket.send(client.address, packet.data(), packet.size());
+        stats.bytes += packet.size();
+        ++stats.packets;
+    }
+}
+
+void ReplicationServer::send(const std::vector<Character*>& characters, uint32_t tick) {
+    auto quantizeStart = std::chrono::steady_clock::now();
+    quantized.resize(characters.size());
+    for (size_t i = 0; i < characters.size(); ++i) quantizeCharacter(characters[i], quantized[i]);
+    buildGrid();
+    stats.quantizeMs += millisecondsSince(quantizeStart);
+    ++stats.ticks;
+
+    for (const std::unique_ptr<Client>& client : clients) {
+        auto start = std::chrono::steady_clock::now();
+        uint32_t sequence = client->nextSequence++;
+        NetView& view = client->sent.store(sequence);
+        view.tick = tick;
+        collectInterest(*client, view);
+        auto interestEnd = std::chrono::steady_clock::now();
+
+        // find() after store(): a baseline as old as the history was just overwritten
+        const NetView* baseline = client->sent.find(client->acked);
+        encodeNetView(view, baseline, payload);
+        auto encodeEnd = std::chrono::steady_clock::now();
+
+        sendPayload(*client, sequence);
+        double interestMs = std::chrono::duration<double, std::milli>(interestEnd - start).count();
+        double encodeMs = std::chrono::duration<double, std::milli>(encodeEnd - interestEnd).count();
+        double sendMs = millisecondsSince(encodeEnd);
+        stats.interestMs += interestMs;
+        stats.encodeMs += encodeMs;
+        stats.sendMs += sendMs;
+        stats.maxClientMs = std::max(stats.maxClientMs, interestMs + encodeMs + sendMs);
+        ++stats.views;
+        if (!baseline) ++stats.fullViews;
+        stats.entities += view.ids.size();
+    }
+}
+
+void ReplicationServer::printStats(double seconds, double simulationMs) {
+    if (stats.ticks == 0) return;
+    double ticks = static_cast<double>(stats.ticks);
+    std::printf("%zu clients | sim %.3f ms/tick, quantize %.3f ms/tick", clients.size(), simulationMs / ticks, stats.quantizeMs / ticks);
+    if (stats.views > 0) {
+        double views = static_cast<double>(stats.views);
+        double clientsPerTick = views / ticks; // Clients come and go within the window
+        std::printf(" | per view: interest %.3f + encode %.3f + send %.3f ms (max %.3f), %.0f entities, %.0f B, %.0f%% full"
+                    " | %.1f KB/s and %.0f packets/s per client",
+                    stats.interestMs / views, stats.encodeMs / views, stats.sendMs / views, stats.maxClientMs,
+                    stats.entities / views, stats.bytes / views, 100.0 * stats.fullViews / views,
+                    stats.bytes / 1024.0 / seconds / clientsPerTick, stats.packets / seconds / clientsPerTick);
+    }
+    if (stats.oversized > 0) std::printf(" | %zu views over 65535 fragments dropped", stats.oversized);
+    if (stats.refused > 0) std::printf(" | %zu HELLOs refused (%zu clients max)", stats.refused, MAX_CLIENTS);
+    std::printf("\n");
+    std::fflush(stdout);
+    stats = Stats();
+}
+
+// --- ReplicationClient ---
+
+bool ReplicationClient::connect(const NetAddress& serverAddress, float interestRadius, int follow) {
+    NetAddress any;
+    any.ip = 0;
+    any.port = 0;
+    server = serverAddress;
+    radius = interestRadius;
+    followId = follow;
+    history.clear();
+    current = NetView();
+    return socket.open(any);
+}
+
+void ReplicationClient::sendControl(uint8_t type) {
+    uint8_t buffer[sizeof(NetPacketHeader) + sizeof(NetControl)];
+    NetPacketHeader header{ NET_MAGIC, type, 0, 0, current.sequence, 0, 0 };
+    NetControl control{ focus.x, focus.z, radius };
+    std::memcpy(buffer, &header, sizeof(header));
+    std::memcpy(buffer + sizeof(header), &control, sizeof(control));
+    socket.send(server, buffer, type == NET_BYE ? sizeof(header) : sizeof(buffer));
+}
+
+void ReplicationClient::update(double now) {
+    if (!socket.isOpen()) return;
+    if (!hasView() && now - lastHello >= 0.5) {
+        sendControl(NET_HELLO);
+        lastHello = now;
+    }
+
+    uint8_t buffer[1500];
+    NetAddress from;
+    int bytes;
+    while ((bytes = socket.receive(from, buffer, sizeof(buffer))) >= 0) {
+        NetPacketHeader header;
+        if (!(from == server) || bytes < (int)sizeof(header)) continue;
+        std::memcpy(&header, buffer, sizeof(header));
+        if (header.magic != NET_MAGIC || header.type != NET_VIEW || header.fragmentCount == 0) continue;
+        stats.bytes += bytes;
+        ++stats.packets;
+        lastHeard = now;
+
+        if (header.sequence <= current.sequence || header.sequence < assembling) continue; // Late
+        if (header.sequence != assembling) {
+            if (fragmentsMissing > 0) ++stats.incomplete; // A newer view started before the last one completed
+            assembling = header.sequence;
+            fragments.resize(header.fragmentCount);
+            for (std::vector<uint8_t>& fragment : fragments) fragment.clear();
+            fragmentsMissing = header.fragmentCount;
+        }
+        if (header.fragmentIndex >= fragments.size() || header.fragmentCount != fragments.size() ||
+            !fragments[header.fragmentIndex].empty() || bytes == (int)sizeof(header)) {
+            continue;
+        }
+        fragments[header.fragmentIndex].assign(buffer + sizeof(header), buffer + bytes);
+        if (--fragmentsMissing == 0) finishView();
+    }
+}
+
+void ReplicationClient::finishView() {
+    payload.clear();
+    for (const std::vector<uint8_t>& fragment : fragments) payload.insert(payload.end(), fragment.begin(), fragment.end());
+
+    auto start = std::chrono::steady_clock::now();
+    NetView& view = history.store(assembling);
+    NetDecodeResult result = decodeNetView(payload, history, view);
+    stats.decodeMs += millisecondsSince(start);
+    if (result != NetDecodeResult::Ok) {
+        view.sequence = 0; // Never a baseline
+        if (result == NetDecodeResult::MissingBaseline) ++stats.missingBaseline;
+        else if (result == NetDecodeResult::Corrupt) ++stats.corrupt;
+        else ++stats.checksumMismatches;
+        return;
+    }
+    current = view;
+    ++stats.views;
+    stats.entities += current.ids.size();
+
+    // The interest area follows the followed character while it is in view
+    if (followId >= 0) {
+        auto found = std::lower_bound(current.ids.begin(), current.ids.end(), static_cast<uint32_t>(followId));
+        if (found != current.ids.end() && *found == static_cast<uint32_t>(followId)) {
+            focus = netPosition(current.entities[found - current.ids.begin()]);
+        }
+    }
+    sendControl(NET_ACK);
+}
+
+void ReplicationClient::disconnect() {
+    if (!socket.isOpen()) return;
+    sendControl(NET_BYE);
+    socket.close();
+}
+
+ReplicationOptions parseReplicationOptions(int argc, char** argv) {
+    ReplicationOptions options;
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(arg, "--port") == 0 && hasValue) {
+            options.address.port = static_cast<uint16_t>(std::clamp(std::atoi(argv[++i]), 1, 65535));
+        } else if (std::strcmp(arg, "--bind") == 0 && hasValue) {
+            options.bindAny = std::strcmp(argv[++i], "any") == 0;
+        } else if (std::strcmp(arg, "--characters") == 0 && hasValue) {
+            options.characters = std::max(0LL, std::atoll(argv[++i]));
+        } else if (std::strcmp(arg, "--seconds") == 0 && hasValue) {
+            options.seconds = std::max(0.0, std::atof(argv[++i]));
+        } else if (std::strcmp(arg, "--tick-rate") == 0 && hasValue) {
+            options.tickRate = std::clamp(std::atoi(argv[++i]), 1, 1000);
+        } else if (std::strcmp(arg, "--connect") == 0 && hasValue) {
+            options.client = true;
+            if (!parseNetAddress(argv[++i], options.address)) std::fprintf(stderr, "Bad address %s, using %s\n", argv[i], options.address.toString().c_str());
+        } else if (std::strcmp(arg, "--interest") == 0 && hasValue) {
+            options.interest = std::max(0.0f, static_cast<float>(std::atof(argv[++i])));
+        } else if (std::strcmp(arg, "--follow") == 0 && hasValue) {
+            options.follow = std::atoi(argv[++i]);
+        }
+    }
+    if (options.seconds < 0.0) options.seconds = options.client ? 10.0 : 0.0;
+    return options;
+}
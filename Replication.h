@@ -0,0 +1,244 @@
+#ifndef REPLICATION_H
+#define REPLICATION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "AdventureCharacters.h"
+
+// Authoritative replication of the Adventure Time world over UDP (AdventureServer, mainserver.cpp).
+// The server owns the Character simulation. Every tick it quantizes each character once
+// (NetEntity), then for each client picks the characters within that client's interest radius
+// (a NetView) and encodes it as a delta against the last view the client acknowledged: ids that
+// left, and for the others only the field groups that changed, positions as small varint steps.
+// Payloads are split into datagrams of at most NET_MAX_FRAGMENT bytes; a view with a missing
+// fragment is simply lost, and the next one is still encoded against the last acknowledged view.
+// Clients send HELLO to join, ACK after every decoded view (with their current focus) and BYE.
+// There is no reliability layer beyond that, and no encryption or authentication: loopback and
+// LAN tests only.
+
+const uint16_t NET_DEFAULT_PORT = 27015;
+const size_t NET_MAX_FRAGMENT = 1200; // Payload bytes per datagram, below a typical MTU
+
+// --- Quantized state ---
+enum NetEntityFlags : uint8_t {
+    NET_JUMPING = 1u << 0,
+    NET_MOVING = 1u << 1,
+};
+
+// One character as sent to the clients. Positions are 16-bit fixed point over the NET_* ranges
+// below (about 2 mm steps), angles are 16 or 8 bits. No padding: views are hashed as raw bytes.
+struct NetEntity {
+    uint16_t x, y, z;
+    uint16_t rotation;       // [0, 2pi)
+    int8_t headInclination;  // +-pi/4
+    int8_t legSwing;         // +-pi/2
+    int8_t armSwing;
+    uint8_t legStretch;      // Jake, 0..4
+    uint8_t sizeMultiplier;  // Jake, 0..4
+    uint8_t attack;          // Finn: attack progress 1..255 while attacking, else 0
+    uint8_t type;            // CharacterType
+    uint8_t flags;           // NetEntityFlags
+};
+
+const float NET_XZ_RANGE = 64.0f;              // x and z in [-64, 64]
+const float NET_Y_MIN = -8.0f, NET_Y_MAX = 24.0f;
+
+void quantizeCharacter(const Character* character, NetEntity& entity);
+glm::vec3 netPosition(const NetEntity& entity);
+
+// The characters one client sees on one tick, sorted by id (index in the server's list)
+struct NetView {
+    uint32_t sequence = 0; // Per client, from 1; 0 means "no view"
+    uint32_t tick = 0;
+    std::vector<uint32_t> ids;
+    std::vector<NetEntity> entities; // Parallel to ids
+
+    void clear() { ids.clear(); entities.clear(); }
+};
+
+uint32_t netViewChecksum(const NetView& view);
+
+// The last SIZE views by sequence: what the server sent to a client, or what a client decoded
+class NetViewHistory {
+public:
+    static const size_t SIZE = 32;
+
+    const NetView* find(uint32_t sequence) const;
+    NetView& store(uint32_t sequence); // Reuses the capacity of the view it replaces
+    void clear();
+
+private:
+    NetView views[SIZE];
+};
+
+// Payload: sequence, baseline sequence (0 = full view), tick, entity count, checksum, then the
+// ids that left the view and the entities that are new or changed
+void encodeNetView(const NetView& view, const NetView* baseline, std::vector<uint8_t>& payload);
+
+enum class NetDecodeResult { Ok, MissingBaseline, Corrupt, ChecksumMismatch };
+NetDecodeResult decodeNetView(const std::vector<uint8_t>& payload, const NetViewHistory& history, NetView& view);
+
+// --- UDP ---
+struct NetAddress {
+    uint32_t ip = 0x7F000001; // Host order, 127.0.0.1
+    uint16_t port = NET_DEFAULT_PORT;
+
+    bool operator==(const NetAddress& other) const { return ip == other.ip && port == other.port; }
+    std::string toString() const;
+};
+
+// "host[:port]" with a dotted IPv4 host (or "localhost")
+bool parseNetAddress(const std::string& text, NetAddress& address);
+
+// Non-blocking IPv4 UDP socket (POSIX)
+class UdpSocket {
+public:
+    UdpSocket() = default;
+    ~UdpSocket();
+    UdpSocket(const UdpSocket&) = delete;
+    UdpSocket& operator=(const UdpSocket&) = delete;
+
+    bool open(const NetAddress& bindAddress); // Port 0: any free port
+    void close();
+    bool isOpen() const { return handle >= 0; }
+
+    bool send(const NetAddress& to, const void* data, size_t bytes);
+    // Bytes received, or -1 when nothing is waiting
+    int receive(NetAddress& from, void* data, size_t capacity);
+
+private:
+    int handle = -1;
+};
+
+// --- Server ---
+class ReplicationServer {
+public:
+    static constexpr double CLIENT_TIMEOUT = 3.0; // Seconds without a packet before a client is dropped
+    static constexpr size_t MAX_CLIENTS = 64;     // HELLOs past this are ignored (each client costs a history)
+
+    bool open(const NetAddress& bindAddress);
+
+    // Handles HELLO/ACK/BYE; 'now' in seconds
+    void receive(double now);
+    // Quantizes 'characters' once, then encodes and sends one view per client
+    void send(const std::vector<Character*>& characters, uint32_t tick);
+
+    size_t clientCount() const { return clients.size(); }
+
+    // Totals since the last printStats (per tick sums, divided when printed)
+    struct Stats {
+        size_t ticks = 0;
+        size_t views = 0;         // Views sent (one per client per tick)
+        size_t fullViews = 0;     // ...of which without a baseline
+        size_t oversized = 0;     // Not sent: more than 65535 fragments
+        size_t refused = 0;       // HELLOs ignored because MAX_CLIENTS were connected
+        size_t entities = 0;      // Entities in the views sent
+        size_t bytes = 0;         // UDP payload bytes, headers included
+        size_t packets = 0;
+        double quantizeMs = 0.0;  // Once per tick
+        double interestMs = 0.0;  // Per client: picking the characters in range
+        double encodeMs = 0.0;    // Per client: delta encoding and checksum
+        double maxClientMs = 0.0; // Worst interest + encode + send of one client
+        double sendMs = 0.0;      // Per client: fragmenting and sendto
+    };
+    const Stats& getStats() const { return stats; }
+    void printStats(double seconds, double simulationMs);
+
+private:
+    struct Client {
+        NetAddress address;
+        float focusX = 0.0f;
+        float focusZ = 0.0f;
+        float radius = 0.0f; // 0: the whole world
+        uint32_t acked = 0;
+        uint32_t nextSequence = 1;
+        double lastHeard = 0.0;
+        NetViewHistory sent;
+    };
+
+    Client* findClient(const NetAddress& address);
+    void buildGrid();
+    void collectInterest(const Client& client, NetView& view);
+    void sendPayload(Client& client, uint32_t sequence);
+
+    UdpSocket socket;
+    std::vector<std::unique_ptr<Client>> clients;
+    std::vector<NetEntity> quantized;   // Every character this tick
+    std::vector<uint32_t> cellStart;    // Uniform grid over the quantized positions
+    std::vector<uint32_t> cellItems;
+    std::vector<uint8_t> payload;
+    std::vector<uint8_t> packet;
+    Stats stats;
+};
+
+// --- Client ---
+class ReplicationClient {
+public:
+    bool connect(const NetAddress& server, float radius, int followId);
+    // Receives, reassembles, decodes and acknowledges; repeats HELLO until the first view
+    void update(double now);
+    void disconnect();
+
+    const NetView& latest() const { return current; }
+    bool hasView() const { return current.sequence != 0; }
+    double lastReceived() const { return lastHeard; }
+
+    struct Stats {
+        size_t bytes = 0;
+        size_t packets = 0;
+        size_t views = 0;
+        size_t incomplete = 0;       // Views with a fragment that never arrived
+        size_t missingBaseline = 0;
+        size_t corrupt = 0;
+        size_t checksumMismatches = 0;
+        size_t entities = 0;         // Sum over decoded views
+        double decodeMs = 0.0;
+    };
+    const Stats& getStats() const { return stats; }
+
+private:
+    void sendControl(uint8_t type);
+    void finishView();
+
+    UdpSocket socket;
+    NetAddress server;
+    float radius = 0.0f;
+    int followId = -1;
+    glm::vec3 focus = glm::vec3(0.0f);
+    double lastHello = -1.0;
+    double lastHeard = 0.0;
+
+    uint32_t assembling = 0; // Sequence of the view being reassembled
+    std::vector<std::vector<uint8_t>> fragments;
+    size_t fragmentsMissing = 0;
+    std::vector<uint8_t> payload;
+    NetViewHistory history;
+    NetView current;
+    Stats stats;
+};
+
+// AdventureServer options:
+//   --port N              UDP port (default 27015); the server binds to 127.0.0.1 unless --bind any
+//   --characters N        world size: the usual seven plus NPCs up to N (default 2000)
+//   --seconds S           run time; server default 0 = until killed, client default 10
+//   --tick-rate N         simulation and send rate in Hz (default 60)
+//   --connect host[:port] run as a headless client of that server
+//   --interest R          client interest radius around its focus (default 20, 0 = everything)
+//   --follow id           client focus follows that character (default 0, Finn; -1 = world origin)
+struct ReplicationOptions {
+    bool client = false;
+    NetAddress address;
+    bool bindAny = false;
+    long long characters = 2000;
+    double seconds = -1.0; // Unset: the role's default
+    int tickRate = 60;
+    float interest = 20.0f;
+    int follow = 0;
+};
+
+ReplicationOptions parseReplicationOptions(int argc, char** argv);
+
+#endif // REPLICATION_H
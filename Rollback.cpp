@@ -0,0 +1,286 @@
+#include "Rollback.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+uint32_t mixBits(uint32_t x) {
+    x ^= x >> 16;
+    x *= 0x7FEB352Du;
+    x ^= x >> 15;
+    x *= 0x846CA68Bu;
+    x ^= x >> 16;
+    return x;
+}
+
+double millisecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+}
+
+// --- RollbackSession ---
+
+RollbackSession::RollbackSession(std::vector<Character*>& characterList, float fixedDeltaTime, int maxRollbackTicks, float coneScaleFactor)
+    : characters(characterList), deltaTime(fixedDeltaTime), maxRollback(static_cast<uint32_t>(std::max(1, maxRollbackTicks))) {
+    ring.resize(2 * (maxRollback + 1));
+    scene.coneScaleFactor = coneScaleFactor;
+}
+
+int RollbackSession::addPlayer(int characterIndex) {
+    if (playerCount() >= MAX_PLAYERS || characterIndex < 0 || characterIndex >= (int)characters.size()) return -1;
+    controlled.push_back(characterIndex);
+    if (controlled.size() == 1) scene.activeCharacterIndex = characterIndex;
+    return playerCount() - 1;
+}
+
+RollbackSession::TickSlot& RollbackSession::openSlot(uint32_t atTick) {
+    TickSlot& opened = slot(atTick);
+    if (opened.tick != atTick) {
+        opened.tick = atTick;
+        opened.hash = 0;
+        std::fill(std::begin(opened.used), std::end(opened.used), PlayerInput(0));
+        std::fill(std::begin(opened.known), std::end(opened.known), false);
+    }
+    return opened;
+}
+
+bool RollbackSession::submitInput(int player, uint32_t atTick, PlayerInput input) {
+    if (player < 0 || player >= playerCount()) return false;
+    if (atTick + maxRollback < tick) { // Its snapshot (or the one before, for prediction) is gone
+        ++stats.droppedInputs;
+        return false;
+    }
+    // Further ahead it would take the slot of a tick that can still be rolled back to
+    if (atTick >= tick + ring.size() - maxRollback - 1) return false;
+
+    if (atTick >= tick) {
+        TickSlot& future = openSlot(atTick);
+        future.used[player] = input;
+        future.known[player] = true;
+        return true;
+    }
+
+    TickSlot& past = slot(atTick);
+    ++stats.lateInputs;
+    if (past.known[player]) return true; // Duplicate
+    past.known[player] = true;
+    if (past.used[player] != input) {
+        ++stats.mispredictions;
+        past.used[player] = input;
+        rollbackFrom = std::min(rollbackFrom, atTick);
+    }
+    updateConfirmed();
+    return true;
+}
+
+void RollbackSession::simulate(uint32_t atTick, bool checkHash) {
+    TickSlot& current = openSlot(atTick);
+    saveSnapshot(characters, scene, current.state);
+    uint64_t hash = hashSnapshot(current.state);
+    if (checkHash && hash != current.hash) ++stats.desyncs;
+    current.hash = hash;
+
+    // Unknown inputs repeat what the player used on the previous tick
+    const TickSlot* previous = atTick > 0 && slot(atTick - 1).tick == atTick - 1 ? &slot(atTick - 1) : nullptr;
+    for (int player = 0; player < playerCount(); ++player) {
+        if (!current.known[player]) current.used[player] = previous ? previous->used[player] : 0;
+        applyPlayerInput(characters[controlled[player]], current.used[player], deltaTime);
+    }
+    updateWorld(characters, controlled.data(), controlled.size(), deltaTime);
+}
+
+void RollbackSession::rollback(uint32_t fromTick, bool checkHashes) {
+    auto start = std::chrono::steady_clock::now();
+    loadSnapshot(slot(fromTick).state, characters, scene);
+    // The restored tick must hash the same as when it was saved, whatever the inputs
+    for (uint32_t atTick = fromTick; atTick < tick; ++atTick) simulate(atTick, checkHashes || atTick == fromTick);
+
+    double ms = millisecondsSince(start);
+    ++stats.rollbacks;
+    stats.resimulatedTicks += tick - fromTick;
+    stats.maxRollbackTicks = std::max<size_t>(stats.maxRollbackTicks, tick - fromTick);
+    stats.rollbackMs += ms;
+    stats.maxRollbackMs = std::max(stats.maxRollbackMs, ms);
+}
+
+void RollbackSession::synchronize() {
+    if (rollbackFrom < tick) rollback(rollbackFrom, false);
+    rollbackFrom = UINT32_MAX;
+}
+
+void RollbackSession::advance() {
+    if (rollbackFrom < tick) {
+        synchronize();
+    } else if (syncTest && tick > 0) {
+        rollback(tick - std::min(maxRollback, tick), true); // Same inputs: every hash must come back the same
+    }
+    simulate(tick, false);
+    ++tick;
+    ++stats.ticks;
+    updateConfirmed();
+}
+
+void RollbackSession::updateConfirmed() {
+    while (confirmed < tick) {
+        const TickSlot& oldest = slot(confirmed);
+        bool allKnown = true;
+        for (int player = 0; player < playerCount(); ++player) allKnown = allKnown && oldest.known[player];
+        if (!allKnown && confirmed + maxRollback >= tick) break; // Its input can still arrive
+        ++confirmed;
+    }
+}
+
+bool RollbackSession::stateHash(uint32_t atTick, uint64_t& hash) const {
+    if (atTick >= tick || slot(atTick).tick != atTick) return false;
+    hash = slot(atTick).hash;
+    return true;
+}
+
+uint64_t RollbackSession::currentStateHash() {
+    saveSnapshot(characters, scene, scratch);
+    return hashSnapshot(scratch);
+}
+
+// FNV-1a over 64-bit words (the blob is padded to 4 bytes; a trailing half word is hashed alone)
+uint64_t hashSnapshot(const std::vector<uint8_t>& snapshot) {
+    const uint64_t FNV_PRIME = 0x100000001B3ull;
+    uint64_t hash = 0xCBF29CE484222325ull;
+    size_t i = 0;
+    for (; i + 8 <= snapshot.size(); i += 8) {
+        uint64_t word;
+        std::memcpy(&word, snapshot.data() + i, sizeof(word));
+        hash = (hash ^ word) * FNV_PRIME;
+    }
+    for (; i < snapshot.size(); ++i) hash = (hash ^ snapshot[i]) * FNV_PRIME;
+    return hash;
+}
+
+PlayerInput scriptedPlayerInput(uint32_t seed, int player, uint32_t tick) {
+    uint32_t block = (tick + static_cast<uint32_t>(player) * 7u) / 16u;
+    uint32_t bits = mixBits(seed ^ mixBits(static_cast<uint32_t>(player) * 0x9E3779B9u + block));
+    PlayerInput input = 0;
+    if (bits & 1u) input |= INPUT_FORWARD;
+    else if ((bits & 6u) == 0) input |= INPUT_BACKWARD;
+    if (((bits >> 3) & 3u) == 1u) input |= INPUT_LEFT;
+    if (((bits >> 3) & 3u) == 2u) input |= INPUT_RIGHT;
+    if (((bits >> 5) & 7u) == 0) input |= INPUT_JUMP;
+    if (((bits >> 8) & 7u) == 0) input |= INPUT_ATTACK;
+    if (((bits >> 11) & 7u) == 0) input |= INPUT_STRETCH;
+    if (((bits >> 14) & 15u) == 0) input |= INPUT_GROW;
+    if (((bits >> 18) & 7u) == 0) input |= INPUT_HEAD_UP;
+    return input;
+}
+
+RollbackOptions parseRollbackOptions(int argc, char** argv) {
+    RollbackOptions options;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--rollback-sync") == 0) {
+            options.syncTest = true;
+        } else if (std::strcmp(argv[i], "--rollback") == 0) {
+            options.enabled = true;
+            // Optional "players,delay,maxTicks"
+            if (i + 1 < argc && argv[i + 1][0] != '-') {
+                const char* value = argv[++i];
+                options.players = std::atoi(value);
+                if (const char* comma = std::strchr(value, ',')) {
+                    options.delay = std::atoi(comma + 1);
+                    if (const char* second = std::strchr(comma + 1, ',')) options.maxTicks = std::atoi(second + 1);
+                }
+            }
+        }
+    }
+    options.players = std::clamp(options.players, 1, RollbackSession::MAX_PLAYERS);
+    options.maxTicks = std::max(1, options.maxTicks);
+    options.delay = std::clamp(options.delay, 0, options.maxTicks); // Later than maxTicks could never be applied
+    return options;
+}
+
+bool runRollbackTest(const RollbackOptions& options, std::vector<Character*>& characters, int frames, float deltaTime, uint32_t seed) {
+    int players = std::min(options.players, (int)characters.size());
+    std::vector<uint8_t> start;
+    SnapshotScene scene;
+    scene.activeCharacterIndex = 0;
+    saveSnapshot(characters, scene, start);
+
+    // Remote inputs reach the session 0..delay ticks after their tick, in no particular order
+    auto arrival = [&](int player, uint32_t tick) {
+        return tick + mixBits(seed * 31u + static_cast<uint32_t>(player) * 0x85EBCA6Bu + tick) % static_cast<uint32_t>(options.delay + 1);
+    };
+    RollbackSession session(characters, deltaTime, options.maxTicks);
+    session.syncTest = options.syncTest;
+    for (int player = 0; player < players; ++player) session.addPlayer(player);
+
+    std::vector<uint64_t> hashes; // Final hash of the state at the start of every tick, then the end state
+    hashes.reserve(frames + 1);
+    auto recordConfirmed = [&]() {
+        uint64_t hash = 0;
+        while (hashes.size() < session.confirmedTick() && session.stateHash(static_cast<uint32_t>(hashes.size()), hash)) {
+            hashes.push_back(hash);
+        }
+    };
+    auto deliver = [&](uint32_t now) {
+        for (int player = 1; player < players; ++player) {
+            for (uint32_t tick = now > (uint32_t)options.delay ? now - options.delay : 0; tick <= now && tick < (uint32_t)frames; ++tick) {
+                if (arrival(player, tick) == now) session.submitInput(player, tick, scriptedPlayerInput(seed, player, tick));
+            }
+        }
+    };
+
+    auto rollbackStart = std::chrono::steady_clock::now();
+    for (uint32_t tick = 0; tick < (uint32_t)frames; ++tick) {
+        session.submitInput(0, tick, scriptedPlayerInput(seed, 0, tick));
+        deliver(tick);
+        session.advance();
+        recordConfirmed();
+    }
+    for (uint32_t now = frames; now < (uint32_t)(frames + options.delay); ++now) deliver(now);
+    session.synchronize();
+    recordConfirmed();
+    hashes.push_back(session.currentStateHash());
+    double rollbackRunMs = millisecondsSince(rollbackStart);
+
+    // Reference: same start, every input on time, no session
+    loadSnapshot(start, characters, scene);
+    std::vector<int> controlled;
+    for (int player = 0; player < players; ++player) controlled.push_back(player);
+    std::vector<uint8_t> state;
+    size_t mismatches = 0;
+    long long firstMismatch = -1;
+    auto compare = [&](size_t tick) {
+        saveSnapshot(characters, scene, state);
+        if (tick < hashes.size() && hashSnapshot(state) == hashes[tick]) return;
+        if (firstMismatch < 0) firstMismatch = static_cast<long long>(tick);
+        ++mismatches;
+    };
+    auto referenceStart = std::chrono::steady_clock::now();
+    for (uint32_t tick = 0; tick < (uint32_t)frames; ++tick) {
+        compare(tick);
+        for (int player = 0; player < players; ++player) {
+            applyPlayerInput(characters[player], scriptedPlayerInput(seed, player, tick), deltaTime);
+        }
+        updateWorld(characters, controlled.data(), controlled.size(), deltaTime);
+    }
+    compare(frames);
+    double referenceRunMs = millisecondsSince(referenceStart);
+
+    const RollbackSession::Stats& stats = session.getStats();
+    std::printf("AdventureTime rollback: %d players, inputs up to %d ticks late, max rollback %d ticks, %d ticks\n",
+                players, options.delay, options.maxTicks, frames);
+    std::printf("inputs: %zu late, %zu mispredicted, %zu dropped\n", stats.lateInputs, stats.mispredictions, stats.droppedInputs);
+    std::printf("rollbacks: %zu, %zu ticks re-simulated (max %zu in one frame), %.3f ms avg, %.3f ms max per rollback\n",
+                stats.rollbacks, stats.resimulatedTicks, stats.maxRollbackTicks,
+                stats.rollbacks ? stats.rollbackMs / stats.rollbacks : 0.0, stats.maxRollbackMs);
+    std::printf("frame cost: %.3f ms/tick with rollback, %.3f ms/tick without\n",
+                rollbackRunMs / std::max(1, frames), referenceRunMs / std::max(1, frames));
+    if (options.syncTest) std::printf("sync test: %zu hash mismatches\n", stats.desyncs);
+    if (mismatches == 0) {
+        std::printf("state hashes: %d ticks match the on-time run\n", frames + 1);
+    } else {
+        std::printf("state hashes: %zu of %d ticks differ from the on-time run, first at tick %lld\n",
+                    mismatches, frames + 1, firstMismatch);
+    }
+    std::fflush(stdout);
+    return mismatches == 0 && stats.desyncs == 0;
+}
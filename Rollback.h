@@ -0,0 +1,118 @@
+#ifndef ROLLBACK_H
+#define ROLLBACK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "AdventureCharacters.h"
+#include "Snapshot.h"
+
+// Rollback for several players, each driving one character with its own input stream.
+// The session keeps a ring of per-tick snapshots (Snapshot.h, state at the start of the tick)
+// and the input every player used on that tick. A missing input is predicted by repeating the
+// player's input of the previous tick; when the real one arrives late and differs, the next
+// advance() restores the snapshot of that tick and re-simulates up to the present in the same
+// frame. Inputs older than maxRollbackTicks can no longer be applied and are dropped.
+//
+// Every tick also records a 64-bit hash of its snapshot. A tick is confirmed once every player's
+// input up to it is known, and from then on its hash must not change: comparing confirmed hashes
+// with a run that had every input on time checks determinism. With syncTest the session also
+// rolls back maxRollbackTicks every tick without any input change and counts hash mismatches.
+class RollbackSession {
+public:
+    static const int MAX_PLAYERS = 8;
+
+    // 'characters' must keep the same types in the same order for the whole session
+    RollbackSession(std::vector<Character*>& characters, float deltaTime, int maxRollbackTicks, float coneScaleFactor = 1.5f);
+
+    // Player 'index' controls characters[characterIndex]; add every player before the first tick
+    int addPlayer(int characterIndex);
+    int playerCount() const { return static_cast<int>(controlled.size()); }
+
+    // Input of 'player' for 'tick', early, on time (tick == currentTick()) or late.
+    // Returns false when it is too old to roll back to or too far ahead to be stored.
+    bool submitInput(int player, uint32_t tick, PlayerInput input);
+
+    // Rolls back if a late input changed the past, then simulates currentTick()
+    void advance();
+    // Only the pending rollback: afterwards every submitted input is part of the state
+    void synchronize();
+
+    uint32_t currentTick() const { return tick; }
+    // The state at the start of this tick and of every earlier one is final: every input before
+    // it is known (or too old to change) and no rollback is pending
+    uint32_t confirmedTick() const { return confirmed < rollbackFrom ? confirmed : rollbackFrom; }
+    // Hash of the state at the start of 'atTick', while that tick is still in the ring
+    bool stateHash(uint32_t atTick, uint64_t& hash) const;
+    uint64_t currentStateHash(); // State now, at the start of currentTick()
+
+    bool syncTest = false;
+
+    struct Stats {
+        size_t ticks = 0;             // advance() calls
+        size_t lateInputs = 0;        // Arrived after their tick was simulated
+        size_t mispredictions = 0;    // ...with a different value than the prediction
+        size_t droppedInputs = 0;
+        size_t rollbacks = 0;
+        size_t resimulatedTicks = 0;
+        size_t maxRollbackTicks = 0;  // Longest single rewind
+        size_t desyncs = 0;           // Sync test hash mismatches
+        double rollbackMs = 0.0;      // Restore + re-simulation, total
+        double maxRollbackMs = 0.0;   // ...and the worst frame
+    };
+    const Stats& getStats() const { return stats; }
+
+private:
+    struct TickSlot {
+        uint32_t tick = UINT32_MAX;
+        std::vector<uint8_t> state; // Snapshot at the start of the tick (capacity reused)
+        uint64_t hash = 0;
+        PlayerInput used[MAX_PLAYERS] = {}; // What the simulation applied (confirmed or predicted)
+        bool known[MAX_PLAYERS] = {};
+    };
+
+    TickSlot& slot(uint32_t atTick) { return ring[atTick % ring.size()]; }
+    const TickSlot& slot(uint32_t atTick) const { return ring[atTick % ring.size()]; }
+    TickSlot& openSlot(uint32_t atTick); // Resets the slot when it still holds an older tick
+    void simulate(uint32_t atTick, bool checkHash);
+    void rollback(uint32_t fromTick, bool checkHashes);
+    void updateConfirmed();
+
+    std::vector<Character*>& characters;
+    std::vector<int> controlled; // Character index per player
+    std::vector<TickSlot> ring;  // maxRollbackTicks + 1 past ticks, the same again for early inputs
+    std::vector<uint8_t> scratch; // currentStateHash
+    SnapshotScene scene;
+    float deltaTime;
+    uint32_t maxRollback;
+    uint32_t tick = 0;
+    uint32_t confirmed = 0;
+    uint32_t rollbackFrom = UINT32_MAX; // Oldest tick with a misprediction
+    Stats stats;
+};
+
+uint64_t hashSnapshot(const std::vector<uint8_t>& snapshot);
+
+// Deterministic stand-in for a player's controller: holds a random mix of actions for 16 ticks
+// (offset per player), so prediction by repetition is right most of the time
+PlayerInput scriptedPlayerInput(uint32_t seed, int player, uint32_t tick);
+
+// --rollback players[,delay[,maxTicks]]   headless rollback test: 'players' characters (from Finn)
+//     each driven by a scripted input stream; player 0 is local, the others' inputs arrive
+//     0..delay ticks late (default 4) and up to maxTicks (default 8) ticks are re-simulated
+// --rollback-sync                         also roll back maxTicks every tick as a sync test
+struct RollbackOptions {
+    bool enabled = false;
+    int players = 2;
+    int delay = 4;
+    int maxTicks = 8;
+    bool syncTest = false;
+};
+
+RollbackOptions parseRollbackOptions(int argc, char** argv);
+
+// Runs 'frames' ticks through a RollbackSession, then again from the same start with every
+// input on time, and compares the per-tick hashes. Prints a report; returns false on a desync.
+bool runRollbackTest(const RollbackOptions& options, std::vector<Character*>& characters, int frames, float deltaTime, uint32_t seed);
+
+#endif // ROLLBACK_H
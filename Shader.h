@@ -21,13 +21,13 @@ public:
     // Ativa o shader
     void use();
 
-    // Funções utilitárias para uniforms
-    void setBool(const std::string &name, bool value) const;
-    void setInt(const std::string &name, int value) const;
-    void setFloat(const std::string &name, float value) const;
-    void setVec3(const std::string &name, const glm::vec3 &value) const;
-    void setVec3(const std::string &name, float x, float y, float z) const;
-    void setMat4(const std::string &name, const glm::mat4 &mat) const;
+    // Funções utilitárias para uniforms (const char*: literais não constroem std::string a cada chamada)
+    void setBool(const char* name, bool value) const;
+    void setInt(const char* name, int value) const;
+    void setFloat(const char* name, float value) const;
+    void setVec3(const char* name, const glm::vec3 &value) const;
+    void setVec3(const char* name, float x, float y, float z) const;
+    void setMat4(const char* name, const glm::mat4 &mat) const;
 
 private:
     // Função utilitária para checar erros de compilação/linkagem
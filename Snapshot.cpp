@@ -0,0 +1,418 @@
+#include "Snapshot.h"
+#include "Formation.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <type_traits>
+#include <utility>
+
+namespace {
+const uint32_t SNAPSHOT_MAGIC = 0x4E535441; // "ATSN"
+const uint32_t DELTA_MAGIC = 0x44535441;    // "ATSD"
+const size_t RNG_BYTES = (sizeof(std::mt19937) + 3) / 4 * 4; // Padded so the records stay 4-byte aligned
+
+static_assert(std::is_trivially_copyable<std::mt19937>::value, "the RNG state is stored with memcpy");
+
+struct SnapshotHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t headerBytes;  // Sizes of this build's structs: a blob from another layout is rejected
+    uint32_t rngBytes;
+    uint32_t recordBytes;
+    uint32_t groupRecordBytes;
+    uint32_t characterCount;
+    uint32_t groupCount;
+    float simulationTime;
+    uint32_t simulationTick;
+    float coneScaleFactor;
+    int32_t activeCharacterIndex;
+    int32_t partyGroup; // Index into the group records, -1 if none
+};
+
+enum CharacterFlags : uint32_t {
+    FLAG_JUMPING = 1u << 0,
+    FLAG_MOVING = 1u << 1,
+    FLAG_NPC = 1u << 2,
+    FLAG_CONTROLLED = 1u << 3,
+    FLAG_ATTACKING = 1u << 4, // Finn
+};
+
+struct CharacterRecord {
+    uint32_t type;
+    uint32_t flags;
+    glm::vec3 position;
+    float rotation;
+    float headInclination;
+    float speed;
+    float verticalSpeed;
+    float gravity;
+    float groundHeight;
+    float initialJumpSpeed;
+    float legSwingAngle;
+    float armSwingAngle;
+    glm::vec3 targetPosition;
+    float timeSinceLastDecision;
+    float decisionInterval;
+    float lodPendingTime;
+    uint32_t lodTier;
+    glm::vec3 velocity;
+    glm::vec3 flockSteering;
+    int32_t formationGroup; // Index into the group records, -1 if none
+    uint32_t formationSlot;
+    float attackStartTime;  // Finn
+    float legStretch;       // Jake
+    float sizeMultiplier;   // Jake
+};
+
+struct GroupRecord {
+    int32_t leader; // Index into the character records, -1 if the leader was not in the list
+    uint32_t shape;
+    float spacing;
+    float speedMultiplier;
+    uint32_t followerCount;
+};
+
+static_assert(std::is_trivially_copyable<CharacterRecord>::value && sizeof(CharacterRecord) % 4 == 0, "flat record");
+static_assert(std::is_trivially_copyable<GroupRecord>::value && sizeof(GroupRecord) % 4 == 0, "flat record");
+static_assert(sizeof(SnapshotHeader) % 4 == 0, "flat header");
+
+// Scratch reused between calls (saving and loading are not reentrant)
+struct GroupScratch {
+    std::vector<int> ids;                // Formation id of each group record, in record order
+    std::vector<const Character*> leaders;
+    std::vector<std::pair<const Character*, size_t>> byLeader;
+    std::vector<int32_t> leaderIndex;
+    std::vector<size_t> followerStart;   // Prefix sums of followerCount
+    std::vector<Character*> followers;   // By group, then slot
+};
+GroupScratch scratch;
+
+// Group record index of a formation id (forEachGroup lists groups by slot, so the low index bits are sorted)
+int32_t groupIndex(int id) {
+    if (id < 0) return -1;
+    auto found = std::lower_bound(scratch.ids.begin(), scratch.ids.end(), id,
+                                  [](int a, int b) { return (a & 0xFFFF) < (b & 0xFFFF); });
+    return found != scratch.ids.end() && *found == id ? static_cast<int32_t>(found - scratch.ids.begin()) : -1;
+}
+
+void putVarint(std::vector<uint8_t>& out, uint32_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+bool getVarint(const uint8_t*& in, const uint8_t* end, uint32_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        if (in == end) return false;
+        uint8_t byte = *in++;
+        value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+uint32_t word(const std::vector<uint8_t>& bytes, size_t index) {
+    uint32_t value;
+    std::memcpy(&value, bytes.data() + index * 4, 4);
+    return value;
+}
+}
+
+void saveSnapshot(const std::vector<Character*>& characters, const SnapshotScene& scene, std::vector<uint8_t>& snapshot) {
+    // Groups: formation ids and leaders, in forEachGroup order
+    scratch.ids.clear();
+    scratch.leaders.clear();
+    formations.forEachGroup([](int id, Character* leader, FormationShape, float, float) {
+        scratch.ids.push_back(id);
+        scratch.leaders.push_back(leader);
+    });
+    size_t groupCount = scratch.ids.size();
+    // Leader pointers sorted once, then one binary search per character
+    scratch.leaderIndex.assign(groupCount, -1);
+    scratch.byLeader.clear();
+    for (size_t g = 0; g < groupCount; ++g) scratch.byLeader.emplace_back(scratch.leaders[g], g);
+    std::sort(scratch.byLeader.begin(), scratch.byLeader.end());
+    for (size_t i = 0; i < characters.size() && groupCount > 0; ++i) {
+        auto found = std::lower_bound(scratch.byLeader.begin(), scratch.byLeader.end(), std::make_pair(static_cast<const Character*>(characters[i]), size_t(0)));
+        for (; found != scratch.byLeader.end() && found->first == characters[i]; ++found) scratch.leaderIndex[found->second] = static_cast<int32_t>(i);
+    }
+
+    size_t bytes = sizeof(SnapshotHeader) + RNG_BYTES + characters.size() * sizeof(CharacterRecord) + groupCount * sizeof(GroupRecord);
+    snapshot.resize(bytes);
+    uint8_t* out = snapshot.data();
+
+    SnapshotHeader header = {};
+    header.magic = SNAPSHOT_MAGIC;
+    header.version = SNAPSHOT_VERSION;
+    header.headerBytes = sizeof(SnapshotHeader);
+    header.rngBytes = static_cast<uint32_t>(RNG_BYTES);
+    header.recordBytes = sizeof(CharacterRecord);
+    header.groupRecordBytes = sizeof(GroupRecord);
+    header.characterCount = static_cast<uint32_t>(characters.size());
+    header.groupCount = static_cast<uint32_t>(groupCount);
+    header.simulationTime = simulationTime;
+    header.simulationTick = simulationTick;
+    header.coneScaleFactor = scene.coneScaleFactor;
+    header.activeCharacterIndex = scene.activeCharacterIndex;
+    header.partyGroup = formations.isActive(partyGroup) ? groupIndex(partyGroup) : -1;
+    std::memcpy(out, &header, sizeof(header));
+    out += sizeof(header);
+
+    std::memset(out, 0, RNG_BYTES);
+    std::memcpy(out, &gen, sizeof(gen));
+    out += RNG_BYTES;
+
+    for (const Character* character : characters) {
+        CharacterRecord record;
+        CharacterType type = characterType(character);
+        record.type = static_cast<uint32_t>(type);
+        record.flags = (character->isJumping ? FLAG_JUMPING : 0u) | (character->moving ? FLAG_MOVING : 0u) |
+                       (character->isNPC ? FLAG_NPC : 0u) | (character->isUnderPlayerControl ? FLAG_CONTROLLED : 0u);
+        record.position = character->position;
+        record.rotation = character->rotation;
+        record.headInclination = character->headInclination;
+        record.speed = character->speed;
+        record.verticalSpeed = character->currentVerticalSpeed;
+        record.gravity = character->gravity;
+        record.groundHeight = character->groundHeight;
+        record.initialJumpSpeed = character->initialJumpSpeed;
+        record.legSwingAngle = character->legSwingAngle;
+        record.armSwingAngle = character->armSwingAngle;
+        record.targetPosition = character->targetPosition;
+        record.timeSinceLastDecision = character->timeSinceLastDecision;
+        record.decisionInterval = character->decisionInterval;
+        record.lodPendingTime = character->lodPendingTime;
+        record.lodTier = character->lodTier;
+        record.velocity = character->velocity;
+        record.flockSteering = character->flockSteering;
+        record.formationGroup = groupIndex(character->formationGroup);
+        record.formationSlot = character->formationSlot;
+        record.attackStartTime = 0.0f;
+        record.legStretch = 1.0f;
+        record.sizeMultiplier = 1.0f;
+        if (type == CHARACTER_FINN) {
+            const Finn* finn = static_cast<const Finn*>(character);
+            if (finn->isAttacking) record.flags |= FLAG_ATTACKING;
+            record.attackStartTime = finn->attackStartTime;
+        } else if (type == CHARACTER_JAKE) {
+            const Jake* jake = static_cast<const Jake*>(character);
+            record.legStretch = jake->legStretch;
+            record.sizeMultiplier = jake->sizeMultiplier;
+        }
+        std::memcpy(out, &record, sizeof(record));
+        out += sizeof(record);
+    }
+
+    size_t group = 0;
+    formations.forEachGroup([&](int id, Character*, FormationShape shape, float spacing, float speedMultiplier) {
+        GroupRecord record;
+        record.leader = scratch.leaderIndex[group];
+        record.shape = static_cast<uint32_t>(shape);
+        record.spacing = spacing;
+        record.speedMultiplier = speedMultiplier;
+        record.followerCount = static_cast<uint32_t>(formations.followerCount(id));
+        std::memcpy(out + group * sizeof(record), &record, sizeof(record));
+        ++group;
+    });
+}
+
+bool loadSnapshot(const std::vector<uint8_t>& snapshot, std::vector<Character*>& characters, SnapshotScene& scene) {
+    SnapshotHeader header;
+    if (snapshot.size() < sizeof(header)) return false;
+    std::memcpy(&header, snapshot.data(), sizeof(header));
+    if (header.magic != SNAPSHOT_MAGIC || header.version != SNAPSHOT_VERSION || header.headerBytes != sizeof(SnapshotHeader) ||
+        header.rngBytes != RNG_BYTES || header.recordBytes != sizeof(CharacterRecord) || header.groupRecordBytes != sizeof(GroupRecord)) {
+        return false;
+    }
+    size_t recordsOffset = sizeof(SnapshotHeader) + RNG_BYTES;
+    size_t groupsOffset = recordsOffset + static_cast<size_t>(header.characterCount) * sizeof(CharacterRecord);
+    if (snapshot.size() != groupsOffset + static_cast<size_t>(header.groupCount) * sizeof(GroupRecord)) return false;
+    const uint8_t* records = snapshot.data() + recordsOffset;
+    const uint8_t* groups = snapshot.data() + groupsOffset;
+
+    // Validate the references before touching the scene
+    scratch.followerStart.assign(header.groupCount + 1, 0);
+    for (uint32_t g = 0; g < header.groupCount; ++g) {
+        GroupRecord group;
+        std::memcpy(&group, groups + g * sizeof(GroupRecord), sizeof(group));
+        if (group.leader < -1 || group.leader >= static_cast<int32_t>(header.characterCount) ||
+            group.shape > static_cast<uint32_t>(FormationShape::Ring)) {
+            return false;
+        }
+        // Each character follows at most one group: the counts come from the file, so bound them
+        // before they size anything
+        if (group.followerCount > header.characterCount) return false;
+        scratch.followerStart[g + 1] = scratch.followerStart[g] + group.followerCount;
+        if (scratch.followerStart[g + 1] > header.characterCount) return false;
+    }
+    bool sameTypes = characters.size() == header.characterCount;
+    for (uint32_t i = 0; i < header.characterCount; ++i) {
+        CharacterRecord record;
+        std::memcpy(&record, records + i * sizeof(CharacterRecord), sizeof(record));
+        if (record.type >= CHARACTER_TYPE_COUNT) return false;
+        if (record.formationGroup >= 0 && (static_cast<uint32_t>(record.formationGroup) >= header.groupCount ||
+            record.formationSlot >= scratch.followerStart[record.formationGroup + 1] - scratch.followerStart[record.formationGroup])) {
+            return false;
+        }
+        if (sameTypes && characterType(characters[i]) != static_cast<CharacterType>(record.type)) sameTypes = false;
+    }
+
+    // Same characters (restart, rollback): overwrite in place. Otherwise respawn the list.
+    if (!sameTypes) {
+        despawnCharacters(characters);
+        characters.reserve(header.characterCount);
+        for (uint32_t i = 0; i < header.characterCount; ++i) {
+            CharacterRecord record;
+            std::memcpy(&record, records + i * sizeof(CharacterRecord), sizeof(record));
+            characters.push_back(characterPools.spawn(static_cast<CharacterType>(record.type), record.position));
+        }
+    }
+    formations.clear();
+    npcScheduler.clear();
+
+    scratch.followers.assign(scratch.followerStart[header.groupCount], nullptr);
+    for (uint32_t i = 0; i < header.characterCount; ++i) {
+        CharacterRecord record;
+        std::memcpy(&record, records + i * sizeof(CharacterRecord), sizeof(record));
+        Character* character = characters[i];
+        character->position = record.position;
+        character->rotation = record.rotation;
+        character->headInclination = record.headInclination;
+        character->speed = record.speed;
+        character->isJumping = (record.flags & FLAG_JUMPING) != 0;
+        character->currentVerticalSpeed = record.verticalSpeed;
+        character->gravity = record.gravity;
+        character->groundHeight = record.groundHeight;
+        character->initialJumpSpeed = record.initialJumpSpeed;
+        character->legSwingAngle = record.legSwingAngle;
+        character->armSwingAngle = record.armSwingAngle;
+        character->moving = (record.flags & FLAG_MOVING) != 0;
+        character->targetPosition = record.targetPosition;
+        character->timeSinceLastDecision = record.timeSinceLastDecision;
+        character->decisionInterval = record.decisionInterval;
+        character->isNPC = (record.flags & FLAG_NPC) != 0;
+        character->isUnderPlayerControl = (record.flags & FLAG_CONTROLLED) != 0;
+        character->lodPendingTime = record.lodPendingTime;
+        character->lodTier = static_cast<uint8_t>(record.lodTier);
+        character->velocity = record.velocity;
+        character->flockSteering = record.flockSteering;
+        character->formationGroup = -1; // Set again by formations.join below
+        character->formationSlot = 0;
+        if (record.type == CHARACTER_FINN) {
+            Finn* finn = static_cast<Finn*>(character);
+            finn->isAttacking = (record.flags & FLAG_ATTACKING) != 0;
+            finn->attackStartTime = record.attackStartTime;
+        } else if (record.type == CHARACTER_JAKE) {
+            Jake* jake = static_cast<Jake*>(character);
+            jake->legStretch = record.legStretch;
+            jake->sizeMultiplier = record.sizeMultiplier;
+        }
+        if (record.formationGroup >= 0) scratch.followers[scratch.followerStart[record.formationGroup] + record.formationSlot] = character;
+        if (character->isNPC) {
+            character->decisionDue = true;
+            npcScheduler.scheduleNow(character);
+        }
+    }
+
+    partyGroup = -1;
+    for (uint32_t g = 0; g < header.groupCount; ++g) {
+        GroupRecord record;
+        std::memcpy(&record, groups + g * sizeof(GroupRecord), sizeof(record));
+        if (record.leader < 0) continue; // Its followers stay free
+        int id = formations.createGroup(characters[record.leader], static_cast<FormationShape>(record.shape), record.spacing, record.speedMultiplier);
+        if (static_cast<int32_t>(g) == header.partyGroup) partyGroup = id;
+        // Joining in slot order gives every follower its old slot back
+        for (uint32_t f = scratch.followerStart[g]; f < scratch.followerStart[g + 1]; ++f) {
+            if (scratch.followers[f]) formations.join(id, scratch.followers[f]);
+        }
+    }
+
+    simulationTime = header.simulationTime;
+    simulationTick = header.simulationTick;
+    std::memcpy(&gen, snapshot.data() + sizeof(SnapshotHeader), sizeof(gen));
+    scene.activeCharacterIndex = header.activeCharacterIndex;
+    scene.coneScaleFactor = header.coneScaleFactor;
+    return true;
+}
+
+// Delta layout: magic, version, base bytes, snapshot bytes (uint32 each), then until every word
+// of the snapshot is covered: varint words kept from the base, varint words stored, the stored words.
+void encodeSnapshotDelta(const std::vector<uint8_t>& base, const std::vector<uint8_t>& snapshot, std::vector<uint8_t>& delta) {
+    uint32_t header[4] = { DELTA_MAGIC, SNAPSHOT_VERSION, static_cast<uint32_t>(base.size()), static_cast<uint32_t>(snapshot.size()) };
+    delta.resize(sizeof(header));
+    std::memcpy(delta.data(), header, sizeof(header));
+
+    size_t words = snapshot.size() / 4;
+    size_t baseWords = base.size() / 4;
+    size_t i = 0;
+    while (i < words) {
+        size_t kept = i;
+        while (i < words && i < baseWords && word(snapshot, i) == word(base, i)) ++i;
+        size_t stored = i;
+        // Store until two words in a row match again (a lone match costs more to skip than to store)
+        while (i < words && !(i + 1 < words && i + 1 < baseWords && word(snapshot, i) == word(base, i) && word(snapshot, i + 1) == word(base, i + 1))) ++i;
+        putVarint(delta, static_cast<uint32_t>(stored - kept));
+        putVarint(delta, static_cast<uint32_t>(i - stored));
+        delta.insert(delta.end(), snapshot.begin() + stored * 4, snapshot.begin() + i * 4);
+    }
+}
+
+bool decodeSnapshotDelta(const std::vector<uint8_t>& base, const std::vector<uint8_t>& delta, std::vector<uint8_t>& snapshot) {
+    uint32_t header[4];
+    if (delta.size() < sizeof(header)) return false;
+    std::memcpy(header, delta.data(), sizeof(header));
+    if (header[0] != DELTA_MAGIC || header[1] != SNAPSHOT_VERSION || header[2] != base.size() || header[3] % 4 != 0) return false;
+
+    size_t words = header[3] / 4;
+    size_t baseWords = base.size() / 4;
+    snapshot.resize(header[3]);
+    const uint8_t* in = delta.data() + sizeof(header);
+    const uint8_t* end = delta.data() + delta.size();
+    size_t i = 0;
+    while (i < words) {
+        uint32_t kept, stored;
+        if (!getVarint(in, end, kept) || !getVarint(in, end, stored)) return false;
+        if (kept > words - i || i + kept > baseWords || stored > words - i - kept || static_cast<size_t>(end - in) < stored * 4u) return false;
+        std::memcpy(snapshot.data() + i * 4, base.data() + i * 4, kept * 4u);
+        i += kept;
+        std::memcpy(snapshot.data() + i * 4, in, stored * 4u);
+        in += stored * 4u;
+        i += stored;
+        if (kept == 0 && stored == 0) return false;
+    }
+    return in == end;
+}
+
+bool writeSnapshotFile(const std::string& path, const std::vector<uint8_t>& bytes) {
+    std::ofstream file(path, std::ios::binary);
+    file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    return static_cast<bool>(file);
+}
+
+bool readSnapshotFile(const std::string& path, std::vector<uint8_t>& bytes) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) return false;
+    bytes.resize(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    file.read(reinterpret_cast<char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    return static_cast<bool>(file);
+}
+
+SnapshotOptions parseSnapshotOptions(int argc, char** argv) {
+    SnapshotOptions options;
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (std::strcmp(argv[i], "--snapshot-load") == 0) {
+            options.loadPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--snapshot-save") == 0) {
+            std::string value = argv[++i];
+            size_t comma = value.find(',');
+            options.savePath = value.substr(0, comma);
+            if (comma != std::string::npos) options.saveFrame = std::max(0, std::atoi(value.c_str() + comma + 1));
+        }
+    }
+    return options;
+}
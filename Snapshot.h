@@ -0,0 +1,51 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "AdventureCharacters.h"
+
+// Binary snapshots of the Adventure Time simulation: every character, the formation groups,
+// simulationTime/Tick, the RNG state, the active character and the cone scale. The blob is flat
+// and versioned:
+//   SnapshotHeader | std::mt19937 bytes | CharacterRecord[characterCount] | GroupRecord[groupCount]
+// Records are fixed-size structs of 4-byte fields, copied with memcpy; the blob is only
+// meant for the build that wrote it (the header checks the version and the struct sizes).
+// Derived state is rebuilt instead of stored: npcScheduler (every NPC is re-tested on the
+// next tick, which never changes a decision), flow fields and flock steering.
+const uint32_t SNAPSHOT_VERSION = 2; // 2: simulationTick (LOD stagger)
+
+// Everything outside the character list that a snapshot covers
+struct SnapshotScene {
+    int activeCharacterIndex = 0;
+    float coneScaleFactor = 1.5f;
+};
+
+// Replaces 'snapshot' (its capacity is reused, so saving every tick does not allocate)
+void saveSnapshot(const std::vector<Character*>& characters, const SnapshotScene& scene, std::vector<uint8_t>& snapshot);
+// Restores in place when the list already holds the same types in the same order
+// (a restart or rollback); otherwise despawns it and spawns the snapshot's characters.
+// Returns false, changing nothing, when the blob is not a valid snapshot of this version.
+bool loadSnapshot(const std::vector<uint8_t>& snapshot, std::vector<Character*>& characters, SnapshotScene& scene);
+
+// Delta against an earlier snapshot: runs of unchanged 32-bit words are skipped, the others
+// are stored. Decoding needs the same base.
+void encodeSnapshotDelta(const std::vector<uint8_t>& base, const std::vector<uint8_t>& snapshot, std::vector<uint8_t>& delta);
+bool decodeSnapshotDelta(const std::vector<uint8_t>& base, const std::vector<uint8_t>& delta, std::vector<uint8_t>& snapshot);
+
+bool writeSnapshotFile(const std::string& path, const std::vector<uint8_t>& bytes);
+bool readSnapshotFile(const std::string& path, std::vector<uint8_t>& bytes);
+
+// --snapshot-load file       restore the scene from 'file' before the first frame
+// --snapshot-save file[,N]   save the scene to 'file' after frame N (default: on exit)
+struct SnapshotOptions {
+    std::string loadPath;
+    std::string savePath;
+    int saveFrame = -1;
+};
+
+SnapshotOptions parseSnapshotOptions(int argc, char** argv);
+
+#endif // SNAPSHOT_H
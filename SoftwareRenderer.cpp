@@ -0,0 +1,319 @@
+#include "SoftwareRenderer.h"
+#include "Mesh.h"
+#include <algorithm> // Para std::min, std::max, std::swap
+#include <chrono>
+#include <cmath>     // Para floor, ceil
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SOFTWARE_RENDERER_SSE2 1
+#endif
+
+static uint32_t packColor(const glm::vec3& color) {
+    glm::vec3 c = glm::clamp(color, 0.0f, 1.0f) * 255.0f + 0.5f;
+    return static_cast<uint32_t>(c.r)
+         | (static_cast<uint32_t>(c.g) << 8)
+         | (static_cast<uint32_t>(c.b) << 16)
+         | 0xFF000000u;
+}
+
+static double millisecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+SoftwareRenderer::SoftwareRenderer(int width, int height, unsigned threadCount)
+    : width(width),
+      height(height),
+      tilesX((width + TILE_SIZE - 1) / TILE_SIZE),
+      tilesY((height + TILE_SIZE - 1) / TILE_SIZE),
+      paddedWidth(tilesX * TILE_SIZE),
+      paddedHeight(tilesY * TILE_SIZE),
+      // O tamanho é arredondado para tiles inteiros: a rasterização nunca precisa testar bordas do buffer
+      colorBuffer(static_cast<size_t>(paddedWidth) * paddedHeight, 0),
+      depthBuffer(static_cast<size_t>(paddedWidth) * paddedHeight, 1.0f),
+      pool(threadCount),
+      bins(pool.size()),
+      viewProjection(1.0f),
+      clearValue(0xFF000000u) {
+    for (Bin& bin : bins) {
+        bin.tiles.resize(static_cast<size_t>(tilesX) * tilesY);
+    }
+}
+
+void SoftwareRenderer::beginFrame(const glm::mat4& view, const glm::mat4& projection, const glm::vec3& clearColor) {
+    viewProjection = projection * view;
+    clearValue = packColor(clearColor);
+    draws.clear();
+}
+
+void SoftwareRenderer::drawMesh(const Mesh& mesh, const glm::mat4& model, const glm::vec3& color) {
+    if (mesh.positions.empty()) return;
+    draws.push_back({ &mesh, model, packColor(color) });
+}
+
+void SoftwareRenderer::endFrame() {
+    stats = Stats();
+    stats.drawCalls = draws.size();
+
+    // --- Fase 1: geometria e binning (um intervalo contíguo de draws por job) ---
+    auto geometryStart = std::chrono::steady_clock::now();
+    size_t jobCount = bins.size();
+    size_t drawCount = draws.size();
+    pool.parallelFor(jobCount, [&](size_t job, unsigned /*worker*/) {
+        processDraws(job * drawCount / jobCount, (job + 1) * drawCount / jobCount, bins[job]);
+    });
+    stats.geometryMs = millisecondsSince(geometryStart);
+
+    // --- Fase 2: rasterização, um tile por vez em cada thread ---
+    auto rasterStart = std::chrono::steady_clock::now();
+    pool.parallelFor(static_cast<size_t>(tilesX) * tilesY, [&](size_t tile, unsigned /*worker*/) {
+        rasterTile(static_cast<int>(tile));
+    });
+    stats.rasterMs = millisecondsSince(rasterStart);
+
+    for (const Bin& bin : bins) {
+        stats.trianglesSubmitted += bin.submitted;
+        stats.trianglesCulled += bin.culled;
+        stats.trianglesClipped += bin.clipped;
+        stats.tileBins += bin.binned;
+    }
+}
+
+void SoftwareRenderer::processDraws(size_t begin, size_t end, Bin& bin) {
+    bin.triangles.clear();
+    for (std::vector<uint32_t>& tile : bin.tiles) tile.clear();
+    bin.submitted = bin.culled = bin.clipped = bin.binned = 0;
+
+    for (size_t d = begin; d < end; ++d) {
+        const DrawCommand& draw = draws[d];
+        const std::vector<glm::vec3>& positions = draw.mesh->positions;
+        glm::mat4 mvp = viewProjection * draw.model;
+
+        bin.clipPositions.resize(positions.size());
+        for (size_t v = 0; v < positions.size(); ++v) {
+            bin.clipPositions[v] = mvp * glm::vec4(positions[v], 1.0f);
+        }
+
+        for (size_t v = 0; v + 2 < positions.size(); v += 3) {
+            ++bin.submitted;
+            clipAndSetup(bin.clipPositions[v], bin.clipPositions[v + 1], bin.clipPositions[v + 2], draw.color, bin);
+        }
+    }
+}
+
+void SoftwareRenderer::clipAndSetup(const glm::vec4& a, const glm::vec4& b, const glm::vec4& c, uint32_t color, Bin& bin) {
+    // Rejeição trivial: os três vértices fora do mesmo plano do frustum
+    if ((a.x >  a.w && b.x >  b.w && c.x >  c.w) || (a.x < -a.w && b.x < -b.w && c.x < -c.w) ||
+        (a.y >  a.w && b.y >  b.w && c.y >  c.w) || (a.y < -a.w && b.y < -b.w && c.y < -c.w) ||
+        (a.z >  a.w && b.z >  b.w && c.z >  c.w) || (a.z < -a.w && b.z < -b.w && c.z < -c.w)) {
+        ++bin.culled;
+        return;
+    }
+
+    // Plano near do GL: z >= -w. Só ele precisa de recorte; os demais ficam com o bounding box na tela.
+    float da = a.z + a.w, db = b.z + b.w, dc = c.z + c.w;
+    if (da >= 0.0f && db >= 0.0f && dc >= 0.0f) {
+        setupTriangle(a, b, c, color, bin);
+        return;
+    }
+
+    // Sutherland-Hodgman contra um plano: triângulo -> polígono de até 4 vértices
+    ++bin.clipped;
+    const glm::vec4 in[3] = { a, b, c };
+    const float dist[3] = { da, db, dc };
+    glm::vec4 out[4];
+    int outCount = 0;
+    for (int i = 0; i < 3; ++i) {
+        int j = (i + 1) % 3;
+        if (dist[i] >= 0.0f) out[outCount++] = in[i];
+        if ((dist[i] >= 0.0f) != (dist[j] >= 0.0f)) {
+            float t = dist[i] / (dist[i] - dist[j]);
+            out[outCount++] = in[i] + (in[j] - in[i]) * t;
+        }
+    }
+    for (int i = 1; i + 1 < outCount; ++i) {
+        setupTriangle(out[0], out[i], out[i + 1], color, bin);
+    }
+}
+
+void SoftwareRenderer::setupTriangle(const glm::vec4& a, const glm::vec4& b, const glm::vec4& c, uint32_t color, Bin& bin) {
+    // Divisão perspectiva e viewport (origem no canto inferior esquerdo)
+    float x[3], y[3], z[3];
+    const glm::vec4* clip[3] = { &a, &b, &c };
+    for (int i = 0; i < 3; ++i) {
+        float invW = 1.0f / clip[i]->w;
+        x[i] = (clip[i]->x * invW * 0.5f + 0.5f) * width;
+        y[i] = (clip[i]->y * invW * 0.5f + 0.5f) * height;
+        z[i] = clip[i]->z * invW * 0.5f + 0.5f;
+    }
+
+    // Área com sinal: positiva para triângulos anti-horários (frente, GL_CCW)
+    float area2 = (x[1] - x[0]) * (y[2] - y[0]) - (x[2] - x[0]) * (y[1] - y[0]);
+    if (area2 == 0.0f || (cullBackFaces && area2 < 0.0f)) {
+        ++bin.culled;
+        return;
+    }
+    if (area2 < 0.0f) {
+        // Sem culling: inverte a ordem para que as arestas sejam positivas no interior
+        std::swap(x[1], x[2]);
+        std::swap(y[1], y[2]);
+        std::swap(z[1], z[2]);
+        area2 = -area2;
+    }
+
+    Triangle tri;
+    tri.minX = std::max(0, static_cast<int>(std::floor(std::min(x[0], std::min(x[1], x[2])))));
+    tri.minY = std::max(0, static_cast<int>(std::floor(std::min(y[0], std::min(y[1], y[2])))));
+    tri.maxX = std::min(width - 1, static_cast<int>(std::ceil(std::max(x[0], std::max(x[1], x[2])))));
+    tri.maxY = std::min(height - 1, static_cast<int>(std::ceil(std::max(y[0], std::max(y[1], y[2])))));
+    if (tri.minX > tri.maxX || tri.minY > tri.maxY) {
+        ++bin.culled;
+        return;
+    }
+
+    // Aresta i é a oposta ao vértice i, então E_i / area2 é o peso baricêntrico do vértice i
+    for (int i = 0; i < 3; ++i) {
+        int va = (i + 1) % 3, vb = (i + 2) % 3;
+        tri.edgeA[i] = y[va] - y[vb];
+        tri.edgeB[i] = x[vb] - x[va];
+        tri.edgeC[i] = -(tri.edgeA[i] * x[va] + tri.edgeB[i] * y[va]);
+        // Regra top-left (y para cima, anti-horário): aresta superior ou esquerda
+        tri.topLeft[i] = (tri.edgeA[i] == 0.0f && tri.edgeB[i] < 0.0f) || tri.edgeA[i] > 0.0f;
+    }
+    float invArea = 1.0f / area2;
+    tri.zA = (tri.edgeA[0] * z[0] + tri.edgeA[1] * z[1] + tri.edgeA[2] * z[2]) * invArea;
+    tri.zB = (tri.edgeB[0] * z[0] + tri.edgeB[1] * z[1] + tri.edgeB[2] * z[2]) * invArea;
+    tri.zC = (tri.edgeC[0] * z[0] + tri.edgeC[1] * z[1] + tri.edgeC[2] * z[2]) * invArea;
+    tri.color = color;
+
+    uint32_t index = static_cast<uint32_t>(bin.triangles.size());
+    bin.triangles.push_back(tri);
+
+    // Binning: todos os tiles do bounding box, menos os que ficam inteiramente fora de alguma aresta
+    int tx0 = tri.minX / TILE_SIZE, tx1 = tri.maxX / TILE_SIZE;
+    int ty0 = tri.minY / TILE_SIZE, ty1 = tri.maxY / TILE_SIZE;
+    for (int ty = ty0; ty <= ty1; ++ty) {
+        float cy0 = ty * TILE_SIZE + 0.5f, cy1 = cy0 + TILE_SIZE - 1.0f;
+        for (int tx = tx0; tx <= tx1; ++tx) {
+            float cx0 = tx * TILE_SIZE + 0.5f, cx1 = cx0 + TILE_SIZE - 1.0f;
+            bool outside = false;
+            for (int e = 0; e < 3 && !outside; ++e) {
+                // Canto do tile onde a aresta é máxima
+                float px = tri.edgeA[e] > 0.0f ? cx1 : cx0;
+                float py = tri.edgeB[e] > 0.0f ? cy1 : cy0;
+                outside = tri.edgeA[e] * px + tri.edgeB[e] * py + tri.edgeC[e] < 0.0f;
+            }
+            if (!outside) {
+                bin.tiles[static_cast<size_t>(ty) * tilesX + tx].push_back(index);
+                ++bin.binned;
+            }
+        }
+    }
+}
+
+void SoftwareRenderer::rasterTile(int tileIndex) {
+    int tileX0 = (tileIndex % tilesX) * TILE_SIZE;
+    int tileY0 = (tileIndex / tilesX) * TILE_SIZE;
+
+    for (int y = tileY0; y < tileY0 + TILE_SIZE; ++y) {
+        size_t row = static_cast<size_t>(y) * paddedWidth + tileX0;
+        std::fill(colorBuffer.begin() + row, colorBuffer.begin() + row + TILE_SIZE, clearValue);
+        std::fill(depthBuffer.begin() + row, depthBuffer.begin() + row + TILE_SIZE, 1.0f);
+    }
+
+    // Bins em ordem de job preservam a ordem de submissão dos draws
+    for (const Bin& bin : bins) {
+        for (uint32_t index : bin.tiles[tileIndex]) {
+            rasterTriangle(bin.triangles[index], tileX0, tileY0);
+        }
+    }
+}
+
+void SoftwareRenderer::rasterTriangle(const Triangle& tri, int tileX0, int tileY0) {
+    // Intersecção do bounding box com o tile; x alinhado em grupos de 4 pixels
+    int x0 = std::max(tri.minX, tileX0) & ~3;
+    int x1 = std::min(tri.maxX + 1, tileX0 + TILE_SIZE);
+    int y0 = std::max(tri.minY, tileY0);
+    int y1 = std::min(tri.maxY + 1, tileY0 + TILE_SIZE);
+
+#ifdef SOFTWARE_RENDERER_SSE2
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 laneOffsets = _mm_set_ps(3.5f, 2.5f, 1.5f, 0.5f);
+    const __m128i color = _mm_set1_epi32(static_cast<int>(tri.color));
+    __m128 edgeA[3], topLeft[3];
+    for (int e = 0; e < 3; ++e) {
+        edgeA[e] = _mm_set1_ps(tri.edgeA[e]);
+        topLeft[e] = _mm_castsi128_ps(_mm_set1_epi32(tri.topLeft[e] ? -1 : 0));
+    }
+    const __m128 zA = _mm_set1_ps(tri.zA);
+
+    for (int y = y0; y < y1; ++y) {
+        float py = y + 0.5f;
+        __m128 rowTerm[3];
+        for (int e = 0; e < 3; ++e) {
+            rowTerm[e] = _mm_set1_ps(tri.edgeB[e] * py + tri.edgeC[e]);
+        }
+        __m128 zRow = _mm_set1_ps(tri.zB * py + tri.zC);
+        float* depthRow = &depthBuffer[static_cast<size_t>(y) * paddedWidth];
+        uint32_t* colorRow = &colorBuffer[static_cast<size_t>(y) * paddedWidth];
+
+        for (int x = x0; x < x1; x += 4) {
+            __m128 px = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), laneOffsets);
+
+            // Dentro se E > 0, ou E == 0 numa aresta top-left
+            __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+            for (int e = 0; e < 3; ++e) {
+                __m128 value = _mm_add_ps(_mm_mul_ps(edgeA[e], px), rowTerm[e]);
+                __m128 covered = _mm_or_ps(_mm_cmpgt_ps(value, zero),
+                                           _mm_and_ps(_mm_cmpeq_ps(value, zero), topLeft[e]));
+                inside = _mm_and_ps(inside, covered);
+            }
+            if (_mm_movemask_ps(inside) == 0) continue;
+
+            __m128 z = _mm_add_ps(_mm_mul_ps(zA, px), zRow);
+            __m128 oldDepth = _mm_loadu_ps(depthRow + x);
+            __m128 pass = _mm_and_ps(inside, _mm_cmplt_ps(z, oldDepth));
+            if (_mm_movemask_ps(pass) == 0) continue;
+
+            _mm_storeu_ps(depthRow + x, _mm_or_ps(_mm_and_ps(pass, z), _mm_andnot_ps(pass, oldDepth)));
+            __m128i passMask = _mm_castps_si128(pass);
+            __m128i oldColor = _mm_loadu_si128(reinterpret_cast<const __m128i*>(colorRow + x));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(colorRow + x),
+                             _mm_or_si128(_mm_and_si128(passMask, color), _mm_andnot_si128(passMask, oldColor)));
+        }
+    }
+#else
+    for (int y = y0; y < y1; ++y) {
+        float py = y + 0.5f;
+        float* depthRow = &depthBuffer[static_cast<size_t>(y) * paddedWidth];
+        uint32_t* colorRow = &colorBuffer[static_cast<size_t>(y) * paddedWidth];
+        for (int x = x0; x < x1; ++x) {
+            float px = x + 0.5f;
+            bool inside = true;
+            for (int e = 0; e < 3 && inside; ++e) {
+                float value = tri.edgeA[e] * px + tri.edgeB[e] * py + tri.edgeC[e];
+                inside = value > 0.0f || (value == 0.0f && tri.topLeft[e]);
+            }
+            if (!inside) continue;
+            float z = tri.zA * px + tri.zB * py + tri.zC;
+            if (z < depthRow[x]) {
+                depthRow[x] = z;
+                colorRow[x] = tri.color;
+            }
+        }
+    }
+#endif
+}
+
+void SoftwareRenderer::readPixelsRGB(std::vector<uint8_t>& out) const {
+    out.resize(static_cast<size_t>(width) * height * 3);
+    for (int y = 0; y < height; ++y) {
+        const uint32_t* src = &colorBuffer[static_cast<size_t>(height - 1 - y) * paddedWidth];
+        uint8_t* dst = &out[static_cast<size_t>(y) * width * 3];
+        for (int x = 0; x < width; ++x) {
+            dst[x * 3 + 0] = static_cast<uint8_t>(src[x]);
+            dst[x * 3 + 1] = static_cast<uint8_t>(src[x] >> 8);
+            dst[x * 3 + 2] = static_cast<uint8_t>(src[x] >> 16);
+        }
+    }
+}
@@ -0,0 +1,100 @@
+#ifndef SOFTWARE_RENDERER_H
+#define SOFTWARE_RENDERER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "Renderer.h"
+#include "ThreadPool.h"
+
+// Rasterizador de software por tiles, para rodar sem GPU (máquinas de build/teste).
+//
+// drawMesh só enfileira; endFrame executa duas fases paralelas:
+//  1. Geometria: cada job transforma um intervalo contíguo de draws, recorta no
+//     plano near, descarta faces de trás e distribui os triângulos nos tiles
+//     que eles tocam (bins por job, então não há travas).
+//  2. Rasterização: cada tile é limpo e rasterizado por uma única thread,
+//     percorrendo os bins na ordem de submissão, 4 pixels por vez (SSE2).
+// Profundidade usa GL_LESS e o buffer tem origem no canto inferior esquerdo, como o GL.
+class SoftwareRenderer : public Renderer {
+public:
+    static const int TILE_SIZE = 32; // Lado do tile em pixels (múltiplo de 4)
+
+    struct Stats {
+        size_t drawCalls = 0;
+        size_t trianglesSubmitted = 0;
+        size_t trianglesCulled = 0;   // Faces de trás, degenerados ou fora do frustum
+        size_t trianglesClipped = 0;  // Cortados pelo plano near
+        size_t tileBins = 0;          // Total de pares (triângulo, tile)
+        double geometryMs = 0.0;
+        double rasterMs = 0.0;
+    };
+
+    // threadCount = 0 usa todos os núcleos
+    SoftwareRenderer(int width, int height, unsigned threadCount = 0);
+
+    // Equivale a glEnable(GL_CULL_FACE) + glCullFace(GL_BACK) + glFrontFace(GL_CCW)
+    bool cullBackFaces = true;
+
+    void beginFrame(const glm::mat4& view, const glm::mat4& projection, const glm::vec3& clearColor) override;
+    void drawMesh(const Mesh& mesh, const glm::mat4& model, const glm::vec3& color) override;
+    void endFrame() override;
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    const Stats& getStats() const { return stats; }
+
+    // Pixel RGBA8 (bytes R, G, B, A) com origem no canto inferior esquerdo
+    uint32_t pixel(int x, int y) const { return colorBuffer[static_cast<size_t>(y) * paddedWidth + x]; }
+    float depth(int x, int y) const { return depthBuffer[static_cast<size_t>(y) * paddedWidth + x]; }
+
+    // Copia o quadro como RGB8, linhas de cima para baixo (ordem de PPM/PNG)
+    void readPixelsRGB(std::vector<uint8_t>& out) const;
+
+private:
+    struct DrawCommand {
+        const Mesh* mesh;
+        glm::mat4 model;
+        uint32_t color;
+    };
+
+    // Triângulo pronto para rasterizar: três funções de aresta E(x,y) = A*x + B*y + C
+    // (positivas no interior) e o plano de profundidade z(x,y) = zA*x + zB*y + zC
+    struct Triangle {
+        float edgeA[3], edgeB[3], edgeC[3];
+        bool topLeft[3];
+        float zA, zB, zC;
+        int minX, minY, maxX, maxY;
+        uint32_t color;
+    };
+
+    // Saída da fase de geometria de um job
+    struct Bin {
+        std::vector<glm::vec4> clipPositions;       // Rascunho reutilizado
+        std::vector<Triangle> triangles;
+        std::vector<std::vector<uint32_t>> tiles;   // Índices em 'triangles' por tile
+        size_t submitted = 0, culled = 0, clipped = 0, binned = 0;
+    };
+
+    void processDraws(size_t begin, size_t end, Bin& bin);
+    void clipAndSetup(const glm::vec4& a, const glm::vec4& b, const glm::vec4& c, uint32_t color, Bin& bin);
+    void setupTriangle(const glm::vec4& a, const glm::vec4& b, const glm::vec4& c, uint32_t color, Bin& bin);
+    void rasterTile(int tileIndex);
+    void rasterTriangle(const Triangle& tri, int tileX0, int tileY0);
+
+    int width, height;
+    int tilesX, tilesY;
+    int paddedWidth, paddedHeight;
+    std::vector<uint32_t> colorBuffer;
+    std::vector<float> depthBuffer;
+
+    ThreadPool pool;
+    std::vector<Bin> bins;
+    std::vector<DrawCommand> draws;
+    glm::mat4 viewProjection;
+    uint32_t clearValue;
+    Stats stats;
+};
+
+#endif // SOFTWARE_RENDERER_H
@@ -0,0 +1,44 @@
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+
+// Fila circular sem travas para exatamente um produtor e um consumidor.
+// CAPACITY precisa ser potência de 2. push falha (devolve false) com a fila cheia.
+template <typename T, size_t CAPACITY>
+class SpscQueue {
+    static_assert((CAPACITY & (CAPACITY - 1)) == 0, "CAPACITY must be a power of two");
+
+public:
+    SpscQueue() = default;
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    // --- Produtor ---
+    bool push(const T& item) {
+        size_t tail = tailIndex.load(std::memory_order_relaxed);
+        if (tail - headIndex.load(std::memory_order_acquire) == CAPACITY) return false;
+        items[tail & (CAPACITY - 1)] = item;
+        tailIndex.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // --- Consumidor ---
+    bool pop(T& item) {
+        size_t head = headIndex.load(std::memory_order_relaxed);
+        if (head == tailIndex.load(std::memory_order_acquire)) return false;
+        item = items[head & (CAPACITY - 1)];
+        headIndex.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool empty() const { return headIndex.load(std::memory_order_acquire) == tailIndex.load(std::memory_order_acquire); }
+
+private:
+    T items[CAPACITY];
+    alignas(64) std::atomic<size_t> headIndex{0}; // Escrito só pelo consumidor
+    alignas(64) std::atomic<size_t> tailIndex{0}; // Escrito só pelo produtor
+};
+
+#endif // SPSC_QUEUE_H
@@ -0,0 +1,68 @@
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool(unsigned threadCount) {
+    if (threadCount == 0) threadCount = std::thread::hardware_concurrency();
+    if (threadCount == 0) threadCount = 1;
+
+    // A thread que chama parallelFor é o worker 0
+    for (unsigned i = 1; i < threadCount; ++i) {
+        threads.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wakeCondition.notify_all();
+    for (std::thread& t : threads) t.join();
+}
+
+void ThreadPool::parallelFor(size_t count, const std::function<void(size_t, unsigned)>& job) {
+    if (count == 0) return;
+    if (threads.empty() || count == 1) {
+        for (size_t i = 0; i < count; ++i) job(i, 0);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        currentJob = &job;
+        jobCount = count;
+        nextIndex.store(0, std::memory_order_relaxed);
+        busyWorkers = static_cast<unsigned>(threads.size());
+        ++generation;
+    }
+    wakeCondition.notify_all();
+
+    runJobs(0);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    doneCondition.wait(lock, [this] { return busyWorkers == 0; });
+    currentJob = nullptr;
+}
+
+void ThreadPool::runJobs(unsigned worker) {
+    size_t index;
+    while ((index = nextIndex.fetch_add(1, std::memory_order_relaxed)) < jobCount) {
+        (*currentJob)(index, worker);
+    }
+}
+
+void ThreadPool::workerLoop(unsigned worker) {
+    unsigned long long seenGeneration = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wakeCondition.wait(lock, [&] { return stopping || generation != seenGeneration; });
+            if (stopping) return;
+            seenGeneration = generation;
+        }
+
+        runJobs(worker);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--busyWorkers == 0) doneCondition.notify_one();
+    }
+}
@@ -0,0 +1,47 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Conjunto fixo de threads para laços paralelos (parallelFor).
+// A thread que chama também trabalha, como 'worker' 0.
+class ThreadPool {
+public:
+    // threadCount = 0 usa std::thread::hardware_concurrency()
+    explicit ThreadPool(unsigned threadCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Número total de workers, incluindo a thread que chama
+    unsigned size() const { return static_cast<unsigned>(threads.size()) + 1; }
+
+    // Executa job(indice, worker) para indice em [0, count) e só retorna quando todos terminarem.
+    // Os índices são distribuídos dinamicamente; 'worker' fica em [0, size()).
+    void parallelFor(size_t count, const std::function<void(size_t index, unsigned worker)>& job);
+
+private:
+    void workerLoop(unsigned worker);
+    void runJobs(unsigned worker);
+
+    std::vector<std::thread> threads;
+    std::mutex mutex;
+    std::condition_variable wakeCondition;
+    std::condition_variable doneCondition;
+
+    const std::function<void(size_t, unsigned)>* currentJob = nullptr;
+    size_t jobCount = 0;
+    std::atomic<size_t> nextIndex{0};
+    unsigned busyWorkers = 0;
+    unsigned long long generation = 0;
+    bool stopping = false;
+};
+
+#endif // THREAD_POOL_H
@@ -0,0 +1,44 @@
+#ifndef TRIPLE_BUFFER_H
+#define TRIPLE_BUFFER_H
+
+#include <atomic>
+#include <cstdint>
+
+// Buffer triplo sem travas para um produtor e um consumidor (ex.: thread de simulação
+// publicando snapshots para a thread de desenho). O produtor sempre escreve no seu
+// buffer e publish() o troca pelo do meio; o consumidor pega o do meio em acquire()
+// só quando há um novo. Nenhum lado espera o outro: o consumidor sempre vê o snapshot
+// completo mais recente, e snapshots intermediários podem ser pulados.
+template <typename T>
+class TripleBuffer {
+public:
+    TripleBuffer() = default;
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    // --- Produtor ---
+    T& writeBuffer() { return buffers[writeIndex]; }
+    void publish() {
+        writeIndex = middle.exchange(static_cast<uint8_t>(writeIndex | FRESH), std::memory_order_acq_rel) & INDEX_MASK;
+    }
+
+    // --- Consumidor ---
+    // true se trocou para um snapshot novo; readBuffer() continua válido até o próximo acquire()
+    bool acquire() {
+        if (!(middle.load(std::memory_order_acquire) & FRESH)) return false;
+        readIndex = middle.exchange(static_cast<uint8_t>(readIndex), std::memory_order_acq_rel) & INDEX_MASK;
+        return true;
+    }
+    T& readBuffer() { return buffers[readIndex]; }
+
+private:
+    static const uint8_t INDEX_MASK = 0x3;
+    static const uint8_t FRESH = 0x4; // O buffer do meio ainda não foi lido
+
+    T buffers[3];
+    std::atomic<uint8_t> middle{1};
+    uint8_t writeIndex = 0; // Só o produtor mexe
+    uint8_t readIndex = 2;  // Só o consumidor mexe
+};
+
+#endif // TRIPLE_BUFFER_H
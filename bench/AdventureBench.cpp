@@ -0,0 +1,365 @@
+// Microbenchmarks of the Adventure Time prototype: NPC update/wander, the ECS systems, snapshots, navigation, flocking, formations, geometry, occlusion culling, draw submission and indirect batching.
+#include "Bench.h"
+#include "AdventureCharacters.h"
+#include "AdventureDraw.h"
+#include "AdventureEcs.h"
+#include "FrameArena.h"
+#include "IndirectRenderer.h"
+#include "Mesh.h"
+#include "Navigation.h"
+#include "OcclusionCulling.h"
+#include "Replication.h"
+#include "Flocking.h"
+#include "Formation.h"
+#include "Rollback.h"
+#include "Snapshot.h"
+#include "SoftwareRenderer.h"
+#include "ThreadPool.h"
+#include <vector>
+
+// The CPU half of IndirectRenderer: records into a DrawBatch and groups it into commands at endFrame
+class BatchRecorder : public Renderer {
+public:
+    DrawBatch batch;
+    bool gpuCulling = false; // Record character boxes and leave the visibility to the (absent) GPU
+
+    void beginFrame(const glm::mat4&, const glm::mat4&, const glm::vec3&) override { batch.clear(); }
+    void drawMesh(const Mesh& mesh, const glm::mat4& model, const glm::vec3& color) override {
+        batch.add(batch.meshSlot(mesh), model, color);
+    }
+    void endFrame() override {
+        if (gpuCulling) batch.buildCommands();
+        else batch.build();
+    }
+    void beginObject(const glm::vec3& boundsMin, const glm::vec3& boundsMax) override { batch.beginObject(boundsMin, boundsMax); }
+    void endObject() override { batch.endObject(); }
+    bool cullsObjects() const override { return gpuCulling; }
+};
+
+// Finn and Jake followed by count-2 NPCs cycling through the four NPC types
+static std::vector<Character*> makeCrowd(long long count) {
+    gen.seed(1234u);
+    std::vector<Character*> characters;
+    for (long long i = 0; i < count; ++i) {
+        glm::vec3 pos(distribWander(gen), 0.0f, distribWander(gen));
+        int type = i < 2 ? static_cast<int>(i) : 2 + static_cast<int>(i % 4);
+        characters.push_back(characterPools.spawn(static_cast<CharacterType>(type), pos));
+    }
+    return characters;
+}
+
+int main(int argc, char** argv) {
+    BenchOptions options = parseBenchOptions(argc, argv);
+    BenchSuite suite("AdventureTime", options);
+    const float dt = 1.0f / 60.0f;
+
+    buildMesh(generateCubePositions(), std::vector<glm::vec3>(), cubeMesh);
+    buildMesh(generatePyramidPositions(), std::vector<glm::vec3>(), pyramidMesh);
+    buildMesh(generateConePositions(), std::vector<glm::vec3>(), coneMesh);
+
+    for (long long count : options.counts) {
+        std::vector<Character*> crowd = makeCrowd(count);
+
+        // Virtual update: jump physics, limb swing and wander for NPCs
+        suite.run("Character::update", count, [&](size_t n) {
+            for (size_t i = 0; i < n; ++i) {
+                simulationTime += dt;
+                for (Character* character : crowd) character->update(dt);
+            }
+            doNotOptimize(crowd.front()->position);
+        }, static_cast<double>(count));
+
+        suite.run("Character::updateNPCWander", count, [&](size_t n) {
+            for (size_t i = 0; i < n; ++i) {
+                for (Character* character : crowd) {
+                    if (character->isNPC) character->updateNPCWander(dt);
+                }
+            }
+            doNotOptimize(crowd.back()->position);
+        }, static_cast<double>(count));
+
+        // The same crowd as ECS entities: every system over the chunks, alone and on a ThreadPool
+        {
+            AdventureEcs ecs;
+            for (long long i = 0; i < count; ++i) {
+                int type = i < 2 ? static_cast<int>(i) : 2 + static_cast<int>(i % 4);
+                ecs.spawn(static_cast<CharacterType>(type), crowd[i]->position);
+            }
+            suite.run("AdventureEcs::step", count, [&](size_t n) {
+                for (size_t i = 0; i < n; ++i) ecs.step(dt, nullptr);
+                doNotOptimize(ecs.renderItemCount());
+            }, static_cast<double>(count));
+            ThreadPool pool;
+            suite.run("AdventureEcs::step/pool", count, [&](size_t n) {
+                for (size_t i = 0; i < n; ++i) ecs.step(dt, &pool);
+                doNotOptimize(ecs.renderItemCount());
+            }, static_cast<double>(count));
+            CountingRenderer counting;
+            suite.run("renderWorldEcs/mock", count, [&](size_t n) {
+                for (size_t i = 0; i < n; ++i) {
+                    renderWorldEcs(counting, ecs, 1.5f, 4.0f / 3.0f);
+                    frameArena.endFrame();
+                }
+                doNotOptimize(counting.checksum);
+            }, static_cast<double>(count));
+        }
+
+        // Snapshots: save, in-place restore, and the delta after one tick of wandering
+        {
+            std::vector<uint8_t> snapshot, next, delta, decoded;
+            SnapshotScene scene;
+            suite.run("saveSnapshot", count, [&](size_t n) {
+                for (size_t i = 0; i < n; ++i) saveSnapshot(crowd, scene, snapshot);
+                doNotOptimize(snapshot.size());
+            }, static_cast<double>(count));
+            suite.run("loadSnapshot/in-place", count, [&](size_t n) {
+                for (size_t i = 0; i < n; ++i) loadSnapshot(snapshot, crowd, scene);
+                doNotOptimize(crowd.back()->position);
+            }, static_cast<double>(count));
+            updateWorld(crowd, -1, dt);
+            saveSnapshot(crowd, scene, next);
+            suite.run("encodeSnapshotDelta/1-tick", count, [&](size_t n) {
+                for (size_t i = 0; i < n; ++i) encodeSnapshotDelta(snapshot, next, delta);
+                doNotOptimize(delta.size());
+            }, static_cast<double>(count));
+            suite.run("decodeSnapshotDelta/1-tick", count, [&](size_t n) {
+                for (size_t i = 0; i < n; ++i) decodeSnapshotDelta(snapshot, delta, decoded);
+                doNotOptimize(decoded.size());
+            }, static_cast<double>(count));
+        }
+
+        // Replication: what the server pays per client and tick with the whole crowd in view,
+        // and what the client pays to rebuild the view
+        {
+            NetViewHistory sent, received;
+            NetView& base = sent.store(1);
+            for (size_t i = 0; i < crowd.size(); ++i) {
+                base.ids.push_back(static_cast<uint32_t>(i));
+                base.entities.emplace_back();
+                quantizeCharacter(crowd[i], base.entities.back());
+            }
+            updateWorld(crowd, -1, dt);
+            NetView& next = sent.store(2);
+            next.ids = base.ids;
+            next.entities.resize(crowd.size());
+            suite.run("quantizeCharacter", count, [&](size_t n) {
+                for (size_t i = 0; i < n; ++i) {
+                    for (size_t c = 0; c < crowd.size(); ++c) quantizeCharacter(crowd[c], next.entities[c]);
+                }
+                doNotOptimize(next.entities.back().x);
+            }, static_cast<double>(count));
+            std::vector<uint8_t> full, delta;
+            encodeNetView(base, nullptr, full);
+            suite.run("encodeNetView/1-tick delta", count, [&](size_t n) {
+                for (size_t i = 0; i < n; ++i) encodeNetView(next, &base, delta);
+                doNotOptimize(delta.size());
+            }, static_cast<double>(count));
+            decodeNetView(full, received, received.store(1));
+            NetView decoded;
+            suite.run("decodeNetView/1-tick delta", count, [&](size_t n) {
+                for (size_t i = 0; i < n; ++i) decodeNetView(delta, received, decoded);
+                doNotOptimize(decoded.ids.size());
+            }, static_cast<double>(count));
+        }
+
+        // Rollback: one tick with its snapshot and hash, then the same with an 8-tick rewind every tick
+        {
+            RollbackSession session(crowd, dt, 8);
+            session.addPlayer(0);
+            session.addPlayer(1);
+            suite.run("RollbackSession::advance", count, [&](size_t n) {
+                for (size_t i = 0; i < n; ++i) {
+                    session.advance();
+                    frameArena.endFrame();
+                }
+                doNotOptimize(session.currentTick());
+            }, static_cast<double>(count));
+            session.syncTest = true;
+            suite.run("RollbackSession::advance/8-tick rollback", count, [&](size_t n) {
+                for (size_t i = 0; i < n; ++i) {
+                    session.advance();
+                    frameArena.endFrame();
+                }
+                doNotOptimize(session.currentTick());
+            }, static_cast<double>(count));
+        }
+
+        // Flow-field lookup per walker, once every waypoint field is cached
+        navigation.enabled = true;
+        for (Character* character : crowd) character->targetPosition = navigation.snapToWaypoint(character->targetPosition);
+        suite.run("Navigation::steer", count, [&](size_t n) {
+            glm::vec3 sum(0.0f);
+            for (size_t i = 0; i < n; ++i) {
+                for (Character* character : crowd) sum += navigation.steer(character->position, character->targetPosition, glm::vec3(0.0f));
+            }
+            doNotOptimize(sum);
+        }, static_cast<double>(count));
+        navigation.enabled = false;
+
+        // Grid rebuild + steering for the flyers of the crowd (half of the NPCs)
+        suite.run("Flocking::update", count, [&](size_t n) {
+            for (size_t i = 0; i < n; ++i) {
+                flocking.update(crowd);
+                frameArena.endFrame();
+            }
+            doNotOptimize(crowd.back()->flockSteering);
+        }, static_cast<double>(count));
+
+        suite.run("updateWorld", count, [&](size_t n) {
+            for (size_t i = 0; i < n; ++i) {
+                updateWorld(crowd, 0, dt);
+                frameArena.endFrame();
+            }
+            doNotOptimize(crowd.back()->position);
+        }, static_cast<double>(count));
+
+        // One leader with everybody else in a wedge: the batched gather/solve/scatter pass
+        if (count > 1) {
+            int group = formations.createGroup(crowd.front(), FormationShape::Wedge, 1.5f);
+            for (size_t c = 1; c < crowd.size(); ++c) formations.join(group, crowd[c]);
+            suite.run("FormationSystem::update", count, [&](size_t n) {
+                for (size_t i = 0; i < n; ++i) {
+                    formations.update(dt);
+                    frameArena.endFrame();
+                }
+                doNotOptimize(crowd.back()->position);
+            }, static_cast<double>(count - 1));
+            formations.disband(group);
+        }
+
+        // Submission: every character model through drawShape into a mock backend
+        CountingRenderer counting;
+        suite.run("renderWorld/mock", count, [&](size_t n) {
+            for (size_t i = 0; i < n; ++i) {
+                renderWorld(counting, crowd, 1.5f, 4.0f / 3.0f);
+                frameArena.endFrame();
+            }
+            doNotOptimize(counting.checksum);
+        }, static_cast<double>(count));
+
+        BatchRecorder recorder;
+        suite.run("renderWorld/indirect batch", count, [&](size_t n) {
+            for (size_t i = 0; i < n; ++i) {
+                renderWorld(recorder, crowd, 1.5f, 4.0f / 3.0f);
+                frameArena.endFrame();
+            }
+            doNotOptimize(recorder.batch.commands.size());
+        }, static_cast<double>(count));
+        // Per-part cost of packing a model into the 24-byte instance record
+        {
+            std::vector<glm::mat4> models;
+            for (size_t i = 0; i < static_cast<size_t>(count); ++i) {
+                glm::mat4 model = glm::translate(glm::mat4(1.0f), glm::vec3(static_cast<float>(i), 0.5f, 2.0f));
+                model = glm::rotate(model, 0.01f * static_cast<float>(i), glm::vec3(0.0f, 1.0f, 0.0f));
+                models.push_back(glm::scale(model, glm::vec3(0.3f, 0.6f, 0.2f)));
+            }
+            suite.run("encodeInstance", count, [&](size_t n) {
+                uint32_t checksum = 0;
+                for (size_t i = 0; i < n; ++i) {
+                    for (const glm::mat4& model : models) checksum += encodeInstance(model, 0).rotation;
+                }
+                doNotOptimize(checksum);
+            }, static_cast<double>(count));
+        }
+
+        // CPU side of --gpu-cull: no visibility test, one box per character and per-mesh counts only
+        recorder.gpuCulling = true;
+        suite.run("renderWorld/gpu-cull batch", count, [&](size_t n) {
+            for (size_t i = 0; i < n; ++i) {
+                renderWorld(recorder, crowd, 1.5f, 4.0f / 3.0f);
+                frameArena.endFrame();
+            }
+            doNotOptimize(recorder.batch.getObjects().size());
+        }, static_cast<double>(count));
+
+        // Same crowd behind the town walls: occluder raster + Hi-Z + one box test per character
+        {
+            buildTown(26);
+            OcclusionCuller culler;
+            occlusionCuller = &culler;
+            suite.run("renderWorld/mock+occlusion", count, [&](size_t n) {
+                for (size_t i = 0; i < n; ++i) {
+                    renderWorld(counting, crowd, 1.5f, 4.0f / 3.0f);
+                    frameArena.endFrame();
+                }
+                doNotOptimize(counting.checksum);
+            }, static_cast<double>(count));
+            suite.run("OcclusionCuller::isVisible", count, [&](size_t n) {
+                size_t visible = 0;
+                for (size_t i = 0; i < n; ++i) {
+                    for (Character* character : crowd) visible += isCharacterVisible(character, characterType(character));
+                }
+                doNotOptimize(visible);
+            }, static_cast<double>(count));
+            occlusionCuller = nullptr;
+            townBlocks.clear();
+        }
+
+        if (count <= 1000) {
+            SoftwareRenderer software(320, 240);
+            suite.run("renderWorld/software", count, [&](size_t n) {
+                for (size_t i = 0; i < n; ++i) {
+                    renderWorld(software, crowd, 1.5f, 4.0f / 3.0f);
+                    frameArena.endFrame();
+                }
+                doNotOptimize(software.pixel(160, 120));
+            }, static_cast<double>(count));
+        }
+
+        despawnCharacters(crowd);
+
+        // Slots come back through the free list: no heap traffic once the slabs exist
+        characterPools.reserve(CHARACTER_BMO, static_cast<size_t>(count));
+        std::vector<Character*> churn;
+        churn.reserve(static_cast<size_t>(count));
+        suite.run("CharacterPools spawn+despawn", count, [&](size_t n) {
+            for (size_t i = 0; i < n; ++i) {
+                for (long long c = 0; c < count; ++c) churn.push_back(characterPools.spawn(CHARACTER_BMO, glm::vec3(0.0f)));
+                despawnCharacters(churn);
+            }
+            doNotOptimize(churn.capacity());
+        }, static_cast<double>(count));
+    }
+    activeRenderer = nullptr;
+
+    // Whole field from scratch vs. repair after the cone grows by one ring of cells
+    NavGrid grid(GROUND_SIZE, 1.0f);
+    grid.addObstacle(PYRAMID_POSITION, 1.2f);
+    int cone = grid.addObstacle(CONE_POSITION, 0.75f);
+    int goal = grid.cellAt(glm::vec3(-20.0f, 0.0f, -20.0f)); // Behind the cone, so the change matters
+    FlowField field;
+    suite.run("FlowField::build", grid.cellCount(), [&](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            field.build(grid, goal);
+            frameArena.endFrame();
+        }
+        doNotOptimize(field.cost(0));
+    }, static_cast<double>(grid.cellCount()));
+    bool grown = false;
+    suite.run("FlowField::repair", grid.cellCount(), [&](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            uint32_t before = grid.version();
+            grown = !grown;
+            grid.moveObstacle(cone, CONE_POSITION, grown ? 1.75f : 0.75f);
+            NavRect changed;
+            grid.changesSince(before, changed);
+            field.repair(grid, changed);
+            frameArena.endFrame();
+        }
+        doNotOptimize(field.cost(0));
+    }, static_cast<double>(grid.cellCount()));
+
+    suite.run("generateCubePositions", 0, [](size_t n) {
+        for (size_t i = 0; i < n; ++i) doNotOptimize(generateCubePositions().size());
+    });
+    suite.run("generatePyramidPositions", 0, [](size_t n) {
+        for (size_t i = 0; i < n; ++i) doNotOptimize(generatePyramidPositions().size());
+    });
+    for (int slices : { 16, 64 }) {
+        suite.run("generateConePositions", slices, [slices](size_t n) {
+            for (size_t i = 0; i < n; ++i) doNotOptimize(generateConePositions(slices).size());
+        });
+    }
+
+    return suite.finish();
+}
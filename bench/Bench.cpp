@@ -0,0 +1,163 @@
+#include "Bench.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+BenchOptions parseBenchOptions(int argc, char** argv) {
+    BenchOptions options;
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(arg, "--json") == 0 && hasValue) {
+            options.jsonPath = argv[++i];
+        } else if (std::strcmp(arg, "--baseline") == 0 && hasValue) {
+            options.baselinePath = argv[++i];
+        } else if (std::strcmp(arg, "--threshold") == 0 && hasValue) {
+            options.threshold = std::atof(argv[++i]);
+        } else if (std::strcmp(arg, "--filter") == 0 && hasValue) {
+            options.filter = argv[++i];
+        } else if (std::strcmp(arg, "--min-time") == 0 && hasValue) {
+            options.minTimeMs = std::max(1.0, std::atof(argv[++i]));
+        } else if (std::strcmp(arg, "--counts") == 0 && hasValue) {
+            options.counts.clear();
+            std::stringstream list(argv[++i]);
+            std::string item;
+            while (std::getline(list, item, ',')) {
+                long long count = std::atoll(item.c_str());
+                if (count > 0) options.counts.push_back(count);
+            }
+        }
+    }
+    return options;
+}
+
+BenchSuite::BenchSuite(const char* suiteName, const BenchOptions& options)
+    : suiteName(suiteName), options(options) {}
+
+static double elapsedNs(const std::function<void(size_t)>& body, size_t iterations) {
+    auto start = std::chrono::steady_clock::now();
+    body(iterations);
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+}
+
+void BenchSuite::run(const std::string& name, long long param, const std::function<void(size_t)>& body,
+                     double itemsPerOp) {
+    if (!options.filter.empty() && name.find(options.filter) == std::string::npos) return;
+
+    // Calibração: dobra o lote até ele durar o tempo alvo por repetição (também serve de aquecimento)
+    double targetNs = options.minTimeMs * 1e6 / options.repetitions;
+    size_t iterations = 1;
+    double ns = elapsedNs(body, iterations);
+    while (ns < targetNs && iterations < (size_t(1) << 40)) {
+        size_t next = ns > 0.0 ? static_cast<size_t>(iterations * std::min(10.0, 1.2 * targetNs / ns)) : iterations * 10;
+        iterations = std::max(iterations * 2, next);
+        ns = elapsedNs(body, iterations);
+    }
+
+    std::vector<double> samples;
+    for (int r = 0; r < options.repetitions; ++r) {
+        samples.push_back(elapsedNs(body, iterations) / iterations);
+    }
+    std::sort(samples.begin(), samples.end());
+
+    BenchResult result;
+    result.name = name;
+    result.param = param;
+    result.iterations = iterations;
+    result.nsPerOp = samples[samples.size() / 2];
+    result.minNsPerOp = samples.front();
+    result.itemsPerSecond = result.nsPerOp > 0.0 ? itemsPerOp * 1e9 / result.nsPerOp : 0.0;
+    results.push_back(result);
+
+    std::printf("%-40s %8lld %14.1f ns/op %14.3g items/s\n", name.c_str(), param, result.nsPerOp, result.itemsPerSecond);
+    std::fflush(stdout);
+}
+
+// Lê o JSON gravado por writeJson: procura, em cada objeto de "results", os campos name/param/ns_per_op
+static std::vector<BenchResult> loadBaseline(const std::string& path) {
+    std::vector<BenchResult> baseline;
+    std::ifstream file(path);
+    if (!file) return baseline;
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    std::string text = buffer.str();
+
+    size_t pos = 0;
+    while ((pos = text.find('{', pos + 1)) != std::string::npos) {
+        size_t end = text.find('}', pos);
+        if (end == std::string::npos) break;
+        std::string object = text.substr(pos, end - pos);
+
+        size_t nameKey = object.find("\"name\"");
+        size_t paramKey = object.find("\"param\"");
+        size_t nsKey = object.find("\"ns_per_op\"");
+        if (nameKey != std::string::npos && paramKey != std::string::npos && nsKey != std::string::npos) {
+            size_t nameStart = object.find('"', object.find(':', nameKey)) + 1;
+            BenchResult result;
+            result.name = object.substr(nameStart, object.find('"', nameStart) - nameStart);
+            result.param = std::atoll(object.c_str() + object.find(':', paramKey) + 1);
+            result.nsPerOp = std::atof(object.c_str() + object.find(':', nsKey) + 1);
+            baseline.push_back(result);
+        }
+        pos = end;
+    }
+    return baseline;
+}
+
+static std::string jsonEscape(const std::string& text) {
+    std::string out;
+    for (char c : text) {
+        if (c == '"' || c == '\\') out += '\\';
+        out += c;
+    }
+    return out;
+}
+
+int BenchSuite::finish() {
+    int exitCode = 0;
+
+    if (!options.baselinePath.empty()) {
+        std::vector<BenchResult> baseline = loadBaseline(options.baselinePath);
+        if (baseline.empty()) std::cerr << "No baseline results in " << options.baselinePath << std::endl;
+
+        std::printf("\nComparison with %s (threshold %+.0f%%)\n", options.baselinePath.c_str(), options.threshold * 100.0);
+        for (BenchResult& result : results) {
+            for (const BenchResult& base : baseline) {
+                if (base.name != result.name || base.param != result.param || base.nsPerOp <= 0.0) continue;
+                result.baselineNsPerOp = base.nsPerOp;
+                double change = result.nsPerOp / base.nsPerOp - 1.0;
+                bool regressed = change > options.threshold;
+                if (regressed) exitCode = 1;
+                std::printf("%-40s %8lld %+8.1f%%%s\n", result.name.c_str(), result.param, change * 100.0,
+                            regressed ? "  REGRESSION" : (change < -options.threshold ? "  faster" : ""));
+            }
+        }
+    }
+
+    if (!options.jsonPath.empty()) {
+        std::ofstream json(options.jsonPath);
+        json << "{\n  \"suite\": \"" << jsonEscape(suiteName) << "\",\n  \"results\": [\n";
+        for (size_t i = 0; i < results.size(); ++i) {
+            const BenchResult& r = results[i];
+            json << "    {\"name\": \"" << jsonEscape(r.name) << "\", \"param\": " << r.param
+                 << ", \"iterations\": " << r.iterations << ", \"ns_per_op\": " << r.nsPerOp
+                 << ", \"min_ns_per_op\": " << r.minNsPerOp << ", \"items_per_second\": " << r.itemsPerSecond;
+            if (r.baselineNsPerOp > 0.0) {
+                json << ", \"baseline_ns_per_op\": " << r.baselineNsPerOp
+                     << ", \"change\": " << (r.nsPerOp / r.baselineNsPerOp - 1.0);
+            }
+            json << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+        }
+        json << "  ]\n}\n";
+        if (!json) {
+            std::cerr << "Failed to write " << options.jsonPath << std::endl;
+            exitCode = 1;
+        }
+    }
+    return exitCode;
+}
@@ -0,0 +1,74 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+#include "CountingRenderer.h"
+
+// Mini-harness de microbenchmarks (sem dependências externas).
+//
+// Cada caso roda 'body(iterations)' em lotes calibrados para durar pelo menos
+// minTimeMs / repetitions; o resultado é a mediana de ns por operação entre os
+// lotes. Opções de linha de comando:
+//   --json arquivo       grava os resultados em JSON
+//   --baseline arquivo   compara com um JSON anterior (mesmo formato)
+//   --threshold F        piora relativa que conta como regressão (padrão 0.10 = 10%)
+//   --filter texto       roda só os casos cujo nome contém 'texto'
+//   --counts 1,100,1000  números de entidades usados nos casos parametrizados
+//   --min-time ms        tempo mínimo medido por caso (padrão 200)
+struct BenchOptions {
+    std::string jsonPath;
+    std::string baselinePath;
+    std::string filter;
+    std::vector<long long> counts = { 1, 100, 1000, 10000 };
+    double minTimeMs = 200.0;
+    int repetitions = 5;
+    double threshold = 0.10;
+};
+
+BenchOptions parseBenchOptions(int argc, char** argv);
+
+struct BenchResult {
+    std::string name;
+    long long param = 0;       // Entidades, segmentos... (0 se não se aplica)
+    size_t iterations = 0;     // Operações por lote
+    double nsPerOp = 0.0;      // Mediana entre os lotes
+    double minNsPerOp = 0.0;
+    double itemsPerSecond = 0.0;
+    double baselineNsPerOp = 0.0; // 0 se não há baseline para o caso
+};
+
+class BenchSuite {
+public:
+    BenchSuite(const char* suiteName, const BenchOptions& options);
+
+    const BenchOptions& getOptions() const { return options; }
+
+    // body(n) executa n operações; itemsPerOp dá a vazão (ex.: entidades atualizadas por operação)
+    void run(const std::string& name, long long param, const std::function<void(size_t)>& body,
+             double itemsPerOp = 1.0);
+
+    // Imprime a tabela, grava o JSON e compara com a baseline.
+    // Retorna 1 se algum caso piorou mais que options.threshold, senão 0.
+    int finish();
+
+private:
+    std::string suiteName;
+    BenchOptions options;
+    std::vector<BenchResult> results;
+};
+
+// Impede que o compilador descarte um valor calculado só para o benchmark
+template <typename T>
+inline void doNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+#endif // BENCH_H
@@ -0,0 +1,157 @@
+// Microbenchmarks do MarioFanGame: física, animação, geometria e submissão de desenho.
+#include "Bench.h"
+#include "Character.h"
+#include "Mario.h"
+#include "Geometry.h"
+#include "Mesh.h"
+#include "Lighting.h"
+#include "SoftwareRenderer.h"
+#include <glm/gtc/matrix_transform.hpp>
+#include <vector>
+
+// Malhas usadas por Mario::draw (no jogo são definidas em main.cpp)
+Mesh cubeMesh;
+Mesh cylinderMesh;
+
+// Expõe os auxiliares de animação protegidos
+struct BenchMario : Mario {
+    using Mario::Mario;
+    using Mario::getWalkRotation;
+    using Mario::getJumpRotation;
+};
+
+// Multidão determinística: posições espalhadas e metade andando, metade no ar
+static std::vector<BenchMario> makeMarios(long long count) {
+    std::vector<BenchMario> marios;
+    marios.reserve(static_cast<size_t>(count));
+    uint32_t state = 12345u;
+    auto next = [&state]() { state = state * 1664525u + 1013904223u; return (state >> 8) / 16777216.0f; };
+    for (long long i = 0; i < count; ++i) {
+        marios.emplace_back(glm::vec3(next() * 20.0f - 10.0f, 0.0f, next() * 20.0f - 10.0f));
+        BenchMario& mario = marios.back();
+        mario.rotationY = next() * 360.0f;
+        mario.velocity = glm::vec3(next() * 4.0f, 0.0f, next() * 4.0f);
+        mario.walkCycleTimer = next() * 6.0f;
+        if (i % 2) mario.startJump();
+    }
+    return marios;
+}
+
+int main(int argc, char** argv) {
+    BenchOptions options = parseBenchOptions(argc, argv);
+    BenchSuite suite("MarioFanGame", options);
+    const float dt = 1.0f / 60.0f;
+
+    buildMesh(generateCubePositions(), std::vector<glm::vec3>(), cubeMesh);
+    buildMesh(generateCylinderPositions(32), std::vector<glm::vec3>(), cylinderMesh);
+
+    for (long long count : options.counts) {
+        std::vector<BenchMario> marios = makeMarios(count);
+
+        suite.run("Character::updatePhysics", count, [&](size_t n) {
+            for (size_t i = 0; i < n; ++i) {
+                for (BenchMario& mario : marios) mario.Character::updatePhysics(dt);
+            }
+            doNotOptimize(marios.front().position);
+        }, static_cast<double>(count));
+
+        marios = makeMarios(count);
+        suite.run("Mario::updatePhysics", count, [&](size_t n) {
+            for (size_t i = 0; i < n; ++i) {
+                for (BenchMario& mario : marios) {
+                    mario.isWalking = true;
+                    mario.updatePhysics(dt);
+                }
+            }
+            doNotOptimize(marios.front().walkCycleTimer);
+        }, static_cast<double>(count));
+
+        // Os dois auxiliares são chamados 4 vezes por Mario a cada draw
+        marios = makeMarios(count);
+        suite.run("Mario::getWalkRotation", count, [&](size_t n) {
+            float sum = 0.0f;
+            for (size_t i = 0; i < n; ++i) {
+                for (BenchMario& mario : marios) {
+                    sum += mario.getWalkRotation(35.0f, 0.0f, glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.25f, 0.0f))[1][2];
+                }
+            }
+            doNotOptimize(sum);
+        }, static_cast<double>(count));
+
+        suite.run("Mario::getJumpRotation", count, [&](size_t n) {
+            float sum = 0.0f;
+            for (size_t i = 0; i < n; ++i) {
+                for (BenchMario& mario : marios) {
+                    sum += mario.getJumpRotation(true, glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.25f, 0.0f))[1][2];
+                }
+            }
+            doNotOptimize(sum);
+        }, static_cast<double>(count));
+
+        // Submissão: Mario::draw -> Renderer::drawMesh, sem GPU
+        glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 5.0f, 15.0f), glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+        glm::mat4 projection = glm::perspective(glm::radians(45.0f), 16.0f / 9.0f, 0.1f, 100.0f);
+        CountingRenderer counting;
+        suite.run("Mario::draw/mock", count, [&](size_t n) {
+            for (size_t i = 0; i < n; ++i) {
+                counting.beginFrame(view, projection, glm::vec3(0.0f));
+                for (BenchMario& mario : marios) mario.draw(counting);
+                counting.endFrame();
+            }
+            doNotOptimize(counting.checksum);
+        }, static_cast<double>(count));
+
+        // Quadro completo no rasterizador de software (submissão + binning + raster)
+        if (count <= 1000) {
+            SoftwareRenderer software(320, 180);
+            suite.run("Mario::draw/software", count, [&](size_t n) {
+                for (size_t i = 0; i < n; ++i) {
+                    software.beginFrame(view, projection, glm::vec3(0.0f));
+                    for (BenchMario& mario : marios) mario.draw(software);
+                    software.endFrame();
+                }
+                doNotOptimize(software.pixel(160, 90));
+            }, static_cast<double>(count));
+        }
+    }
+
+    // Distribuição das luzes pelos clusters (por quadro, na CPU), luzes espalhadas sobre o chão
+    {
+        glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 5.0f, 15.0f), glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+        glm::mat4 projection = glm::perspective(glm::radians(45.0f), 16.0f / 9.0f, 0.1f, 100.0f);
+        for (int lightCount : { 64, 256, 1024 }) {
+            std::vector<PointLight> lights(static_cast<size_t>(lightCount));
+            uint32_t state = 777u;
+            auto next = [&state]() { state = state * 1664525u + 1013904223u; return (state >> 8) / 16777216.0f; };
+            for (PointLight& light : lights) {
+                light.position = glm::vec3(next() * 30.0f - 15.0f, next() * 2.0f, next() * 30.0f - 15.0f);
+                light.radius = 1.5f + next() * 1.5f;
+                light.color = glm::vec3(next(), next(), next());
+            }
+            LightClusters clusters;
+            suite.run("LightClusters::build", lightCount, [&](size_t n) {
+                for (size_t i = 0; i < n; ++i) clusters.build(lights, view, projection, 0.1f, 100.0f);
+                doNotOptimize(clusters.lightIndices.size());
+            }, static_cast<double>(lightCount));
+        }
+    }
+
+    suite.run("generateCubePositions", 0, [](size_t n) {
+        for (size_t i = 0; i < n; ++i) doNotOptimize(generateCubePositions().size());
+    });
+    for (int segments : { 16, 32, 128 }) {
+        suite.run("generateCylinderPositions", segments, [segments](size_t n) {
+            for (size_t i = 0; i < n; ++i) doNotOptimize(generateCylinderPositions(segments).size());
+        });
+    }
+    suite.run("buildMesh/cylinder32", 32, [](size_t n) {
+        std::vector<glm::vec3> positions = generateCylinderPositions(32);
+        for (size_t i = 0; i < n; ++i) {
+            Mesh mesh;
+            buildMesh(positions, std::vector<glm::vec3>(), mesh);
+            doNotOptimize(mesh.quantization);
+        }
+    });
+
+    return suite.finish();
+}
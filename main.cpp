@@ -9,36 +9,133 @@
 #include "Constants.h"   // <-- Inclui as constantes globais
 #include "Character.h"   // Inclui Character
 #include "Mario.h"       // Inclui Mario
+#include "GLRenderer.h"
+#include "IndirectRenderer.h"
+#include "Lighting.h"
+#include "SoftwareRenderer.h"
+#include "Headless.h"
+#include "FrameCapture.h"
+#include "InputRecording.h"
+#include "InputState.h"
+#include "FramePacing.h"
+#include "Pool.h"
+#include "TripleBuffer.h"
 
 #include <iostream>
 #include <vector>
 #include <cmath> // Para atan2, sin, cos
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
 
 // Protótipos de Funções
 void framebuffer_size_callback(GLFWwindow* /*window*/, int width, int height); // Comentado 'window' para silenciar aviso
-void processInput(GLFWwindow *window, Character* character, float dt);
-void drawShape(GLuint vao, GLsizei count, Shader& shader, glm::mat4 model, glm::vec3 color);
+void processInput(const InputStream& input, Character* character, float dt);
+void renderScene(Renderer& renderer, Character* character, const glm::mat4& view, const glm::mat4& projection);
+glm::mat4 sceneView();
+glm::mat4 sceneProjection(float aspect);
+void updateSceneLights(std::vector<PointLight>& lights, int count, const Character* character, float time);
+int runHeadless(const HeadlessOptions& options, const CaptureOptions& captureOptions, const InputOptions& inputOptions,
+                const LightingOptions& lightingOptions);
 
 // Configurações
 const unsigned int SCR_WIDTH = 1280;
 const unsigned int SCR_HEIGHT = 720;
+const glm::vec3 CLEAR_COLOR(0.5f, 0.8f, 1.0f); // Azul claro
+const float NEAR_PLANE = 0.1f;
+const float FAR_PLANE = 100.0f;
 
 // Variáveis globais para acesso fácil pela classe Mario (não ideal, mas funciona)
 // E para uso no main loop
-GLuint cubeVAO, cubeVBO;
-GLsizei cubeVertexCount;
-GLuint cylinderVAO, cylinderVBO;
-GLsizei cylinderVertexCount;
-
-// DeltaTime
-float deltaTime = 0.0f;
-float lastFrame = 0.0f;
+Mesh cubeMesh;
+Mesh cylinderMesh;
 
 // Instância do Jogador (ponteiro para permitir polimorfismo futuro)
 Character* player = nullptr; // Usaremos ponteiro da classe base
+Pool<Mario> marioPool;         // O Mario mora aqui; 'player' aponta para o slot
+Handle<Mario> playerHandle;
+
+// Teclas lidas por processInput (gravadas/reproduzidas por InputStream)
+const InputKeyMap MARIO_KEYS = {
+    GLFW_KEY_W, GLFW_KEY_A, GLFW_KEY_S, GLFW_KEY_D,
+    GLFW_KEY_LEFT, GLFW_KEY_RIGHT, GLFW_KEY_UP, GLFW_KEY_DOWN,
+    GLFW_KEY_SPACE
+};
+
+// Tudo o que a thread de desenho precisa de um tick: uma cópia do Mario (transformações e
+// parâmetros de animação). A thread de desenho nunca lê o 'player' vivo.
+struct SceneSnapshot {
+    uint64_t tick = 0;
+    int64_t inputNs = 0;   // Evento de entrada mais antigo consumido neste tick (0 se nenhum)
+    int64_t sampleNs = 0;  // Quando a simulação leu a entrada do tick
+    Mario player;
+};
+
+// Ligação entre a thread principal (janela, eventos e GL) e a thread de simulação
+struct SimulationLink {
+    TripleBuffer<SceneSnapshot> snapshots;
+    InputEventQueue events;                 // Callbacks do GLFW (thread principal) -> simulação
+    std::atomic<uint64_t> consumedTick{0};  // Último tick que a thread de desenho pegou
+    std::atomic<bool> running{true};
+    std::atomic<bool> inputFinished{false}; // Replay acabou
+};
+
+// Thread de simulação: um tick por quadro desenhado, um tick à frente do desenho.
+// Enquanto o GL desenha o tick N, este laço já calcula o N+1; antes do N+2 ele espera
+// a thread de desenho pegar o N+1, para não acumular ticks que nunca seriam vistos.
+void simulationLoop(SimulationLink& link, InputStream& input) {
+    InputState keys(MARIO_KEYS);
+    auto lastTick = std::chrono::steady_clock::now();
+    for (uint64_t tick = 1; link.running.load(std::memory_order_acquire); ++tick) {
+        uint64_t consumed = link.consumedTick.load(std::memory_order_acquire);
+        while (consumed + 1 < tick && link.running.load(std::memory_order_acquire)) {
+            link.consumedTick.wait(consumed, std::memory_order_acquire);
+            consumed = link.consumedTick.load(std::memory_order_acquire);
+        }
+        if (!link.running.load(std::memory_order_acquire)) break;
+
+        auto now = std::chrono::steady_clock::now();
+        float dt = std::min(std::chrono::duration<float>(now - lastTick).count(), 0.1f); // Limitar deltaTime
+        lastTick = now;
+
+        // Em replay, teclas e deltaTime vêm do arquivo
+        int64_t sampleNs = inputClockNs();
+        InputFrame live;
+        live.deltaTime = dt;
+        live.keys = keys.update(link.events);
+        dt = input.next(live).deltaTime;
+        if (input.finished()) {
+            link.inputFinished.store(true, std::memory_order_release);
+            break;
+        }
 
-int main()
+        processInput(input, player, dt);
+        player->updatePhysics(dt);
+
+        SceneSnapshot& snapshot = link.snapshots.writeBuffer();
+        snapshot.tick = tick;
+        snapshot.inputNs = keys.tickEventTimeNs();
+        snapshot.sampleNs = sampleNs;
+        snapshot.player = *static_cast<Mario*>(player);
+        link.snapshots.publish();
+    }
+}
+
+int main(int argc, char** argv)
 {
+    // --- Modo headless: rasterizador de software, sem janela nem GPU ---
+    HeadlessOptions headless = parseHeadlessOptions(argc, argv);
+    CaptureOptions captureOptions = parseCaptureOptions(argc, argv);
+    InputOptions inputOptions = parseInputOptions(argc, argv);
+    LatencyOptions latencyOptions = parseLatencyOptions(argc, argv);
+    LightingOptions lightingOptions = parseLightingOptions(argc, argv);
+    DrawPathOptions drawPathOptions = parseDrawPathOptions(argc, argv);
+    if (headless.enabled) {
+        return runHeadless(headless, captureOptions, inputOptions, lightingOptions);
+    }
+
     // --- Inicialização GLFW ---
     glfwInit();
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
@@ -58,6 +155,7 @@ int main()
     }
     glfwMakeContextCurrent(window);
     glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+    if (latencyOptions.swapInterval >= 0) glfwSwapInterval(latencyOptions.swapInterval);
 
     // --- Inicialização GLEW ---
     glewExperimental = GL_TRUE;
@@ -75,119 +173,256 @@ int main()
     glViewport(0, 0, SCR_WIDTH, SCR_HEIGHT);
 
     // --- Compilar e linkar shaders ---
-    Shader ourShader("shaders/simple.vert", "shaders/simple.frag");
+    // (shaders/simple.* continua disponível: cor chapada, sem normais)
+    // Com GL 4.3 o quadro sai num glMultiDrawElementsIndirect e a model/cor vêm por instância
+    bool indirect = drawPathOptions.indirect && indirectDrawSupported();
+    Shader ourShader(indirect ? "shaders/lit_indirect.vert" : "shaders/lit.vert", "shaders/lit.frag");
 
     // --- Configurar Geometria ---
     std::vector<glm::vec3> cubePositions = generateCubePositions();
-    setupGeometry(cubePositions, cubeVAO, cubeVBO, cubeVertexCount);
+    setupGeometry(cubePositions, generateCubeNormals(), cubeMesh);
     std::vector<glm::vec3> cylinderPositions = generateCylinderPositions(32);
-    setupGeometry(cylinderPositions, cylinderVAO, cylinderVBO, cylinderVertexCount);
+    setupGeometry(cylinderPositions, generateCylinderNormals(32), cylinderMesh);
 
     // --- Criar Personagem ---
-    player = new Mario(glm::vec3(0.0f, 0.0f, 0.0f)); // Cria o Mario na origem
+    playerHandle = marioPool.spawn(glm::vec3(0.0f, 0.0f, 0.0f)); // Cria o Mario na origem
+    player = marioPool.get(playerHandle);
+
+    GLRenderer directRenderer(ourShader.ID);
+    std::unique_ptr<IndirectRenderer> indirectRenderer;
+    if (indirect) indirectRenderer = std::make_unique<IndirectRenderer>(ourShader.ID);
+    GLRenderer& renderer = indirectRenderer ? *indirectRenderer : directRenderer;
+    InputStream input(MARIO_KEYS, inputOptions);
+
+    // --- Luzes pontuais (--lights N), distribuídas em clusters a cada quadro ---
+    std::vector<PointLight> sceneLights;
+    LightClusters lightClusters;
+    if (lightingOptions.lights > 0) renderer.lighting = &lightClusters;
+
+    // --- Captura de quadros: desenha num FBO e lê de volta por PBOs ---
+    RenderTarget offscreen;
+    FrameCapture* capture = nullptr;
+    if (captureOptions.enabled && createRenderTarget(offscreen, SCR_WIDTH, SCR_HEIGHT)) {
+        capture = new FrameCapture(captureOptions, offscreen.width, offscreen.height);
+    }
+
+    // --- Thread de simulação ---
+    SimulationLink link;
+    installInputCallbacks(window, link.events);
+    link.snapshots.readBuffer().player = *static_cast<Mario*>(player); // Quadro inicial, antes do primeiro tick
+    link.snapshots.readBuffer().sampleNs = inputClockNs();
+    std::thread simulation(simulationLoop, std::ref(link), std::ref(input));
+
+    LatencyTracker latency(latencyOptions.measure);
+    FramePacer pacer(latencyOptions.pacing);
 
     // --- Loop de Renderização ---
     while (!glfwWindowShouldClose(window))
     {
-        // --- Calcular DeltaTime ---
-        float currentFrame = static_cast<float>(glfwGetTime());
-        deltaTime = currentFrame - lastFrame;
-        lastFrame = currentFrame;
-         if (deltaTime > 0.1f) deltaTime = 0.1f; // Limitar deltaTime
-
-        // --- Input ---
-        processInput(window, player, deltaTime);
-
-        // --- Atualizar Física ---
-        if(player)
-        {
-            player->updatePhysics(deltaTime);
+        // --- Input --- (teclas chegam pelos callbacks em glfwPollEvents; Esc fecha a janela lá)
+        // Com --pacing, espera até pouco antes do prazo previsto para pegar eventos e snapshot mais novos
+        pacer.waitForInput();
+        glfwPollEvents();
+        int64_t frameStartNs = inputClockNs();
+        if (link.inputFinished.load(std::memory_order_acquire)) glfwSetWindowShouldClose(window, true);
+
+        // --- Snapshot mais recente da simulação ---
+        bool freshSnapshot = link.snapshots.acquire();
+        if (freshSnapshot) {
+            link.consumedTick.store(link.snapshots.readBuffer().tick, std::memory_order_release);
+            link.consumedTick.notify_one();
         }
+        SceneSnapshot& snapshot = link.snapshots.readBuffer();
 
         // --- Renderização ---
-        glClearColor(0.5f, 0.8f, 1.0f, 1.0f); // Azul claro
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-        // Ativar shader
-        ourShader.use();
-
-        // --- Matrizes de Transformação ---
-        // Matriz de Projeção (Perspectiva) - Constante no loop se aspect ratio não muda
-        glm::mat4 projection = glm::perspective(glm::radians(45.0f), (float)SCR_WIDTH / (float)SCR_HEIGHT, 0.1f, 100.0f);
-        ourShader.setMat4("projection", projection);
-
-        // Matriz de Visualização (Câmera) - ESTÁTICA
-        // Olhando para a origem (0,0,0) de uma posição fixa (ex: 0, 5, 15)
-        glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 5.0f, 15.0f), // Posição da câmera fixa
-                                     glm::vec3(0.0f, 1.0f, 0.0f), // Ponto para onde olha (um pouco acima do chão)
-                                     glm::vec3(0.0f, 1.0f, 0.0f)); // Vetor 'up'
-        ourShader.setMat4("view", view);
-
-        // --- Desenhar Chão ---
-        glm::mat4 floorModel = glm::mat4(1.0f);
-        floorModel = glm::translate(floorModel, glm::vec3(0.0f, -0.05f, 0.0f));
-        floorModel = glm::scale(floorModel, glm::vec3(15.0f, 0.1f, 15.0f));
-        drawShape(cubeVAO, cubeVertexCount, ourShader, floorModel, glm::vec3(0.5f, 0.35f, 0.05f));
-
-        // --- Desenhar Cano ---
-        glm::mat4 pipeModel = glm::mat4(1.0f);
-        pipeModel = glm::translate(pipeModel, glm::vec3(3.0f, 1.5f, -2.0f)); // Centro do cano
-        pipeModel = glm::scale(pipeModel, glm::vec3(0.7f, 1.5f, 0.7f));
-        drawShape(cylinderVAO, cylinderVertexCount, ourShader, pipeModel, glm::vec3(0.0f, 0.8f, 0.2f));
-
-        // --- Desenhar Jogador ---
-        if(player)
-        {
-            // A função draw do Mario/Character espera view e projection, mas elas já foram setadas no shader
-            // Podemos passar ou não, mas a implementação atual de Mario::draw as re-seta.
-            // Para evitar redundância, poderíamos modificar Mario::draw para *não* setar view/projection.
-            // Por agora, deixaremos como está, mas cientes da redundância.
-            player->draw(ourShader, view, projection);
+        glm::mat4 view = sceneView();
+        glm::mat4 projection = sceneProjection((float)SCR_WIDTH / (float)SCR_HEIGHT);
+        if (renderer.lighting) {
+            updateSceneLights(sceneLights, lightingOptions.lights, &snapshot.player, (float)glfwGetTime());
+            lightClusters.build(sceneLights, view, projection, NEAR_PLANE, FAR_PLANE);
+            lightClusters.upload();
+        }
+        if (capture) bindRenderTarget(offscreen);
+        renderScene(renderer, &snapshot.player, view, projection);
+        if (capture) {
+            capture->captureFramebuffer(offscreen.framebuffer);
+            int screenWidth, screenHeight;
+            glfwGetFramebufferSize(window, &screenWidth, &screenHeight);
+            blitToScreen(offscreen, screenWidth, screenHeight);
         }
 
-        // --- Trocar Buffers e Processar Eventos ---
+        // --- Trocar Buffers ---
+        // Um snapshot repetido não conta a entrada de novo, mas a idade da leitura (sample) continua crescendo
+        int64_t submitNs = inputClockNs();
         glfwSwapBuffers(window);
-        glfwPollEvents();
+        pacer.frameSwapped(frameStartNs, submitNs);
+        latency.frameSubmitted(freshSnapshot ? snapshot.inputNs : 0, snapshot.sampleNs, submitNs);
+        latency.poll();
     }
 
+    link.running.store(false, std::memory_order_release);
+    link.consumedTick.fetch_add(1, std::memory_order_release); // Acorda a simulação se ela estiver esperando
+    link.consumedTick.notify_one();
+    simulation.join();
+
     // --- Limpeza ---
-    delete player;
+    latency.printReport("MarioFanGame");
+    pacer.printReport("MarioFanGame");
+    lightClusters.printStats("MarioFanGame lights");
+    lightClusters.destroy();
+    if (indirectRenderer) {
+        indirectRenderer->printStats("MarioFanGame indirect");
+        indirectRenderer.reset(); // Os buffers precisam do contexto
+    }
+    if (capture) {
+        capture->finish();
+        capture->printStats("MarioFanGame capture");
+        delete capture;
+        destroyRenderTarget(offscreen);
+    }
+
+    marioPool.despawn(playerHandle);
     player = nullptr;
 
-    glDeleteVertexArrays(1, &cubeVAO);
-    glDeleteBuffers(1, &cubeVBO);
-    glDeleteVertexArrays(1, &cylinderVAO);
-    glDeleteBuffers(1, &cylinderVBO);
+    destroyMesh(cubeMesh);
+    destroyMesh(cylinderMesh);
     glDeleteProgram(ourShader.ID);
 
     glfwTerminate();
     return 0;
 }
 
-// Função para desenhar uma forma genérica
-void drawShape(GLuint vao, GLsizei count, Shader& shader, glm::mat4 model, glm::vec3 color) {
-    shader.setMat4("model", model);
-    shader.setVec3("objectColor", color);
-    glBindVertexArray(vao);
-    glDrawArrays(GL_TRIANGLES, 0, count);
-    glBindVertexArray(0);
+// Matriz de Visualização (Câmera) - ESTÁTICA
+// Olhando para a origem (0,0,0) de uma posição fixa (ex: 0, 5, 15)
+glm::mat4 sceneView() {
+    return glm::lookAt(glm::vec3(0.0f, 5.0f, 15.0f), // Posição da câmera fixa
+                       glm::vec3(0.0f, 1.0f, 0.0f), // Ponto para onde olha (um pouco acima do chão)
+                       glm::vec3(0.0f, 1.0f, 0.0f)); // Vetor 'up'
+}
+
+// Matriz de Projeção (Perspectiva)
+glm::mat4 sceneProjection(float aspect) {
+    return glm::perspective(glm::radians(45.0f), aspect, NEAR_PLANE, FAR_PLANE);
+}
+
+// Luzes pontuais da cena: a primeira acompanha o personagem, as outras giram em anéis sobre o
+// chão com raio, fase, cor e altura tiradas do índice (o mesmo índice dá sempre a mesma luz)
+void updateSceneLights(std::vector<PointLight>& lights, int count, const Character* character, float time) {
+    lights.resize(count);
+    for (int i = 0; i < count; ++i) {
+        PointLight& light = lights[i];
+        if (i == 0 && character) {
+            light.position = character->position + glm::vec3(0.0f, 2.5f, 0.0f);
+            light.radius = 5.0f;
+            light.color = glm::vec3(1.0f, 0.9f, 0.7f);
+            continue;
+        }
+        float ring = 1.5f + (i % 8) * 1.6f;           // Anéis de 1,5 a 12,7
+        float phase = i * 2.39996f;                   // Ângulo áureo: fases bem espalhadas
+        float speed = (i % 2 ? 1.0f : -1.0f) * 2.0f / ring;
+        float angle = phase + time * speed;
+        light.position = glm::vec3(ring * cos(angle), 0.7f + 0.4f * sin(time * 1.3f + phase), ring * sin(angle));
+        light.radius = 1.5f + (i % 3) * 0.75f;
+        light.color = 1.5f * glm::vec3(0.5f + 0.5f * cos(phase),
+                                       0.5f + 0.5f * cos(phase + 2.0944f),
+                                       0.5f + 0.5f * cos(phase + 4.18879f));
+    }
+}
+
+// Desenha chão, cano e o personagem em qualquer backend (OpenGL ou software)
+void renderScene(Renderer& renderer, Character* character, const glm::mat4& view, const glm::mat4& projection) {
+    renderer.beginFrame(view, projection, CLEAR_COLOR);
+
+    // --- Desenhar Chão ---
+    glm::mat4 floorModel = glm::mat4(1.0f);
+    floorModel = glm::translate(floorModel, glm::vec3(0.0f, -0.05f, 0.0f));
+    floorModel = glm::scale(floorModel, glm::vec3(15.0f, 0.1f, 15.0f));
+    renderer.drawMesh(cubeMesh, floorModel, glm::vec3(0.5f, 0.35f, 0.05f));
+
+    // --- Desenhar Cano ---
+    glm::mat4 pipeModel = glm::mat4(1.0f);
+    pipeModel = glm::translate(pipeModel, glm::vec3(3.0f, 1.5f, -2.0f)); // Centro do cano
+    pipeModel = glm::scale(pipeModel, glm::vec3(0.7f, 1.5f, 0.7f));
+    renderer.drawMesh(cylinderMesh, pipeModel, glm::vec3(0.0f, 0.8f, 0.2f));
+
+    // --- Desenhar Jogador ---
+    if(character)
+    {
+        character->draw(renderer);
+    }
+
+    renderer.endFrame();
+}
+
+// Executa a cena sem janela: sem input, passo fixo e rasterizador de software
+int runHeadless(const HeadlessOptions& options, const CaptureOptions& captureOptions, const InputOptions& inputOptions,
+                const LightingOptions& lightingOptions)
+{
+    std::vector<glm::vec3> cubePositions = generateCubePositions();
+    buildMesh(cubePositions, std::vector<glm::vec3>(), cubeMesh);
+    std::vector<glm::vec3> cylinderPositions = generateCylinderPositions(32);
+    buildMesh(cylinderPositions, std::vector<glm::vec3>(), cylinderMesh);
+
+    SoftwareRenderer renderer(options.width, options.height, options.threads);
+    renderer.cullBackFaces = false; // A janela não habilita GL_CULL_FACE
+    HeadlessReport report;
+    FrameCapture capture(captureOptions, options.width, options.height, false);
+
+    playerHandle = marioPool.spawn(glm::vec3(0.0f, 0.0f, 0.0f));
+    player = marioPool.get(playerHandle);
+    glm::mat4 projection = sceneProjection((float)options.width / (float)options.height);
+
+    // Sem teclado: a entrada vem do replay (que também define o número de quadros) ou fica vazia
+    InputStream input(MARIO_KEYS, inputOptions);
+    // O rasterizador de software desenha com a cor chapada; com --lights só a distribuição das
+    // luzes pelos clusters roda (e é medida), sem mudar a imagem
+    std::vector<PointLight> sceneLights;
+    LightClusters lightClusters;
+    int frames = input.isReplaying() ? static_cast<int>(input.frameCount()) : options.frames;
+
+    for (int frame = 0; frame < frames; ++frame) {
+        InputFrame live;
+        live.deltaTime = options.fixedDeltaTime;
+        float dt = input.next(live).deltaTime;
+
+        auto simulationStart = std::chrono::steady_clock::now();
+        processInput(input, player, dt);
+        player->updatePhysics(dt);
+        double simulationMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - simulationStart).count();
+
+        if (lightingOptions.lights > 0) {
+            updateSceneLights(sceneLights, lightingOptions.lights, player, frame * options.fixedDeltaTime);
+            lightClusters.build(sceneLights, sceneView(), projection, NEAR_PLANE, FAR_PLANE);
+        }
+        renderScene(renderer, player, sceneView(), projection);
+        report.addFrame(simulationMs, renderer.getStats());
+        capture.captureSoftware(renderer);
+    }
+    report.print("MarioFanGame (headless)");
+    lightClusters.printStats("MarioFanGame lights");
+    if (captureOptions.enabled) {
+        capture.finish();
+        capture.printStats("MarioFanGame capture");
+    }
+    bool saved = saveHeadlessFrame(options, renderer);
+
+    marioPool.despawn(playerHandle);
+    player = nullptr;
+    return saved ? 0 : -1;
 }
 
 // Processa input para o personagem
-void processInput(GLFWwindow *window, Character* character, float dt) {
+void processInput(const InputStream& input, Character* character, float dt) {
     if (!character) return;
 
     // Tenta converter para Mario* para acessar membros específicos
     Mario* mario = dynamic_cast<Mario*>(character);
 
-    if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
-        glfwSetWindowShouldClose(window, true);
-
     // --- Rotação (Setas Esquerda/Direita) ---
-    if (glfwGetKey(window, GLFW_KEY_RIGHT) == GLFW_PRESS) {
+    if (input.isDown(GLFW_KEY_RIGHT)) {
         character->rotationY -= PLAYER_ROTATION_SPEED * dt;
     }
-    if (glfwGetKey(window, GLFW_KEY_LEFT) == GLFW_PRESS) {
+    if (input.isDown(GLFW_KEY_LEFT)) {
         character->rotationY += PLAYER_ROTATION_SPEED * dt;
     }
     // Normaliza o ângulo de rotação (opcional, mas bom)
@@ -197,10 +432,10 @@ void processInput(GLFWwindow *window, Character* character, float dt) {
 
     // --- Inclinação da Cabeça (Setas Cima/Baixo) ---
     if (mario) { // Só funciona se a conversão para Mario* foi bem sucedida
-        if (glfwGetKey(window, GLFW_KEY_UP) == GLFW_PRESS) {
+        if (input.isDown(GLFW_KEY_UP)) {
             mario->headTilt -= HEAD_TILT_SPEED * dt;
         }
-        if (glfwGetKey(window, GLFW_KEY_DOWN) == GLFW_PRESS) {
+        if (input.isDown(GLFW_KEY_DOWN)) {
             mario->headTilt += HEAD_TILT_SPEED * dt;
         }
         // Limita a inclinação da cabeça
@@ -210,10 +445,10 @@ void processInput(GLFWwindow *window, Character* character, float dt) {
 
     // --- Movimento (W/A/S/D - Relativo à Direção) ---
     glm::vec3 moveInput(0.0f); // Direção do input local (x=strafe, z=forward)
-    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS) moveInput.z += 1.0f;
-    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS) moveInput.z -= 1.0f;
-    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS) moveInput.x -= 1.0f;
-    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS) moveInput.x += 1.0f;
+    if (input.isDown(GLFW_KEY_W)) moveInput.z += 1.0f;
+    if (input.isDown(GLFW_KEY_S)) moveInput.z -= 1.0f;
+    if (input.isDown(GLFW_KEY_A)) moveInput.x -= 1.0f;
+    if (input.isDown(GLFW_KEY_D)) moveInput.x += 1.0f;
 
     bool isMovingInput = glm::length(moveInput) > 0.1f;
 
@@ -262,15 +497,12 @@ void processInput(GLFWwindow *window, Character* character, float dt) {
     }
 
 
-    // --- Pulo (Espaço) --- (Sem alterações na lógica de detecção)
-    static bool spacePressedLastFrame = false;
-    bool spacePressedThisFrame = (glfwGetKey(window, GLFW_KEY_SPACE) == GLFW_PRESS);
-    if (glfwGetKey(window, GLFW_KEY_SPACE) == GLFW_PRESS && character->onGround) {
+    // --- Pulo (Espaço) --- Segurar o espaço continua pulando ao tocar o chão
+    if (input.isDown(GLFW_KEY_SPACE) && character->onGround) {
         // Chama startJump diretamente se espaço pressionado E está no chão
         character->startJump();
         // Nota: Character::startJump ainda deve ter a checagem 'if (onGround)' por segurança
     }
-    spacePressedLastFrame = spacePressedThisFrame;
 
     if (mario && isMovingInput && character->onGround) {
         mario->isWalking = true;
@@ -0,0 +1,123 @@
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include "AdventureCharacters.h"
+#include "FrameArena.h"
+#include "InputRecording.h"
+#include "Navigation.h"
+#include "Flocking.h"
+#include "Replication.h"
+
+// AdventureServer: the Adventure Time simulation without a window, replicated over UDP
+// (Replication.h). Nobody is player-controlled on the server: every character wanders.
+//   ./AdventureServer --characters 5000 --seconds 30
+//   ./AdventureServer --connect 127.0.0.1:27015 --interest 20 --follow 0   (one per viewer process)
+
+// --- Servidor ---
+int runServer(const ReplicationOptions& options, uint32_t seed) {
+    gen.seed(seed);
+    std::vector<Character*> allCharacters;
+    spawnCharacters(allCharacters);
+    // Same NPC mix as the benchmark crowd: BMO, PB, Ice King, Marceline in turn
+    for (long long i = static_cast<long long>(allCharacters.size()); i < options.characters; ++i) {
+        glm::vec3 position(distribWander(gen), 0.0f, distribWander(gen));
+        allCharacters.push_back(characterPools.spawn(static_cast<CharacterType>(2 + i % 4), position));
+    }
+
+    NetAddress bindAddress = options.address;
+    if (options.bindAny) bindAddress.ip = 0;
+    ReplicationServer server;
+    if (!server.open(bindAddress)) {
+        std::fprintf(stderr, "Failed to open UDP port %s\n", bindAddress.toString().c_str());
+        despawnCharacters(allCharacters);
+        return -1;
+    }
+    std::printf("AdventureServer: %zu characters on %s at %d Hz\n", allCharacters.size(), bindAddress.toString().c_str(), options.tickRate);
+    std::fflush(stdout);
+
+    using Clock = std::chrono::steady_clock;
+    const float dt = 1.0f / options.tickRate;
+    const Clock::duration tickDuration = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(dt));
+    Clock::time_point start = Clock::now();
+    Clock::time_point nextTick = start;
+    double lastReport = 0.0;
+    double simulationMs = 0.0;
+    for (uint32_t tick = 0;; ++tick) {
+        double now = std::chrono::duration<double>(Clock::now() - start).count();
+        if (options.seconds > 0.0 && now >= options.seconds) break;
+        server.receive(now);
+
+        Clock::time_point simulationStart = Clock::now();
+        updateWorld(allCharacters, -1, dt);
+        simulationMs += std::chrono::duration<double, std::milli>(Clock::now() - simulationStart).count();
+        server.send(allCharacters, tick);
+        frameArena.endFrame();
+
+        if (now - lastReport >= 1.0) {
+            server.printStats(now - lastReport, simulationMs);
+            lastReport = now;
+            simulationMs = 0.0;
+        }
+        // Fixed rate; a server that fell far behind skips ahead instead of bursting ticks
+        nextTick += tickDuration;
+        if (Clock::now() - nextTick > std::chrono::milliseconds(250)) nextTick = Clock::now();
+        std::this_thread::sleep_until(nextTick);
+    }
+
+    despawnCharacters(allCharacters);
+    return 0;
+}
+
+// --- Cliente headless ---
+int runClient(const ReplicationOptions& options) {
+    ReplicationClient client;
+    if (!client.connect(options.address, options.interest, options.follow)) {
+        std::fprintf(stderr, "Failed to open a UDP socket\n");
+        return -1;
+    }
+
+    using Clock = std::chrono::steady_clock;
+    Clock::time_point start = Clock::now();
+    double now = 0.0;
+    bool lost = false;
+    while (now < options.seconds) {
+        client.update(now);
+        if (!client.hasView() && now > 5.0) {
+            std::fprintf(stderr, "No answer from %s\n", options.address.toString().c_str());
+            lost = true;
+            break;
+        }
+        if (client.hasView() && now - client.lastReceived() > ReplicationServer::CLIENT_TIMEOUT) {
+            std::fprintf(stderr, "Server %s stopped sending\n", options.address.toString().c_str());
+            lost = true;
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        now = std::chrono::duration<double>(Clock::now() - start).count();
+    }
+    client.disconnect();
+
+    const ReplicationClient::Stats& stats = client.getStats();
+    double views = static_cast<double>(std::max<size_t>(1, stats.views));
+    std::printf("AdventureServer client of %s: %zu views in %.1f s (%.1f/s), %.0f entities and %.0f B per view, %.1f KB/s, %.0f packets/s\n",
+                options.address.toString().c_str(), stats.views, now, stats.views / now, stats.entities / views,
+                stats.bytes / views, stats.bytes / 1024.0 / now, stats.packets / now);
+    std::printf("decode %.3f ms/view; %zu incomplete, %zu without baseline, %zu corrupt, %zu checksum mismatches\n",
+                stats.decodeMs / views, stats.incomplete, stats.missingBaseline, stats.corrupt, stats.checksumMismatches);
+    std::fflush(stdout);
+    return !lost && stats.views > 0 && stats.corrupt == 0 && stats.checksumMismatches == 0 ? 0 : -1;
+}
+
+// --- Função Principal ---
+int main(int argc, char** argv) {
+    ReplicationOptions options = parseReplicationOptions(argc, argv);
+    InputOptions inputOptions = parseInputOptions(argc, argv);
+    parseSimulationLod(argc, argv);
+    parseNavigationOptions(argc, argv);
+    parseFlockingOptions(argc, argv);
+    if (options.client) return runClient(options);
+    addSceneObstacles(1.5f); // Same scene as AdventureTime
+    return runServer(options, inputOptions.hasSeed ? inputOptions.seed : 12345u);
+}
@@ -0,0 +1,64 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec3 viewPosition;
+in vec3 viewNormal;
+in vec3 surfaceColor; // Cor do objeto (uniform no lit.vert, por instância no lit_indirect.vert)
+
+// Luz direcional e ambiente (espaço de visão)
+uniform vec3 sunDirection; // Sentido em que a luz viaja
+uniform vec3 sunColor;
+uniform vec3 ambientColor;
+
+// Luzes pontuais em clusters (ver Lighting.h)
+uniform bool clusteredLights;
+uniform ivec3 clusterDims;      // Blocos em x e y, fatias em z
+uniform vec2 clusterTileScale;  // Blocos por pixel
+uniform vec2 clusterSlice;      // fatia = log(profundidade) * x + y
+uniform samplerBuffer lightData;      // 2 texels por luz: posição (visão) + raio, cor
+uniform usamplerBuffer clusterRanges; // Início e quantidade em lightIndices
+uniform usamplerBuffer lightIndices;
+
+const float SHININESS = 32.0;
+const float SPECULAR = 0.25;
+
+// Lambert (difusa) + Blinn-Phong (especular)
+vec3 shade(vec3 n, vec3 v, vec3 l, vec3 radiance)
+{
+    float diffuse = max(dot(n, l), 0.0);
+    if (diffuse <= 0.0) return vec3(0.0);
+    vec3 h = normalize(l + v);
+    float specular = pow(max(dot(n, h), 0.0), SHININESS) * SPECULAR;
+    return radiance * (surfaceColor * diffuse + vec3(specular));
+}
+
+void main()
+{
+    // Malhas sem normais continuam com a cor chapada
+    if (dot(viewNormal, viewNormal) < 1e-6) {
+        FragColor = vec4(surfaceColor, 1.0);
+        return;
+    }
+    vec3 n = normalize(viewNormal);
+    vec3 v = normalize(-viewPosition);
+    vec3 color = ambientColor * surfaceColor + shade(n, v, -sunDirection, sunColor);
+
+    if (clusteredLights) {
+        // Cluster do fragmento: bloco da tela e fatia exponencial da profundidade
+        int slice = int(floor(log(-viewPosition.z) * clusterSlice.x + clusterSlice.y));
+        ivec3 cell = clamp(ivec3(ivec2(gl_FragCoord.xy * clusterTileScale), slice), ivec3(0), clusterDims - 1);
+        uvec2 range = texelFetch(clusterRanges, (cell.z * clusterDims.y + cell.y) * clusterDims.x + cell.x).xy;
+        for (uint i = 0u; i < range.y; ++i) {
+            int light = int(texelFetch(lightIndices, int(range.x + i)).x);
+            vec4 positionRadius = texelFetch(lightData, 2 * light);
+            vec3 toLight = positionRadius.xyz - viewPosition;
+            float distance2 = dot(toLight, toLight);
+            // Queda suave até zero no raio, o mesmo usado na distribuição pelos clusters
+            float falloff = clamp(1.0 - distance2 / (positionRadius.w * positionRadius.w), 0.0, 1.0);
+            if (falloff <= 0.0) continue;
+            vec3 radiance = texelFetch(lightData, 2 * light + 1).rgb * (falloff * falloff);
+            color += shade(n, v, toLight * inversesqrt(distance2), radiance);
+        }
+    }
+    FragColor = vec4(color, 1.0);
+}
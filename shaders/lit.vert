@@ -0,0 +1,22 @@
+#version 330 core
+layout (location = 0) in vec3 aPos;    // Posição do vértice (a desquantização está na 'model')
+layout (location = 1) in vec3 aNormal; // Normal em espaço de objeto; (0,0,0) se a malha não tiver
+
+uniform mat4 model;
+uniform mat4 view;
+uniform mat4 projection;
+uniform mat3 normalMatrix; // Direção da inversa transposta da 3x3 da model (sem a desquantização); o lit.frag normaliza
+uniform vec3 objectColor;  // Cor vinda da aplicação
+
+out vec3 viewPosition;
+out vec3 viewNormal;
+out vec3 surfaceColor;
+
+void main()
+{
+    vec4 position = view * model * vec4(aPos, 1.0);
+    viewPosition = position.xyz;
+    viewNormal = mat3(view) * (normalMatrix * aNormal); // A view é rígida
+    surfaceColor = objectColor;
+    gl_Position = projection * position;
+}
@@ -0,0 +1,46 @@
+#version 330 core
+layout (location = 0) in vec3 aPos;      // Posição quantizada da malha em [-1, 1] (a desquantização está na instância)
+layout (location = 1) in vec3 aNormal;   // Normal no mesmo espaço de aPos; (0,0,0) se a malha não tiver
+// Por instância (IndirectInstance): model = translação * rotação * escala, cor pela paleta
+layout (location = 2) in vec3 aPosition;
+layout (location = 3) in uint aRotation; // Quatérnio "smallest three": 3 x 10 bits + índice da omitida
+layout (location = 4) in vec3 aScale;    // half
+layout (location = 5) in uint aPalette;
+
+uniform mat4 view;
+uniform mat4 projection;
+uniform samplerBuffer palette;
+
+out vec3 viewPosition;
+out vec3 viewNormal;
+out vec3 surfaceColor;
+
+vec4 decodeRotation(uint bits)
+{
+    vec3 small = vec3(uvec3(bits, bits >> 10, bits >> 20) & 1023u) * (1.41421356 / 1022.0) - 0.70710678;
+    float largest = sqrt(max(0.0, 1.0 - dot(small, small)));
+    uint omitted = bits >> 30;
+    if (omitted == 0u) return vec4(largest, small);
+    if (omitted == 1u) return vec4(small.x, largest, small.yz);
+    if (omitted == 2u) return vec4(small.xy, largest, small.z);
+    return vec4(small, largest);
+}
+
+vec3 rotate(vec4 q, vec3 v)
+{
+    return v + 2.0 * cross(q.xyz, cross(q.xyz, v) + q.w * v);
+}
+
+void main()
+{
+    vec4 rotation = decodeRotation(aRotation);
+    vec4 position = view * vec4(aPosition + rotate(rotation, aScale * aPos), 1.0);
+    viewPosition = position.xyz;
+    // A inversa transposta de R * S é R * S^-1. Uma escala 0 (peça achatada, o half aceita) vira
+    // +-1e-6 com o mesmo sinal, para a divisão não dar inf/NaN; a normal sai no eixo achatado
+    vec3 tinyScale = mix(vec3(1e-6), vec3(-1e-6), lessThan(aScale, vec3(0.0)));
+    vec3 safeScale = mix(tinyScale, aScale, greaterThan(abs(aScale), vec3(1e-6)));
+    viewNormal = mat3(view) * rotate(rotation, aNormal / safeScale);
+    surfaceColor = texelFetch(palette, int(aPalette)).rgb;
+    gl_Position = projection * position;
+}